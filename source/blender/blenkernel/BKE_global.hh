@@ -187,6 +187,12 @@ struct Global {
   char gpu_debug_scope_name[200];
 
   bool profile_gpu;
+
+  /**
+   * Path of the file the compositor appends Chrome trace events to, empty when disabled.
+   * Set using `--profile-compositor <filepath>`.
+   */
+  char compositor_profile_filepath[/*FILE_MAX*/ 1024];
 };
 
 /* **************** GLOBAL ********************* */
@@ -229,6 +235,12 @@ enum {
   G_FLAG_GPU_BACKEND_FALLBACK = (1 << 17),
   G_FLAG_GPU_BACKEND_FALLBACK_QUIET = (1 << 18),
 
+  /**
+   * Only read the data-blocks used by scenes and the UI when opening files,
+   * see #BLO_READ_SKIP_UNUSED_IDS.
+   */
+  G_FLAG_READFILE_SKIP_UNUSED_IDS = (1 << 19),
+
 };
 
 #define G_FLAG_INTERNET_OVERRIDE_PREF_ANY \
@@ -239,7 +251,7 @@ enum {
   (G_FLAG_SCRIPT_AUTOEXEC | G_FLAG_SCRIPT_OVERRIDE_PREF | G_FLAG_INTERNET_ALLOW | \
    G_FLAG_INTERNET_OVERRIDE_PREF_ONLINE | G_FLAG_INTERNET_OVERRIDE_PREF_OFFLINE | \
    G_FLAG_EVENT_SIMULATE | G_FLAG_USERPREF_NO_SAVE_ON_EXIT | G_FLAG_GPU_BACKEND_FALLBACK | \
-   G_FLAG_GPU_BACKEND_FALLBACK_QUIET | \
+   G_FLAG_GPU_BACKEND_FALLBACK_QUIET | G_FLAG_READFILE_SKIP_UNUSED_IDS | \
 \
    /* #BPY_python_reset is responsible for resetting these flags on file load. */ \
    G_FLAG_SCRIPT_AUTOEXEC_FAIL | G_FLAG_SCRIPT_AUTOEXEC_FAIL_QUIET)
@@ -153,6 +153,12 @@ struct Main {
    * with user created data that would be lost when the asset system regenerates the file.
    */
   bool is_asset_edit_file;
+  /**
+   * Only the data-blocks used by the scenes and the UI were read from the file, see
+   * #BLO_READ_SKIP_UNUSED_IDS. The file must not be overwritten, as that would lose all the
+   * data-blocks that were not read.
+   */
+  bool is_partially_read;
 
   /** Commit timestamp from `buildinfo`. */
   uint64_t build_commit_timestamp;
@@ -211,6 +211,7 @@ void BKE_blender_globals_init()
   G.log.level = 1;
 
   G.profile_gpu = false;
+  G.compositor_profile_filepath[0] = '\0';
 }
 
 void BKE_blender_globals_clear()
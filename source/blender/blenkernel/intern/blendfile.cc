@@ -1140,6 +1140,11 @@ static void setup_app_data(bContext *C,
 
   BLI_assert(BKE_main_namemap_validate(*bfd->main));
 
+  if (mode == LOAD_UNDO) {
+    /* Undo steps only contain the data-blocks that were read from the file in the first place. */
+    bfd->main->is_partially_read = bmain->is_partially_read;
+  }
+
   /* This frees the `old_bmain`. */
   BKE_blender_globals_main_replace(bfd->main);
   bmain = G_MAIN;
@@ -467,7 +467,8 @@ bool BKE_main_is_empty(Main *bmain)
 
 bool BKE_main_has_issues(const Main *bmain)
 {
-  return bmain->has_forward_compatibility_issues || bmain->is_asset_edit_file;
+  return bmain->has_forward_compatibility_issues || bmain->is_asset_edit_file ||
+         bmain->is_partially_read;
 }
 
 bool BKE_main_needs_overwrite_confirm(const Main *bmain)
@@ -124,6 +124,54 @@ inline std::optional<Vector<ChunkT>> parse_csv_in_chunks(
   return result_chunks;
 }
 
+/**
+ * Same as #parse_csv_in_chunks, but the data records are parsed in consecutive windows of the
+ * buffer. The chunk results of each window are passed to `process_window` before the next window
+ * is parsed, so the memory used by intermediate results does not grow with the size of the file.
+ * This is meant for very large (e.g. memory-mapped) files.
+ *
+ * \param window_size_bytes: Approximate number of bytes per window. Windows are aligned to lines.
+ *   When a window splits a quoted multi-line field, it is parsed again with a larger size.
+ * \param process_window: Called once per window in order, with the results of `process_records`
+ *   for the chunks of that window.
+ * \return False if the file was malformed.
+ */
+bool parse_csv_in_windows(Span<char> buffer,
+                          const CsvParseOptions &options,
+                          int64_t window_size_bytes,
+                          FunctionRef<void(const CsvRecord &record)> process_header,
+                          FunctionRef<Any<>(const CsvRecords &records)> process_records,
+                          FunctionRef<void(MutableSpan<Any<>> chunk_results)> process_window);
+
+/**
+ * Same as above, but uses a templated chunk type instead of using #Any.
+ */
+template<typename ChunkT>
+inline bool parse_csv_in_windows(
+    const Span<char> buffer,
+    const CsvParseOptions &options,
+    const int64_t window_size_bytes,
+    FunctionRef<void(const CsvRecord &record)> process_header,
+    FunctionRef<ChunkT(const CsvRecords &records)> process_records,
+    FunctionRef<void(MutableSpan<ChunkT> chunk_results)> process_window)
+{
+  Vector<ChunkT> window_chunks;
+  return parse_csv_in_windows(
+      buffer,
+      options,
+      window_size_bytes,
+      process_header,
+      [&](const CsvRecords &records) { return Any<>(process_records(records)); },
+      [&](MutableSpan<Any<>> chunk_results) {
+        window_chunks.clear();
+        window_chunks.reserve(chunk_results.size());
+        for (Any<> &value : chunk_results) {
+          window_chunks.append(std::move(value.get<ChunkT>()));
+        }
+        process_window(window_chunks);
+      });
+}
+
 /**
  * Fields in a CSV file may contain escaped quote characters (e.g. "" or \").
  * This function replaces these with just the quote character.
@@ -88,27 +88,14 @@ static std::optional<CsvRecords> parse_records(const Span<char> buffer,
   return CsvRecords(OffsetIndices<int64_t>(r_data_offsets), r_data_fields);
 }
 
-std::optional<Vector<Any<>>> parse_csv_in_chunks(
-    const Span<char> buffer,
+/**
+ * Parses a buffer that contains only data records, i.e. without the header, in parallel chunks.
+ */
+static std::optional<Vector<Any<>>> parse_data_records_in_chunks(
+    const Span<char> data_buffer,
     const CsvParseOptions &options,
-    FunctionRef<void(const CsvRecord &record)> process_header,
     FunctionRef<Any<>(const CsvRecords &records)> process_records)
 {
-  using namespace detail;
-
-  /* First parse the first row to get the column names. */
-  Vector<Span<char>> header_fields;
-  const std::optional<int64_t> first_data_record_start = parse_record_fields(
-      buffer, 0, options.delimiter, options.quote, options.quote_escape_chars, header_fields);
-  if (!first_data_record_start.has_value()) {
-    return std::nullopt;
-  }
-  /* Call this before starting to process the remaining data. This allows the caller to do some
-   * preprocessing that is used during chunk parsing. */
-  process_header(CsvRecord(header_fields));
-
-  /* This buffer contains only the data records, without the header. */
-  const Span<char> data_buffer = buffer.drop_front(*first_data_record_start);
   /* Split the buffer into chunks that can be processed in parallel. */
   const Vector<Span<char>> data_buffer_chunks = split_into_aligned_chunks(
       data_buffer, options.chunk_size_bytes);
@@ -166,6 +153,72 @@ std::optional<Vector<Any<>>> parse_csv_in_chunks(
   return results;
 }
 
+std::optional<Vector<Any<>>> parse_csv_in_chunks(
+    const Span<char> buffer,
+    const CsvParseOptions &options,
+    FunctionRef<void(const CsvRecord &record)> process_header,
+    FunctionRef<Any<>(const CsvRecords &records)> process_records)
+{
+  using namespace detail;
+
+  /* First parse the first row to get the column names. */
+  Vector<Span<char>> header_fields;
+  const std::optional<int64_t> first_data_record_start = parse_record_fields(
+      buffer, 0, options.delimiter, options.quote, options.quote_escape_chars, header_fields);
+  if (!first_data_record_start.has_value()) {
+    return std::nullopt;
+  }
+  /* Call this before starting to process the remaining data. This allows the caller to do some
+   * preprocessing that is used during chunk parsing. */
+  process_header(CsvRecord(header_fields));
+
+  /* This buffer contains only the data records, without the header. */
+  const Span<char> data_buffer = buffer.drop_front(*first_data_record_start);
+  return parse_data_records_in_chunks(data_buffer, options, process_records);
+}
+
+bool parse_csv_in_windows(const Span<char> buffer,
+                          const CsvParseOptions &options,
+                          const int64_t window_size_bytes,
+                          FunctionRef<void(const CsvRecord &record)> process_header,
+                          FunctionRef<Any<>(const CsvRecords &records)> process_records,
+                          FunctionRef<void(MutableSpan<Any<>> chunk_results)> process_window)
+{
+  using namespace detail;
+
+  Vector<Span<char>> header_fields;
+  const std::optional<int64_t> first_data_record_start = parse_record_fields(
+      buffer, 0, options.delimiter, options.quote, options.quote_escape_chars, header_fields);
+  if (!first_data_record_start.has_value()) {
+    return false;
+  }
+  process_header(CsvRecord(header_fields));
+
+  const int64_t min_window_size = std::max<int64_t>(window_size_bytes, 1);
+  int64_t window_size = min_window_size;
+  Span<char> remaining_buffer = buffer.drop_front(*first_data_record_start);
+  while (!remaining_buffer.is_empty()) {
+    const int64_t window_end = guess_next_record_start(
+        remaining_buffer, std::min(window_size, remaining_buffer.size()));
+    const Span<char> window_buffer = remaining_buffer.take_front(window_end);
+    std::optional<Vector<Any<>>> chunk_results = parse_data_records_in_chunks(
+        window_buffer, options, process_records);
+    if (!chunk_results.has_value()) {
+      if (window_end == remaining_buffer.size()) {
+        return false;
+      }
+      /* The window most likely ends within a quoted multi-line field. Try again with a larger
+       * window, which happens rarely enough to not be a problem for performance. */
+      window_size *= 2;
+      continue;
+    }
+    process_window(*chunk_results);
+    remaining_buffer = remaining_buffer.drop_front(window_end);
+    window_size = min_window_size;
+  }
+  return true;
+}
+
 StringRef unescape_field(const StringRef str,
                          const CsvParseOptions &options,
                          LinearAllocator<> &allocator)
@@ -7,11 +7,17 @@
  */
 
 #include <algorithm>
+#include <atomic>
+#include <condition_variable>
 #include <cstring>
+#include <memory>
+#include <mutex>
 #include <zstd.h>
 
 #include "BLI_fileops.hh"
 #include "BLI_filereader.h"
+#include "BLI_map.hh"
+#include "BLI_task.h"
 
 #ifdef __BIG_ENDIAN__
 #  include "BLI_endian_switch.h"
@@ -19,6 +25,8 @@
 
 #include "MEM_guardedalloc.h"
 
+struct ZstdPrefetch;
+
 struct ZstdReader {
   FileReader reader;
 
@@ -36,6 +44,42 @@ struct ZstdReader {
     char *cached_content;
     int cached_frame;
   } seek;
+
+  /** Only set for seekable files opened with #BLI_filereader_new_zstd_prefetch. */
+  ZstdPrefetch *prefetch;
+};
+
+/** A frame of a seekable file, decompressed ahead of the reader on a worker thread. */
+struct ZstdPrefetchFrame {
+  enum State { Queued, Running, Done, Failed, Cancelled };
+
+  int frame;
+  std::atomic<int> state = Queued;
+  /** Uncompressed content, valid once the state is #Done. */
+  char *data = nullptr;
+
+  std::mutex mutex;
+  std::condition_variable finished;
+
+  ~ZstdPrefetchFrame()
+  {
+    MEM_SAFE_FREE(data);
+  }
+};
+
+struct ZstdPrefetch {
+  TaskPool *pool;
+  /** The base reader is shared by all tasks, its seek & read have to happen together. */
+  std::mutex base_mutex;
+  /** Amount of frames (including the one being read) that are decompressed in advance. */
+  int frames_ahead;
+  /**
+   * Frames in the prefetch window, only accessed from the thread using the reader.
+   * Running tasks hold a reference too, so dropped frames stay valid until they finish.
+   */
+  blender::Map<int, std::shared_ptr<ZstdPrefetchFrame>> frames;
+  /** The frame that the last read returned data from. */
+  std::shared_ptr<ZstdPrefetchFrame> current;
 };
 
 static bool zstd_read_u32(FileReader *base, uint32_t *val)
@@ -158,38 +202,139 @@ static int zstd_frame_from_pos(ZstdReader *zstd, size_t pos)
   return low;
 }
 
-/* Ensure that the currently loaded frame is the correct one. */
-static const char *zstd_ensure_cache(ZstdReader *zstd, int frame)
+/**
+ * Read and decompress a single frame, returning the newly allocated content or null on failure.
+ * Without a context, a temporary one is used, so this can run on any thread.
+ */
+static char *zstd_decompress_frame(ZstdReader *zstd, int frame, ZSTD_DCtx *ctx)
 {
-  if (zstd->seek.cached_frame == frame) {
-    /* Cached frame matches, so just return it. */
-    return zstd->seek.cached_content;
-  }
-
-  /* Cached frame doesn't match, so discard it and cache the wanted one instead. */
-  MEM_SAFE_FREE(zstd->seek.cached_content);
-
   size_t compressed_size = zstd->seek.compressed_ofs[frame + 1] - zstd->seek.compressed_ofs[frame];
   size_t uncompressed_size = zstd->seek.uncompressed_ofs[frame + 1] -
                              zstd->seek.uncompressed_ofs[frame];
 
-  char *uncompressed_data = static_cast<char *>(MEM_mallocN(uncompressed_size, __func__));
   char *compressed_data = static_cast<char *>(MEM_mallocN(compressed_size, __func__));
-  if (zstd->base->seek(zstd->base, zstd->seek.compressed_ofs[frame], SEEK_SET) < 0 ||
-      zstd->base->read(zstd->base, compressed_data, compressed_size) < compressed_size)
   {
-    MEM_freeN(compressed_data);
-    MEM_freeN(uncompressed_data);
-    return nullptr;
+    std::unique_lock<std::mutex> lock;
+    if (zstd->prefetch) {
+      lock = std::unique_lock<std::mutex>(zstd->prefetch->base_mutex);
+    }
+    if (zstd->base->seek(zstd->base, zstd->seek.compressed_ofs[frame], SEEK_SET) < 0 ||
+        zstd->base->read(zstd->base, compressed_data, compressed_size) < compressed_size)
+    {
+      MEM_freeN(compressed_data);
+      return nullptr;
+    }
   }
 
-  size_t res = ZSTD_decompressDCtx(
-      zstd->ctx, uncompressed_data, uncompressed_size, compressed_data, compressed_size);
+  char *uncompressed_data = static_cast<char *>(MEM_mallocN(uncompressed_size, __func__));
+  size_t res = ctx ? ZSTD_decompressDCtx(ctx,
+                                         uncompressed_data,
+                                         uncompressed_size,
+                                         compressed_data,
+                                         compressed_size) :
+                     ZSTD_decompress(
+                         uncompressed_data, uncompressed_size, compressed_data, compressed_size);
   MEM_freeN(compressed_data);
   if (ZSTD_isError(res) || res < uncompressed_size) {
     MEM_freeN(uncompressed_data);
     return nullptr;
   }
+  return uncompressed_data;
+}
+
+/* Decompress a prefetched frame, unless another thread already started or it was dropped. */
+static void zstd_prefetch_frame_run(ZstdReader *zstd, ZstdPrefetchFrame &frame)
+{
+  int expected = ZstdPrefetchFrame::Queued;
+  if (!frame.state.compare_exchange_strong(expected, ZstdPrefetchFrame::Running)) {
+    return;
+  }
+  char *data = zstd_decompress_frame(zstd, frame.frame, nullptr);
+  {
+    std::lock_guard lock(frame.mutex);
+    frame.data = data;
+    frame.state = data ? ZstdPrefetchFrame::Done : ZstdPrefetchFrame::Failed;
+  }
+  frame.finished.notify_all();
+}
+
+static void zstd_prefetch_task_run(TaskPool *__restrict pool, void *taskdata)
+{
+  ZstdReader *zstd = static_cast<ZstdReader *>(BLI_task_pool_user_data(pool));
+  auto &frame = *static_cast<std::shared_ptr<ZstdPrefetchFrame> *>(taskdata);
+  zstd_prefetch_frame_run(zstd, *frame);
+}
+
+static void zstd_prefetch_task_free(TaskPool *__restrict /*pool*/, void *taskdata)
+{
+  MEM_delete(static_cast<std::shared_ptr<ZstdPrefetchFrame> *>(taskdata));
+}
+
+/* Get the content of a frame, and queue decompression of the frames following it. */
+static const char *zstd_prefetch_get(ZstdReader *zstd, int frame)
+{
+  ZstdPrefetch &prefetch = *zstd->prefetch;
+  const int window_end = std::min(frame + prefetch.frames_ahead, zstd->seek.frames_num);
+
+  /* Drop frames outside of the window, unless they are already being decompressed. */
+  prefetch.frames.remove_if([&](const auto &item) {
+    if (item.key >= frame && item.key < window_end) {
+      return false;
+    }
+    int expected = ZstdPrefetchFrame::Queued;
+    item.value->state.compare_exchange_strong(expected, ZstdPrefetchFrame::Cancelled);
+    return true;
+  });
+
+  for (int i = frame; i < window_end; i++) {
+    prefetch.frames.lookup_or_add_cb(i, [&]() {
+      auto new_frame = std::make_shared<ZstdPrefetchFrame>();
+      new_frame->frame = i;
+      BLI_task_pool_push(prefetch.pool,
+                         zstd_prefetch_task_run,
+                         MEM_new<std::shared_ptr<ZstdPrefetchFrame>>(__func__, new_frame),
+                         true,
+                         zstd_prefetch_task_free);
+      return new_frame;
+    });
+  }
+
+  std::shared_ptr<ZstdPrefetchFrame> entry = prefetch.frames.lookup(frame);
+  /* Don't wait for a worker to pick up the wanted frame, decompress it here instead. */
+  zstd_prefetch_frame_run(zstd, *entry);
+  {
+    std::unique_lock lock(entry->mutex);
+    entry->finished.wait(lock, [&]() {
+      const int state = entry->state;
+      return state == ZstdPrefetchFrame::Done || state == ZstdPrefetchFrame::Failed;
+    });
+  }
+  if (entry->state == ZstdPrefetchFrame::Failed) {
+    return nullptr;
+  }
+  prefetch.current = std::move(entry);
+  return prefetch.current->data;
+}
+
+/* Ensure that the currently loaded frame is the correct one. */
+static const char *zstd_ensure_cache(ZstdReader *zstd, int frame)
+{
+  if (zstd->prefetch) {
+    return zstd_prefetch_get(zstd, frame);
+  }
+
+  if (zstd->seek.cached_frame == frame) {
+    /* Cached frame matches, so just return it. */
+    return zstd->seek.cached_content;
+  }
+
+  /* Cached frame doesn't match, so discard it and cache the wanted one instead. */
+  MEM_SAFE_FREE(zstd->seek.cached_content);
+
+  char *uncompressed_data = zstd_decompress_frame(zstd, frame, zstd->ctx);
+  if (uncompressed_data == nullptr) {
+    return nullptr;
+  }
 
   zstd->seek.cached_frame = frame;
   zstd->seek.cached_content = uncompressed_data;
@@ -282,6 +427,13 @@ static void zstd_close(FileReader *reader)
 {
   ZstdReader *zstd = (ZstdReader *)reader;
 
+  if (zstd->prefetch) {
+    /* Wait for running tasks, they use the base reader. */
+    BLI_task_pool_cancel(zstd->prefetch->pool);
+    BLI_task_pool_free(zstd->prefetch->pool);
+    MEM_delete(zstd->prefetch);
+  }
+
   ZSTD_freeDCtx(zstd->ctx);
   if (zstd->reader.seek) {
     MEM_freeN(zstd->seek.uncompressed_ofs);
@@ -299,7 +451,7 @@ static void zstd_close(FileReader *reader)
   MEM_freeN(zstd);
 }
 
-FileReader *BLI_filereader_new_zstd(FileReader *base)
+static ZstdReader *zstd_reader_new(FileReader *base)
 {
   ZstdReader *zstd = MEM_callocN<ZstdReader>(__func__);
 
@@ -326,5 +478,21 @@ FileReader *BLI_filereader_new_zstd(FileReader *base)
   /* Rewind after the seek table check so that zstd_read starts at the file's start. */
   zstd->base->seek(zstd->base, 0, SEEK_SET);
 
+  return zstd;
+}
+
+FileReader *BLI_filereader_new_zstd(FileReader *base)
+{
+  return (FileReader *)zstd_reader_new(base);
+}
+
+FileReader *BLI_filereader_new_zstd_prefetch(FileReader *base)
+{
+  ZstdReader *zstd = zstd_reader_new(base);
+  if (zstd->reader.seek && zstd->seek.frames_num > 1) {
+    zstd->prefetch = MEM_new<ZstdPrefetch>(__func__);
+    zstd->prefetch->pool = BLI_task_pool_create(zstd, TASK_PRIORITY_HIGH);
+    zstd->prefetch->frames_ahead = std::clamp(BLI_task_scheduler_num_threads() * 2, 2, 32);
+  }
   return (FileReader *)zstd;
 }
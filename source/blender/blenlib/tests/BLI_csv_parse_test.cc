@@ -256,6 +256,56 @@ TEST(csv_parse, ParseCsvTrailingNewline)
   EXPECT_EQ(result.records[1][0], "2");
 }
 
+TEST(csv_parse, ParseCsvInWindows)
+{
+  CsvParseOptions options;
+  options.chunk_size_bytes = 1;
+  const StringRef str = "a,b\n1,2\n3,\"4\n\n5\"\n6,7\n8,9\n";
+
+  Vector<std::string> column_names;
+  Vector<std::string> fields;
+  int windows_num = 0;
+  const bool success = parse_csv_in_windows<Vector<std::string>>(
+      Span<char>(str),
+      options,
+      6,
+      [&](const CsvRecord &record) {
+        for (const int64_t i : record.index_range()) {
+          column_names.append(record.field_str(i));
+        }
+      },
+      [&](const CsvRecords &records) {
+        Vector<std::string> result;
+        for (const int64_t record_i : records.index_range()) {
+          const CsvRecord record = records.record(record_i);
+          for (const int64_t column_i : record.index_range()) {
+            result.append(record.field_str(column_i));
+          }
+        }
+        return result;
+      },
+      [&](MutableSpan<Vector<std::string>> chunk_results) {
+        windows_num++;
+        for (const Vector<std::string> &chunk : chunk_results) {
+          fields.extend(chunk);
+        }
+      });
+
+  EXPECT_TRUE(success);
+  EXPECT_EQ(column_names, Vector<std::string>({"a", "b"}));
+  /* The multi-line field does not fit into a single window, but is still parsed correctly. */
+  EXPECT_EQ(fields, Vector<std::string>({"1", "2", "3", "4\n\n5", "6", "7", "8", "9"}));
+  EXPECT_GT(windows_num, 1);
+
+  EXPECT_FALSE(parse_csv_in_windows<int>(
+      Span<char>(StringRef("a\n1\n\"2\n")),
+      options,
+      1,
+      [](const CsvRecord & /*record*/) {},
+      [](const CsvRecords &records) { return int(records.size()); },
+      [](MutableSpan<int> /*chunk_results*/) {}));
+}
+
 TEST(csv_parse, UnescapeField)
 {
   LinearAllocator<> allocator;
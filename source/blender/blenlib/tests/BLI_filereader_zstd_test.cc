@@ -0,0 +1,85 @@
+/* SPDX-FileCopyrightText: 2024 Blender Authors
+ *
+ * SPDX-License-Identifier: Apache-2.0 */
+
+#include "testing/testing.h"
+
+#include <cstring>
+#include <zstd.h>
+
+#include "BLI_filereader.h"
+#include "BLI_vector.hh"
+
+namespace blender::tests {
+
+static void append_u32(Vector<char> &data, const uint32_t value)
+{
+  /* Seek table values are little endian. */
+  for (int i = 0; i < 4; i++) {
+    data.append(char((value >> (i * 8)) & 0xff));
+  }
+}
+
+/** Compress `content` into frames of `frame_size` bytes followed by a seek table. */
+static Vector<char> compress_seekable(const Span<char> content, const int64_t frame_size)
+{
+  Vector<char> data;
+  Vector<std::pair<uint32_t, uint32_t>> frames;
+  for (int64_t start = 0; start < content.size(); start += frame_size) {
+    const Span<char> frame = content.slice(start, std::min(frame_size, content.size() - start));
+    Vector<char> compressed(ZSTD_compressBound(frame.size()));
+    const size_t size = ZSTD_compress(
+        compressed.data(), compressed.size(), frame.data(), frame.size(), 1);
+    EXPECT_FALSE(ZSTD_isError(size));
+    data.extend(compressed.as_span().take_front(size));
+    frames.append({uint32_t(size), uint32_t(frame.size())});
+  }
+  append_u32(data, 0x184D2A5E);
+  append_u32(data, frames.size() * 8 + 9);
+  for (const auto &[compressed_size, uncompressed_size] : frames) {
+    append_u32(data, compressed_size);
+    append_u32(data, uncompressed_size);
+  }
+  append_u32(data, frames.size());
+  data.append(0);
+  append_u32(data, 0x8F92EAB1);
+  return data;
+}
+
+TEST(filereader_zstd, prefetch_matches_content)
+{
+  Vector<char> content(1000000);
+  for (const int64_t i : content.index_range()) {
+    content[i] = char((i * 7 + i / 1000) & 0xff);
+  }
+  const Vector<char> compressed = compress_seekable(content, 4096);
+
+  FileReader *file = BLI_filereader_new_zstd_prefetch(
+      BLI_filereader_new_memory(compressed.data(), compressed.size()));
+  ASSERT_NE(file, nullptr);
+  ASSERT_NE(file->seek, nullptr);
+
+  /* Sequential reads of odd sizes, crossing frame boundaries. */
+  Vector<char> result(content.size());
+  int64_t pos = 0;
+  while (pos < content.size()) {
+    const int64_t len = std::min<int64_t>(3001, content.size() - pos);
+    ASSERT_EQ(file->read(file, result.data() + pos, len), len);
+    pos += len;
+  }
+  EXPECT_EQ(result.as_span(), content.as_span());
+  char byte;
+  EXPECT_EQ(file->read(file, &byte, 1), 0);
+
+  /* Backward and forward seeks. */
+  for (const int64_t offset : {int64_t(500000), int64_t(10), int64_t(999990), int64_t(40960)}) {
+    EXPECT_EQ(file->seek(file, offset, SEEK_SET), offset);
+    char buf[10];
+    ASSERT_EQ(file->read(file, buf, sizeof(buf)), sizeof(buf));
+    EXPECT_EQ(memcmp(buf, content.data() + offset, sizeof(buf)), 0);
+  }
+
+  file->close(file);
+}
+
+}  // namespace blender::tests
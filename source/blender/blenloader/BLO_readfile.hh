@@ -92,7 +92,7 @@ struct BlendFileReadWMSetupData {
 };
 
 struct BlendFileReadParams {
-  uint skip_flags : 3; /* #eBLOReadSkip */
+  uint skip_flags : 4; /* #eBLOReadSkip */
   uint is_startup : 1;
   uint is_factory_settings : 1;
 
@@ -154,8 +154,18 @@ enum eBLOReadSkip {
   BLO_READ_SKIP_DATA = (1 << 1),
   /** Do not attempt to re-use IDs from old bmain for unchanged ones in case of undo. */
   BLO_READ_SKIP_UNDO_OLD_MAIN = (1 << 2),
+  /**
+   * Only read the local data-blocks that are (directly or indirectly) used by the scenes and the
+   * UI (window-manager, screens and workspaces). The headers of all other IDs are still indexed,
+   * but their data is never loaded from the file, which can save a lot of time and memory when
+   * opening large files e.g. for rendering. Sets #Main.is_partially_read, since writing such a
+   * Main back over the original file would lose the unused data-blocks.
+   *
+   * Ignored when reading undo steps.
+   */
+  BLO_READ_SKIP_UNUSED_IDS = (1 << 3),
 };
-ENUM_OPERATORS(eBLOReadSkip, BLO_READ_SKIP_UNDO_OLD_MAIN)
+ENUM_OPERATORS(eBLOReadSkip, BLO_READ_SKIP_UNUSED_IDS)
 #define BLO_READ_SKIP_ALL (BLO_READ_SKIP_USERDEF | BLO_READ_SKIP_DATA)
 
 /**
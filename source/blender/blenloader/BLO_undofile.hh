@@ -12,11 +12,13 @@
 #include "BLI_filereader.h"
 #include "BLI_listbase.h"
 #include "BLI_map.hh"
+#include "BLI_multi_value_map.hh"
 
 namespace blender {
 class ImplicitSharingInfo;
 }
 struct Main;
+struct MemFileChunkIndex;
 struct Scene;
 
 struct MemFileSharedStorage {
@@ -24,6 +26,11 @@ struct MemFileSharedStorage {
    * Maps the data pointer to the sharing info that it is owned by.
    */
   blender::Map<const void *, const blender::ImplicitSharingInfo *> map;
+  /**
+   * The keys of #map added while writing each ID, by ID session UID. Allows to keep the shared
+   * data alive when the ID is not written again in the next undo step.
+   */
+  blender::MultiValueMap<uint, const void *> data_by_id_session_uid;
 
   ~MemFileSharedStorage();
 };
@@ -31,9 +38,22 @@ struct MemFileSharedStorage {
 struct MemFileChunk {
   void *next, *prev;
   const char *buf;
+  /**
+   * Owner of #buf. The same buffer can be used by chunks of any #MemFile of the undo history
+   * sharing the same #MemFileChunkIndex, each chunk is a user of it.
+   */
+  const blender::ImplicitSharingInfo *buf_sharing_info;
   /** Size in bytes. */
   size_t size;
-  /** When true, this chunk doesn't own the memory, it's shared with a previous #MemFileChunk */
+  /** Hash of the content of #buf. */
+  uint64_t hash;
+  /**
+   * When true, this chunk is identical to the matching one in the previous step, and shares its
+   * memory. Used by undo code to detect unchanged IDs.
+   *
+   * \note Chunks can also share memory with unrelated chunks of the same content without being
+   * identical, see #MemFileChunkIndex.
+   */
   bool is_identical;
   /** When true, this chunk is also identical to the one in the next step (used by undo code to
    * detect unchanged IDs).
@@ -52,6 +72,11 @@ struct MemFile {
    * without making a copy. This is faster and requires less memory.
    */
   MemFileSharedStorage *shared_storage;
+  /**
+   * Index of the chunk buffers by content, shared with the other memfiles of the same undo
+   * history (a user of it).
+   */
+  MemFileChunkIndex *chunk_index;
 };
 
 struct MemFileWriteData {
@@ -90,6 +115,21 @@ void BLO_memfile_write_finalize(MemFileWriteData *mem_data);
 
 void BLO_memfile_chunk_add(MemFileWriteData *mem_data, const char *buf, size_t size);
 
+/**
+ * Get the address the ID with the given session UID had when the reference memfile was written,
+ * or null if it is not part of it.
+ */
+const void *BLO_memfile_write_reference_id_address(const MemFileWriteData *mem_data,
+                                                   uint id_session_uid);
+/**
+ * Add the chunks written for the ID with the given session UID in the reference memfile to the
+ * written memfile, instead of writing that ID again. Only valid when the ID and all the IDs it
+ * uses are known to be unchanged since the reference memfile was written.
+ *
+ * \return False if the ID is not part of the reference memfile, nothing is added then.
+ */
+bool BLO_memfile_write_reuse_id_chunks(MemFileWriteData *mem_data, uint id_session_uid);
+
 /* exports */
 
 /**
@@ -44,6 +44,7 @@
 #include "MEM_alloc_string_storage.hh"
 #include "MEM_guardedalloc.h"
 
+#include "BLI_array.hh"
 #include "BLI_endian_defines.h"
 #include "BLI_endian_switch.h"
 #include "BLI_fileops.h"
@@ -52,6 +53,7 @@
 #include "BLI_memarena.h"
 #include "BLI_string.h"
 #include "BLI_string_ref.hh"
+#include "BLI_task.hh"
 #include "BLI_threads.h"
 #include "BLI_time.h"
 #include "BLI_utildefines.h"
@@ -1278,7 +1280,7 @@ static FileData *blo_filedata_from_file_descriptor(const char *filepath,
     }
   }
   else if (BLI_file_magic_is_zstd(header)) {
-    file = BLI_filereader_new_zstd(rawfile);
+    file = BLI_filereader_new_zstd_prefetch(rawfile);
     if (file != nullptr) {
       rawfile = nullptr; /* The `Zstd` #FileReader takes ownership of `rawfile`. */
     }
@@ -1361,7 +1363,7 @@ FileData *blo_filedata_from_memory(const void *mem,
     file = BLI_filereader_new_gzip(mem_file);
   }
   else if (BLI_file_magic_is_zstd(static_cast<const char *>(mem))) {
-    file = BLI_filereader_new_zstd(mem_file);
+    file = BLI_filereader_new_zstd_prefetch(mem_file);
   }
 
   if (file == nullptr) {
@@ -1913,6 +1915,31 @@ static void *read_struct(FileData *fd, BHead *bh, const char *blockname, const i
   return temp;
 }
 
+/**
+ * Same as #read_struct, for a block which data is already in memory and with a precomputed
+ * allocation name. This only reads shared file data, so it can run on multiple blocks in parallel.
+ */
+static void *read_struct_in_memory(FileData *fd, BHead *bh, const char *alloc_name)
+{
+#ifdef USE_BHEAD_READ_ON_DEMAND
+  BLI_assert(BHEADN_FROM_BHEAD(bh)->has_data);
+#endif
+  if (bh->len == 0 || fd->compflags[bh->SDNAnr] == SDNA_CMP_REMOVED) {
+    return nullptr;
+  }
+  if (bh->SDNAnr > SDNA_RAW_DATA_STRUCT_INDEX && (fd->flags & FD_FLAGS_SWITCH_ENDIAN)) {
+    switch_endian_structs(fd->filesdna, bh);
+  }
+  if (fd->compflags[bh->SDNAnr] == SDNA_CMP_NOT_EQUAL) {
+    return DNA_struct_reconstruct(fd->reconstruct_info, bh->SDNAnr, bh->nr, (bh + 1), alloc_name);
+  }
+  /* SDNA_CMP_EQUAL */
+  const int alignment = DNA_struct_alignment(fd->filesdna, bh->SDNAnr);
+  void *temp = MEM_mallocN_aligned(bh->len, alignment, alloc_name);
+  memcpy(temp, (bh + 1), bh->len);
+  return temp;
+}
+
 /* Like read_struct, but gets a pointer without allocating. Only works for
  * undo since DNA must match. */
 static const void *peek_struct_undo(FileData *fd, BHead *bhead)
@@ -2576,27 +2603,102 @@ static bool direct_link_id(FileData *fd,
   return success;
 }
 
+/**
+ * Minimum amount of data blocks, or of their total size in bytes, for the blocks of a datablock
+ * to be reconstructed in parallel.
+ */
+static constexpr int64_t PARALLEL_READ_MIN_BLOCKS = 64;
+static constexpr int64_t PARALLEL_READ_MIN_BYTES = 1024 * 1024;
+
 /* Read all data associated with a datablock into datamap. */
 static BHead *read_data_into_datamap(FileData *fd,
                                      BHead *bhead,
                                      const char *allocname,
                                      const int id_type_index)
 {
-  bhead = blo_bhead_next(fd, bhead);
+  /* First scan all data blocks of the datablock; reading their headers (and possibly their
+   * data) from the file has to be sequential. */
+  blender::Vector<BHead *, 64> data_bheads;
+  int64_t data_size = 0;
+  for (bhead = blo_bhead_next(fd, bhead); bhead && bhead->code == BLO_CODE_DATA;
+       bhead = blo_bhead_next(fd, bhead))
+  {
+    data_bheads.append(bhead);
+    data_size += bhead->len;
+  }
+
+  blender::Array<void *, 64> data(data_bheads.size(), nullptr);
+  if (data_bheads.size() >= PARALLEL_READ_MIN_BLOCKS || data_size >= PARALLEL_READ_MIN_BYTES) {
+    /* Endian switching and reconstruction (or a copy) is independent for every block, so it's done
+     * in parallel. Reading blocks that are not in memory yet needs file access, which is done
+     * serially first, into a temporary block. Blocks that only need a copy are read straight into
+     * their final allocation instead. Allocation names are looked up serially too, since their
+     * storage is not thread-safe. */
+    blender::Array<BHead *, 64> memory_bheads(data_bheads.size(), nullptr);
+    blender::Array<const char *, 64> alloc_names(data_bheads.size(), nullptr);
+    blender::Vector<int64_t> memory_indices;
+    blender::Vector<BHead *> temp_bheads;
+    for (const int64_t i : data_bheads.index_range()) {
+      BHead *bh = data_bheads[i];
+      if (bh->len == 0 || fd->compflags[bh->SDNAnr] == SDNA_CMP_REMOVED) {
+        continue;
+      }
+#ifdef USE_BHEAD_READ_ON_DEMAND
+      if (!BHEADN_FROM_BHEAD(bh)->has_data) {
+        const bool needs_switch_endian = bh->SDNAnr > SDNA_RAW_DATA_STRUCT_INDEX &&
+                                         (fd->flags & FD_FLAGS_SWITCH_ENDIAN);
+        if (fd->compflags[bh->SDNAnr] == SDNA_CMP_EQUAL && !needs_switch_endian) {
+          data[i] = read_struct(fd, bh, allocname, id_type_index);
+          continue;
+        }
+        bh = blo_bhead_read_full(fd, bh);
+        if (UNLIKELY(bh == nullptr)) {
+          fd->flags &= ~FD_FLAGS_FILE_OK;
+          continue;
+        }
+        temp_bheads.append(bh);
+      }
+#endif
+      memory_bheads[i] = bh;
+      alloc_names[i] = get_alloc_name(fd, bh, allocname, id_type_index);
+      memory_indices.append(i);
+    }
+    /* Block sizes vary a lot (e.g. mesh arrays vs. small structs), balance tasks by bytes. */
+    blender::threading::parallel_for(
+        memory_indices.index_range(),
+        64 * 1024,
+        [&](const blender::IndexRange range) {
+          for (const int64_t i : range) {
+            const int64_t bhead_index = memory_indices[i];
+            data[bhead_index] = read_struct_in_memory(
+                fd, memory_bheads[bhead_index], alloc_names[bhead_index]);
+          }
+        },
+        blender::threading::individual_task_sizes([&](const int64_t i) {
+          /* Add a constant for the per-block overhead of small blocks. */
+          return int64_t(data_bheads[memory_indices[i]]->len) + 64;
+        }));
+    for (BHead *bh : temp_bheads) {
+      MEM_freeN(BHEADN_FROM_BHEAD(bh));
+    }
+  }
+  else {
+    for (const int64_t i : data_bheads.index_range()) {
+      data[i] = read_struct(fd, data_bheads[i], allocname, id_type_index);
+    }
+  }
 
-  while (bhead && bhead->code == BLO_CODE_DATA) {
-    void *data = read_struct(fd, bhead, allocname, id_type_index);
-    if (data) {
-      const bool is_new = oldnewmap_insert(fd->datamap, bhead->old, data, 0);
+  /* Insert in file order, so that the error handling of duplicate addresses is unchanged. */
+  for (const int64_t i : data_bheads.index_range()) {
+    if (data[i]) {
+      const bool is_new = oldnewmap_insert(fd->datamap, data_bheads[i]->old, data[i], 0);
       if (!is_new) {
         CLOG_ERROR(&LOG,
                    "Blendfile corruption: Invalid, or multiple `bhead` with same old address "
                    "value (%p) for a given ID.",
-                   bhead->old);
+                   data_bheads[i]->old);
       }
     }
-
-    bhead = blo_bhead_next(fd, bhead);
   }
 
   return bhead;
@@ -3634,6 +3736,28 @@ static void blo_read_file_checks(Main *bmain)
   UNUSED_VARS_NDEBUG(bmain);
 }
 
+static void expand_doit_local(void *fdhandle, Main *mainvar, void *old);
+
+/**
+ * With #BLO_READ_SKIP_UNUSED_IDS, only these data-blocks are read unconditionally, all other local
+ * ones are only read when they are used by them, see #expand_doit_local.
+ */
+static bool read_file_id_is_root(const BHead *bhead)
+{
+  return ELEM(bhead->code, ID_WM, ID_SCR, ID_WS, ID_SCE, ID_LI);
+}
+
+static int read_file_main_ids_num(Main *bmain)
+{
+  int ids_num = 0;
+  ID *id_iter;
+  FOREACH_MAIN_ID_BEGIN (bmain, id_iter) {
+    ids_num++;
+  }
+  FOREACH_MAIN_ID_END;
+  return ids_num;
+}
+
 BlendFileData *blo_read_file_internal(FileData *fd, const char *filepath)
 {
   BHead *bhead = blo_bhead_first(fd);
@@ -3645,6 +3769,10 @@ BlendFileData *blo_read_file_internal(FileData *fd, const char *filepath)
     CLOG_INFO(&LOG_UNDO, 2, "UNDO: read step");
   }
 
+  const bool skip_unused_ids = !is_undo && (fd->skip_flags & BLO_READ_SKIP_DATA) == 0 &&
+                               (fd->skip_flags & BLO_READ_SKIP_UNUSED_IDS) != 0;
+  int skipped_ids_num = 0;
+
   /* Prevent any run of layer collections rebuild during readfile process, and the do_versions
    * calls.
    *
@@ -3746,8 +3874,16 @@ BlendFileData *blo_read_file_internal(FileData *fd, const char *filepath)
           if (fd->skip_flags & BLO_READ_SKIP_DATA) {
             bhead = blo_bhead_next(fd, bhead);
           }
+          else if (skip_unused_ids && !read_file_id_is_root(bhead)) {
+            /* Only the ID header is known at this point, its data is read later if it is used. */
+            skipped_ids_num++;
+            bhead = blo_bhead_next(fd, bhead);
+          }
           else {
-            bhead = read_libblock(fd, bfd->main, bhead, ID_TAG_LOCAL, {}, false, nullptr);
+            ID_Readfile_Data::Tags id_read_tags{};
+            id_read_tags.needs_expanding = skip_unused_ids;
+            bhead = read_libblock(
+                fd, bfd->main, bhead, ID_TAG_LOCAL, id_read_tags, false, nullptr);
           }
         }
         else {
@@ -3762,6 +3898,23 @@ BlendFileData *blo_read_file_internal(FileData *fd, const char *filepath)
     }
   }
 
+  if (skip_unused_ids && skipped_ids_num > 0) {
+    /* Read the skipped data-blocks that are used by the root ones, recursively. */
+    const int read_ids_num = read_file_main_ids_num(bfd->main);
+    BLO_expand_main(fd, bfd->main, expand_doit_local);
+    skipped_ids_num -= read_file_main_ids_num(bfd->main) - read_ids_num;
+    if (bfd->main->id_map != nullptr) {
+      BKE_main_idmap_destroy(bfd->main->id_map);
+      bfd->main->id_map = nullptr;
+    }
+    if (bfd->main->is_read_invalid) {
+      return bfd;
+    }
+
+    bfd->main->is_partially_read = skipped_ids_num > 0;
+    CLOG_INFO(&LOG, 1, "Skipped reading %d unused data-blocks", skipped_ids_num);
+  }
+
   if (is_undo) {
     /* Move the remaining Library IDs and their linked data to the new main.
      *
@@ -4107,6 +4260,34 @@ struct BlendExpander {
   BLOExpandDoitCallback callback;
 };
 
+/** Read the data-block of `bhead` into `mainvar` if needed, when it is in the same library. */
+static void expand_doit_same_library(FileData *fd, Main *mainvar, BHead *bhead, const int id_tag)
+{
+  ID *id = library_id_is_yet_read(fd, mainvar, bhead);
+  if (id == nullptr) {
+    ID_Readfile_Data::Tags id_read_tags{};
+    id_read_tags.needs_expanding = true;
+    read_libblock(fd, mainvar, bhead, id_tag, id_read_tags, false, &id);
+    BLI_assert(id != nullptr);
+    id_sort_by_name(which_libbase(mainvar, GS(id->name)), id, static_cast<ID *>(id->prev));
+  }
+  else {
+    /* Convert any previously read weak link to regular link to signal that we want to read this
+     * data-block. Note that this function also visits already-loaded data-blocks, and thus their
+     * `readfile_data` field might already have been freed. */
+    if (BLO_readfile_id_runtime_tags(*id).is_link_placeholder) {
+      id->flag &= ~ID_FLAG_INDIRECT_WEAK_LINK;
+    }
+
+    /* this is actually only needed on UI call? when ID was already read before,
+     * and another append happens which invokes same ID...
+     * in that case the lookup table needs this entry */
+    oldnewmap_lib_insert(fd, bhead->old, id, bhead->code);
+    /* commented because this can print way too much */
+    // if (G.debug & G_DEBUG) printf("expand: already read %s\n", id->name);
+  }
+}
+
 static void expand_doit_library(void *fdhandle, Main *mainvar, void *old)
 {
   FileData *fd = static_cast<FileData *>(fdhandle);
@@ -4196,31 +4377,37 @@ static void expand_doit_library(void *fdhandle, Main *mainvar, void *old)
   }
   else {
     /* Data-block in same library. */
-    ID *id = library_id_is_yet_read(fd, mainvar, bhead);
-    if (id == nullptr) {
-      ID_Readfile_Data::Tags id_read_tags{};
-      id_read_tags.needs_expanding = true;
-      read_libblock(
-          fd, mainvar, bhead, fd->id_tag_extra | ID_TAG_INDIRECT, id_read_tags, false, &id);
-      BLI_assert(id != nullptr);
-      id_sort_by_name(which_libbase(mainvar, GS(id->name)), id, static_cast<ID *>(id->prev));
-    }
-    else {
-      /* Convert any previously read weak link to regular link to signal that we want to read this
-       * data-block. Note that this function also visits already-loaded data-blocks, and thus their
-       * `readfile_data` field might already have been freed. */
-      if (BLO_readfile_id_runtime_tags(*id).is_link_placeholder) {
-        id->flag &= ~ID_FLAG_INDIRECT_WEAK_LINK;
-      }
+    expand_doit_same_library(fd, mainvar, bhead, fd->id_tag_extra | ID_TAG_INDIRECT);
+  }
+}
 
-      /* this is actually only needed on UI call? when ID was already read before,
-       * and another append happens which invokes same ID...
-       * in that case the lookup table needs this entry */
-      oldnewmap_lib_insert(fd, bhead->old, id, bhead->code);
-      /* commented because this can print way too much */
-      // if (G.debug & G_DEBUG) printf("expand: already read %s\n", id->name);
-    }
+/**
+ * Expand callback used with #BLO_READ_SKIP_UNUSED_IDS, to read the local data-blocks skipped by
+ * #blo_read_file_internal that are used by already read ones. Linked data is handled later by
+ * #read_libraries as usual.
+ */
+static void expand_doit_local(void *fdhandle, Main *mainvar, void *old)
+{
+  FileData *fd = static_cast<FileData *>(fdhandle);
+
+  if (mainvar->is_read_invalid) {
+    return;
   }
+
+  BHead *bhead = find_bhead(fd, old);
+  if (bhead == nullptr) {
+    return;
+  }
+  /* In 2.50+ file identifier for screens is patched, forward compatibility. */
+  if (bhead->code == ID_SCRN) {
+    bhead->code = ID_SCR;
+  }
+  /* Library IDs and placeholders of linked data-blocks are always read. */
+  if (!blo_bhead_is_id_valid_type(bhead) || ELEM(bhead->code, ID_LINK_PLACEHOLDER, ID_LI)) {
+    return;
+  }
+
+  expand_doit_same_library(fd, mainvar, bhead, ID_TAG_LOCAL);
 }
 
 static int expand_cb(LibraryIDLinkCallbackData *cb_data)
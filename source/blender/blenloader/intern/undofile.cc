@@ -22,30 +22,133 @@
 #include "MEM_guardedalloc.h"
 
 #include "DNA_listBase.h"
+#include "DNA_sdna_types.h"
 
 #include "BLI_implicit_sharing.hh"
+#include "BLI_vector.hh"
 
 #include "BLO_readfile.hh"
 #include "BLO_undofile.hh"
 
+#include "BKE_idtype.hh"
 #include "BKE_lib_id.hh"
 #include "BKE_main.hh"
 #include "BKE_undo_system.hh"
 
+#include <xxhash.h>
+
 #include "BLI_strict_flags.h" /* IWYU pragma: keep. Keep last. */
 
 /* **************** support for memory-write, for undo buffers *************** */
 
+/**
+ * Owner of a chunk buffer. The buffer is freed as soon as no chunk uses it anymore, even if the
+ * #MemFileChunkIndex still references it.
+ */
+class MemFileChunkBuffer : public blender::ImplicitSharingInfo {
+ public:
+  char *buf;
+
+  MemFileChunkBuffer(char *buf) : buf(buf) {}
+
+ private:
+  void delete_data_only() override
+  {
+    MEM_SAFE_FREE(buf);
+  }
+
+  void delete_self_with_data() override
+  {
+    this->delete_data_only();
+    MEM_delete(this);
+  }
+};
+
+/**
+ * Index of all chunk buffers of the memfiles of an undo history by their content, so that a chunk
+ * identical to any chunk of any retained undo step can share its memory, and not only one
+ * matching the same chunk of the previous step.
+ *
+ * The index is shared by all the memfiles written with each other as reference, and only holds
+ * weak users of the buffers: they are freed with the last chunk using them.
+ */
+struct MemFileChunkIndex : public blender::ImplicitSharingMixin {
+  struct Buffer {
+    const char *buf;
+    size_t size;
+    const blender::ImplicitSharingInfo *sharing_info;
+  };
+
+  blender::Map<uint64_t, blender::Vector<Buffer, 1>> buffers_by_hash;
+
+  ~MemFileChunkIndex() override
+  {
+    for (const blender::Span<Buffer> buffers : buffers_by_hash.values()) {
+      for (const Buffer &buffer : buffers) {
+        buffer.sharing_info->remove_weak_user_and_delete_if_last();
+      }
+    }
+  }
+
+  void add(const uint64_t hash,
+           const char *buf,
+           const size_t size,
+           const blender::ImplicitSharingInfo *sharing_info)
+  {
+    sharing_info->add_weak_user();
+    buffers_by_hash.lookup_or_add_default(hash).append({buf, size, sharing_info});
+  }
+
+  const Buffer *find(const uint64_t hash, const char *buf, const size_t size) const
+  {
+    const blender::Vector<Buffer, 1> *buffers = buffers_by_hash.lookup_ptr(hash);
+    if (buffers == nullptr) {
+      return nullptr;
+    }
+    for (const Buffer &buffer : *buffers) {
+      if (buffer.size == size && !buffer.sharing_info->is_expired() &&
+          memcmp(buffer.buf, buf, size) == 0)
+      {
+        return &buffer;
+      }
+    }
+    return nullptr;
+  }
+
+  /** Forget about the buffers that have been freed since they were added. */
+  void remove_expired()
+  {
+    buffers_by_hash.remove_if([](const auto item) {
+      item.value.remove_if([](const Buffer &buffer) {
+        if (buffer.sharing_info->is_expired()) {
+          buffer.sharing_info->remove_weak_user_and_delete_if_last();
+          return true;
+        }
+        return false;
+      });
+      return item.value.is_empty();
+    });
+  }
+
+ private:
+  void delete_self() override
+  {
+    MEM_delete(this);
+  }
+};
+
 void BLO_memfile_free(MemFile *memfile)
 {
   while (MemFileChunk *chunk = static_cast<MemFileChunk *>(BLI_pophead(&memfile->chunks))) {
-    if (chunk->is_identical == false) {
-      MEM_freeN((void *)chunk->buf);
-    }
+    chunk->buf_sharing_info->remove_user_and_delete_if_last();
     MEM_freeN(chunk);
   }
   MEM_delete(memfile->shared_storage);
   memfile->shared_storage = nullptr;
+  if (memfile->chunk_index) {
+    memfile->chunk_index->remove_user_and_delete_if_last();
+    memfile->chunk_index = nullptr;
+  }
   memfile->size = 0;
 }
 
@@ -57,34 +160,9 @@ MemFileSharedStorage::~MemFileSharedStorage()
   }
 }
 
-void BLO_memfile_merge(MemFile *first, MemFile *second)
+void BLO_memfile_merge(MemFile *first, MemFile * /*second*/)
 {
-  /* We use this mapping to store the memory buffers from second memfile chunks which are not owned
-   * by it (i.e. shared with some previous memory steps). */
-  blender::Map<const char *, MemFileChunk *> buffer_to_second_memchunk;
-
-  /* First, detect all memchunks in second memfile that are not owned by it. */
-  LISTBASE_FOREACH (MemFileChunk *, sc, &second->chunks) {
-    if (sc->is_identical) {
-      buffer_to_second_memchunk.add(sc->buf, sc);
-    }
-  }
-
-  /* Now, check all chunks from first memfile (the one we are removing), and if a memchunk owned by
-   * it is also used by the second memfile, transfer the ownership. */
-  LISTBASE_FOREACH (MemFileChunk *, fc, &first->chunks) {
-    if (!fc->is_identical) {
-      if (MemFileChunk *sc = buffer_to_second_memchunk.lookup_default(fc->buf, nullptr)) {
-        BLI_assert(sc->is_identical);
-        sc->is_identical = false;
-        fc->is_identical = true;
-      }
-      /* Note that if the second memfile does not use that chunk, we assume that the first one
-       * fully owns it without sharing it with any other memfile, and hence it should be freed with
-       * it. */
-    }
-  }
-
+  /* Buffers shared with the second memfile are kept alive by the chunks using them. */
   BLO_memfile_free(first);
 }
 
@@ -101,6 +179,16 @@ void BLO_memfile_write_init(MemFileWriteData *mem_data,
 {
   mem_data->written_memfile = written_memfile;
   mem_data->reference_memfile = reference_memfile;
+
+  BLI_assert(written_memfile->chunk_index == nullptr);
+  if (reference_memfile != nullptr && reference_memfile->chunk_index != nullptr) {
+    written_memfile->chunk_index = reference_memfile->chunk_index;
+    written_memfile->chunk_index->add_user();
+    written_memfile->chunk_index->remove_expired();
+  }
+  else {
+    written_memfile->chunk_index = MEM_new<MemFileChunkIndex>(__func__);
+  }
   mem_data->reference_current_chunk = reference_memfile ? static_cast<MemFileChunk *>(
                                                               reference_memfile->chunks.first) :
                                                           nullptr;
@@ -126,28 +214,44 @@ void BLO_memfile_write_finalize(MemFileWriteData *mem_data)
   mem_data->id_session_uid_mapping.clear();
 }
 
+static MemFileChunk *memfile_chunk_append(MemFileWriteData *mem_data, const size_t size)
+{
+  MemFileChunk *chunk = MEM_mallocN<MemFileChunk>("MemFileChunk");
+  chunk->buf = nullptr;
+  chunk->buf_sharing_info = nullptr;
+  chunk->size = size;
+  chunk->hash = 0;
+  chunk->is_identical = false;
+  /* This is unsafe in the sense that an app handler or other code that does not
+   * perform an undo push may make changes after the last undo push that
+   * will then not be undo. Though it's not entirely clear that is wrong behavior. */
+  chunk->is_identical_future = true;
+  chunk->id_session_uid = mem_data->current_id_session_uid;
+  BLI_addtail(&mem_data->written_memfile->chunks, chunk);
+  return chunk;
+}
+
+static void memfile_chunk_share(MemFileChunk *chunk, const MemFileChunk *other)
+{
+  chunk->buf = other->buf;
+  chunk->buf_sharing_info = other->buf_sharing_info;
+  chunk->buf_sharing_info->add_user();
+  chunk->hash = other->hash;
+}
+
 void BLO_memfile_chunk_add(MemFileWriteData *mem_data, const char *buf, size_t size)
 {
   MemFile *memfile = mem_data->written_memfile;
   MemFileChunk **compchunk_step = &mem_data->reference_current_chunk;
 
-  MemFileChunk *curchunk = MEM_mallocN<MemFileChunk>("MemFileChunk");
-  curchunk->size = size;
-  curchunk->buf = nullptr;
-  curchunk->is_identical = false;
-  /* This is unsafe in the sense that an app handler or other code that does not
-   * perform an undo push may make changes after the last undo push that
-   * will then not be undo. Though it's not entirely clear that is wrong behavior. */
-  curchunk->is_identical_future = true;
-  curchunk->id_session_uid = mem_data->current_id_session_uid;
-  BLI_addtail(&memfile->chunks, curchunk);
+  MemFileChunk *curchunk = memfile_chunk_append(mem_data, size);
 
   /* we compare compchunk with buf */
   if (*compchunk_step != nullptr) {
     MemFileChunk *compchunk = *compchunk_step;
     if (compchunk->size == curchunk->size) {
       if (memcmp(compchunk->buf, buf, size) == 0) {
-        curchunk->buf = compchunk->buf;
+        memfile_chunk_share(curchunk, compchunk);
         curchunk->is_identical = true;
         compchunk->is_identical_future = true;
       }
@@ -155,13 +259,68 @@ void BLO_memfile_chunk_add(MemFileWriteData *mem_data, const char *buf, size_t s
     *compchunk_step = static_cast<MemFileChunk *>(compchunk->next);
   }
 
-  /* not equal... */
-  if (curchunk->buf == nullptr) {
-    char *buf_new = static_cast<char *>(MEM_mallocN(size, "Chunk buffer"));
-    memcpy(buf_new, buf, size);
-    curchunk->buf = buf_new;
-    memfile->size += size;
+  if (curchunk->buf != nullptr) {
+    return;
+  }
+
+  /* Not equal to the matching chunk of the previous step, but the same content may still exist
+   * elsewhere in the undo history. */
+  curchunk->hash = XXH3_64bits(buf, size);
+  if (const MemFileChunkIndex::Buffer *buffer = memfile->chunk_index->find(
+          curchunk->hash, buf, size))
+  {
+    curchunk->buf = buffer->buf;
+    curchunk->buf_sharing_info = buffer->sharing_info;
+    curchunk->buf_sharing_info->add_user();
+    return;
+  }
+
+  char *buf_new = static_cast<char *>(MEM_mallocN(size, "Chunk buffer"));
+  memcpy(buf_new, buf, size);
+  curchunk->buf = buf_new;
+  curchunk->buf_sharing_info = MEM_new<MemFileChunkBuffer>(__func__, buf_new);
+  memfile->chunk_index->add(curchunk->hash, buf_new, size, curchunk->buf_sharing_info);
+  memfile->size += size;
+}
+
+const void *BLO_memfile_write_reference_id_address(const MemFileWriteData *mem_data,
+                                                   const uint id_session_uid)
+{
+  const MemFileChunk *chunk = mem_data->id_session_uid_mapping.lookup_default(id_session_uid,
+                                                                              nullptr);
+  if (chunk == nullptr || chunk->size < sizeof(BHead)) {
+    return nullptr;
+  }
+  /* The data of each ID starts in a new chunk, with the block of the ID itself. */
+  BHead bhead;
+  memcpy(&bhead, chunk->buf, sizeof(BHead));
+  if ((bhead.code >> 16) != 0 || !BKE_idtype_idcode_is_valid(short(bhead.code))) {
+    return nullptr;
+  }
+  return bhead.old;
+}
+
+bool BLO_memfile_write_reuse_id_chunks(MemFileWriteData *mem_data, const uint id_session_uid)
+{
+  const MemFileChunk *compchunk = mem_data->id_session_uid_mapping.lookup_default(id_session_uid,
+                                                                                  nullptr);
+  if (compchunk == nullptr) {
+    return false;
+  }
+
+  BLI_assert(mem_data->current_id_session_uid == MAIN_ID_SESSION_UID_UNSET);
+  mem_data->current_id_session_uid = id_session_uid;
+  for (; compchunk != nullptr && compchunk->id_session_uid == id_session_uid;
+       compchunk = static_cast<MemFileChunk *>(compchunk->next))
+  {
+    MemFileChunk *curchunk = memfile_chunk_append(mem_data, compchunk->size);
+    memfile_chunk_share(curchunk, compchunk);
+    curchunk->is_identical = true;
+    const_cast<MemFileChunk *>(compchunk)->is_identical_future = true;
   }
+  mem_data->current_id_session_uid = MAIN_ID_SESSION_UID_UNSET;
+  mem_data->reference_current_chunk = const_cast<MemFileChunk *>(compchunk);
+  return true;
 }
 
 Main *BLO_memfile_main_get(MemFile *memfile, Main *bmain, Scene **r_scene)
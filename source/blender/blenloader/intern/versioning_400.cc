@@ -20,6 +20,7 @@
 #include "DNA_action_types.h"
 #include "DNA_anim_types.h"
 #include "DNA_brush_types.h"
+#include "DNA_cachefile_types.h"
 #include "DNA_camera_types.h"
 #include "DNA_collection_types.h"
 #include "DNA_constraint_types.h"
@@ -7736,6 +7737,15 @@ void blo_do_versions_400(FileData *fd, Library * /*lib*/, Main *bmain)
     FOREACH_NODETREE_END;
   }
 
+  if (!MAIN_VERSION_FILE_ATLEAST(bmain, 405, 33)) {
+    const CacheFile *default_cache_file = DNA_struct_default_get(CacheFile);
+    LISTBASE_FOREACH (CacheFile *, cache_file, &bmain->cachefiles) {
+      cache_file->playback_prefetch_frames = default_cache_file->playback_prefetch_frames;
+      cache_file->playback_prefetch_cache_size =
+          default_cache_file->playback_prefetch_cache_size;
+    }
+  }
+
   /* Always run this versioning (keep at the bottom of the function). Meshes are written with the
    * legacy format which always needs to be converted to the new format on file load. To be moved
    * to a subversion check in 5.0. */
@@ -82,10 +82,13 @@
 /* Allow writefile to use deprecated functionality (for forward compatibility code). */
 #define DNA_DEPRECATED_ALLOW
 
+#include "DNA_collection_types.h"
 #include "DNA_fileglobal_types.h"
 #include "DNA_genfile.h"
 #include "DNA_key_types.h"
+#include "DNA_node_types.h"
 #include "DNA_print.hh"
+#include "DNA_scene_types.h"
 #include "DNA_sdna_types.h"
 #include "DNA_userdef_types.h"
 
@@ -1082,6 +1085,107 @@ static void write_id(WriteData *wd, ID *id)
   mywrite_id_end(wd, id);
 }
 
+/**
+ * In undo case, reuse the data written for the ID in the previous undo step instead of writing it
+ * again, when it is known to be unchanged since then (see
+ * #UserDef_Experimental.use_undo_skip_unchanged_ids).
+ *
+ * The ID has to be unchanged according to the changes tagged since the last undo push, and it and
+ * all the IDs it uses must still be at the addresses they were written at, since ID pointers are
+ * stored as such in the previous undo step.
+ *
+ * \return True if the ID does not have to be written.
+ */
+static bool write_id_undo_reuse_unchanged(WriteData *wd, Main *bmain, ID *id)
+{
+  MemFileWriteData &mem = wd->mem;
+  if (mem.reference_memfile == nullptr) {
+    return false;
+  }
+  /* These are small, but contain many UI pointers which are not all covered below. */
+  if (ELEM(GS(id->name), ID_WM, ID_SCR, ID_WS)) {
+    return false;
+  }
+  if (id->recalc_after_undo_push != 0) {
+    return false;
+  }
+  /* Embedded IDs are written as part of their owner, but their changes are only tagged on them,
+   * e.g. when editing nodes. Clearing the tags after an undo push handles the same IDs. */
+  const bNodeTree *node_tree = blender::bke::node_tree_from_id(id);
+  if (node_tree != nullptr && node_tree->id.recalc_after_undo_push != 0) {
+    return false;
+  }
+  if (GS(id->name) == ID_SCE) {
+    const Scene *scene = reinterpret_cast<const Scene *>(id);
+    if (scene->master_collection != nullptr &&
+        scene->master_collection->id.recalc_after_undo_push != 0)
+    {
+      return false;
+    }
+  }
+  if (BLO_memfile_write_reference_id_address(&mem, id->session_uid) != id) {
+    return false;
+  }
+
+  bool used_ids_unchanged = true;
+  BKE_library_foreach_ID_link(
+      bmain,
+      id,
+      [&](LibraryIDLinkCallbackData *cb_data) {
+        if (cb_data->cb_flag & IDWALK_CB_EMBEDDED) {
+          /* Embedded IDs are written as part of their owner, their own uses are walked as well.
+           * Catches embedded IDs not covered above. */
+          const ID *id_embedded = *cb_data->id_pointer;
+          if (id_embedded != nullptr && id_embedded->recalc_after_undo_push != 0) {
+            used_ids_unchanged = false;
+            return IDWALK_RET_STOP_ITER;
+          }
+          return IDWALK_RET_NOP;
+        }
+        const ID *id_used = *cb_data->id_pointer;
+        if (id_used == nullptr || ID_IS_LINKED(id_used)) {
+          /* Linked data is not re-allocated by undo. */
+          return IDWALK_RET_NOP;
+        }
+        if ((cb_data->cb_flag & IDWALK_CB_EMBEDDED_NOT_OWNING) ||
+            BLO_memfile_write_reference_id_address(&mem, id_used->session_uid) != id_used)
+        {
+          used_ids_unchanged = false;
+          return IDWALK_RET_STOP_ITER;
+        }
+        return IDWALK_RET_NOP;
+      },
+      nullptr,
+      IDWALK_READONLY);
+  if (!used_ids_unchanged) {
+    return false;
+  }
+
+  if (!BLO_memfile_write_reuse_id_chunks(&mem, id->session_uid)) {
+    return false;
+  }
+
+  /* Keep the shared data referenced by the reused chunks alive, see #BLO_write_shared. */
+  const MemFileSharedStorage *reference_storage = mem.reference_memfile->shared_storage;
+  if (reference_storage != nullptr) {
+    MemFile &memfile = *mem.written_memfile;
+    for (const void *data : reference_storage->data_by_id_session_uid.lookup(id->session_uid)) {
+      const blender::ImplicitSharingInfo *sharing_info = reference_storage->map.lookup(data);
+      if (memfile.shared_storage == nullptr) {
+        memfile.shared_storage = MEM_new<MemFileSharedStorage>(__func__);
+      }
+      memfile.shared_storage->data_by_id_session_uid.add(id->session_uid, data);
+      if (memfile.shared_storage->map.add(data, sharing_info)) {
+        sharing_info->add_user();
+      }
+    }
+  }
+
+  /* Same as when actually writing the ID, see #BLO_Write_IDBuffer. */
+  id->recalc_up_to_undo_push = 0;
+  return true;
+}
+
 /** Keep it last of `write_*_data` functions. */
 static void write_libraries(WriteData *wd, Main *bmain)
 {
@@ -1494,7 +1598,12 @@ static bool write_file_handle(Main *mainvar,
   }
 
   /* Actually write local data-blocks to the file. */
+  const bool use_undo_reuse_unchanged = is_undo &&
+                                        USER_EXPERIMENTAL_TEST(&U, use_undo_skip_unchanged_ids);
   for (ID *id : local_ids_to_write) {
+    if (use_undo_reuse_unchanged && write_id_undo_reuse_unchanged(wd, mainvar, id)) {
+      continue;
+    }
     write_id(wd, id);
   }
 
@@ -1981,6 +2090,8 @@ void BLO_write_shared(BlendWriter *writer,
       if (memfile.shared_storage->map.add(data, sharing_info)) {
         /* The undo-step takes (shared) ownership of the data, which also makes it immutable. */
         sharing_info->add_user();
+        memfile.shared_storage->data_by_id_session_uid.add(
+            writer->wd->mem.current_id_session_uid, data);
         /* This size is an estimate, but good enough to count data with many users less. */
         memfile.size += approximate_size_in_bytes / sharing_info->strong_users();
         return;
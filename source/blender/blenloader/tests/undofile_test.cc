@@ -0,0 +1,216 @@
+/* SPDX-FileCopyrightText: 2025 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#include "testing/testing.h"
+
+#include <cstring>
+
+#include "BLI_listbase.h"
+
+#include "DNA_ID.h"
+#include "DNA_material_types.h"
+#include "DNA_node_types.h"
+#include "DNA_sdna_types.h"
+#include "DNA_userdef_types.h"
+
+#include "BKE_lib_id.hh"
+#include "BKE_main.hh"
+#include "BKE_material.hh"
+#include "BKE_node.hh"
+
+#include "BLO_undofile.hh"
+#include "BLO_writefile.hh"
+
+#include "blendfile_loading_base_test.h"
+
+namespace blender::blenloader::tests {
+
+static void write_chunk(MemFileWriteData &mem_data, const uint id_session_uid, const char *text)
+{
+  mem_data.current_id_session_uid = id_session_uid;
+  BLO_memfile_chunk_add(&mem_data, text, strlen(text) + 1);
+  mem_data.current_id_session_uid = MAIN_ID_SESSION_UID_UNSET;
+}
+
+static void write_memfile(MemFile &memfile,
+                          MemFile *reference,
+                          const Span<const char *> texts,
+                          const uint first_id_session_uid = 1)
+{
+  MemFileWriteData mem_data{};
+  BLO_memfile_write_init(&mem_data, &memfile, reference);
+  for (const int i : texts.index_range()) {
+    write_chunk(mem_data, first_id_session_uid + uint(i), texts[i]);
+  }
+  BLO_memfile_write_finalize(&mem_data);
+}
+
+static MemFileChunk *chunk_at(MemFile &memfile, const int index)
+{
+  return static_cast<MemFileChunk *>(BLI_findlink(&memfile.chunks, index));
+}
+
+TEST(undofile, IdenticalChunksShareMemory)
+{
+  MemFile first{};
+  MemFile second{};
+  write_memfile(first, nullptr, {"aaaa", "bbbb"});
+  write_memfile(second, &first, {"aaaa", "cccc"});
+
+  EXPECT_EQ(chunk_at(second, 0)->buf, chunk_at(first, 0)->buf);
+  EXPECT_TRUE(chunk_at(second, 0)->is_identical);
+  EXPECT_TRUE(chunk_at(first, 0)->is_identical_future);
+  EXPECT_FALSE(chunk_at(second, 1)->is_identical);
+  EXPECT_EQ(second.size, 5);
+
+  BLO_memfile_free(&second);
+  BLO_memfile_free(&first);
+}
+
+TEST(undofile, ContentDeduplicationAcrossSteps)
+{
+  MemFile first{};
+  MemFile second{};
+  MemFile third{};
+  write_memfile(first, nullptr, {"aaaa", "bbbb"});
+  write_memfile(second, &first, {"aaaa", "cccc"});
+  /* Reverting the second chunk to its content from the first step does not need new memory, but
+   * the chunk is still a change compared to the previous step. */
+  write_memfile(third, &second, {"aaaa", "bbbb"});
+
+  EXPECT_EQ(chunk_at(third, 1)->buf, chunk_at(first, 1)->buf);
+  EXPECT_FALSE(chunk_at(third, 1)->is_identical);
+  EXPECT_EQ(third.size, 0);
+
+  /* Identical content within a single step is shared too. */
+  MemFile fourth{};
+  write_memfile(fourth, &third, {"dddd", "dddd"});
+  EXPECT_EQ(chunk_at(fourth, 0)->buf, chunk_at(fourth, 1)->buf);
+  EXPECT_EQ(fourth.size, 5);
+
+  /* Freeing the older steps keeps the memory used by the newer ones. */
+  BLO_memfile_merge(&first, &second);
+  BLO_memfile_merge(&second, &third);
+  EXPECT_STREQ(chunk_at(third, 0)->buf, "aaaa");
+  EXPECT_STREQ(chunk_at(third, 1)->buf, "bbbb");
+
+  BLO_memfile_free(&fourth);
+  BLO_memfile_free(&third);
+}
+
+TEST(undofile, ReuseIdChunks)
+{
+  MemFile first{};
+  MemFile second{};
+  write_memfile(first, nullptr, {"aaaa", "bbbb", "cccc"});
+
+  MemFileWriteData mem_data{};
+  BLO_memfile_write_init(&mem_data, &second, &first);
+  write_chunk(mem_data, 1, "xxxx");
+  EXPECT_TRUE(BLO_memfile_write_reuse_id_chunks(&mem_data, 2));
+  EXPECT_FALSE(BLO_memfile_write_reuse_id_chunks(&mem_data, 42));
+  write_chunk(mem_data, 3, "cccc");
+  BLO_memfile_write_finalize(&mem_data);
+
+  ASSERT_EQ(BLI_listbase_count(&second.chunks), 3);
+  EXPECT_EQ(chunk_at(second, 1)->buf, chunk_at(first, 1)->buf);
+  EXPECT_EQ(chunk_at(second, 1)->id_session_uid, 2);
+  EXPECT_TRUE(chunk_at(second, 1)->is_identical);
+  /* The chunk following the reused ones is still compared with its matching chunk. */
+  EXPECT_TRUE(chunk_at(second, 2)->is_identical);
+  EXPECT_EQ(second.size, 5);
+
+  BLO_memfile_free(&second);
+  BLO_memfile_free(&first);
+}
+
+TEST(undofile, ReferenceIdAddress)
+{
+  ID id{};
+  BHead bhead{};
+  bhead.code = ID_OB;
+  bhead.old = &id;
+  char buf[sizeof(BHead) + 4] = {};
+  memcpy(buf, &bhead, sizeof(BHead));
+
+  MemFile first{};
+  MemFileWriteData mem_data{};
+  BLO_memfile_write_init(&mem_data, &first, nullptr);
+  mem_data.current_id_session_uid = 7;
+  BLO_memfile_chunk_add(&mem_data, buf, sizeof(buf));
+  mem_data.current_id_session_uid = MAIN_ID_SESSION_UID_UNSET;
+  BLO_memfile_write_finalize(&mem_data);
+
+  MemFile second{};
+  BLO_memfile_write_init(&mem_data, &second, &first);
+  EXPECT_EQ(BLO_memfile_write_reference_id_address(&mem_data, 7), &id);
+  EXPECT_EQ(BLO_memfile_write_reference_id_address(&mem_data, 8), nullptr);
+  BLO_memfile_write_finalize(&mem_data);
+
+  BLO_memfile_free(&second);
+  BLO_memfile_free(&first);
+}
+
+class UndofileWriteTest : public BlendfileLoadingBaseTest {};
+
+static bool id_chunks_are_identical(MemFile &memfile, const uint id_session_uid)
+{
+  LISTBASE_FOREACH (MemFileChunk *, chunk, &memfile.chunks) {
+    if (chunk->id_session_uid == id_session_uid && !chunk->is_identical) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static float first_node_location_x(MemFile &memfile, Main *bmain)
+{
+  Main *bmain_undo = BLO_memfile_main_get(&memfile, bmain, nullptr);
+  const Material *material = static_cast<const Material *>(bmain_undo->materials.first);
+  const bNode *node = static_cast<const bNode *>(material->nodetree->nodes.first);
+  const float location_x = node->location[0];
+  BKE_main_free(bmain_undo);
+  return location_x;
+}
+
+TEST_F(UndofileWriteTest, ReuseUnchangedIdsEmbeddedNodeTreeEdit)
+{
+  const int flag_orig = U.flag;
+  const char use_undo_skip_unchanged_ids_orig = U.experimental.use_undo_skip_unchanged_ids;
+  U.flag |= USER_DEVELOPER_UI;
+  U.experimental.use_undo_skip_unchanged_ids = true;
+
+  Main *bmain = BKE_main_new();
+  Material *material = BKE_material_add(bmain, "Material");
+  id_fake_user_set(&material->id);
+  material->nodetree = bke::node_tree_add_tree_embedded(
+      bmain, &material->id, "Shader Nodetree", "ShaderNodeTree");
+  bNode *node = bke::node_add_node(nullptr, *material->nodetree, "ShaderNodeValue");
+
+  MemFile first{};
+  ASSERT_TRUE(BLO_write_file_mem(bmain, nullptr, &first, 0));
+
+  /* Only the embedded node tree is tagged when editing nodes. */
+  material->id.recalc_after_undo_push = 0;
+  material->nodetree->id.recalc_after_undo_push = 0;
+  node->location[0] = 10.0f;
+  material->nodetree->id.recalc_after_undo_push = ID_RECALC_SYNC_TO_EVAL;
+
+  MemFile second{};
+  ASSERT_TRUE(BLO_write_file_mem(bmain, &first, &second, 0));
+
+  EXPECT_FALSE(id_chunks_are_identical(second, material->id.session_uid));
+  EXPECT_EQ(first_node_location_x(second, bmain), 10.0f);
+  /* Undoing the edit restores the previous location. */
+  EXPECT_EQ(first_node_location_x(first, bmain), 0.0f);
+
+  BLO_memfile_free(&second);
+  BLO_memfile_free(&first);
+  BKE_main_free(bmain);
+
+  U.flag = flag_orig;
+  U.experimental.use_undo_skip_unchanged_ids = use_undo_skip_unchanged_ids_orig;
+}
+
+}  // namespace blender::blenloader::tests
@@ -40,6 +40,9 @@ class ConversionOperation : public SimpleOperation {
 
   /* Convert the input to the appropriate type and write the result to the output on the CPU. */
   void execute_cpu(const Result &input, Result &output);
+
+ protected:
+  ProfiledOperationType profiled_type() const override;
 };
 
 }  // namespace blender::compositor
@@ -6,6 +6,8 @@
 
 #include <memory>
 
+#include "BLI_map.hh"
+#include "BLI_set.hh"
 #include "BLI_vector.hh"
 
 #include "NOD_derived_node_tree.hh"
@@ -14,6 +16,7 @@
 #include "COM_context.hh"
 #include "COM_node_operation.hh"
 #include "COM_operation.hh"
+#include "COM_scheduler.hh"
 
 namespace blender::compositor {
 
@@ -93,6 +96,13 @@ class Evaluator {
   std::unique_ptr<DerivedNodeTree> derived_node_tree_;
   /* The compiled operations stream, which contains all compiled operations so far. */
   Vector<std::unique_ptr<Operation>> operations_stream_;
+  /* A map that associates scheduled nodes with keys that identify their results across
+   * evaluations, see the compute_node_keys method. Nodes whose results can't be identified don't
+   * have a key. */
+  Map<DNode, uint64_t> node_keys_;
+  /* The nodes whose needed results are all cached from previous evaluations, so they need not be
+   * evaluated. See the compute_pruned_schedule method. */
+  Set<DNode> cached_nodes_;
 
  public:
   /* Construct an evaluator from a context. */
@@ -114,6 +124,30 @@ class Evaluator {
    * stream, and evaluate the operation. */
   void evaluate_node(DNode node, CompileState &compile_state);
 
+  /* Compute the keys of the nodes in the given schedule. The key of a node hashes everything its
+   * results depend on, that is, the type and parameters of the node, the values of its unlinked
+   * inputs, the keys of the outputs its linked inputs are linked to, and the relevant state of the
+   * context. So if the key of a node didn't change since a previous evaluation, the node computes
+   * the same results, which can thus be cached in the static cache manager and reused. Nodes that
+   * depend on the frame or on data outside of the node tree, like render passes and movie clips,
+   * don't get a key, and consequently, neither do the nodes that depend on them. */
+  void compute_node_keys(const Schedule &schedule);
+
+  /* Returns true if the results of the given node can be cached and retrieved from the cache. */
+  bool is_cacheable_node(const DNode &node);
+
+  /* Compute the cached_nodes_ set and return the given schedule without the nodes that are only
+   * needed by cached nodes, so those nodes are not evaluated at all. */
+  Schedule compute_pruned_schedule(const Schedule &schedule);
+
+  /* Similar to evaluate_node, but the results of the node operation share the data of the results
+   * cached in a previous evaluation instead of evaluating the operation. */
+  void evaluate_cached_node(DNode node, CompileState &compile_state);
+
+  /* Cache the results of the given node operation that was just evaluated if its node is
+   * cacheable, see the compute_node_keys method. */
+  void cache_node_results(DNode node, NodeOperation &operation);
+
   /* Map each input of the node operation to the result of the output linked to it. Unlinked inputs
    * are mapped to the result of a newly created Input Single Value Operation, which is added to
    * the operations stream and evaluated. Since this method might add operations to the operations
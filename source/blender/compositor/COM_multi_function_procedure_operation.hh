@@ -18,6 +18,7 @@
 #include "NOD_multi_function.hh"
 
 #include "COM_context.hh"
+#include "COM_domain.hh"
 #include "COM_input_descriptor.hh"
 #include "COM_pixel_operation.hh"
 #include "COM_scheduler.hh"
@@ -58,6 +59,11 @@ class MultiFunctionProcedureOperation : public PixelOperation {
    * output results for each of the parameters in the procedure. Note that parameters have no
    * identifiers and are identified solely by their order. */
   Vector<std::string> parameter_identifiers_;
+  /* A map that associates the identifiers of inputs that need realization on the operation domain
+   * with the domain they should be realized on. Those inputs are realized on the fly while the
+   * procedure is executed on the CPU as opposed to using a realization input processor, see the
+   * add_and_evaluate_input_processors method. */
+  Map<std::string, Domain> fused_realization_domains_;
 
  public:
   /* Build a multi-function procedure as well as an executor for it from the given pixel compile
@@ -70,6 +76,12 @@ class MultiFunctionProcedureOperation : public PixelOperation {
    * inputs and outputs as parameters. */
   void execute() override;
 
+ protected:
+  /* Identical to the base method, except that on the CPU, inputs that only need realization on
+   * the operation domain are not realized by an input processor, but are sampled on the fly while
+   * the procedure is executed, which avoids a full size intermediate copy of the input. */
+  void add_and_evaluate_input_processors() override;
+
  private:
   /* Builds the procedure by going over the nodes in the compile unit, calling their
    * multi-functions and creating any necessary inputs or outputs to the operation/procedure. */
@@ -52,6 +52,11 @@ class NodeOperation : public Operation {
   /* Compute a node preview using the result returned from the get_preview_result method. */
   void compute_preview() override;
 
+  ProfiledOperationType profiled_type() const override;
+
+  /* The name of the node. */
+  std::string profiled_name() const override;
+
   /* Returns a reference to the derived node that this operation represents. */
   const DNode &node() const;
 
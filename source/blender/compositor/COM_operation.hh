@@ -14,6 +14,7 @@
 #include "COM_context.hh"
 #include "COM_domain.hh"
 #include "COM_input_descriptor.hh"
+#include "COM_profiler.hh"
 #include "COM_result.hh"
 
 namespace blender::compositor {
@@ -138,6 +139,14 @@ class Operation {
    * implementation and should be implemented by operations which can have previews. */
   virtual void compute_preview();
 
+  /* Returns the type of the operation as recorded by the profiler. This defaults to an input
+   * operation and should be overridden by other kinds of operations. */
+  virtual ProfiledOperationType profiled_type() const;
+
+  /* Returns the name of the operation as recorded by the profiler. This defaults to the name of
+   * its profiled type. */
+  virtual std::string profiled_name() const;
+
   /* Get a reference to the result connected to the input identified by the given identifier. */
   Result &get_input(StringRef identifier) const;
 
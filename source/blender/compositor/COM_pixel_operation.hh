@@ -113,6 +113,12 @@ class PixelOperation : public Operation {
    * preview_outputs_ vector set, see the populate_results_for_node method for more information. */
   void compute_preview() override;
 
+  ProfiledOperationType profiled_type() const override;
+
+  /* The names of the nodes compiled in the operation, since the nodes can't be profiled
+   * individually. */
+  std::string profiled_name() const override;
+
   /* Get the identifier of the operation output corresponding to the given output socket. This is
    * called by the compiler to identify the operation output that provides the result for an input
    * by providing the output socket that the input is linked to. See
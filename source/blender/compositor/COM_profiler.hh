@@ -4,8 +4,14 @@
 
 #pragma once
 
+#include <cstdint>
+#include <mutex>
+#include <string>
+
 #include "BLI_map.hh"
+#include "BLI_string_ref.hh"
 #include "BLI_timeit.hh"
+#include "BLI_vector.hh"
 
 #include "DNA_node_types.h"
 
@@ -13,19 +19,76 @@ namespace blender::compositor {
 
 class Context;
 
+/* The type of a profiled operation, which is exported as the category of its trace event. */
+enum class ProfiledOperationType : uint8_t {
+  /* The evaluation of the whole node tree, which encloses all other operations. */
+  Evaluation,
+  Node,
+  Pixel,
+  Conversion,
+  Realization,
+  Input,
+};
+
 /* -------------------------------------------------------------------------------------------------
  * Profiler
  *
  * A class that profiles the evaluation of the compositor and tracks information like the
- * evaluation time of every node. */
+ * evaluation time of every node. Additionally, every evaluated operation is recorded along with
+ * the memory of the results allocated during its evaluation, the number of bytes realized on new
+ * domains, and the time spent in conversions, such that the evaluation can be exported as
+ * Chrome trace events and inspected in tools like Perfetto. */
 class Profiler {
  private:
+  /* The statistics of a single evaluation of an operation. All statistics are inclusive, that is,
+   * they include the statistics of the operations evaluated during the evaluation of this
+   * operation, like input processors. */
+  struct OperationEvent {
+    ProfiledOperationType type;
+    std::string name;
+    timeit::TimePoint start;
+    timeit::Nanoseconds duration = timeit::Nanoseconds::zero();
+    /* The number of results allocated and their total size in bytes. */
+    int64_t allocations_count = 0;
+    int64_t allocated_bytes = 0;
+    /* The peak and time weighted average of the memory of all live results. */
+    int64_t peak_memory = 0;
+    int64_t average_memory = 0;
+    /* The value of memory_integral_ when the operation started, used to compute the average. */
+    double start_memory_integral = 0.0;
+    /* The number of bytes produced by realizing inputs on new domains. */
+    int64_t realized_bytes = 0;
+    /* The time spent in conversion operations. */
+    timeit::Nanoseconds conversions_time = timeit::Nanoseconds::zero();
+  };
+
   /* Stores the evaluation time of each node instance keyed by its instance key. Note that
    * pixel-wise nodes like Math nodes will not be measured, that's because they are compiled
    * together with other pixel-wise operations in a single operation, so we can't measure the
    * evaluation time of each individual node. */
   Map<bNodeInstanceKey, timeit::Nanoseconds> nodes_evaluation_times_;
 
+  /* The events of all operations evaluated so far, in the order in which they started. */
+  Vector<OperationEvent> operation_events_;
+  /* The indices of the events of the operations currently being evaluated, where nested
+   * operations come last. */
+  Vector<int64_t> operations_stack_;
+
+  /* Results may be allocated and freed from multiple threads, so the memory tracking members
+   * below are protected by this mutex. */
+  std::mutex memory_mutex_;
+  /* The size in bytes of the data of every live result allocated while profiling, keyed by the
+   * pointer to the data. Results allocated before profiling started are not tracked. */
+  Map<const void *, int64_t> live_allocations_;
+  /* The total size of live_allocations_. */
+  int64_t memory_usage_ = 0;
+  /* The integral of the memory usage over time in byte nanoseconds up until the time of the last
+   * memory change, from which time weighted averages of the memory usage are computed. */
+  double memory_integral_ = 0.0;
+  timeit::TimePoint last_memory_change_time_ = timeit::Clock::now();
+  /* The memory usage after every change, exported as a counter track. */
+  Vector<std::pair<timeit::TimePoint, int64_t>> memory_samples_;
+
  public:
   /* Returns a reference to the nodes evaluation times. */
   Map<bNodeInstanceKey, timeit::Nanoseconds> &get_nodes_evaluation_times();
@@ -36,12 +99,41 @@ class Profiler {
   /* Finalize profiling by computing node group times. This should be called after evaluation. */
   void finalize(const bNodeTree &node_tree);
 
+  /* Start recording an event for an operation of the given type and name. Operations can be
+   * nested, and every call should be matched with a call to end_operation. */
+  void begin_operation(ProfiledOperationType type, std::string name);
+
+  /* Finish recording the event of the last operation that began. */
+  void end_operation();
+
+  /* Track the given newly allocated result data of the given size. */
+  void add_result_allocation(const void *data, int64_t size_in_bytes);
+
+  /* Stop tracking the given result data, which is about to be freed. */
+  void remove_result_allocation(const void *data);
+
+  /* Add the given number of bytes produced by realizing an input on a new domain to the
+   * operations currently being evaluated. */
+  void add_realized_bytes(int64_t size_in_bytes);
+
+  /* Append the recorded events to the given file in the Chrome trace event format, creating the
+   * file if it was not written by this process before, otherwise, the events are added to the
+   * existing ones. The file stays a valid JSON array after every call. */
+  void write_chrome_trace(StringRefNull filepath);
+
  private:
   /* Computes the evaluation time of every group node inside the given tree recursively by
    * accumulating the evaluation time of its nodes, setting the computed time to the group nodes.
    * The time is returned since the method is called recursively. */
   timeit::Nanoseconds accumulate_node_group_times(const bNodeTree &node_tree,
                                                   bNodeInstanceKey instance_key);
+
+  /* Integrate the current memory usage up until the given time. Expects memory_mutex_ to be
+   * locked. */
+  void update_memory_integral(timeit::TimePoint time);
 };
 
+/* Returns the name of the given operation type, used as the category of trace events. */
+StringRefNull profiled_operation_type_name(ProfiledOperationType type);
+
 }  // namespace blender::compositor
@@ -28,6 +28,21 @@ class RealizeOnDomainOperation : public SimpleOperation {
 
   void execute() override;
 
+  /* Returns the domain that the input is realized on. */
+  const Domain &target_domain() const;
+
+  /* Computes the transformation that maps the pixels of the given target domain to the space of
+   * the given input, which is what the input is sampled with when realizing it on the domain. */
+  static float3x3 compute_inverse_transformation(const Result &input, const Domain &target_domain);
+
+  /* Samples the given input at the given texel of the target domain whose inverse transformation
+   * was computed using the compute_inverse_transformation method. This is what the CPU
+   * implementation evaluates for every pixel, but it is also used to realize inputs on the fly
+   * where a realized copy of the input is not needed, see MultiFunctionProcedureOperation. */
+  static float4 sample_realized(const Result &input,
+                                const float3x3 &inverse_transformation,
+                                const int2 &texel);
+
   /* Determine if a realize on domain operation is needed for the input with the given result and
    * descriptor in an operation with the given operation domain. If it is not needed, return a null
    * pointer. If it is needed, return an instance of the operation.
@@ -45,13 +60,15 @@ class RealizeOnDomainOperation : public SimpleOperation {
   /* The operation domain is just the target domain. */
   Domain compute_domain() override;
 
+  ProfiledOperationType profiled_type() const override;
+
  private:
   /* Get the name of the realization shader of the appropriate type. */
   const char *get_realization_shader_name();
 
   /* Computes the translation that the input should be translated by to fix the artifacts related
    * to interpolation. See the implementation for more information. */
-  float2 compute_corrective_translation();
+  static float2 compute_corrective_translation(const Result &input, const Domain &target_domain);
 
   void realize_on_domain_gpu(const float3x3 &inverse_transformation);
   void realize_on_domain_cpu(const float3x3 &inverse_transformation);
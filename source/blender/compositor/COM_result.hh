@@ -323,9 +323,16 @@ class Result {
   /* Returns true if the result is allocated. */
   bool is_allocated() const;
 
+  /* Returns true if the result wraps external data that it doesn't own. See the is_external_
+   * member for more information. */
+  bool is_external() const;
+
   /* Returns the reference count of the result. */
   int reference_count() const;
 
+  /* Returns the size in bytes of the data of the result, or zero if it is not allocated. */
+  int64_t size_in_bytes() const;
+
   /* Returns a reference to the domain of the result. See the Domain class. */
   const Domain &domain() const;
 
@@ -434,6 +441,11 @@ class Result {
    * context. See the allocate_texture method for information about the from_pool argument. */
   void allocate_data(int2 size, bool from_pool);
 
+  /* Returns a pointer that identifies the allocated data, that is, the GPU texture or the CPU
+   * buffer depending on the storage type. This is used to track the memory of results in the
+   * profiler. */
+  const void *data_pointer() const;
+
   /* Same as get_pixel_index but can be used when the type of the result is not known at compile
    * time. */
   int64_t get_pixel_index(const int2 &texel) const;
@@ -0,0 +1,89 @@
+/* SPDX-FileCopyrightText: 2025 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+
+#include "BLI_map.hh"
+
+#include "COM_cached_resource.hh"
+#include "COM_result.hh"
+
+namespace blender::compositor {
+
+class Context;
+
+/* -------------------------------------------------------------------------------------------------
+ * Cached Node Result.
+ *
+ * A cached resource that stores a result computed by a node operation in a previous evaluation,
+ * such that the node need not be evaluated again as long as it would compute the same result. The
+ * result is identified by a key that hashes the node, its parameters, and the keys of everything
+ * its inputs depend on, see Evaluator::compute_node_keys. The cached result shares its data with
+ * the result that was computed by the node operation, so caching it doesn't copy anything.
+ *
+ * Only CPU results are cached, since GPU results are typically acquired from the texture pool,
+ * which expects all of its textures to be released by the end of every evaluation. */
+class CachedNodeResult : public CachedResource {
+ public:
+  Result result;
+  /* The size of the data of the result in bytes, which is counted against the memory limit of
+   * the container. */
+  int64_t size_in_bytes = 0;
+  /* The value of the use clock of the container when the result was last added or retrieved. */
+  uint64_t last_used = 0;
+  /* True if the current evaluation will retrieve the result, so it must not be evicted until the
+   * next reset, see CachedNodeResultContainer::pin. */
+  bool is_pinned = false;
+
+  CachedNodeResult(Context &context, const Result &source);
+
+  ~CachedNodeResult();
+};
+
+/* ------------------------------------------------------------------------------------------------
+ * Cached Node Result Container.
+ *
+ * Unlike other containers, the results can be large, so the container is bounded by a memory
+ * limit, evicting the least recently used results when it is exceeded. */
+class CachedNodeResultContainer : CachedResourceContainer {
+ private:
+  Map<uint64_t, std::unique_ptr<CachedNodeResult>> map_;
+  int64_t memory_limit_ = 0;
+  int64_t memory_usage_ = 0;
+  uint64_t use_clock_ = 0;
+
+ public:
+  void reset() override;
+
+  /* Set the memory limit of the container in bytes, evicting results if it is exceeded. */
+  void set_memory_limit(int64_t limit);
+
+  /* Returns true if a result with the given key is cached. */
+  bool contains(uint64_t key) const;
+
+  /* Keep the result with the given key cached until the next reset, because the current
+   * evaluation skips the nodes needed to compute it and will retrieve it later on. The result is
+   * also tagged as needed. The result with the given key is expected to exist. */
+  void pin(uint64_t key);
+
+  /* Returns the cached result with the given key, tagging it as needed to keep it cached for the
+   * next evaluation. The result with the given key is expected to exist, see the contains
+   * method. */
+  const Result &get(uint64_t key);
+
+  /* Cache the given result with the given key by sharing its data, unless it doesn't fit in the
+   * memory limit next to the pinned results. Results that wrap external data are not cached,
+   * since their data is owned by someone else and can be freed or changed at any time. */
+  void add(Context &context, uint64_t key, const Result &result);
+
+ private:
+  /* Delete the least recently used results that are not pinned until the memory usage fits the
+   * given limit, or only pinned results are left. */
+  void evict(int64_t limit);
+};
+
+}  // namespace blender::compositor
@@ -0,0 +1,130 @@
+/* SPDX-FileCopyrightText: 2025 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#include <cstdint>
+#include <memory>
+
+#include "BLI_assert.h"
+
+#include "COM_cached_node_result.hh"
+#include "COM_context.hh"
+#include "COM_result.hh"
+
+namespace blender::compositor {
+
+/* --------------------------------------------------------------------
+ * Cached Node Result.
+ */
+
+CachedNodeResult::CachedNodeResult(Context &context, const Result &source)
+    : result(context, source.type(), source.precision()),
+      size_in_bytes(source.cpu_data().size_in_bytes())
+{
+  this->result.share_data(source);
+}
+
+CachedNodeResult::~CachedNodeResult()
+{
+  this->result.free();
+}
+
+/* --------------------------------------------------------------------
+ * Cached Node Result Container.
+ */
+
+void CachedNodeResultContainer::reset()
+{
+  /* First, delete all resources that are no longer needed. */
+  map_.remove_if([&](auto item) {
+    if (item.value->needed) {
+      return false;
+    }
+    memory_usage_ -= item.value->size_in_bytes;
+    return true;
+  });
+
+  /* Second, reset the needed and pinned status of the remaining resources to false to ready them
+   * to track their status for the next evaluation. */
+  for (auto &value : map_.values()) {
+    value->needed = false;
+    value->is_pinned = false;
+  }
+}
+
+void CachedNodeResultContainer::set_memory_limit(const int64_t limit)
+{
+  memory_limit_ = limit;
+  this->evict(limit);
+}
+
+bool CachedNodeResultContainer::contains(const uint64_t key) const
+{
+  return map_.contains(key);
+}
+
+void CachedNodeResultContainer::pin(const uint64_t key)
+{
+  CachedNodeResult &cached_result = *map_.lookup(key);
+  cached_result.needed = true;
+  cached_result.is_pinned = true;
+  cached_result.last_used = ++use_clock_;
+}
+
+const Result &CachedNodeResultContainer::get(const uint64_t key)
+{
+  CachedNodeResult &cached_result = *map_.lookup(key);
+  cached_result.needed = true;
+  cached_result.last_used = ++use_clock_;
+  return cached_result.result;
+}
+
+void CachedNodeResultContainer::add(Context &context, const uint64_t key, const Result &result)
+{
+  BLI_assert(!context.use_gpu());
+  if (!result.is_allocated() || result.is_external()) {
+    return;
+  }
+
+  const int64_t size_in_bytes = result.cpu_data().size_in_bytes();
+  if (size_in_bytes > memory_limit_) {
+    return;
+  }
+
+  /* The key might already exist if the node was evaluated even though this output was cached, for
+   * instance, because another one of its outputs wasn't, so the new result replaces the old one. */
+  if (std::unique_ptr<CachedNodeResult> old_result = map_.pop_default(key, nullptr)) {
+    memory_usage_ -= old_result->size_in_bytes;
+  }
+
+  this->evict(memory_limit_ - size_in_bytes);
+  if (memory_usage_ + size_in_bytes > memory_limit_) {
+    return;
+  }
+
+  std::unique_ptr<CachedNodeResult> cached_result = std::make_unique<CachedNodeResult>(context,
+                                                                                       result);
+  cached_result->last_used = ++use_clock_;
+  map_.add_new(key, std::move(cached_result));
+  memory_usage_ += size_in_bytes;
+}
+
+void CachedNodeResultContainer::evict(const int64_t limit)
+{
+  while (memory_usage_ > limit) {
+    uint64_t oldest_key = 0;
+    uint64_t oldest_use = UINT64_MAX;
+    for (const auto item : map_.items()) {
+      if (!item.value->is_pinned && item.value->last_used < oldest_use) {
+        oldest_key = item.key;
+        oldest_use = item.value->last_used;
+      }
+    }
+    if (oldest_use == UINT64_MAX) {
+      break;
+    }
+    memory_usage_ -= map_.pop(oldest_key)->size_in_bytes;
+  }
+}
+
+}  // namespace blender::compositor
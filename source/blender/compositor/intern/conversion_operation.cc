@@ -19,6 +19,7 @@
 #include "COM_context.hh"
 #include "COM_conversion_operation.hh"
 #include "COM_input_descriptor.hh"
+#include "COM_profiler.hh"
 #include "COM_result.hh"
 #include "COM_utilities.hh"
 
@@ -114,6 +115,11 @@ static GMutableSpan get_result_single_value(Result &result)
   return GMutableSpan(result.single_value().type(), result.single_value().get(), 1);
 }
 
+ProfiledOperationType ConversionOperation::profiled_type() const
+{
+  return ProfiledOperationType::Conversion;
+}
+
 void ConversionOperation::execute_single(const Result &input, Result &output)
 {
   const bke::DataTypeConversions &conversions = bke::get_implicit_type_conversions();
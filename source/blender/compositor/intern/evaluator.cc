@@ -2,10 +2,25 @@
  *
  * SPDX-License-Identifier: GPL-2.0-or-later */
 
+#include <fmt/format.h>
+#include <xxhash.h>
+
 #include "BLI_memory_utils.hh"
+#include "BLI_set.hh"
 #include "BLI_string.h"
+#include "BLI_string_ref.hh"
+#include "BLI_vector.hh"
 
+#include "DNA_ID.h"
+#include "DNA_color_types.h"
+#include "DNA_genfile.h"
+#include "DNA_image_types.h"
 #include "DNA_node_types.h"
+#include "DNA_sdna_types.h"
+#include "DNA_userdef_types.h"
+
+#include "BKE_image.hh"
+#include "BKE_node_legacy_types.hh"
 
 #include "NOD_derived_node_tree.hh"
 
@@ -17,6 +32,7 @@
 #include "COM_multi_function_procedure_operation.hh"
 #include "COM_node_operation.hh"
 #include "COM_operation.hh"
+#include "COM_profiler.hh"
 #include "COM_result.hh"
 #include "COM_scheduler.hh"
 #include "COM_shader_operation.hh"
@@ -32,8 +48,18 @@ void Evaluator::evaluate()
 {
   context_.reset();
 
+  if (context_.profiler()) {
+    const int frame = context_.get_frame_number();
+    const std::string_view view_name = context_.get_view_name();
+    context_.profiler()->begin_operation(ProfiledOperationType::Evaluation,
+                                         view_name.empty() ?
+                                             fmt::format("Frame {}", frame) :
+                                             fmt::format("Frame {} ({})", frame, view_name));
+  }
+
   BLI_SCOPED_DEFER([&]() {
     if (context_.profiler()) {
+      context_.profiler()->end_operation();
       context_.profiler()->finalize(context_.get_node_tree());
     }
   });
@@ -49,7 +75,9 @@ void Evaluator::evaluate()
     return;
   }
 
-  const Schedule schedule = compute_schedule(context_, *derived_node_tree_);
+  const Schedule full_schedule = compute_schedule(context_, *derived_node_tree_);
+  this->compute_node_keys(full_schedule);
+  const Schedule schedule = this->compute_pruned_schedule(full_schedule);
 
   CompileState compile_state(context_, schedule);
 
@@ -66,6 +94,9 @@ void Evaluator::evaluate()
     if (is_pixel_node(node)) {
       compile_state.add_node_to_pixel_compile_unit(node);
     }
+    else if (cached_nodes_.contains(node)) {
+      this->evaluate_cached_node(node, compile_state);
+    }
     else {
       this->evaluate_node(node, compile_state);
     }
@@ -120,6 +151,8 @@ void Evaluator::evaluate_node(DNode node, CompileState &compile_state)
   operation->compute_results_reference_counts(compile_state.get_schedule());
 
   operation->evaluate();
+
+  this->cache_node_results(node, *operation);
 }
 
 void Evaluator::map_node_operation_inputs_to_their_results(DNode node,
@@ -254,6 +287,405 @@ void Evaluator::map_pixel_operation_inputs_to_their_results(PixelOperation *oper
   }
 }
 
+/* Accumulates the data that identifies the result of a node, which is hashed to compute the key
+ * of the node, see Evaluator::compute_node_keys. */
+class NodeKeyBuilder {
+ private:
+  Vector<char> data_;
+
+ public:
+  void add_bytes(const void *data, const int64_t size)
+  {
+    data_.extend(Span<char>(static_cast<const char *>(data), size));
+  }
+
+  template<typename T> void add(const T &value)
+  {
+    static_assert(std::is_trivially_copyable_v<T>);
+    this->add_bytes(&value, sizeof(T));
+  }
+
+  void add_string(const StringRef string)
+  {
+    this->add(string.size());
+    this->add_bytes(string.data(), string.size());
+  }
+
+  uint64_t hash() const
+  {
+    return XXH3_64bits(data_.data(), data_.size());
+  }
+};
+
+/* Adds the members of an array of DNA structs. Pointers are not followed, except for the points of
+ * curve maps, so returns false if the data has other non-null pointers, because the data they
+ * point to can change without the pointers changing. */
+static bool add_dna_struct_key(NodeKeyBuilder &builder,
+                               const SDNA &sdna,
+                               const SDNA_Struct &sdna_struct,
+                               const void *data,
+                               const int64_t element_num)
+{
+  const char *struct_name = sdna.types[sdna_struct.type_index];
+  const int64_t struct_size = sdna.types_size[sdna_struct.type_index];
+  const bool is_curve_map = STREQ(struct_name, "CurveMap");
+
+  for (const int64_t i : IndexRange(element_num)) {
+    const char *element_data = static_cast<const char *>(data) + i * struct_size;
+    int64_t offset = 0;
+    for (const int member_i : IndexRange(sdna_struct.members_num)) {
+      const SDNA_StructMember &member = sdna_struct.members[member_i];
+      const char *member_name = sdna.members[member.member_index];
+      const int member_size = DNA_struct_member_size(
+          &sdna, member.type_index, member.member_index);
+      const char *member_data = element_data + offset;
+      offset += member_size;
+
+      /* Pointers and function pointers. */
+      if (ELEM(member_name[0], '*', '(')) {
+        /* The tables of curve maps are computed from their points, which are added below. */
+        if (is_curve_map) {
+          continue;
+        }
+        const int pointers_num = member_size / sdna.pointer_size;
+        for (const int pointer_i : IndexRange(pointers_num)) {
+          if (reinterpret_cast<const void *const *>(member_data)[pointer_i] != nullptr) {
+            return false;
+          }
+        }
+        continue;
+      }
+
+      const int member_struct_index = DNA_struct_find_index_without_alias(
+          &sdna, sdna.types[member.type_index]);
+      if (member_struct_index == -1) {
+        builder.add_bytes(member_data, member_size);
+        continue;
+      }
+
+      if (!add_dna_struct_key(builder,
+                              sdna,
+                              *sdna.structs[member_struct_index],
+                              member_data,
+                              sdna.members_array_num[member.member_index]))
+      {
+        return false;
+      }
+    }
+
+    if (is_curve_map) {
+      const CurveMap &curve_map = *reinterpret_cast<const CurveMap *>(element_data);
+      builder.add_bytes(curve_map.curve, sizeof(CurveMapPoint) * curve_map.totpoint);
+    }
+  }
+  return true;
+}
+
+/* Adds the storage of the node. Returns false if the storage is not a DNA struct or it has
+ * pointers, see add_dna_struct_key. */
+static bool add_node_storage_key(NodeKeyBuilder &builder, const bNode &node)
+{
+  if (!node.storage) {
+    return true;
+  }
+
+  const SDNA &sdna = *DNA_sdna_current_get();
+  const int struct_index = DNA_struct_find_index_without_alias(
+      &sdna, node.typeinfo->storagename.c_str());
+  if (struct_index == -1) {
+    return false;
+  }
+
+  return add_dna_struct_key(builder, sdna, *sdna.structs[struct_index], node.storage, 1);
+}
+
+/* Adds the value of an unlinked input. Returns false if the value of the socket type is not known
+ * to the compositor. */
+static bool add_socket_value_key(NodeKeyBuilder &builder, const bNodeSocket &socket)
+{
+  builder.add(socket.type);
+  switch (socket.type) {
+    case SOCK_FLOAT:
+      builder.add(socket.default_value_typed<bNodeSocketValueFloat>()->value);
+      return true;
+    case SOCK_INT:
+      builder.add(socket.default_value_typed<bNodeSocketValueInt>()->value);
+      return true;
+    case SOCK_BOOLEAN:
+      builder.add(socket.default_value_typed<bNodeSocketValueBoolean>()->value);
+      return true;
+    case SOCK_VECTOR:
+      builder.add(socket.default_value_typed<bNodeSocketValueVector>()->value);
+      return true;
+    case SOCK_RGBA:
+      builder.add(socket.default_value_typed<bNodeSocketValueRGBA>()->value);
+      return true;
+    case SOCK_MENU:
+      builder.add(socket.default_value_typed<bNodeSocketValueMenu>()->value);
+      return true;
+    case SOCK_STRING:
+      builder.add_string(socket.default_value_typed<bNodeSocketValueString>()->value);
+      return true;
+    default:
+      return false;
+  }
+}
+
+/* Adds the state of the context that nodes can depend on. */
+static void add_context_key(NodeKeyBuilder &builder, const Context &context)
+{
+  builder.add(context.get_precision());
+  builder.add(context.get_render_size());
+  builder.add(context.get_compositing_region());
+  builder.add(context.get_render_percentage());
+  builder.add(context.get_denoise_quality());
+  builder.add_string(context.get_view_name());
+}
+
+/* Adds the ID referenced by the node. Returns false if the result of the node can't be cached
+ * because the ID can change without the node tree changing, which is the case for all IDs except
+ * still images, whose changes are tracked by their update count. */
+static bool add_node_id_key(NodeKeyBuilder &builder, ID &id)
+{
+  if (GS(id.name) != ID_IM) {
+    return false;
+  }
+
+  Image &image = reinterpret_cast<Image &>(id);
+  if (!ELEM(image.type, IMA_TYPE_IMAGE, IMA_TYPE_MULTILAYER) || BKE_image_is_animated(&image)) {
+    return false;
+  }
+
+  builder.add(id.session_uid);
+  builder.add(image.runtime.update_count);
+  return true;
+}
+
+/* Returns true if the result of the node depends on the current frame or other scene data that is
+ * not part of the node tree. */
+static bool is_time_dependent_node(const DNode &node)
+{
+  return ELEM(node->type_legacy, CMP_NODE_TIME, CMP_NODE_SCENE_TIME, CMP_NODE_DEFOCUS);
+}
+
+static uint64_t compute_output_key(const uint64_t node_key, const bNodeSocket &output)
+{
+  return get_default_hash(node_key, StringRef(output.identifier));
+}
+
+void Evaluator::compute_node_keys(const Schedule &schedule)
+{
+  /* Results are only cached on the CPU, see CachedNodeResult. */
+  if (context_.use_gpu() || U.memcachelimit <= 0) {
+    return;
+  }
+
+  NodeKeyBuilder context_builder;
+  add_context_key(context_builder, context_);
+  const uint64_t context_key = context_builder.hash();
+
+  /* The schedule is such that the nodes that a node depends on come before it, so their keys are
+   * already computed. */
+  for (const DNode &node : schedule) {
+    if (is_time_dependent_node(node)) {
+      continue;
+    }
+
+    NodeKeyBuilder builder;
+    builder.add(context_key);
+    builder.add_string(node->idname);
+    builder.add(node->is_muted());
+    builder.add(node->custom1);
+    builder.add(node->custom2);
+    builder.add(node->custom3);
+    builder.add(node->custom4);
+    if (!add_node_storage_key(builder, *node)) {
+      continue;
+    }
+    if (node->id && !add_node_id_key(builder, *node->id)) {
+      continue;
+    }
+
+    bool has_key = true;
+    for (const bNodeSocket *input : node->input_sockets()) {
+      if (!input->is_available()) {
+        continue;
+      }
+
+      /* Unlinked inputs are identified by their value, linked inputs by the key of the output they
+       * are linked to, which is missing if the origin node can't be cached. */
+      const DSocket origin = get_input_origin_socket(DInputSocket(node.context(), input));
+      if (origin->is_input()) {
+        if (!add_socket_value_key(builder, *origin)) {
+          has_key = false;
+          break;
+        }
+        continue;
+      }
+
+      const uint64_t *origin_key = node_keys_.lookup_ptr(origin.node());
+      if (!origin_key) {
+        has_key = false;
+        break;
+      }
+      builder.add(compute_output_key(*origin_key, *origin));
+    }
+
+    if (has_key) {
+      node_keys_.add_new(node, builder.hash());
+    }
+  }
+}
+
+bool Evaluator::is_cacheable_node(const DNode &node)
+{
+  /* Pixel nodes are cheap to evaluate compared to storing their results, but they still have
+   * keys for the nodes that depend on them. */
+  if (is_pixel_node(node) || !node_keys_.contains(node)) {
+    return false;
+  }
+
+  /* Previews are computed while evaluating the node, so nodes whose previews are needed are always
+   * evaluated. */
+  if (bool(context_.needed_outputs() & OutputTypes::Previews) && is_node_preview_needed(node)) {
+    return false;
+  }
+
+  return true;
+}
+
+Schedule Evaluator::compute_pruned_schedule(const Schedule &schedule)
+{
+  if (node_keys_.is_empty()) {
+    return schedule;
+  }
+
+  CachedNodeResultContainer &node_results = context_.cache_manager().node_results;
+  node_results.set_memory_limit(int64_t(U.memcachelimit) * 1024 * 1024);
+
+  /* Go over the schedule in reverse, such that the nodes that use the outputs of a node are
+   * visited before it, and find the nodes that are needed. A node is needed if it is an output
+   * node, that is, none of its outputs are used by scheduled nodes, or if any of its outputs are
+   * used by a needed node that will be evaluated. A needed node whose used outputs are all cached
+   * need not be evaluated, and the nodes it depends on are not needed for it. */
+  Set<DNode> needed_nodes;
+  for (int i = schedule.size() - 1; i >= 0; i--) {
+    const DNode &node = schedule[i];
+    const std::optional<uint64_t> node_key = node_keys_.lookup_try(node);
+    bool is_output_node = true;
+    bool is_used = false;
+    bool is_cached = this->is_cacheable_node(node);
+    Vector<uint64_t> used_output_keys;
+    for (const bNodeSocket *output : node->output_sockets()) {
+      if (!output->is_available()) {
+        continue;
+      }
+
+      const DOutputSocket doutput(node.context(), output);
+      if (number_of_inputs_linked_to_output_conditioned(
+              doutput, [&](DInputSocket input) { return schedule.contains(input.node()); }) == 0)
+      {
+        continue;
+      }
+      is_output_node = false;
+
+      if (number_of_inputs_linked_to_output_conditioned(doutput, [&](DInputSocket input) {
+            return needed_nodes.contains(input.node()) && !cached_nodes_.contains(input.node());
+          }) == 0)
+      {
+        continue;
+      }
+      is_used = true;
+
+      if (is_cached) {
+        const uint64_t output_key = compute_output_key(*node_key, *output);
+        is_cached = node_results.contains(output_key);
+        used_output_keys.append(output_key);
+      }
+    }
+
+    if (is_output_node) {
+      needed_nodes.add_new(node);
+    }
+    else if (is_used) {
+      needed_nodes.add_new(node);
+      if (is_cached) {
+        cached_nodes_.add_new(node);
+        /* Nodes evaluated before this one add their results to the cache, which must not evict
+         * the results of this node, since the nodes that compute them are skipped. */
+        for (const uint64_t output_key : used_output_keys) {
+          node_results.pin(output_key);
+        }
+      }
+    }
+  }
+
+  Schedule pruned_schedule;
+  for (const DNode &node : schedule) {
+    if (needed_nodes.contains(node)) {
+      pruned_schedule.add_new(node);
+    }
+  }
+  return pruned_schedule;
+}
+
+void Evaluator::evaluate_cached_node(DNode node, CompileState &compile_state)
+{
+  NodeOperation *operation = node->typeinfo->get_compositor_operation(context_, node);
+
+  compile_state.map_node_to_node_operation(node, operation);
+
+  operations_stream_.append(std::unique_ptr<Operation>(operation));
+
+  operation->compute_results_reference_counts(compile_state.get_schedule());
+
+  CachedNodeResultContainer &node_results = context_.cache_manager().node_results;
+  const uint64_t node_key = node_keys_.lookup(node);
+  for (const bNodeSocket *output : node->output_sockets()) {
+    if (!output->is_available()) {
+      continue;
+    }
+
+    /* Outputs that are only used by other cached nodes might not be cached, but they are not
+     * read either, so they can be left unallocated. */
+    Result &result = operation->get_result(output->identifier);
+    const uint64_t output_key = compute_output_key(node_key, *output);
+    if (result.should_compute() && node_results.contains(output_key)) {
+      result.share_data(node_results.get(output_key));
+    }
+  }
+
+  /* The inputs of the node are not needed, but the results of the scheduled nodes it is linked to
+   * still count it as one of their users, so release them as if the node was evaluated. */
+  for (const bNodeSocket *input : node->input_sockets()) {
+    if (!input->is_available()) {
+      continue;
+    }
+
+    const DSocket origin = get_input_origin_socket(DInputSocket(node.context(), input));
+    if (origin->is_output() && compile_state.get_schedule().contains(origin.node())) {
+      compile_state.get_result_from_output_socket(DOutputSocket(origin)).release();
+    }
+  }
+}
+
+void Evaluator::cache_node_results(DNode node, NodeOperation &operation)
+{
+  if (!this->is_cacheable_node(node)) {
+    return;
+  }
+
+  CachedNodeResultContainer &node_results = context_.cache_manager().node_results;
+  const uint64_t node_key = node_keys_.lookup(node);
+  for (const bNodeSocket *output : node->output_sockets()) {
+    if (output->is_available()) {
+      node_results.add(context_,
+                       compute_output_key(node_key, *output),
+                       operation.get_result(output->identifier));
+    }
+  }
+}
+
 void Evaluator::cancel_evaluation()
 {
   context_.cache_manager().skip_next_reset();
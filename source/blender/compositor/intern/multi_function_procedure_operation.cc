@@ -9,9 +9,11 @@
 #include "BLI_color.hh"
 #include "BLI_cpp_type.hh"
 #include "BLI_generic_span.hh"
+#include "BLI_generic_virtual_array.hh"
 #include "BLI_index_mask.hh"
 #include "BLI_map.hh"
 #include "BLI_math_base.hh"
+#include "BLI_math_matrix_types.hh"
 #include "BLI_math_vector_types.hh"
 #include "BLI_string_ref.hh"
 #include "BLI_vector.hh"
@@ -33,10 +35,12 @@
 #include "NOD_multi_function.hh"
 
 #include "COM_context.hh"
+#include "COM_conversion_operation.hh"
 #include "COM_domain.hh"
 #include "COM_input_descriptor.hh"
 #include "COM_multi_function_procedure_operation.hh"
 #include "COM_pixel_operation.hh"
+#include "COM_realize_on_domain_operation.hh"
 #include "COM_result.hh"
 #include "COM_scheduler.hh"
 #include "COM_utilities.hh"
@@ -54,6 +58,66 @@ MultiFunctionProcedureOperation::MultiFunctionProcedureOperation(Context &contex
   procedure_executor_ = std::make_unique<mf::ProcedureExecutor>(procedure_);
 }
 
+/* A virtual array that realizes an input on the domain of the operation on the fly, that is, it
+ * samples the input at the pixels that are read by the procedure executor. Since the executor
+ * evaluates the procedure in chunks of pixels, this only ever materializes a chunk worth of
+ * realized pixels at a time, as opposed to a full realized copy of the input, see the
+ * add_and_evaluate_input_processors method. */
+class GVArray_For_RealizedInput : public GVArrayImpl {
+ private:
+  const Result &input_;
+  float3x3 inverse_transformation_;
+  int width_;
+
+ public:
+  GVArray_For_RealizedInput(const Result &input, const Domain &target_domain)
+      : GVArrayImpl(input.get_cpp_type(), int64_t(target_domain.size.x) * target_domain.size.y),
+        input_(input),
+        inverse_transformation_(
+            RealizeOnDomainOperation::compute_inverse_transformation(input, target_domain)),
+        width_(target_domain.size.x)
+  {
+  }
+
+  void get_to_uninitialized(const int64_t index, void *r_value) const override
+  {
+    type_->copy_construct(this->sample(index), r_value);
+  }
+
+  void materialize(const IndexMask &mask, void *dst) const override
+  {
+    this->materialize_to_uninitialized(mask, dst);
+  }
+
+  void materialize_to_uninitialized(const IndexMask &mask, void *dst) const override
+  {
+    mask.foreach_index_optimized<int64_t>([&](const int64_t i) {
+      type_->copy_construct(this->sample(i), POINTER_OFFSET(dst, type_->size * i));
+    });
+  }
+
+  void materialize_compressed(const IndexMask &mask, void *dst) const override
+  {
+    this->materialize_compressed_to_uninitialized(mask, dst);
+  }
+
+  void materialize_compressed_to_uninitialized(const IndexMask &mask, void *dst) const override
+  {
+    mask.foreach_index_optimized<int64_t>([&](const int64_t i, const int64_t pos) {
+      type_->copy_construct(this->sample(i), POINTER_OFFSET(dst, type_->size * pos));
+    });
+  }
+
+ private:
+  /* Realized inputs are of float types, whose CPP types can be constructed from the first
+   * channels of the sampled float4, see Result::store_pixel_generic_type. */
+  float4 sample(const int64_t index) const
+  {
+    const int2 texel = int2(int(index % width_), int(index / width_));
+    return RealizeOnDomainOperation::sample_realized(input_, inverse_transformation_, texel);
+  }
+};
+
 void MultiFunctionProcedureOperation::execute()
 {
   const Domain domain = compute_domain();
@@ -68,9 +132,20 @@ void MultiFunctionProcedureOperation::execute()
   for (int i = 0; i < procedure_.params().size(); i++) {
     if (procedure_.params()[i].type == mf::ParamType::InterfaceType::Input) {
       const Result &input = get_input(parameter_identifiers_[i]);
+      const Domain *realization_domain = fused_realization_domains_.lookup_ptr(
+          parameter_identifiers_[i]);
       if (input.is_single_value()) {
         parameter_builder.add_readonly_single_input(input.single_value());
       }
+      else if (realization_domain) {
+        parameter_builder.add_readonly_single_input(
+            GVArray::For<GVArray_For_RealizedInput>(input, *realization_domain));
+        if (this->context().profiler()) {
+          this->context().profiler()->add_realized_bytes(
+              int64_t(realization_domain->size.x) * realization_domain->size.y *
+              input.get_cpp_type().size);
+        }
+      }
       else {
         parameter_builder.add_readonly_single_input(input.cpu_data());
       }
@@ -103,6 +178,57 @@ void MultiFunctionProcedureOperation::execute()
   }
 }
 
+void MultiFunctionProcedureOperation::add_and_evaluate_input_processors()
+{
+  /* The GPU realizes inputs using dedicated shaders, so keep the default processors. */
+  if (this->context().use_gpu()) {
+    PixelOperation::add_and_evaluate_input_processors();
+    return;
+  }
+
+  /* See the base method for why each processor type is added to all inputs first. */
+  for (const int i : procedure_.params().index_range()) {
+    if (procedure_.params()[i].type != mf::ParamType::InterfaceType::Input) {
+      continue;
+    }
+    const StringRef identifier = parameter_identifiers_[i];
+    this->add_and_evaluate_input_processor(
+        identifier,
+        ConversionOperation::construct_if_needed(
+            this->context(), this->get_input(identifier), this->get_input_descriptor(identifier)));
+  }
+
+  /* Realizing an input on the domain of the operation would allocate a full copy of the input
+   * only for the procedure to read it once, so if the operation domain is already realized, fuse
+   * the realization into the procedure instead, sampling the input on the fly as the pixels are
+   * evaluated, see GVArray_For_RealizedInput. Otherwise, the domain of the operation changes
+   * after realization, so the realization processor is still needed. */
+  for (const int i : procedure_.params().index_range()) {
+    if (procedure_.params()[i].type != mf::ParamType::InterfaceType::Input) {
+      continue;
+    }
+    const StringRef identifier = parameter_identifiers_[i];
+    const Domain operation_domain = this->compute_domain();
+    std::unique_ptr<SimpleOperation> realize_on_domain(
+        RealizeOnDomainOperation::construct_if_needed(this->context(),
+                                                      this->get_input(identifier),
+                                                      this->get_input_descriptor(identifier),
+                                                      operation_domain));
+    if (!realize_on_domain) {
+      continue;
+    }
+
+    const Domain &target_domain =
+        static_cast<RealizeOnDomainOperation *>(realize_on_domain.get())->target_domain();
+    if (target_domain == operation_domain) {
+      fused_realization_domains_.add_new(identifier, target_domain);
+      continue;
+    }
+
+    this->add_and_evaluate_input_processor(identifier, realize_on_domain.release());
+  }
+}
+
 void MultiFunctionProcedureOperation::build_procedure()
 {
   for (DNode node : compile_unit_) {
@@ -17,6 +17,7 @@
 #include "COM_input_descriptor.hh"
 #include "COM_node_operation.hh"
 #include "COM_operation.hh"
+#include "COM_profiler.hh"
 #include "COM_result.hh"
 #include "COM_scheduler.hh"
 #include "COM_utilities.hh"
@@ -63,6 +64,16 @@ void NodeOperation::compute_preview()
   }
 }
 
+ProfiledOperationType NodeOperation::profiled_type() const
+{
+  return ProfiledOperationType::Node;
+}
+
+std::string NodeOperation::profiled_name() const
+{
+  return node_->name;
+}
+
 Result *NodeOperation::get_preview_result()
 {
   /* Find the first linked output. */
@@ -13,6 +13,7 @@
 #include "COM_domain.hh"
 #include "COM_input_descriptor.hh"
 #include "COM_operation.hh"
+#include "COM_profiler.hh"
 #include "COM_realize_on_domain_operation.hh"
 #include "COM_result.hh"
 #include "COM_simple_operation.hh"
@@ -25,6 +26,11 @@ Operation::~Operation() = default;
 
 void Operation::evaluate()
 {
+  Profiler *profiler = context().profiler();
+  if (profiler) {
+    profiler->begin_operation(this->profiled_type(), this->profiled_name());
+  }
+
   evaluate_input_processors();
 
   execute();
@@ -33,6 +39,10 @@ void Operation::evaluate()
 
   release_inputs();
 
+  if (profiler) {
+    profiler->end_operation();
+  }
+
   context().evaluate_operation_post();
 }
 
@@ -135,6 +145,16 @@ void Operation::add_and_evaluate_input_processor(StringRef identifier, SimpleOpe
 
 void Operation::compute_preview(){};
 
+ProfiledOperationType Operation::profiled_type() const
+{
+  return ProfiledOperationType::Input;
+}
+
+std::string Operation::profiled_name() const
+{
+  return profiled_operation_type_name(this->profiled_type());
+}
+
 Result &Operation::get_input(StringRef identifier) const
 {
   return *results_mapped_to_inputs_.lookup(identifier);
@@ -15,6 +15,7 @@
 #include "COM_multi_function_procedure_operation.hh"
 #include "COM_operation.hh"
 #include "COM_pixel_operation.hh"
+#include "COM_profiler.hh"
 #include "COM_result.hh"
 #include "COM_scheduler.hh"
 #include "COM_shader_operation.hh"
@@ -53,6 +54,20 @@ void PixelOperation::compute_preview()
   }
 }
 
+ProfiledOperationType PixelOperation::profiled_type() const
+{
+  return ProfiledOperationType::Pixel;
+}
+
+std::string PixelOperation::profiled_name() const
+{
+  std::string name;
+  for (const DNode &node : compile_unit_) {
+    name += name.empty() ? node->name : std::string(", ") + node->name;
+  }
+  return name;
+}
+
 StringRef PixelOperation::get_output_identifier_from_output_socket(DOutputSocket output_socket)
 {
   return output_sockets_to_output_identifiers_map_.lookup(output_socket);
@@ -2,6 +2,13 @@
  *
  * SPDX-License-Identifier: GPL-2.0-or-later */
 
+#include <algorithm>
+#include <cstdio>
+#include <mutex>
+
+#include "BLI_fileops.hh"
+#include "BLI_serialize.hh"
+#include "BLI_set.hh"
 #include "BLI_timeit.hh"
 
 #include "DNA_node_types.h"
@@ -68,4 +75,212 @@ void Profiler::finalize(const bNodeTree &node_tree)
   this->accumulate_node_group_times(node_tree, bke::NODE_INSTANCE_KEY_BASE);
 }
 
+void Profiler::begin_operation(const ProfiledOperationType type, std::string name)
+{
+  std::scoped_lock lock(memory_mutex_);
+
+  OperationEvent event;
+  event.type = type;
+  event.name = std::move(name);
+  event.start = timeit::Clock::now();
+  event.peak_memory = memory_usage_;
+  this->update_memory_integral(event.start);
+  event.start_memory_integral = memory_integral_;
+
+  operations_stack_.append(operation_events_.append_and_get_index(std::move(event)));
+}
+
+void Profiler::end_operation()
+{
+  std::scoped_lock lock(memory_mutex_);
+
+  const timeit::TimePoint end = timeit::Clock::now();
+  this->update_memory_integral(end);
+
+  OperationEvent &event = operation_events_[operations_stack_.pop_last()];
+  event.duration = end - event.start;
+  if (event.duration.count() > 0) {
+    event.average_memory = int64_t((memory_integral_ - event.start_memory_integral) /
+                                   double(event.duration.count()));
+  }
+  else {
+    event.average_memory = memory_usage_;
+  }
+
+  if (event.type == ProfiledOperationType::Conversion) {
+    event.conversions_time += event.duration;
+  }
+
+  /* Conversions time is accumulated at the end of operations, as opposed to the other statistics
+   * which are added to all operations in the stack as they happen. */
+  if (!operations_stack_.is_empty()) {
+    operation_events_[operations_stack_.last()].conversions_time += event.conversions_time;
+  }
+}
+
+void Profiler::add_result_allocation(const void *data, const int64_t size_in_bytes)
+{
+  std::scoped_lock lock(memory_mutex_);
+
+  const timeit::TimePoint time = timeit::Clock::now();
+  this->update_memory_integral(time);
+
+  live_allocations_.add_overwrite(data, size_in_bytes);
+  memory_usage_ += size_in_bytes;
+  memory_samples_.append({time, memory_usage_});
+
+  for (const int64_t event_index : operations_stack_) {
+    OperationEvent &event = operation_events_[event_index];
+    event.allocations_count++;
+    event.allocated_bytes += size_in_bytes;
+    event.peak_memory = std::max(event.peak_memory, memory_usage_);
+  }
+}
+
+void Profiler::remove_result_allocation(const void *data)
+{
+  std::scoped_lock lock(memory_mutex_);
+
+  /* The data was allocated before profiling started, so it was never tracked. */
+  const std::optional<int64_t> size_in_bytes = live_allocations_.pop_try(data);
+  if (!size_in_bytes) {
+    return;
+  }
+
+  const timeit::TimePoint time = timeit::Clock::now();
+  this->update_memory_integral(time);
+
+  memory_usage_ -= *size_in_bytes;
+  memory_samples_.append({time, memory_usage_});
+}
+
+void Profiler::add_realized_bytes(const int64_t size_in_bytes)
+{
+  std::scoped_lock lock(memory_mutex_);
+
+  for (const int64_t event_index : operations_stack_) {
+    operation_events_[event_index].realized_bytes += size_in_bytes;
+  }
+}
+
+void Profiler::update_memory_integral(const timeit::TimePoint time)
+{
+  const timeit::Nanoseconds elapsed_time = time - last_memory_change_time_;
+  memory_integral_ += double(memory_usage_) * double(elapsed_time.count());
+  last_memory_change_time_ = time;
+}
+
+/* Trace event timestamps and durations are in microseconds. */
+static double to_trace_time(const timeit::Nanoseconds time)
+{
+  return double(time.count()) / 1000.0;
+}
+
+static double to_trace_time(const timeit::TimePoint time)
+{
+  return to_trace_time(std::chrono::duration_cast<timeit::Nanoseconds>(time.time_since_epoch()));
+}
+
+void Profiler::write_chrome_trace(StringRefNull filepath)
+{
+  using namespace io::serialize;
+
+  /* Files are written from scratch the first time they are written by this process, and appended
+   * to afterwards, such that the events of all evaluations end up in the same file. */
+  static std::mutex files_mutex;
+  static Set<std::string> written_files;
+  std::scoped_lock files_lock(files_mutex);
+  std::scoped_lock memory_lock(memory_mutex_);
+
+  Vector<std::unique_ptr<DictionaryValue>> events;
+
+  for (const OperationEvent &operation_event : operation_events_) {
+    std::unique_ptr<DictionaryValue> event = std::make_unique<DictionaryValue>();
+    event->append_str("name", operation_event.name);
+    event->append_str("cat", profiled_operation_type_name(operation_event.type).c_str());
+    event->append_str("ph", "X");
+    event->append_double("ts", to_trace_time(operation_event.start));
+    event->append_double("dur", to_trace_time(operation_event.duration));
+    event->append_int("pid", 1);
+    event->append_int("tid", 1);
+
+    std::shared_ptr<DictionaryValue> arguments = event->append_dict("args");
+    arguments->append_int("allocations_count", operation_event.allocations_count);
+    arguments->append_int("allocated_bytes", operation_event.allocated_bytes);
+    if (operation_event.allocations_count != 0) {
+      arguments->append_int("average_result_bytes",
+                            operation_event.allocated_bytes / operation_event.allocations_count);
+    }
+    arguments->append_int("peak_memory_bytes", operation_event.peak_memory);
+    arguments->append_int("average_memory_bytes", operation_event.average_memory);
+    arguments->append_int("realized_bytes", operation_event.realized_bytes);
+    arguments->append_double("conversions_time_us",
+                             to_trace_time(operation_event.conversions_time));
+    events.append(std::move(event));
+  }
+
+  for (const std::pair<timeit::TimePoint, int64_t> &sample : memory_samples_) {
+    std::unique_ptr<DictionaryValue> event = std::make_unique<DictionaryValue>();
+    event->append_str("name", "Results Memory");
+    event->append_str("ph", "C");
+    event->append_double("ts", to_trace_time(sample.first));
+    event->append_int("pid", 1);
+    event->append_dict("args")->append_int("bytes", sample.second);
+    events.append(std::move(event));
+  }
+
+  const bool is_new_file = written_files.add(filepath.c_str());
+  if (!is_new_file && events.is_empty()) {
+    return;
+  }
+
+  fstream file;
+  if (is_new_file) {
+    file.open(filepath, std::ios::out | std::ios::trunc | std::ios::binary);
+  }
+  else {
+    file.open(filepath, std::ios::in | std::ios::out | std::ios::binary);
+  }
+  if (!file.is_open()) {
+    fprintf(stderr, "Compositor: cannot write profile to '%s'\n", filepath.c_str());
+    return;
+  }
+
+  if (is_new_file) {
+    file << R"([{"name":"process_name","ph":"M","pid":1,"args":{"name":"Compositor"}})";
+  }
+  else {
+    /* Overwrite the closing "\n]\n" of the array written by the previous call. */
+    file.seekp(-3, std::ios::end);
+  }
+
+  JsonFormatter formatter;
+  for (const std::unique_ptr<DictionaryValue> &event : events) {
+    file << ",\n";
+    formatter.serialize(file, *event);
+  }
+  file << "\n]\n";
+}
+
+StringRefNull profiled_operation_type_name(const ProfiledOperationType type)
+{
+  switch (type) {
+    case ProfiledOperationType::Evaluation:
+      return "Evaluation";
+    case ProfiledOperationType::Node:
+      return "Node";
+    case ProfiledOperationType::Pixel:
+      return "Pixel Operation";
+    case ProfiledOperationType::Conversion:
+      return "Conversion";
+    case ProfiledOperationType::Realization:
+      return "Realization";
+    case ProfiledOperationType::Input:
+      return "Input";
+  }
+
+  BLI_assert_unreachable();
+  return "";
+}
+
 }  // namespace blender::compositor
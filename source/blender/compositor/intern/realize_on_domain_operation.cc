@@ -16,6 +16,7 @@
 #include "COM_context.hh"
 #include "COM_domain.hh"
 #include "COM_input_descriptor.hh"
+#include "COM_profiler.hh"
 #include "COM_result.hh"
 #include "COM_utilities.hh"
 
@@ -39,34 +40,79 @@ RealizeOnDomainOperation::RealizeOnDomainOperation(Context &context,
 }
 
 void RealizeOnDomainOperation::execute()
+{
+  const float3x3 inverse_transformation = compute_inverse_transformation(this->get_input(),
+                                                                         this->compute_domain());
+
+  if (this->context().use_gpu()) {
+    this->realize_on_domain_gpu(inverse_transformation);
+  }
+  else {
+    this->realize_on_domain_cpu(inverse_transformation);
+  }
+
+  if (this->context().profiler()) {
+    this->context().profiler()->add_realized_bytes(this->get_result().size_in_bytes());
+  }
+}
+
+float3x3 RealizeOnDomainOperation::compute_inverse_transformation(const Result &input,
+                                                                  const Domain &target_domain)
 {
   /* Translate the input such that it is centered in the virtual compositing space. Adding any
    * corrective translation if necessary. */
-  const float2 input_center_translation = float2(-float2(this->get_input().domain().size) / 2.0f);
+  const float2 input_center_translation = float2(-float2(input.domain().size) / 2.0f);
   const float3x3 input_transformation = math::translate(
-      this->get_input().domain().transformation,
-      input_center_translation + this->compute_corrective_translation());
+      input.domain().transformation,
+      input_center_translation + compute_corrective_translation(input, target_domain));
 
   /* Translate the output such that it is centered in the virtual compositing space. */
-  const float2 output_center_translation = -float2(this->compute_domain().size) / 2.0f;
-  const float3x3 output_transformation = math::translate(this->compute_domain().transformation,
+  const float2 output_center_translation = -float2(target_domain.size) / 2.0f;
+  const float3x3 output_transformation = math::translate(target_domain.transformation,
                                                          output_center_translation);
 
   /* Get the transformation from the output space to the input space */
-  const float3x3 inverse_transformation = math::invert(input_transformation) *
-                                          output_transformation;
+  return math::invert(input_transformation) * output_transformation;
+}
 
-  if (this->context().use_gpu()) {
-    this->realize_on_domain_gpu(inverse_transformation);
-  }
-  else {
-    this->realize_on_domain_cpu(inverse_transformation);
+float4 RealizeOnDomainOperation::sample_realized(const Result &input,
+                                                 const float3x3 &inverse_transformation,
+                                                 const int2 &texel)
+{
+  /* Add 0.5 to evaluate the input sampler at the center of the pixel. */
+  float2 coordinates = float2(texel) + float2(0.5f);
+
+  /* Transform the input image by transforming the domain coordinates with the inverse of input
+   * image's transformation. The inverse transformation is an affine matrix and thus the
+   * coordinates should be in homogeneous coordinates. */
+  coordinates = (inverse_transformation * float3(coordinates, 1.0f)).xy();
+
+  /* Subtract the offset and divide by the input image size to get the relevant coordinates into
+   * the sampler's expected [0, 1] range. */
+  const int2 input_size = input.domain().size;
+  float2 normalized_coordinates = coordinates / float2(input_size);
+
+  const RealizationOptions &realization_options = input.get_realization_options();
+  switch (realization_options.interpolation) {
+    case Interpolation::Nearest:
+      return input.sample_nearest_wrap(
+          normalized_coordinates, realization_options.repeat_x, realization_options.repeat_y);
+    case Interpolation::Bilinear:
+      return input.sample_bilinear_wrap(
+          normalized_coordinates, realization_options.repeat_x, realization_options.repeat_y);
+    case Interpolation::Bicubic:
+      return input.sample_cubic_wrap(
+          normalized_coordinates, realization_options.repeat_x, realization_options.repeat_y);
   }
+
+  BLI_assert_unreachable();
+  return float4(0.0f);
 }
 
-float2 RealizeOnDomainOperation::compute_corrective_translation()
+float2 RealizeOnDomainOperation::compute_corrective_translation(const Result &input,
+                                                                const Domain &target_domain)
 {
-  if (this->get_input().get_realization_options().interpolation == Interpolation::Nearest) {
+  if (input.get_realization_options().interpolation == Interpolation::Nearest) {
     /* Bias translations in case of nearest interpolation to avoids the round-to-even behavior of
      * some GPUs at pixel boundaries. */
     return float2(std::numeric_limits<float>::epsilon() * 10e3f);
@@ -77,8 +123,8 @@ float2 RealizeOnDomainOperation::compute_corrective_translation()
    * to the centering translation. Which introduce fuzzy result due to interpolation. So if one
    * is odd and the other is even, detected by testing the low bit of the xor of the sizes, shift
    * the input by 1/2 pixel so the pixels align. */
-  const int2 output_size = this->compute_domain().size;
-  const int2 input_size = this->get_input().domain().size;
+  const int2 output_size = target_domain.size;
+  const int2 input_size = input.domain().size;
   return float2(((input_size[0] ^ output_size[0]) & 1) ? -0.5f : 0.0f,
                 ((input_size[1] ^ output_size[1]) & 1) ? -0.5f : 0.0f);
 }
@@ -171,45 +217,27 @@ void RealizeOnDomainOperation::realize_on_domain_cpu(const float3x3 &inverse_tra
   const Domain domain = this->compute_domain();
   output.allocate_texture(domain);
 
-  const RealizationOptions realization_options = input.get_realization_options();
   parallel_for(domain.size, [&](const int2 texel) {
-    /* Add 0.5 to evaluate the input sampler at the center of the pixel. */
-    float2 coordinates = float2(texel) + float2(0.5f);
-
-    /* Transform the input image by transforming the domain coordinates with the inverse of input
-     * image's transformation. The inverse transformation is an affine matrix and thus the
-     * coordinates should be in homogeneous coordinates. */
-    coordinates = (inverse_transformation * float3(coordinates, 1.0f)).xy();
-
-    /* Subtract the offset and divide by the input image size to get the relevant coordinates into
-     * the sampler's expected [0, 1] range. */
-    const int2 input_size = input.domain().size;
-    float2 normalized_coordinates = coordinates / float2(input_size);
-
-    float4 sample;
-    switch (realization_options.interpolation) {
-      case Interpolation::Nearest:
-        sample = input.sample_nearest_wrap(
-            normalized_coordinates, realization_options.repeat_x, realization_options.repeat_y);
-        break;
-      case Interpolation::Bilinear:
-        sample = input.sample_bilinear_wrap(
-            normalized_coordinates, realization_options.repeat_x, realization_options.repeat_y);
-        break;
-      case Interpolation::Bicubic:
-        sample = input.sample_cubic_wrap(
-            normalized_coordinates, realization_options.repeat_x, realization_options.repeat_y);
-        break;
-    }
-    output.store_pixel_generic_type(texel, sample);
+    output.store_pixel_generic_type(texel,
+                                    sample_realized(input, inverse_transformation, texel));
   });
 }
 
+const Domain &RealizeOnDomainOperation::target_domain() const
+{
+  return target_domain_;
+}
+
 Domain RealizeOnDomainOperation::compute_domain()
 {
   return target_domain_;
 }
 
+ProfiledOperationType RealizeOnDomainOperation::profiled_type() const
+{
+  return ProfiledOperationType::Realization;
+}
+
 /* If the transformations of the input and output domains are within this tolerance value, then
  * realization shouldn't be needed. */
 static constexpr float transformation_tolerance = 10e-6f;
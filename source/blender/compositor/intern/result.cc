@@ -23,6 +23,7 @@
 #include "COM_context.hh"
 #include "COM_derived_resources.hh"
 #include "COM_domain.hh"
+#include "COM_profiler.hh"
 #include "COM_result.hh"
 
 namespace blender::compositor {
@@ -559,6 +560,10 @@ void Result::free()
     return;
   }
 
+  if (context_->profiler()) {
+    context_->profiler()->remove_result_allocation(this->data_pointer());
+  }
+
   switch (storage_type_) {
     case ResultStorageType::GPU:
       if (is_from_pool_) {
@@ -582,6 +587,19 @@ void Result::free()
   derived_resources_ = nullptr;
 }
 
+const void *Result::data_pointer() const
+{
+  switch (storage_type_) {
+    case ResultStorageType::GPU:
+      return this->gpu_texture();
+    case ResultStorageType::CPU:
+      return this->cpu_data().data();
+  }
+
+  BLI_assert_unreachable();
+  return nullptr;
+}
+
 bool Result::should_compute()
 {
   return reference_count_ != 0;
@@ -636,11 +654,39 @@ bool Result::is_allocated() const
   return false;
 }
 
+bool Result::is_external() const
+{
+  return is_external_;
+}
+
 int Result::reference_count() const
 {
   return reference_count_;
 }
 
+int64_t Result::size_in_bytes() const
+{
+  if (!this->is_allocated()) {
+    return 0;
+  }
+
+  switch (storage_type_) {
+    case ResultStorageType::GPU: {
+      /* Half precision textures use 16-bit channels, while other textures use 32-bit channels. */
+      const int64_t channel_size = precision_ == ResultPrecision::Half ? 2 : 4;
+      const eGPUTextureFormat format = GPU_texture_format(this->gpu_texture());
+      return int64_t(GPU_texture_width(this->gpu_texture())) *
+             GPU_texture_height(this->gpu_texture()) * GPU_texture_component_len(format) *
+             channel_size;
+    }
+    case ResultStorageType::CPU:
+      return this->cpu_data().size_in_bytes();
+  }
+
+  BLI_assert_unreachable();
+  return 0;
+}
+
 GPointer Result::single_value() const
 {
   return std::visit([](const auto &value) { return GPointer(&value); }, single_value_);
@@ -718,6 +764,10 @@ void Result::allocate_data(int2 size, bool from_pool)
   }
 
   data_reference_count_ = new int(1);
+
+  if (context_->profiler()) {
+    context_->profiler()->add_result_allocation(this->data_pointer(), this->size_in_bytes());
+  }
 }
 
 }  // namespace blender::compositor
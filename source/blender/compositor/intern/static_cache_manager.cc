@@ -30,6 +30,7 @@ void StaticCacheManager::reset()
   fog_glow_kernels.reset();
   texture_coordinates.reset();
   pixel_coordinates.reset();
+  node_results.reset();
 }
 
 void StaticCacheManager::skip_next_reset()
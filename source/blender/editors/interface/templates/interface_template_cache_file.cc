@@ -127,6 +127,19 @@ void uiTemplateCacheFileTimeSettings(uiLayout *layout, PointerRNA *fileptr)
   row = uiLayoutRow(layout, false);
   uiItemR(row, fileptr, "frame_offset", UI_ITEM_NONE, std::nullopt, ICON_NONE);
   uiLayoutSetActive(row, !RNA_boolean_get(fileptr, "is_sequence"));
+
+  row = uiLayoutRowWithHeading(layout, true, IFACE_("Playback Prefetch"));
+  sub = uiLayoutRow(row, true);
+  uiLayoutSetPropDecorate(sub, false);
+  uiItemR(sub, fileptr, "use_playback_prefetch", UI_ITEM_NONE, "", ICON_NONE);
+  subsub = uiLayoutRow(sub, true);
+  uiLayoutSetActive(subsub, RNA_boolean_get(fileptr, "use_playback_prefetch"));
+  uiItemR(subsub, fileptr, "playback_prefetch_frames", UI_ITEM_NONE, IFACE_("Frames"), ICON_NONE);
+  uiItemDecoratorR(row, fileptr, "playback_prefetch_frames", 0);
+
+  row = uiLayoutRow(layout, false);
+  uiLayoutSetActive(row, RNA_boolean_get(fileptr, "use_playback_prefetch"));
+  uiItemR(row, fileptr, "playback_prefetch_cache_size", UI_ITEM_NONE, std::nullopt, ICON_NONE);
 }
 
 static void cache_file_layer_item(uiList * /*ui_list*/,
@@ -389,6 +389,14 @@ static std::string ui_template_status_tooltip(bContext *C,
     tooltip_message += RPT_(
         "This file is managed by the Blender asset system and cannot be overridden");
   }
+  if (bmain->is_partially_read) {
+    if (!tooltip_message.empty()) {
+      tooltip_message += "\n\n";
+    }
+    tooltip_message += RPT_(
+        "Only the data-blocks used by scenes and the UI were loaded, this file cannot be "
+        "overridden");
+  }
 
   return tooltip_message;
 }
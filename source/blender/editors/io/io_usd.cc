@@ -293,6 +293,7 @@ static wmOperatorStatus wm_usd_export_exec(bContext *C, wmOperator *op)
   const bool export_volumes = RNA_boolean_get(op->ptr, "export_volumes");
 
   const bool use_instancing = RNA_boolean_get(op->ptr, "use_instancing");
+  const bool deduplicate_meshes = RNA_boolean_get(op->ptr, "deduplicate_meshes");
   const bool evaluation_mode = RNA_enum_get(op->ptr, "evaluation_mode");
 
   const bool generate_preview_surface = RNA_boolean_get(op->ptr, "generate_preview_surface");
@@ -390,6 +391,7 @@ static wmOperatorStatus wm_usd_export_exec(bContext *C, wmOperator *op)
   params.convert_world_material = convert_world_material;
 
   params.use_instancing = use_instancing;
+  params.deduplicate_meshes = deduplicate_meshes;
   params.export_custom_properties = export_custom_properties;
   params.author_blender_name = author_blender_name;
   params.allow_unicode = allow_unicode;
@@ -560,6 +562,7 @@ static void wm_usd_export_draw(bContext *C, wmOperator *op)
   {
     uiLayout *col = uiLayoutColumn(panel, false);
     uiItemR(col, ptr, "use_instancing", UI_ITEM_NONE, std::nullopt, ICON_NONE);
+    uiItemR(col, ptr, "deduplicate_meshes", UI_ITEM_NONE, std::nullopt, ICON_NONE);
   }
 }
 
@@ -713,6 +716,13 @@ void WM_OT_usd_export(wmOperatorType *ot)
                   "Instancing",
                   "Export instanced objects as references in USD rather than real objects");
 
+  RNA_def_boolean(ot->srna,
+                  "deduplicate_meshes",
+                  false,
+                  "Deduplicate Meshes",
+                  "Write identical non-animated meshes only once, and reference them from all "
+                  "other objects using the same mesh data and materials");
+
   RNA_def_enum(ot->srna,
                "evaluation_mode",
                rna_enum_usd_export_evaluation_mode_items,
@@ -375,6 +375,9 @@ void ED_undosys_stack_memfile_id_changed_tag(UndoStack *ustack, ID *id)
       break;
     }
   }
+  /* Also ensure the ID is written again in the next undo step, even when the change was not
+   * tagged for the depsgraph. */
+  id->recalc_after_undo_push |= ID_RECALC_SYNC_TO_EVAL;
 }
 
 /** \} */
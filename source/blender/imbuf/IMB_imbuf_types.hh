@@ -242,6 +242,12 @@ struct ImBuf {
   /* memory cache limiter */
   /** reference counter for multiple users */
   int refcounter;
+  /**
+   * Called when the last user frees the image, before its data is freed. The creator can take
+   * back buffers it gave to the image this way, e.g. to reuse them. Not copied by duplication.
+   */
+  void (*free_callback)(ImBuf *ibuf, void *user_data);
+  void *free_callback_user_data;
 
   /* some parameters to pass along for packing images */
   /** Compressed image only used with PNG and EXR currently. */
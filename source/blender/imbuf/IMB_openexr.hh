@@ -18,7 +18,9 @@
 #define EXR_TOT_MAXNAME 64
 #define EXR_PASS_MAXCHAN 24
 
+struct ImBuf;
 struct StampData;
+struct rcti;
 
 void *IMB_exr_get_handle();
 void *IMB_exr_get_handle_name(const char *name);
@@ -88,3 +90,23 @@ void IMB_exr_add_view(void *handle, const char *name);
 bool IMB_exr_has_multilayer(void *handle);
 
 bool IMB_exr_get_ppm(void *handle, double ppm[2]);
+
+/**
+ * Load a region of a single part EXR file, decoding only the scan-lines or tiles that overlap it,
+ * so that large images don't have to be decoded and kept in memory completely.
+ *
+ * \param region: Pixels to load in Blender's bottom-up image space, relative to the data window
+ * of the mip-map level. The maximum bounds are exclusive. It's clamped to the image size.
+ * \param mip_level: Level of a tiled file with mip-maps, zero for the full resolution.
+ * \param channel_names: Names of up to 4 channels that are read into the channels of the image
+ * buffer, channels missing in the file are zero. When null, the color channels are read into RGBA
+ * like when loading the whole file.
+ * \return A float image buffer of the size of the clamped region, or null when the file can't be
+ * read or the region is empty. Unlike when loading the whole image, the pixels are not converted
+ * to the scene linear color space, the color space of the file is assigned to the float buffer.
+ */
+ImBuf *IMB_exr_load_region(const char *filepath,
+                           const rcti *region,
+                           int mip_level,
+                           const char *const *channel_names,
+                           int channels_num);
@@ -266,6 +266,9 @@ void IMB_freeImBuf(ImBuf *ibuf)
     BLI_assert_msg(!(ibuf->filepath[0] == '/' && ibuf->filepath[1] == '/'),
                    "'.blend' relative \"//\" must not be used in ImBuf!");
 
+    if (ibuf->free_callback) {
+      ibuf->free_callback(ibuf, ibuf->free_callback_user_data);
+    }
     IMB_free_all_data(ibuf);
     IMB_free_gpu_textures(ibuf);
     IMB_metadata_free(ibuf->metadata);
@@ -687,6 +690,8 @@ ImBuf *IMB_dupImBuf(const ImBuf *ibuf1)
 
   /* set malloc flag */
   tbuf.refcounter = 0;
+  tbuf.free_callback = nullptr;
+  tbuf.free_callback_user_data = nullptr;
 
   /* for now don't duplicate metadata */
   tbuf.metadata = nullptr;
@@ -63,6 +63,7 @@
 #include <OpenEXR/ImfOutputPart.h>
 #include <OpenEXR/ImfPartHelper.h>
 #include <OpenEXR/ImfPartType.h>
+#include <OpenEXR/ImfTiledInputPart.h>
 #include <OpenEXR/ImfTiledOutputPart.h>
 
 #include "DNA_scene_types.h" /* For OpenEXR compression constants */
@@ -78,13 +79,16 @@
 
 #include "MEM_guardedalloc.h"
 
+#include "BLI_array.hh"
 #include "BLI_fileops.h"
 #include "BLI_listbase.h"
 #include "BLI_math_base.hh"
 #include "BLI_math_color.h"
 #include "BLI_mmap.h"
 #include "BLI_path_utils.hh"
+#include "BLI_rect.h"
 #include "BLI_string.h"
+#include "BLI_task.hh"
 #include "BLI_threads.h"
 
 #include "BKE_idprop.hh"
@@ -573,49 +577,47 @@ static bool imb_save_openexr_half(ImBuf *ibuf, const char *filepath, const int f
 
     /* we store first everything in half array */
     std::unique_ptr<RGBAZ[]> pixels = std::unique_ptr<RGBAZ[]>(new RGBAZ[int64_t(height) * width]);
-    RGBAZ *to = pixels.get();
+    RGBAZ *first = pixels.get();
     int xstride = sizeof(RGBAZ);
     int ystride = xstride * width;
 
     /* indicate used buffers */
-    frameBuffer.insert("R", Slice(HALF, (char *)&to->r, xstride, ystride));
-    frameBuffer.insert("G", Slice(HALF, (char *)&to->g, xstride, ystride));
-    frameBuffer.insert("B", Slice(HALF, (char *)&to->b, xstride, ystride));
+    frameBuffer.insert("R", Slice(HALF, (char *)&first->r, xstride, ystride));
+    frameBuffer.insert("G", Slice(HALF, (char *)&first->g, xstride, ystride));
+    frameBuffer.insert("B", Slice(HALF, (char *)&first->b, xstride, ystride));
     if (is_alpha) {
-      frameBuffer.insert("A", Slice(HALF, (char *)&to->a, xstride, ystride));
-    }
-    if (ibuf->float_buffer.data) {
-      float *from;
-
-      for (int i = ibuf->y - 1; i >= 0; i--) {
-        from = ibuf->float_buffer.data + int64_t(channels) * i * width;
-
-        for (int j = ibuf->x; j > 0; j--) {
-          to->r = float_to_half_safe(from[0]);
-          to->g = float_to_half_safe((channels >= 2) ? from[1] : from[0]);
-          to->b = float_to_half_safe((channels >= 3) ? from[2] : from[0]);
-          to->a = float_to_half_safe((channels >= 4) ? from[3] : 1.0f);
-          to++;
-          from += channels;
-        }
-      }
-    }
-    else {
-      uchar *from;
-
-      for (int i = ibuf->y - 1; i >= 0; i--) {
-        from = ibuf->byte_buffer.data + int64_t(4) * i * width;
-
-        for (int j = ibuf->x; j > 0; j--) {
-          to->r = srgb_to_linearrgb(float(from[0]) / 255.0f);
-          to->g = srgb_to_linearrgb(float(from[1]) / 255.0f);
-          to->b = srgb_to_linearrgb(float(from[2]) / 255.0f);
-          to->a = channels >= 4 ? float(from[3]) / 255.0f : 1.0f;
-          to++;
-          from += 4;
-        }
-      }
-    }
+      frameBuffer.insert("A", Slice(HALF, (char *)&first->a, xstride, ystride));
+    }
+
+    /* Convert the rows in parallel, the file stores them top-down. */
+    blender::threading::parallel_for(
+        blender::IndexRange(height), 64, [&](const blender::IndexRange rows) {
+          for (const int64_t i : rows) {
+            RGBAZ *to = pixels.get() + (height - 1 - i) * width;
+            if (ibuf->float_buffer.data) {
+              const float *from = ibuf->float_buffer.data + int64_t(channels) * i * width;
+              for (int j = ibuf->x; j > 0; j--) {
+                to->r = float_to_half_safe(from[0]);
+                to->g = float_to_half_safe((channels >= 2) ? from[1] : from[0]);
+                to->b = float_to_half_safe((channels >= 3) ? from[2] : from[0]);
+                to->a = float_to_half_safe((channels >= 4) ? from[3] : 1.0f);
+                to++;
+                from += channels;
+              }
+            }
+            else {
+              const uchar *from = ibuf->byte_buffer.data + int64_t(4) * i * width;
+              for (int j = ibuf->x; j > 0; j--) {
+                to->r = srgb_to_linearrgb(float(from[0]) / 255.0f);
+                to->g = srgb_to_linearrgb(float(from[1]) / 255.0f);
+                to->b = srgb_to_linearrgb(float(from[2]) / 255.0f);
+                to->a = channels >= 4 ? float(from[3]) / 255.0f : 1.0f;
+                to++;
+                from += 4;
+              }
+            }
+          }
+        });
 
     exr_printf("OpenEXR-save: Writing OpenEXR file of height %d.\n", height);
 
@@ -1138,9 +1140,12 @@ void IMB_exr_write_channels(void *handle)
       if (echan->use_half_float) {
         const float *rect = echan->rect;
         half *cur = current_rect_half;
-        for (size_t i = 0; i < num_pixels; i++, cur++) {
-          *cur = float_to_half_safe(rect[i * echan->xstride]);
-        }
+        blender::threading::parallel_for(
+            blender::IndexRange(num_pixels), 4096, [&](const blender::IndexRange range) {
+              for (const int64_t i : range) {
+                cur[i] = float_to_half_safe(rect[i * echan->xstride]);
+              }
+            });
         half *rect_to_write = current_rect_half + (data->height - 1L) * data->width;
         frameBuffer.insert(
             echan->name,
@@ -1885,6 +1890,94 @@ static bool exr_is_half_float(MultiPartInputFile &file)
   return true;
 }
 
+/** Channels of a single layer file that are read into the RGBA channels of an #ImBuf. */
+struct ExrRGBAChannels {
+  int num_rgb_channels;
+  bool has_luma;
+  bool has_chroma;
+  bool has_xyz;
+};
+
+/**
+ * Insert the slices that read the color channels of the file into RGBA pixels, with `first`
+ * pointing to the pixel at the origin of the data window coordinates.
+ */
+static ExrRGBAChannels exr_insert_rgba_slices(MultiPartInputFile &file,
+                                              FrameBuffer &frameBuffer,
+                                              float *first,
+                                              const size_t xstride,
+                                              const size_t ystride)
+{
+  const char *rgb_channels[3];
+  ExrRGBAChannels channels;
+  channels.num_rgb_channels = exr_has_rgb(file, rgb_channels);
+  channels.has_luma = exr_has_luma(file);
+  channels.has_chroma = exr_has_chroma(file);
+  channels.has_xyz = exr_has_xyz(file);
+
+  if (channels.num_rgb_channels > 0) {
+    for (int i = 0; i < channels.num_rgb_channels; i++) {
+      frameBuffer.insert(exr_rgba_channelname(file, rgb_channels[i]),
+                         Slice(Imf::FLOAT, (char *)(first + i), xstride, ystride));
+    }
+  }
+  else if (channels.has_xyz) {
+    frameBuffer.insert(exr_rgba_channelname(file, "X"),
+                       Slice(Imf::FLOAT, (char *)first, xstride, ystride));
+    frameBuffer.insert(exr_rgba_channelname(file, "Y"),
+                       Slice(Imf::FLOAT, (char *)(first + 1), xstride, ystride));
+    frameBuffer.insert(exr_rgba_channelname(file, "Z"),
+                       Slice(Imf::FLOAT, (char *)(first + 2), xstride, ystride));
+  }
+  else if (channels.has_luma) {
+    frameBuffer.insert(exr_rgba_channelname(file, "Y"),
+                       Slice(Imf::FLOAT, (char *)first, xstride, ystride));
+    frameBuffer.insert(exr_rgba_channelname(file, "BY"),
+                       Slice(Imf::FLOAT, (char *)(first + 1), xstride, ystride, 1, 1, 0.5f));
+    frameBuffer.insert(exr_rgba_channelname(file, "RY"),
+                       Slice(Imf::FLOAT, (char *)(first + 2), xstride, ystride, 1, 1, 0.5f));
+  }
+
+  /* 1.0 is fill value, this still needs to be assigned even when (is_alpha == 0) */
+  frameBuffer.insert(exr_rgba_channelname(file, "A"),
+                     Slice(Imf::FLOAT, (char *)(first + 3), xstride, ystride, 1, 1, 1.0f));
+
+  return channels;
+}
+
+/** Convert RGBA pixels read with #exr_insert_rgba_slices from luma/chroma or gray-scale to RGB. */
+static void exr_rgba_convert_to_rgb(const ExrRGBAChannels &channels,
+                                    float *rect,
+                                    const size_t num_pixels)
+{
+  if (channels.num_rgb_channels == 0 && channels.has_luma && channels.has_chroma) {
+    blender::threading::parallel_for(
+        blender::IndexRange(num_pixels), 4096, [&](const blender::IndexRange range) {
+          for (const int64_t a : range) {
+            float *color = rect + a * 4;
+            ycc_to_rgb(color[0] * 255.0f,
+                       color[1] * 255.0f,
+                       color[2] * 255.0f,
+                       &color[0],
+                       &color[1],
+                       &color[2],
+                       BLI_YCC_ITU_BT709);
+          }
+        });
+  }
+  else if (!channels.has_xyz && channels.num_rgb_channels <= 1) {
+    /* Convert 1 to 3 channels. */
+    blender::threading::parallel_for(
+        blender::IndexRange(num_pixels), 4096, [&](const blender::IndexRange range) {
+          for (const int64_t a : range) {
+            float *color = rect + a * 4;
+            color[1] = color[0];
+            color[2] = color[0];
+          }
+        });
+  }
+}
+
 static bool imb_exr_is_multilayer_file(MultiPartInputFile &file)
 {
   const ChannelList &channels = file.header(0).channels();
@@ -2135,12 +2228,7 @@ ImBuf *imb_load_openexr(const uchar *mem, size_t size, int flags, ImFileColorSpa
           }
         }
         else {
-          const char *rgb_channels[3];
-          const int num_rgb_channels = exr_has_rgb(*file, rgb_channels);
-          const bool has_luma = exr_has_luma(*file);
-          const bool has_xyz = exr_has_xyz(*file);
           FrameBuffer frameBuffer;
-          float *first;
           size_t xstride = sizeof(float[4]);
           size_t ystride = -xstride * width;
 
@@ -2149,38 +2237,12 @@ ImBuf *imb_load_openexr(const uchar *mem, size_t size, int flags, ImFileColorSpa
 
           /* Inverse correct first pixel for data-window
            * coordinates (- dw.min.y because of y flip). */
-          first = ibuf->float_buffer.data - 4 * (dw.min.x - dw.min.y * width);
+          float *first = ibuf->float_buffer.data - 4 * (dw.min.x - dw.min.y * width);
           /* But, since we read y-flipped (negative y stride) we move to last scan-line. */
           first += 4 * (height - 1) * width;
 
-          if (num_rgb_channels > 0) {
-            for (int i = 0; i < num_rgb_channels; i++) {
-              frameBuffer.insert(exr_rgba_channelname(*file, rgb_channels[i]),
-                                 Slice(Imf::FLOAT, (char *)(first + i), xstride, ystride));
-            }
-          }
-          else if (has_xyz) {
-            frameBuffer.insert(exr_rgba_channelname(*file, "X"),
-                               Slice(Imf::FLOAT, (char *)first, xstride, ystride));
-            frameBuffer.insert(exr_rgba_channelname(*file, "Y"),
-                               Slice(Imf::FLOAT, (char *)(first + 1), xstride, ystride));
-            frameBuffer.insert(exr_rgba_channelname(*file, "Z"),
-                               Slice(Imf::FLOAT, (char *)(first + 2), xstride, ystride));
-          }
-          else if (has_luma) {
-            frameBuffer.insert(exr_rgba_channelname(*file, "Y"),
-                               Slice(Imf::FLOAT, (char *)first, xstride, ystride));
-            frameBuffer.insert(
-                exr_rgba_channelname(*file, "BY"),
-                Slice(Imf::FLOAT, (char *)(first + 1), xstride, ystride, 1, 1, 0.5f));
-            frameBuffer.insert(
-                exr_rgba_channelname(*file, "RY"),
-                Slice(Imf::FLOAT, (char *)(first + 2), xstride, ystride, 1, 1, 0.5f));
-          }
-
-          /* 1.0 is fill value, this still needs to be assigned even when (is_alpha == 0) */
-          frameBuffer.insert(exr_rgba_channelname(*file, "A"),
-                             Slice(Imf::FLOAT, (char *)(first + 3), xstride, ystride, 1, 1, 1.0f));
+          const ExrRGBAChannels rgba_channels = exr_insert_rgba_slices(
+              *file, frameBuffer, first, xstride, ystride);
 
           InputPart in(*file, 0);
           in.setFrameBuffer(frameBuffer);
@@ -2199,26 +2261,8 @@ ImBuf *imb_load_openexr(const uchar *mem, size_t size, int flags, ImFileColorSpa
           }
 #endif
 
-          if (num_rgb_channels == 0 && has_luma && exr_has_chroma(*file)) {
-            for (size_t a = 0; a < size_t(ibuf->x) * ibuf->y; a++) {
-              float *color = ibuf->float_buffer.data + a * 4;
-              ycc_to_rgb(color[0] * 255.0f,
-                         color[1] * 255.0f,
-                         color[2] * 255.0f,
-                         &color[0],
-                         &color[1],
-                         &color[2],
-                         BLI_YCC_ITU_BT709);
-            }
-          }
-          else if (!has_xyz && num_rgb_channels <= 1) {
-            /* Convert 1 to 3 channels. */
-            for (size_t a = 0; a < size_t(ibuf->x) * ibuf->y; a++) {
-              float *color = ibuf->float_buffer.data + a * 4;
-              color[1] = color[0];
-              color[2] = color[0];
-            }
-          }
+          exr_rgba_convert_to_rgb(
+              rgba_channels, ibuf->float_buffer.data, size_t(ibuf->x) * ibuf->y);
 
           /* file is no longer needed */
           delete membuf;
@@ -2258,6 +2302,234 @@ ImBuf *imb_load_openexr(const uchar *mem, size_t size, int flags, ImFileColorSpa
   }
 }
 
+/**
+ * Read at most this many scan-lines of a scan-line file at once, to bound the memory used by the
+ * temporary buffer. This is a multiple of the lines per block of all compression types, so that
+ * no block is decoded twice.
+ */
+static constexpr int exr_region_batch_lines = 256;
+
+/** Pixels decoded by OpenEXR, in top-down file order. */
+struct ExrRegionBlock {
+  Box2i box;
+  blender::Array<float> pixels;
+};
+
+/**
+ * Read the pixels of all scan-lines or tiles that overlap the file data window coordinates
+ * `file_region` of the first part into temporary blocks and copy the overlapping pixels into
+ * `ibuf`. OpenEXR decodes the line blocks or tiles of every read on its global thread pool.
+ */
+static void exr_read_region(MultiPartInputFile &file,
+                            const Box2i &data_window,
+                            const Box2i &file_region,
+                            const int mip_level,
+                            const char *const *channel_names,
+                            ImBuf *ibuf,
+                            ExrRGBAChannels *r_rgba_channels)
+{
+  const int num_channels = ibuf->channels;
+
+  /* Insert the slices of the requested channels, decoding into the block pixels. */
+  const auto make_frame_buffer = [&](ExrRegionBlock &block) {
+    const int64_t block_width = block.box.max.x - block.box.min.x + 1;
+    const int64_t block_height = block.box.max.y - block.box.min.y + 1;
+    block.pixels.reinitialize(block_width * block_height * num_channels);
+    const size_t xstride = sizeof(float) * num_channels;
+    const size_t ystride = xstride * block_width;
+    /* Inverse correct first pixel for data-window coordinates. */
+    float *first = block.pixels.data() -
+                   num_channels * (block.box.min.y * block_width + block.box.min.x);
+
+    FrameBuffer frameBuffer;
+    if (channel_names == nullptr) {
+      *r_rgba_channels = exr_insert_rgba_slices(file, frameBuffer, first, xstride, ystride);
+    }
+    else {
+      for (int i = 0; i < num_channels; i++) {
+        frameBuffer.insert(channel_names[i],
+                           Slice(Imf::FLOAT, (char *)(first + i), xstride, ystride, 1, 1, 0.0f));
+      }
+    }
+    return frameBuffer;
+  };
+
+  /* Copy the pixels of the block inside the region, flipping to Blender's bottom-up order. */
+  const auto copy_block = [&](const ExrRegionBlock &block) {
+    const int64_t block_width = block.box.max.x - block.box.min.x + 1;
+    const int y_min = std::max(block.box.min.y, file_region.min.y);
+    const int y_max = std::min(block.box.max.y, file_region.max.y);
+    const int64_t row_size = int64_t(ibuf->x) * num_channels;
+    blender::threading::parallel_for(
+        blender::IndexRange(y_min, y_max - y_min + 1), 64, [&](const blender::IndexRange rows) {
+          for (const int64_t y : rows) {
+            const float *src = block.pixels.data() +
+                               num_channels * ((y - block.box.min.y) * block_width +
+                                               file_region.min.x - block.box.min.x);
+            /* Row of the region in Blender's bottom-up order. */
+            const int64_t dst_y = file_region.max.y - y;
+            memcpy(ibuf->float_buffer.data + dst_y * row_size, src, sizeof(float) * row_size);
+          }
+        });
+  };
+
+  const Header &header = file.header(0);
+  if (header.hasTileDescription()) {
+    TiledInputPart in(file, 0);
+    const int tile_width = in.tileXSize();
+    const int tile_height = in.tileYSize();
+    const int dx_min = (file_region.min.x - data_window.min.x) / tile_width;
+    const int dx_max = (file_region.max.x - data_window.min.x) / tile_width;
+    const int dy_min = (file_region.min.y - data_window.min.y) / tile_height;
+    const int dy_max = (file_region.max.y - data_window.min.y) / tile_height;
+
+    /* Read one row of tiles at a time. */
+    for (int dy = dy_min; dy <= dy_max; dy++) {
+      ExrRegionBlock block;
+      block.box.min = in.dataWindowForTile(dx_min, dy, mip_level, mip_level).min;
+      block.box.max = in.dataWindowForTile(dx_max, dy, mip_level, mip_level).max;
+      in.setFrameBuffer(make_frame_buffer(block));
+      in.readTiles(dx_min, dx_max, dy, dy, mip_level, mip_level);
+      copy_block(block);
+    }
+  }
+  else {
+    InputPart in(file, 0);
+    /* Scan-lines are always decoded completely, so the blocks span the whole data window. */
+    int y = file_region.min.y -
+            (file_region.min.y - data_window.min.y) % exr_region_batch_lines;
+    for (; y <= file_region.max.y; y += exr_region_batch_lines) {
+      ExrRegionBlock block;
+      block.box.min = V2i(data_window.min.x, std::max(y, file_region.min.y));
+      block.box.max = V2i(data_window.max.x,
+                          std::min(y + exr_region_batch_lines - 1, file_region.max.y));
+      in.setFrameBuffer(make_frame_buffer(block));
+      in.readPixels(block.box.min.y, block.box.max.y);
+      copy_block(block);
+    }
+  }
+}
+
+static ImBuf *exr_load_region(MultiPartInputFile &file,
+                              const rcti &region,
+                              const int mip_level,
+                              const char *const *channel_names,
+                              const int channels_num)
+{
+  const Header &header = file.header(0);
+  Box2i data_window;
+  if (header.hasTileDescription()) {
+    TiledInputPart in(file, 0);
+    if (!in.isValidLevel(mip_level, mip_level)) {
+      return nullptr;
+    }
+    data_window = in.dataWindowForLevel(mip_level, mip_level);
+  }
+  else {
+    /* Only tiled files can store mip-map levels. */
+    if (mip_level != 0) {
+      return nullptr;
+    }
+    data_window = header.dataWindow();
+  }
+  const int data_width = data_window.max.x - data_window.min.x + 1;
+  const int data_height = data_window.max.y - data_window.min.y + 1;
+
+  rcti bounds;
+  BLI_rcti_init(&bounds, 0, data_width, 0, data_height);
+  rcti clamped_region;
+  if (!BLI_rcti_isect(&region, &bounds, &clamped_region) || BLI_rcti_is_empty(&clamped_region)) {
+    return nullptr;
+  }
+
+  /* Region in the file's data window coordinates, which are top-down and inclusive. */
+  Box2i file_region;
+  file_region.min.x = data_window.min.x + clamped_region.xmin;
+  file_region.max.x = data_window.min.x + clamped_region.xmax - 1;
+  file_region.min.y = data_window.min.y + data_height - clamped_region.ymax;
+  file_region.max.y = data_window.min.y + data_height - 1 - clamped_region.ymin;
+
+  const int num_channels = channel_names ? channels_num : 4;
+  const bool is_alpha = channel_names ? channels_num == 4 : exr_has_alpha(file);
+  ImBuf *ibuf = IMB_allocImBuf(BLI_rcti_size_x(&clamped_region),
+                               BLI_rcti_size_y(&clamped_region),
+                               is_alpha ? 32 : 24,
+                               0);
+  ibuf->ftype = IMB_FTYPE_OPENEXR;
+  /* No need to clear image memory, it will be fully written below. */
+  if (!IMB_alloc_float_pixels(ibuf, num_channels, false)) {
+    IMB_freeImBuf(ibuf);
+    return nullptr;
+  }
+
+  try {
+    ExrRGBAChannels rgba_channels;
+    exr_read_region(
+        file, data_window, file_region, mip_level, channel_names, ibuf, &rgba_channels);
+    if (channel_names == nullptr) {
+      exr_rgba_convert_to_rgb(rgba_channels, ibuf->float_buffer.data, size_t(ibuf->x) * ibuf->y);
+    }
+  }
+  catch (...) {
+    IMB_freeImBuf(ibuf);
+    throw;
+  }
+  return ibuf;
+}
+
+/**
+ * Assign the color space of the file to the float buffer, chosen the same way as when loading the
+ * whole image: from the file metadata, the OpenColorIO file rules or the default float role.
+ */
+static void exr_assign_file_colorspace(ImBuf *ibuf, const Header &header, const char *filepath)
+{
+  ImFileColorSpace file_colorspace;
+  imb_exr_set_known_colorspace(header, file_colorspace);
+  const char *colorspace = file_colorspace.metadata_colorspace;
+  if (colorspace[0] == '\0' || IMB_colormanagement_space_get_named(colorspace) == nullptr) {
+    colorspace = IMB_colormanagement_space_from_filepath_rules(filepath);
+  }
+  if (colorspace == nullptr) {
+    colorspace = IMB_colormanagement_role_colorspace_name_get(COLOR_ROLE_DEFAULT_FLOAT);
+  }
+  IMB_colormanagement_assign_float_colorspace(ibuf, colorspace);
+}
+
+ImBuf *IMB_exr_load_region(const char *filepath,
+                           const rcti *region,
+                           const int mip_level,
+                           const char *const *channel_names,
+                           const int channels_num)
+{
+  if (channel_names != nullptr && !IN_RANGE_INCL(channels_num, 1, 4)) {
+    return nullptr;
+  }
+
+  IStream *stream = nullptr;
+  MultiPartInputFile *file = nullptr;
+  ImBuf *ibuf = nullptr;
+
+  /* OpenExr uses exceptions for error-handling. */
+  try {
+    stream = new IFileStream(filepath);
+    file = new MultiPartInputFile(*stream);
+    ibuf = exr_load_region(*file, *region, mip_level, channel_names, channels_num);
+    if (ibuf) {
+      exr_assign_file_colorspace(ibuf, file->header(0), filepath);
+    }
+  }
+  catch (const std::exception &exc) {
+    std::cerr << "OpenEXR-Load-Region: ERROR: " << exc.what() << std::endl;
+  }
+  catch (...) { /* Catch-all for edge cases or compiler bugs. */
+    std::cerr << "OpenEXR-Load-Region: UNKNOWN ERROR" << std::endl;
+  }
+
+  delete file;
+  delete stream;
+  return ibuf;
+}
+
 ImBuf *imb_load_filepath_thumbnail_openexr(const char *filepath,
                                            const int /*flags*/,
                                            const size_t max_thumb_size,
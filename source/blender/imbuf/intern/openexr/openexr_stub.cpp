@@ -86,3 +86,12 @@ bool IMB_exr_get_ppm(void * /*handle*/, double /*ppm*/[2])
 {
   return false;
 }
+
+ImBuf *IMB_exr_load_region(const char * /*filepath*/,
+                           const rcti * /*region*/,
+                           int /*mip_level*/,
+                           const char *const * /*channel_names*/,
+                           int /*channels_num*/)
+{
+  return nullptr;
+}
@@ -8,6 +8,7 @@
  */
 
 #include "BLI_math_vector.hh"
+#include "BLI_simd.hh"
 #include "BLI_task.hh"
 #include "BLI_utildefines.h"
 #include "MEM_guardedalloc.h"
@@ -363,7 +364,18 @@ static void alloc_scale_dst_buffers(
 
 static inline float4 load_pixel(const uchar4 *ptr)
 {
+#if BLI_HAVE_SSE2
+  int packed;
+  memcpy(&packed, ptr, sizeof(packed));
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i rgba8 = _mm_cvtsi32_si128(packed);
+  const __m128i rgba32 = _mm_unpacklo_epi16(_mm_unpacklo_epi8(rgba8, zero), zero);
+  float4 result;
+  _mm_storeu_ps(result, _mm_cvtepi32_ps(rgba32));
+  return result;
+#else
   return float4(ptr[0]);
+#endif
 }
 static inline float4 load_pixel(const float *ptr)
 {
@@ -383,7 +395,15 @@ static inline float4 load_pixel(const float4 *ptr)
 }
 static inline void store_pixel(float4 pix, uchar4 *ptr)
 {
+#if BLI_HAVE_SSE2
+  /* Values are in 0..255 range, so adding 0.5 and truncating matches rounding them. */
+  const __m128i rgba32 = _mm_cvttps_epi32(_mm_add_ps(_mm_loadu_ps(pix), _mm_set1_ps(0.5f)));
+  const __m128i rgba16 = _mm_packs_epi32(rgba32, _mm_setzero_si128());
+  const int packed = _mm_cvtsi128_si32(_mm_packus_epi16(rgba16, _mm_setzero_si128()));
+  memcpy(ptr, &packed, sizeof(packed));
+#else
   *ptr = uchar4(blender::math::round(pix));
+#endif
 }
 static inline void store_pixel(float4 pix, float *ptr)
 {
@@ -449,28 +469,45 @@ struct ScaleDownY {
     const float add = (ibufy - 0.01f) / newy;
     const float inv_add = 1.0f / add;
 
+    /* The sample positions only depend on the row, so process whole rows of a range of columns at
+     * once. This reads and writes memory contiguously and lets the inner loops over the columns
+     * be vectorized, compared to stepping through the image one column at a time. */
+    constexpr int64_t columns_chunk = 256;
     const int grain_size = threaded ? 32 : ibufx;
     threading::parallel_for(IndexRange(ibufx), grain_size, [&](IndexRange range) {
-      for (const int x : range) {
-        const T *src_ptr = src + x;
-        T *dst_ptr = dst + x;
+      float4 val[columns_chunk];
+      float4 nval[columns_chunk];
+      for (int64_t chunk_start = range.first(); chunk_start < range.one_after_last();
+           chunk_start += columns_chunk)
+      {
+        const int64_t chunk_size = std::min(columns_chunk, range.one_after_last() - chunk_start);
+        const T *src_ptr = src + chunk_start;
+        T *dst_ptr = dst + chunk_start;
         float sample = 0.0f;
-        float4 val(0.0f);
+        std::fill_n(val, chunk_size, float4(0.0f));
 
         for (int y = 0; y < newy; y++) {
-          float4 nval = -val * sample;
+          for (int64_t x = 0; x < chunk_size; x++) {
+            nval[x] = -val[x] * sample;
+          }
           sample += add;
           while (sample >= 1.0f) {
             sample -= 1.0f;
-            nval += load_pixel(src_ptr);
+            for (int64_t x = 0; x < chunk_size; x++) {
+              nval[x] += load_pixel(src_ptr + x);
+            }
             src_ptr += ibufx;
           }
 
-          val = load_pixel(src_ptr);
+          for (int64_t x = 0; x < chunk_size; x++) {
+            val[x] = load_pixel(src_ptr + x);
+          }
           src_ptr += ibufx;
 
-          float4 pix = (nval + sample * val) * inv_add;
-          store_pixel(pix, dst_ptr);
+          for (int64_t x = 0; x < chunk_size; x++) {
+            float4 pix = (nval[x] + sample * val[x]) * inv_add;
+            store_pixel(pix, dst_ptr + x);
+          }
           dst_ptr += ibufx;
 
           sample -= 1.0f;
@@ -547,38 +584,40 @@ struct ScaleUpY {
       }
     }
     else {
+      /* Like for #ScaleDownY, process whole rows of a range of columns at once. */
       const int grain_size = threaded ? 32 : ibufx;
       threading::parallel_for(IndexRange(ibufx), grain_size, [&](IndexRange range) {
-        for (const int x : range) {
-          float sample = -0.5f + add * 0.5f;
-          int counter = 0;
-          const T *src_ptr = src + x;
-          T *dst_ptr = dst + x;
-
-          float4 val = load_pixel(src_ptr);
-          float4 nval = load_pixel(src_ptr + ibufx);
-          float4 diff = nval - val;
-          if (ibufy > 2) {
-            src_ptr += ibufx * 2;
-            counter += 2;
-          }
+        float sample = -0.5f + add * 0.5f;
+        int counter = 0;
+        const T *src_ptr = src + range.first();
+        T *dst_ptr = dst + range.first();
+
+        const T *val_ptr = src_ptr;
+        const T *nval_ptr = src_ptr + ibufx;
+        if (ibufy > 2) {
+          src_ptr += ibufx * 2;
+          counter += 2;
+        }
 
-          for (int y = 0; y < newy; y++) {
-            if (sample >= 1.0f) {
-              sample -= 1.0f;
-              val = nval;
-              nval = load_pixel(src_ptr);
-              diff = nval - val;
-              if (counter + 1 < ibufy) {
-                src_ptr += ibufx;
-                ++counter;
-              }
+        for (int y = 0; y < newy; y++) {
+          if (sample >= 1.0f) {
+            sample -= 1.0f;
+            val_ptr = nval_ptr;
+            nval_ptr = src_ptr;
+            if (counter + 1 < ibufy) {
+              src_ptr += ibufx;
+              ++counter;
             }
-            float4 pix = val + blender::math::max(sample, 0.0f) * diff;
-            store_pixel(pix, dst_ptr);
-            dst_ptr += ibufx;
-            sample += add;
           }
+          const float factor = blender::math::max(sample, 0.0f);
+          for (const int64_t x : range.index_range()) {
+            float4 val = load_pixel(val_ptr + x);
+            float4 diff = load_pixel(nval_ptr + x) - val;
+            float4 pix = val + factor * diff;
+            store_pixel(pix, dst_ptr + x);
+          }
+          dst_ptr += ibufx;
+          sample += add;
         }
       });
     }
@@ -77,6 +77,13 @@ ImBuf *MOV_decode_frame(MovieReader *anim,
  */
 ImBuf *MOV_decode_preview_frame(MovieReader *anim);
 
+/**
+ * Reuse the pixel memory of decoded frames for the following frames, once they are freed. This
+ * avoids allocating and clearing large buffers for every frame of high resolution movies.
+ * Returned images are regular images, their buffer goes back to the reader when they are freed.
+ */
+void MOV_set_use_frame_pool(MovieReader *anim, bool use_frame_pool);
+
 /**
  * Return the length (in frames) of the movie.
  */
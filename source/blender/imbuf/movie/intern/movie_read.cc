@@ -13,10 +13,12 @@
 #include <cmath>
 #include <cstdio>
 #include <cstdlib>
+#include <cstring>
 #include <sys/types.h>
 
 #include "BLI_path_utils.hh"
 #include "BLI_string.h"
+#include "BLI_task.hh"
 #include "BLI_threads.h"
 #include "BLI_utildefines.h"
 
@@ -54,6 +56,67 @@ extern "C" {
 static void free_anim_ffmpeg(MovieReader *anim);
 #endif
 
+/** Amount of pixel buffers of freed frames that are kept for reuse. */
+#define MOVIE_FRAME_POOL_SIZE 2
+
+/**
+ * Pixel buffers of decoded frames that were freed, kept for the following frames. Frames give
+ * their buffer back from their free callback, so the pool is shared by the reader and its frames
+ * that are not freed yet, and the last of them frees it.
+ */
+struct MovieFramePool {
+  ThreadMutex mutex;
+  /** The reader while it uses the pool, and the frames that are not freed yet. */
+  int users_num = 1;
+  /** Set when the reader doesn't use the pool anymore, buffers of freed frames are not kept. */
+  bool is_released = false;
+
+  /** Layout of the buffers, they have the size of the frames of the reader. */
+  bool is_float = false;
+  size_t buffer_size = 0;
+  size_t buffer_alignment = 0;
+
+  void *buffers[MOVIE_FRAME_POOL_SIZE] = {};
+  int buffers_num = 0;
+};
+
+static void movie_frame_pool_clear(MovieFramePool *pool)
+{
+  for (int i = 0; i < pool->buffers_num; i++) {
+    MEM_freeN(pool->buffers[i]);
+  }
+  pool->buffers_num = 0;
+}
+
+/** Remove a user of the pool, must be called with the pool mutex held. */
+static void movie_frame_pool_user_remove_and_unlock(MovieFramePool *pool)
+{
+  pool->users_num--;
+  const bool is_unused = pool->users_num == 0;
+  BLI_mutex_unlock(&pool->mutex);
+
+  if (is_unused) {
+    movie_frame_pool_clear(pool);
+    BLI_mutex_end(&pool->mutex);
+    MEM_delete(pool);
+  }
+}
+
+/** Stop using the pool of the reader, it's freed once the frames using it are freed as well. */
+static void movie_frame_pool_free(MovieReader *anim)
+{
+  MovieFramePool *pool = anim->frame_pool;
+  if (pool == nullptr) {
+    return;
+  }
+  anim->frame_pool = nullptr;
+
+  BLI_mutex_lock(&pool->mutex);
+  pool->is_released = true;
+  movie_frame_pool_clear(pool);
+  movie_frame_pool_user_remove_and_unlock(pool);
+}
+
 void MOV_close(MovieReader *anim)
 {
   if (anim == nullptr) {
@@ -64,6 +127,7 @@ void MOV_close(MovieReader *anim)
   free_anim_ffmpeg(anim);
 #endif
   MOV_close_proxies(anim);
+  movie_frame_pool_free(anim);
   IMB_metadata_free(anim->metadata);
 
   MEM_delete(anim);
@@ -142,6 +206,17 @@ void MOV_set_multiview_suffix(MovieReader *anim, const char *suffix)
   STRNCPY(anim->suffix, suffix);
 }
 
+void MOV_set_use_frame_pool(MovieReader *anim, const bool use_frame_pool)
+{
+  if (!use_frame_pool) {
+    movie_frame_pool_free(anim);
+  }
+  else if (anim->frame_pool == nullptr) {
+    anim->frame_pool = MEM_new<MovieFramePool>("MovieFramePool");
+    BLI_mutex_init(&anim->frame_pool->mutex);
+  }
+}
+
 #ifdef WITH_FFMPEG
 
 static double ffmpeg_stream_start_time_get(const AVStream *stream)
@@ -573,6 +648,51 @@ static AVFrame *ffmpeg_double_buffer_frame_fallback_get(MovieReader *anim)
   return nullptr;
 }
 
+/**
+ * Interleave a frame with planar GBR(A) float layout into the RGBA float buffer of the image,
+ * flipping it vertically. Frames without an alpha plane get an opaque alpha channel.
+ */
+static void ffmpeg_interleave_float_planes(const AVFrame *planar, ImBuf *ibuf)
+{
+  const size_t src_linesize = planar->linesize[0];
+  BLI_assert_msg(planar->linesize[1] == src_linesize && planar->linesize[2] == src_linesize &&
+                     (planar->data[3] == nullptr || planar->linesize[3] == src_linesize),
+                 "ffmpeg frame should be same size planes for a floating point image case");
+  blender::threading::parallel_for(
+      blender::IndexRange(ibuf->y), 32, [&](const blender::IndexRange y_range) {
+        for (const int64_t y : y_range) {
+          size_t src_offset = src_linesize * (ibuf->y - y - 1);
+          const float *src_g = reinterpret_cast<const float *>(planar->data[0] + src_offset);
+          const float *src_b = reinterpret_cast<const float *>(planar->data[1] + src_offset);
+          const float *src_r = reinterpret_cast<const float *>(planar->data[2] + src_offset);
+          const float *src_a = planar->data[3] ?
+                                   reinterpret_cast<const float *>(planar->data[3] + src_offset) :
+                                   nullptr;
+          float *dst = ibuf->float_buffer.data + ibuf->x * y * 4;
+          for (int x = 0; x < ibuf->x; x++) {
+            *dst++ = *src_r++;
+            *dst++ = *src_g++;
+            *dst++ = *src_b++;
+            *dst++ = src_a ? *src_a++ : 1.0f;
+          }
+        }
+      });
+}
+
+/** Copy RGBA bytes into the byte buffer of the image, flipping it vertically. */
+static void ffmpeg_flip_copy_rgba(const uint8_t *src, const int src_linesize, ImBuf *ibuf)
+{
+  const size_t dst_linesize = size_t(ibuf->x) * 4;
+  blender::threading::parallel_for(
+      blender::IndexRange(ibuf->y), 64, [&](const blender::IndexRange y_range) {
+        for (const int64_t y : y_range) {
+          memcpy(ibuf->byte_buffer.data + dst_linesize * y,
+                 src + size_t(src_linesize) * (ibuf->y - y - 1),
+                 dst_linesize);
+        }
+      });
+}
+
 /**
  * Postprocess the image in anim->pFrame and do color conversion and de-interlacing stuff.
  *
@@ -615,33 +735,29 @@ static void ffmpeg_postprocess(MovieReader *anim, AVFrame *input, ImBuf *ibuf)
     }
   }
 
+  /* Decoders that output the layout of the final image already don't need swscale. */
+  const AVPixelFormat input_format = AVPixelFormat(input->format);
+  const bool use_direct_copy = anim->is_float ? ELEM(input_format,
+                                                     AV_PIX_FMT_GBRAPF32LE,
+                                                     AV_PIX_FMT_GBRPF32LE) :
+                                                input_format == AV_PIX_FMT_RGBA;
+
   if (anim->is_float) {
     /* Float images are converted into planar BGRA layout by swscale (since
      * it does not support direct YUV->RGBA float interleaved conversion).
      * Do vertical flip and interleave into RGBA manually. */
-    /* Decode, then do vertical flip into destination. */
-    ffmpeg_sws_scale_frame(anim->img_convert_ctx, anim->pFrameRGB, input);
-
-    const size_t src_linesize = anim->pFrameRGB->linesize[0];
-    BLI_assert_msg(anim->pFrameRGB->linesize[1] == src_linesize &&
-                       anim->pFrameRGB->linesize[2] == src_linesize &&
-                       anim->pFrameRGB->linesize[3] == src_linesize,
-                   "ffmpeg frame should be 4 same size planes for a floating point image case");
-    for (int y = 0; y < ibuf->y; y++) {
-      size_t src_offset = src_linesize * (ibuf->y - y - 1);
-      const float *src_g = reinterpret_cast<const float *>(anim->pFrameRGB->data[0] + src_offset);
-      const float *src_b = reinterpret_cast<const float *>(anim->pFrameRGB->data[1] + src_offset);
-      const float *src_r = reinterpret_cast<const float *>(anim->pFrameRGB->data[2] + src_offset);
-      const float *src_a = reinterpret_cast<const float *>(anim->pFrameRGB->data[3] + src_offset);
-      float *dst = ibuf->float_buffer.data + ibuf->x * y * 4;
-      for (int x = 0; x < ibuf->x; x++) {
-        *dst++ = *src_r++;
-        *dst++ = *src_g++;
-        *dst++ = *src_b++;
-        *dst++ = *src_a++;
-      }
+    if (use_direct_copy) {
+      ffmpeg_interleave_float_planes(input, ibuf);
+    }
+    else {
+      /* Decode, then do vertical flip into destination. */
+      ffmpeg_sws_scale_frame(anim->img_convert_ctx, anim->pFrameRGB, input);
+      ffmpeg_interleave_float_planes(anim->pFrameRGB, ibuf);
     }
   }
+  else if (use_direct_copy) {
+    ffmpeg_flip_copy_rgba(input->data[0], input->linesize[0], ibuf);
+  }
   else {
     /* If final destination image layout matches that of decoded RGB frame (including
      * any line padding done by ffmpeg for SIMD alignment), we can directly
@@ -672,23 +788,7 @@ static void ffmpeg_postprocess(MovieReader *anim, AVFrame *input, ImBuf *ibuf)
     else {
       /* Decode, then do vertical flip into destination. */
       ffmpeg_sws_scale_frame(anim->img_convert_ctx, anim->pFrameRGB, input);
-
-      /* Use negative line size to do vertical image flip. */
-      const int src_linesize[4] = {-rgb_linesize, 0, 0, 0};
-      const uint8_t *const src[4] = {
-          rgb_data + (anim->y - 1) * rgb_linesize, nullptr, nullptr, nullptr};
-      int dst_size = av_image_get_buffer_size(AVPixelFormat(anim->pFrameRGB->format),
-                                              anim->pFrameRGB->width,
-                                              anim->pFrameRGB->height,
-                                              1);
-      av_image_copy_to_buffer(ibuf->byte_buffer.data,
-                              dst_size,
-                              src,
-                              src_linesize,
-                              AVPixelFormat(anim->pFrameRGB->format),
-                              anim->x,
-                              anim->y,
-                              1);
+      ffmpeg_flip_copy_rgba(rgb_data, rgb_linesize, ibuf);
     }
   }
 
@@ -1138,6 +1238,89 @@ static bool ffmpeg_must_seek(MovieReader *anim, int position)
   return must_seek;
 }
 
+/** Free callback of decoded frames, gives the pixel buffer of the frame back to the pool. */
+static void movie_frame_pool_frame_free(ImBuf *ibuf, void *user_data)
+{
+  MovieFramePool *pool = static_cast<MovieFramePool *>(user_data);
+  BLI_mutex_lock(&pool->mutex);
+
+  /* The buffer may have been replaced or taken since the frame was decoded. */
+  const ImBufOwnership ownership = pool->is_float ? ibuf->float_buffer.ownership :
+                                                    ibuf->byte_buffer.ownership;
+  const void *buffer = pool->is_float ? static_cast<void *>(ibuf->float_buffer.data) :
+                                        static_cast<void *>(ibuf->byte_buffer.data);
+  if (!pool->is_released && pool->buffers_num < MOVIE_FRAME_POOL_SIZE && buffer != nullptr &&
+      ownership == IB_TAKE_OWNERSHIP && MEM_allocN_len(buffer) == pool->buffer_size &&
+      uintptr_t(buffer) % pool->buffer_alignment == 0)
+  {
+    pool->buffers[pool->buffers_num++] = pool->is_float ?
+                                             static_cast<void *>(IMB_steal_float_buffer(ibuf)) :
+                                             static_cast<void *>(IMB_steal_byte_buffer(ibuf));
+  }
+
+  movie_frame_pool_user_remove_and_unlock(pool);
+}
+
+/**
+ * Take a pixel buffer of the frame pool for the next frame, if there is one with the right size.
+ * Registers the frame as a user of the pool.
+ */
+static uint8_t *ffmpeg_frame_pool_take_buffer(MovieFramePool *pool,
+                                              const bool is_float,
+                                              const size_t buffer_size,
+                                              const size_t buffer_alignment)
+{
+  uint8_t *buffer_data = nullptr;
+  BLI_mutex_lock(&pool->mutex);
+  if (pool->is_float != is_float || pool->buffer_size != buffer_size ||
+      pool->buffer_alignment != buffer_alignment)
+  {
+    movie_frame_pool_clear(pool);
+    pool->is_float = is_float;
+    pool->buffer_size = buffer_size;
+    pool->buffer_alignment = buffer_alignment;
+  }
+  if (pool->buffers_num > 0) {
+    pool->buffers_num--;
+    buffer_data = static_cast<uint8_t *>(pool->buffers[pool->buffers_num]);
+  }
+  pool->users_num++;
+  BLI_mutex_unlock(&pool->mutex);
+  return buffer_data;
+}
+
+/** Allocate the image for a decoded frame, reusing pixel memory of the frame pool if possible. */
+static ImBuf *ffmpeg_frame_ibuf_alloc(MovieReader *anim, const int planes)
+{
+  /* Allocate the storage explicitly to ensure the memory is aligned. */
+  const size_t align = ffmpeg_get_buffer_alignment();
+  const size_t pixel_size = anim->is_float ? 16 : 4;
+  const size_t buffer_size = pixel_size * anim->x * anim->y;
+
+  uint8_t *buffer_data = nullptr;
+  if (anim->frame_pool != nullptr) {
+    buffer_data = ffmpeg_frame_pool_take_buffer(
+        anim->frame_pool, anim->is_float, buffer_size, align);
+  }
+  if (buffer_data == nullptr) {
+    buffer_data = static_cast<uint8_t *>(MEM_mallocN_aligned(buffer_size, align, "ffmpeg ibuf"));
+  }
+
+  ImBuf *ibuf = IMB_allocImBuf(anim->x, anim->y, planes, 0);
+  if (anim->is_float) {
+    IMB_assign_float_buffer(ibuf, reinterpret_cast<float *>(buffer_data), IB_TAKE_OWNERSHIP);
+  }
+  else {
+    IMB_assign_byte_buffer(ibuf, buffer_data, IB_TAKE_OWNERSHIP);
+  }
+
+  if (anim->frame_pool != nullptr) {
+    ibuf->free_callback = movie_frame_pool_frame_free;
+    ibuf->free_callback_user_data = anim->frame_pool;
+  }
+  return ibuf;
+}
+
 static ImBuf *ffmpeg_fetchibuf(MovieReader *anim, int position, IMB_Timecode_Type tc)
 {
   if (anim == nullptr) {
@@ -1190,19 +1373,11 @@ static ImBuf *ffmpeg_fetchibuf(MovieReader *anim, int position, IMB_Timecode_Typ
     planes = R_IMF_PLANES_RGB;
   }
 
-  ImBuf *cur_frame_final = IMB_allocImBuf(anim->x, anim->y, planes, 0);
-
-  /* Allocate the storage explicitly to ensure the memory is aligned. */
-  const size_t align = ffmpeg_get_buffer_alignment();
-  const size_t pixel_size = anim->is_float ? 16 : 4;
-  uint8_t *buffer_data = static_cast<uint8_t *>(
-      MEM_mallocN_aligned(pixel_size * anim->x * anim->y, align, "ffmpeg ibuf"));
+  ImBuf *cur_frame_final = ffmpeg_frame_ibuf_alloc(anim, planes);
   if (anim->is_float) {
-    IMB_assign_float_buffer(cur_frame_final, (float *)buffer_data, IB_TAKE_OWNERSHIP);
     cur_frame_final->float_buffer.colorspace = colormanage_colorspace_get_named(anim->colorspace);
   }
   else {
-    IMB_assign_byte_buffer(cur_frame_final, buffer_data, IB_TAKE_OWNERSHIP);
     cur_frame_final->byte_buffer.colorspace = colormanage_colorspace_get_named(anim->colorspace);
   }
 
@@ -1340,6 +1515,7 @@ ImBuf *MOV_decode_frame(MovieReader *anim,
 
     if (proxy) {
       position = MOV_calc_frame_index_with_timecode(anim, tc, position);
+      MOV_set_use_frame_pool(proxy, anim->frame_pool != nullptr);
 
       return MOV_decode_frame(proxy, position, IMB_TC_NONE, IMB_PROXY_NONE);
     }
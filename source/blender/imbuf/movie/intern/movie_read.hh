@@ -28,6 +28,7 @@ struct SwsContext;
 #endif
 
 struct IDProperty;
+struct MovieFramePool;
 struct MovieIndex;
 
 struct MovieReader {
@@ -92,4 +93,7 @@ struct MovieReader {
   char suffix[64] = {}; /* MAX_NAME - multiview */
 
   IDProperty *metadata = nullptr;
+
+  /** Pixel buffers of freed frames, see #MOV_set_use_frame_pool. Shared with decoded frames. */
+  MovieFramePool *frame_pool = nullptr;
 };
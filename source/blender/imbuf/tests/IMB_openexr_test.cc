@@ -0,0 +1,219 @@
+/* SPDX-FileCopyrightText: 2025 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#include "testing/testing.h"
+
+#include "BLI_array.hh"
+#include "BLI_fileops.h"
+#include "BLI_path_utils.hh"
+#include "BLI_rect.h"
+#include "BLI_tempfile.h"
+
+#include "DNA_scene_types.h"
+
+#include "IMB_imbuf.hh"
+#include "IMB_openexr.hh"
+
+#include <OpenEXR/ImfChannelList.h>
+#include <OpenEXR/ImfFrameBuffer.h>
+#include <OpenEXR/ImfHeader.h>
+#include <OpenEXR/ImfTileDescription.h>
+#include <OpenEXR/ImfTiledOutputFile.h>
+
+namespace blender::imbuf::tests {
+
+static constexpr int test_width = 300;
+static constexpr int test_height = 600;
+
+static float test_pixel_value(const int x, const int y, const int channel, const int level = 0)
+{
+  return float(x) + float(y) * 1000.0f + float(channel) * 0.25f + float(level) * 0.0625f;
+}
+
+static std::string test_filepath(const char *name)
+{
+  char tempdir[FILE_MAX];
+  BLI_temp_directory_path_get(tempdir, sizeof(tempdir));
+  char filepath[FILE_MAX];
+  BLI_path_join(filepath, sizeof(filepath), tempdir, name);
+  return filepath;
+}
+
+/** Write a float RGBA file with pixel values encoding their position and channel. */
+static std::string write_test_file(const char *name, const int compression)
+{
+  const std::string filepath = test_filepath(name);
+
+  Array<float> pixels(int64_t(test_width) * test_height * 4);
+  for (int y = 0; y < test_height; y++) {
+    for (int x = 0; x < test_width; x++) {
+      for (int channel = 0; channel < 4; channel++) {
+        pixels[(int64_t(y) * test_width + x) * 4 + channel] = test_pixel_value(x, y, channel);
+      }
+    }
+  }
+
+  void *handle = IMB_exr_get_handle();
+  const char *channel_names[4] = {"R", "G", "B", "A"};
+  for (int channel = 0; channel < 4; channel++) {
+    IMB_exr_add_channel(handle,
+                        nullptr,
+                        channel_names[channel],
+                        nullptr,
+                        4,
+                        4 * test_width,
+                        pixels.data() + channel,
+                        false);
+  }
+  const double ppm[2] = {0.0, 0.0};
+  EXPECT_TRUE(IMB_exr_begin_write(
+      handle, filepath.c_str(), test_width, test_height, ppm, compression, 0, nullptr));
+  IMB_exr_write_channels(handle);
+  IMB_exr_close(handle);
+  return filepath;
+}
+
+/**
+ * Write a tiled float RGBA file with mip-maps, with pixel values encoding their position in the
+ * level, their channel and the level. Blender's images are bottom-up, the file is top-down.
+ */
+static std::string write_tiled_test_file(const char *name)
+{
+  const std::string filepath = test_filepath(name);
+  const char *channel_names[4] = {"R", "G", "B", "A"};
+
+  Imf::Header header(test_width, test_height);
+  header.compression() = Imf::ZIP_COMPRESSION;
+  header.setTileDescription(Imf::TileDescription(64, 32, Imf::MIPMAP_LEVELS, Imf::ROUND_DOWN));
+  for (const char *channel_name : channel_names) {
+    header.channels().insert(channel_name, Imf::Channel(Imf::FLOAT));
+  }
+
+  Imf::TiledOutputFile file(filepath.c_str(), header);
+  for (int level = 0; level < file.numLevels(); level++) {
+    const int width = file.levelWidth(level);
+    const int height = file.levelHeight(level);
+    Array<float> pixels(int64_t(width) * height * 4);
+    for (int y = 0; y < height; y++) {
+      for (int x = 0; x < width; x++) {
+        for (int channel = 0; channel < 4; channel++) {
+          pixels[(int64_t(height - 1 - y) * width + x) * 4 + channel] = test_pixel_value(
+              x, y, channel, level);
+        }
+      }
+    }
+    Imf::FrameBuffer frame_buffer;
+    for (int channel = 0; channel < 4; channel++) {
+      frame_buffer.insert(channel_names[channel],
+                          Imf::Slice(Imf::FLOAT,
+                                     reinterpret_cast<char *>(pixels.data() + channel),
+                                     sizeof(float[4]),
+                                     sizeof(float[4]) * width));
+    }
+    file.setFrameBuffer(frame_buffer);
+    file.writeTiles(0, file.numXTiles(level) - 1, 0, file.numYTiles(level) - 1, level);
+  }
+  return filepath;
+}
+
+static void expect_region_pixels(const ImBuf *ibuf,
+                                 const rcti &region,
+                                 const Span<int> channels,
+                                 const int level = 0)
+{
+  ASSERT_NE(ibuf, nullptr);
+  ASSERT_NE(ibuf->float_buffer.data, nullptr);
+  EXPECT_EQ(ibuf->x, BLI_rcti_size_x(&region));
+  EXPECT_EQ(ibuf->y, BLI_rcti_size_y(&region));
+  EXPECT_EQ(ibuf->channels, channels.size());
+  for (int y = 0; y < ibuf->y; y++) {
+    for (int x = 0; x < ibuf->x; x++) {
+      const float *pixel = ibuf->float_buffer.data +
+                           (int64_t(y) * ibuf->x + x) * ibuf->channels;
+      for (const int i : channels.index_range()) {
+        EXPECT_EQ(pixel[i],
+                  test_pixel_value(region.xmin + x, region.ymin + y, channels[i], level));
+      }
+    }
+  }
+}
+
+TEST(openexr, LoadRegion)
+{
+  /* No compression and ZIP compression, which stores blocks of 16 scan-lines. */
+  for (const int compression : {R_IMF_EXR_CODEC_NONE, R_IMF_EXR_CODEC_ZIP}) {
+    const std::string filepath = write_test_file("imbuf_openexr_region_test.exr", compression);
+
+    /* The region spans multiple batches of scan-lines. */
+    rcti region;
+    BLI_rcti_init(&region, 17, 141, 5, 533);
+    ImBuf *ibuf = IMB_exr_load_region(filepath.c_str(), &region, 0, nullptr, 0);
+    expect_region_pixels(ibuf, region, {0, 1, 2, 3});
+    IMB_freeImBuf(ibuf);
+
+    /* Subset of channels in a different order. */
+    const char *channel_names[2] = {"B", "R"};
+    BLI_rcti_init(&region, 290, 300, 590, 600);
+    ibuf = IMB_exr_load_region(filepath.c_str(), &region, 0, channel_names, 2);
+    expect_region_pixels(ibuf, region, {2, 0});
+    IMB_freeImBuf(ibuf);
+
+    /* The region is clamped to the image. */
+    BLI_rcti_init(&region, -10, 10, 595, 700);
+    ibuf = IMB_exr_load_region(filepath.c_str(), &region, 0, nullptr, 0);
+    BLI_rcti_init(&region, 0, 10, 595, 600);
+    expect_region_pixels(ibuf, region, {0, 1, 2, 3});
+    IMB_freeImBuf(ibuf);
+
+    /* Empty regions and mip-map levels of scan-line files can't be loaded. */
+    BLI_rcti_init(&region, 400, 500, 0, 10);
+    EXPECT_EQ(IMB_exr_load_region(filepath.c_str(), &region, 0, nullptr, 0), nullptr);
+    BLI_rcti_init(&region, 0, 10, 0, 10);
+    EXPECT_EQ(IMB_exr_load_region(filepath.c_str(), &region, 1, nullptr, 0), nullptr);
+
+    BLI_delete(filepath.c_str(), false, false);
+  }
+}
+
+TEST(openexr, LoadRegionTiled)
+{
+  const std::string filepath = write_tiled_test_file("imbuf_openexr_region_tiled_test.exr");
+
+  /* The region spans multiple rows and columns of tiles, without being aligned to them. */
+  rcti region;
+  BLI_rcti_init(&region, 17, 141, 5, 533);
+  ImBuf *ibuf = IMB_exr_load_region(filepath.c_str(), &region, 0, nullptr, 0);
+  expect_region_pixels(ibuf, region, {0, 1, 2, 3});
+  IMB_freeImBuf(ibuf);
+
+  /* Subset of channels in a different order, at the bottom of the image. */
+  const char *channel_names[3] = {"A", "G", "R"};
+  BLI_rcti_init(&region, 250, 300, 0, 40);
+  ibuf = IMB_exr_load_region(filepath.c_str(), &region, 0, channel_names, 3);
+  expect_region_pixels(ibuf, region, {3, 1, 0});
+  IMB_freeImBuf(ibuf);
+
+  /* Mip-map levels are half the size of the previous level, the region is clamped to them. */
+  BLI_rcti_init(&region, 30, 200, 100, 400);
+  ibuf = IMB_exr_load_region(filepath.c_str(), &region, 1, nullptr, 0);
+  BLI_rcti_init(&region, 30, 150, 100, 300);
+  expect_region_pixels(ibuf, region, {0, 1, 2, 3}, 1);
+  IMB_freeImBuf(ibuf);
+
+  BLI_rcti_init(&region, 0, 37, 0, 75);
+  ibuf = IMB_exr_load_region(filepath.c_str(), &region, 3, nullptr, 0);
+  expect_region_pixels(ibuf, region, {0, 1, 2, 3}, 3);
+  IMB_freeImBuf(ibuf);
+
+  /* The smallest level is a single pixel, there are no levels beyond it. */
+  BLI_rcti_init(&region, 0, 1, 0, 1);
+  ibuf = IMB_exr_load_region(filepath.c_str(), &region, 9, nullptr, 0);
+  expect_region_pixels(ibuf, region, {0, 1, 2, 3}, 9);
+  IMB_freeImBuf(ibuf);
+  EXPECT_EQ(IMB_exr_load_region(filepath.c_str(), &region, 10, nullptr, 0), nullptr);
+
+  BLI_delete(filepath.c_str(), false, false);
+}
+
+}  // namespace blender::imbuf::tests
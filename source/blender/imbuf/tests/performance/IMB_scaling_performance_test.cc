@@ -142,3 +142,44 @@ TEST(imbuf_scaling, scaling_perf_float)
 {
   test_scaling_perf(true);
 }
+
+static void transform_rotate_perf_impl(const char *name,
+                                       bool use_float,
+                                       eIMBInterpolationFilterMode filter)
+{
+  /* Rotate and scale down around the image center, like a transformed sequencer strip. */
+  ImBuf *src = create_src_image(use_float);
+  ImBuf *dst = IMB_allocImBuf(DST_SMALLER_X, DST_SMALLER_Y, src->planes, src->flags);
+  const float2 src_center = float2(src->x, src->y) * 0.5f;
+  const float2 dst_center = float2(dst->x, dst->y) * 0.5f;
+  const float3x3 matrix = math::from_loc_rot_scale<float3x3>(
+                              src_center, math::AngleRadian(0.3f), float2(2.1f, 1.4f)) *
+                          math::from_location<float3x3>(-dst_center);
+  const rctf src_crop = {0.0f, float(src->x), 0.0f, float(src->y)};
+  {
+    SCOPED_TIMER(name);
+    for (int i = 0; i < 4; i++) {
+      IMB_transform(src, dst, IMB_TRANSFORM_MODE_CROP_SRC, filter, matrix, &src_crop);
+    }
+  }
+  IMB_freeImBuf(src);
+  IMB_freeImBuf(dst);
+}
+
+static void test_transform_rotate_perf(bool use_float)
+{
+  transform_rotate_perf_impl("xrot_neare_m", use_float, IMB_FILTER_NEAREST);
+  transform_rotate_perf_impl("xrot_bilin_m", use_float, IMB_FILTER_BILINEAR);
+  transform_rotate_perf_impl("xrot_cubic_m", use_float, IMB_FILTER_CUBIC_BSPLINE);
+  transform_rotate_perf_impl("xrot_boxfl_m", use_float, IMB_FILTER_BOX);
+}
+
+TEST(imbuf_scaling, transform_rotate_perf_byte)
+{
+  test_transform_rotate_perf(false);
+}
+
+TEST(imbuf_scaling, transform_rotate_perf_float)
+{
+  test_transform_rotate_perf(true);
+}
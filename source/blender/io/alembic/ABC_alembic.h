@@ -125,6 +125,15 @@ struct ABCReadParams {
   int read_flags;
   const char *velocity_name;
   float velocity_scale;
+
+  /** Times of upcoming frames to read ahead of time on background threads, may be null. */
+  const double *prefetch_times = nullptr;
+  int prefetch_times_num = 0;
+  /**
+   * Memory limit in bytes for the frames read ahead of time, shared by the cache file.
+   * Zero frees the frames that were read ahead of time.
+   */
+  int64_t prefetch_memory_limit = 0;
 };
 
 #ifdef __cplusplus
@@ -18,6 +18,8 @@
 #include <string>
 
 #include "BLI_assert.h"
+#include "BLI_task.hh"
+#include "BLI_vector.hh"
 
 #include "DNA_layer_types.h"
 #include "DNA_object_types.h"
@@ -34,10 +36,43 @@ ABCHierarchyIterator::ABCHierarchyIterator(Main *bmain,
 
 void ABCHierarchyIterator::iterate_and_write()
 {
+  defer_writes_ = true;
   AbstractHierarchyIterator::iterate_and_write();
+  defer_writes_ = false;
+
+  write_deferred();
   update_archive_bounding_box();
 }
 
+bool ABCHierarchyIterator::is_deferring_writes() const
+{
+  return defer_writes_;
+}
+
+void ABCHierarchyIterator::write_deferred()
+{
+  Vector<ABCAbstractWriter *> deferred_writers;
+  for (AbstractHierarchyWriter *abstract_writer : writers_.values()) {
+    ABCAbstractWriter *abc_writer = static_cast<ABCAbstractWriter *>(abstract_writer);
+    if (abc_writer->has_deferred_write()) {
+      deferred_writers.append(abc_writer);
+    }
+  }
+
+  /* Extracting the data from Blender is where most of the time goes for scenes with many
+   * objects, and only reads the evaluated depsgraph. The archive can only be written to from one
+   * thread at a time. */
+  threading::parallel_for(deferred_writers.index_range(), 1, [&](const IndexRange range) {
+    for (const int i : range) {
+      deferred_writers[i]->prepare_deferred_write();
+    }
+  });
+
+  for (ABCAbstractWriter *abc_writer : deferred_writers) {
+    abc_writer->finish_deferred_write();
+  }
+}
+
 void ABCHierarchyIterator::update_archive_bounding_box()
 {
   Imath::Box3d bounds;
@@ -36,6 +36,9 @@ class ABCHierarchyIterator : public AbstractHierarchyIterator {
   ABCArchive *abc_archive_;
   const AlembicExportParams &params_;
 
+  /* Set while iterating, see is_deferring_writes(). */
+  bool defer_writes_ = false;
+
  public:
   ABCHierarchyIterator(Main *bmain,
                        Depsgraph *depsgraph,
@@ -45,6 +48,11 @@ class ABCHierarchyIterator : public AbstractHierarchyIterator {
   void iterate_and_write() override;
   std::string make_valid_name(const std::string &name) const override;
 
+  /* When true, writers that support it postpone writing the current frame until the whole
+   * hierarchy has been visited. Their data is then extracted from Blender in parallel, and
+   * written to the archive afterwards, one writer at a time. */
+  bool is_deferring_writes() const;
+
   Alembic::Abc::OObject get_alembic_object(const std::string &export_path) const;
 
  protected:
@@ -66,6 +74,7 @@ class ABCHierarchyIterator : public AbstractHierarchyIterator {
  private:
   Alembic::Abc::OObject get_alembic_parent(const HierarchyContext *context) const;
   ABCWriterConstructorArgs writer_constructor_args(const HierarchyContext *context) const;
+  void write_deferred();
   void update_archive_bounding_box();
   void update_bounding_box_recursive(Imath::Box3d &bounds, const HierarchyContext *context);
 
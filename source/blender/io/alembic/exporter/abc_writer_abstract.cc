@@ -4,6 +4,8 @@
 #include "abc_writer_abstract.h"
 #include "abc_hierarchy_iterator.h"
 
+#include "BLI_assert.h"
+
 #include "BKE_object.hh"
 
 #include "DNA_object_types.h"
@@ -43,6 +45,36 @@ void ABCAbstractWriter::write(HierarchyContext &context)
     return;
   }
 
+  if (args_.hierarchy_iterator->is_deferring_writes() && supports_parallel_prepare()) {
+    deferred_context_ = context;
+    return;
+  }
+
+  prepare_write(context);
+  finish_write(context);
+}
+
+bool ABCAbstractWriter::has_deferred_write() const
+{
+  return deferred_context_.has_value();
+}
+
+void ABCAbstractWriter::prepare_deferred_write()
+{
+  BLI_assert(deferred_context_);
+  prepare_write(*deferred_context_);
+}
+
+void ABCAbstractWriter::finish_deferred_write()
+{
+  BLI_assert(deferred_context_);
+  HierarchyContext context = std::move(*deferred_context_);
+  deferred_context_.reset();
+  finish_write(context);
+}
+
+void ABCAbstractWriter::finish_write(HierarchyContext &context)
+{
   do_write(context);
 
   if (custom_props_) {
@@ -52,6 +84,13 @@ void ABCAbstractWriter::write(HierarchyContext &context)
   frame_has_been_written_ = true;
 }
 
+bool ABCAbstractWriter::supports_parallel_prepare() const
+{
+  return false;
+}
+
+void ABCAbstractWriter::prepare_write(HierarchyContext & /*context*/) {}
+
 void ABCAbstractWriter::ensure_custom_properties_exporter(const HierarchyContext &context)
 {
   if (!args_.export_params->export_custom_properties) {
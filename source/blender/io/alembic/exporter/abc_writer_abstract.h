@@ -10,6 +10,7 @@
 #include <Alembic/Abc/OObject.h>
 
 #include <memory>
+#include <optional>
 
 struct IDProperty;
 struct Object;
@@ -31,11 +32,25 @@ class ABCAbstractWriter : public AbstractHierarchyWriter {
   /* Optional writer for custom properties. */
   std::unique_ptr<CustomPropertiesExporter> custom_props_;
 
+ private:
+  /* Context of the current frame when writing it was postponed by write(), see
+   * ABCHierarchyIterator::write_deferred(). */
+  std::optional<HierarchyContext> deferred_context_;
+
+  void finish_write(HierarchyContext &context);
+
  public:
   explicit ABCAbstractWriter(const ABCWriterConstructorArgs &args);
 
   void write(HierarchyContext &context) override;
 
+  bool has_deferred_write() const;
+  /* Run prepare_write() for the postponed frame. Called on worker threads, in parallel with the
+   * other writers of the frame. */
+  void prepare_deferred_write();
+  /* Write the postponed frame to Alembic. Called on the main thread, one writer at a time. */
+  void finish_deferred_write();
+
   /* Returns true if the data to be written is actually supported. This would, for example, allow a
    * hypothetical camera writer accept a perspective camera but reject an orthogonal one.
    *
@@ -65,6 +80,14 @@ class ABCAbstractWriter : public AbstractHierarchyWriter {
   virtual Alembic::Abc::OCompoundProperty abc_prop_for_custom_props() = 0;
 
  protected:
+  /* Return true if prepare_write() may run on a worker thread. The hierarchy iterator then
+   * postpones writing until all writers of the frame are known, and prepares them in parallel. */
+  virtual bool supports_parallel_prepare() const;
+
+  /* Extract the data of the current frame from Blender, so that do_write() only has to hand it
+   * to Alembic. Must not touch the Alembic archive. Called before every do_write(). */
+  virtual void prepare_write(HierarchyContext &context);
+
   virtual void do_write(HierarchyContext &context) = 0;
 
   virtual void update_bounding_box(Object *object);
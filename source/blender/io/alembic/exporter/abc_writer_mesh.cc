@@ -71,6 +71,12 @@ ABCGenericMeshWriter::ABCGenericMeshWriter(const ABCWriterConstructorArgs &args)
 {
 }
 
+ABCGenericMeshWriter::~ABCGenericMeshWriter()
+{
+  /* Only when writing a prepared frame failed. */
+  free_frame_data();
+}
+
 void ABCGenericMeshWriter::create_alembic_objects(const HierarchyContext *context)
 {
   if (!args_.export_params->apply_subdiv && export_as_subdivision_surface(context->object)) {
@@ -132,8 +138,10 @@ bool ABCGenericMeshWriter::is_supported(const HierarchyContext *context) const
   return true;
 }
 
-void ABCGenericMeshWriter::do_write(HierarchyContext &context)
+void ABCGenericMeshWriter::prepare_write(HierarchyContext &context)
 {
+  free_frame_data();
+
   Object *object = context.object;
   bool needsfree = false;
 
@@ -169,15 +177,49 @@ void ABCGenericMeshWriter::do_write(HierarchyContext &context)
     needsfree = true;
   }
 
+  /* The topology is only read when exporting. Not requesting write access also avoids modifying
+   * meshes that are shared by multiple objects, which may be prepared in parallel. */
   m_custom_data_config.pack_uvs = args_.export_params->packuv;
   m_custom_data_config.mesh = mesh;
-  m_custom_data_config.face_offsets = mesh->face_offsets_for_write().data();
-  m_custom_data_config.corner_verts = mesh->corner_verts_for_write().data();
+  m_custom_data_config.face_offsets = const_cast<int *>(mesh->face_offsets().data());
+  m_custom_data_config.corner_verts = const_cast<int *>(mesh->corner_verts().data());
   m_custom_data_config.faces_num = mesh->faces_num;
   m_custom_data_config.totloop = mesh->corners_num;
   m_custom_data_config.totvert = mesh->verts_num;
   m_custom_data_config.timesample_index = timesample_index_;
 
+  FrameData &data = frame_data_;
+  data.mesh = mesh;
+  data.mesh_needs_free = needsfree;
+
+  get_vertices(mesh, data.points);
+  get_topology(mesh, data.face_verts, data.loop_counts);
+
+  if (args_.export_params->uvs) {
+    data.uv_name = get_uv_sample(data.uvs_and_indices, m_custom_data_config, &mesh->corner_data);
+  }
+
+  if (is_subd_) {
+    get_edge_creases(
+        mesh, data.edge_crease_indices, data.edge_crease_lengths, data.edge_crease_sharpness);
+    get_vert_creases(mesh, data.vert_crease_indices, data.vert_crease_sharpness);
+  }
+  else {
+    if (args_.export_params->normals) {
+      get_loop_normals(mesh, data.normals);
+    }
+    data.has_velocities = get_velocities(mesh, data.velocities);
+  }
+}
+
+void ABCGenericMeshWriter::do_write(HierarchyContext &context)
+{
+  Mesh *mesh = frame_data_.mesh;
+
+  if (mesh == nullptr) {
+    return;
+  }
+
   try {
     if (is_subd_) {
       write_subd(context, mesh);
@@ -185,17 +227,20 @@ void ABCGenericMeshWriter::do_write(HierarchyContext &context)
     else {
       write_mesh(context, mesh);
     }
-
-    if (needsfree) {
-      free_export_mesh(mesh);
-    }
   }
   catch (...) {
-    if (needsfree) {
-      free_export_mesh(mesh);
-    }
+    free_frame_data();
     throw;
   }
+  free_frame_data();
+}
+
+void ABCGenericMeshWriter::free_frame_data()
+{
+  if (frame_data_.mesh && frame_data_.mesh_needs_free) {
+    free_export_mesh(frame_data_.mesh);
+  }
+  frame_data_ = {};
 }
 
 void ABCGenericMeshWriter::free_export_mesh(Mesh *mesh)
@@ -205,24 +250,19 @@ void ABCGenericMeshWriter::free_export_mesh(Mesh *mesh)
 
 void ABCGenericMeshWriter::write_mesh(HierarchyContext &context, Mesh *mesh)
 {
-  std::vector<Imath::V3f> points, normals;
-  std::vector<int32_t> face_verts, loop_counts;
-  std::vector<Imath::V3f> velocities;
-
-  get_vertices(mesh, points);
-  get_topology(mesh, face_verts, loop_counts);
+  const FrameData &data = frame_data_;
 
   if (!frame_has_been_written_ && args_.export_params->face_sets) {
     write_face_sets(context.object, mesh, abc_poly_mesh_schema_);
   }
 
   OPolyMeshSchema::Sample mesh_sample = OPolyMeshSchema::Sample(
-      V3fArraySample(points), Int32ArraySample(face_verts), Int32ArraySample(loop_counts));
-
-  UVSample uvs_and_indices;
+      V3fArraySample(data.points),
+      Int32ArraySample(data.face_verts),
+      Int32ArraySample(data.loop_counts));
 
   if (args_.export_params->uvs) {
-    const char *name = get_uv_sample(uvs_and_indices, m_custom_data_config, &mesh->corner_data);
+    const UVSample &uvs_and_indices = data.uvs_and_indices;
 
     if (!uvs_and_indices.indices.empty() && !uvs_and_indices.uvs.empty()) {
       OV2fGeomParam::Sample uv_sample;
@@ -230,7 +270,7 @@ void ABCGenericMeshWriter::write_mesh(HierarchyContext &context, Mesh *mesh)
       uv_sample.setIndices(UInt32ArraySample(uvs_and_indices.indices));
       uv_sample.setScope(kFacevaryingScope);
 
-      abc_poly_mesh_schema_.setUVSourceName(name);
+      abc_poly_mesh_schema_.setUVSourceName(data.uv_name);
       mesh_sample.setUVs(uv_sample);
     }
 
@@ -241,12 +281,10 @@ void ABCGenericMeshWriter::write_mesh(HierarchyContext &context, Mesh *mesh)
   }
 
   if (args_.export_params->normals) {
-    get_loop_normals(mesh, normals);
-
     ON3fGeomParam::Sample normals_sample;
-    if (!normals.empty()) {
+    if (!data.normals.empty()) {
       normals_sample.setScope(kFacevaryingScope);
-      normals_sample.setVals(V3fArraySample(normals));
+      normals_sample.setVals(V3fArraySample(data.normals));
     }
 
     mesh_sample.setNormals(normals_sample);
@@ -256,8 +294,8 @@ void ABCGenericMeshWriter::write_mesh(HierarchyContext &context, Mesh *mesh)
     write_generated_coordinates(abc_poly_mesh_schema_.getArbGeomParams(), m_custom_data_config);
   }
 
-  if (get_velocities(mesh, velocities)) {
-    mesh_sample.setVelocities(V3fArraySample(velocities));
+  if (data.has_velocities) {
+    mesh_sample.setVelocities(V3fArraySample(data.velocities));
   }
 
   update_bounding_box(context.object);
@@ -270,26 +308,19 @@ void ABCGenericMeshWriter::write_mesh(HierarchyContext &context, Mesh *mesh)
 
 void ABCGenericMeshWriter::write_subd(HierarchyContext &context, Mesh *mesh)
 {
-  std::vector<float> edge_crease_sharpness, vert_crease_sharpness;
-  std::vector<Imath::V3f> points;
-  std::vector<int32_t> face_verts, loop_counts;
-  std::vector<int32_t> edge_crease_indices, edge_crease_lengths, vert_crease_indices;
-
-  get_vertices(mesh, points);
-  get_topology(mesh, face_verts, loop_counts);
-  get_edge_creases(mesh, edge_crease_indices, edge_crease_lengths, edge_crease_sharpness);
-  get_vert_creases(mesh, vert_crease_indices, vert_crease_sharpness);
+  const FrameData &data = frame_data_;
 
   if (!frame_has_been_written_ && args_.export_params->face_sets) {
     write_face_sets(context.object, mesh, abc_subdiv_schema_);
   }
 
   OSubDSchema::Sample subdiv_sample = OSubDSchema::Sample(
-      V3fArraySample(points), Int32ArraySample(face_verts), Int32ArraySample(loop_counts));
+      V3fArraySample(data.points),
+      Int32ArraySample(data.face_verts),
+      Int32ArraySample(data.loop_counts));
 
-  UVSample sample;
   if (args_.export_params->uvs) {
-    const char *name = get_uv_sample(sample, m_custom_data_config, &mesh->corner_data);
+    const UVSample &sample = data.uvs_and_indices;
 
     if (!sample.indices.empty() && !sample.uvs.empty()) {
       OV2fGeomParam::Sample uv_sample;
@@ -297,7 +328,7 @@ void ABCGenericMeshWriter::write_subd(HierarchyContext &context, Mesh *mesh)
       uv_sample.setIndices(UInt32ArraySample(sample.indices));
       uv_sample.setScope(kFacevaryingScope);
 
-      abc_subdiv_schema_.setUVSourceName(name);
+      abc_subdiv_schema_.setUVSourceName(data.uv_name);
       subdiv_sample.setUVs(uv_sample);
     }
 
@@ -311,15 +342,15 @@ void ABCGenericMeshWriter::write_subd(HierarchyContext &context, Mesh *mesh)
     write_generated_coordinates(abc_subdiv_schema_.getArbGeomParams(), m_custom_data_config);
   }
 
-  if (!edge_crease_indices.empty()) {
-    subdiv_sample.setCreaseIndices(Int32ArraySample(edge_crease_indices));
-    subdiv_sample.setCreaseLengths(Int32ArraySample(edge_crease_lengths));
-    subdiv_sample.setCreaseSharpnesses(FloatArraySample(edge_crease_sharpness));
+  if (!data.edge_crease_indices.empty()) {
+    subdiv_sample.setCreaseIndices(Int32ArraySample(data.edge_crease_indices));
+    subdiv_sample.setCreaseLengths(Int32ArraySample(data.edge_crease_lengths));
+    subdiv_sample.setCreaseSharpnesses(FloatArraySample(data.edge_crease_sharpness));
   }
 
-  if (!vert_crease_indices.empty()) {
-    subdiv_sample.setCornerIndices(Int32ArraySample(vert_crease_indices));
-    subdiv_sample.setCornerSharpnesses(FloatArraySample(vert_crease_sharpness));
+  if (!data.vert_crease_indices.empty()) {
+    subdiv_sample.setCornerIndices(Int32ArraySample(data.vert_crease_indices));
+    subdiv_sample.setCornerSharpnesses(FloatArraySample(data.vert_crease_sharpness));
   }
 
   update_bounding_box(context.object);
@@ -565,6 +596,13 @@ static void get_loop_normals(const Mesh *mesh, std::vector<Imath::V3f> &normals)
 
 ABCMeshWriter::ABCMeshWriter(const ABCWriterConstructorArgs &args) : ABCGenericMeshWriter(args) {}
 
+bool ABCMeshWriter::supports_parallel_prepare() const
+{
+  /* The evaluated mesh only has to be read. Other object types may convert their data to a mesh
+   * first, which is not known to be thread-safe. */
+  return true;
+}
+
 Mesh *ABCMeshWriter::get_export_mesh(Object *object_eval, bool & /*r_needsfree*/)
 {
   return BKE_object_get_evaluated_mesh(object_eval);
@@ -36,8 +36,34 @@ class ABCGenericMeshWriter : public ABCAbstractWriter {
 
   CDStreamConfig m_custom_data_config;
 
+  /* Data of the current frame, extracted from Blender by prepare_write(). */
+  struct FrameData {
+    Mesh *mesh = nullptr;
+    bool mesh_needs_free = false;
+
+    std::vector<Imath::V3f> points;
+    std::vector<int32_t> face_verts;
+    std::vector<int32_t> loop_counts;
+    UVSample uvs_and_indices;
+    const char *uv_name = nullptr;
+
+    /* Only for poly-meshes. */
+    std::vector<Imath::V3f> normals;
+    std::vector<Imath::V3f> velocities;
+    bool has_velocities = false;
+
+    /* Only for subdivision surfaces. */
+    std::vector<int32_t> edge_crease_indices;
+    std::vector<int32_t> edge_crease_lengths;
+    std::vector<float> edge_crease_sharpness;
+    std::vector<int32_t> vert_crease_indices;
+    std::vector<float> vert_crease_sharpness;
+  };
+  FrameData frame_data_;
+
  public:
   explicit ABCGenericMeshWriter(const ABCWriterConstructorArgs &args);
+  ~ABCGenericMeshWriter() override;
 
   void create_alembic_objects(const HierarchyContext *context) override;
   Alembic::Abc::OObject get_alembic_object() const override;
@@ -45,6 +71,7 @@ class ABCGenericMeshWriter : public ABCAbstractWriter {
 
  protected:
   bool is_supported(const HierarchyContext *context) const override;
+  void prepare_write(HierarchyContext &context) override;
   void do_write(HierarchyContext &context) override;
 
   virtual Mesh *get_export_mesh(Object *object_eval, bool &r_needsfree) = 0;
@@ -53,6 +80,7 @@ class ABCGenericMeshWriter : public ABCAbstractWriter {
   virtual bool export_as_subdivision_surface(Object *ob_eval) const;
 
  private:
+  void free_frame_data();
   void write_mesh(HierarchyContext &context, Mesh *mesh);
   void write_subd(HierarchyContext &context, Mesh *mesh);
   template<typename Schema> void write_face_sets(Object *object, Mesh *mesh, Schema &schema);
@@ -70,6 +98,7 @@ class ABCMeshWriter : public ABCGenericMeshWriter {
   ABCMeshWriter(const ABCWriterConstructorArgs &args);
 
  protected:
+  bool supports_parallel_prepare() const override;
   Mesh *get_export_mesh(Object *object_eval, bool &r_needsfree) override;
 };
 
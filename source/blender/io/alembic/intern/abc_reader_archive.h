@@ -7,6 +7,8 @@
  * \ingroup balembic
  */
 
+#include "IO_frame_prefetch.hh"
+
 #include <Alembic/Abc/IArchive.h>
 #include <Alembic/Abc/IObject.h>
 
@@ -29,6 +31,9 @@ class ArchiveReader {
 
   std::vector<ArchiveReader *> m_readers;
 
+  /** Frames of the mesh readers opened from this archive, read ahead of time. */
+  io::FramePrefetchCache m_prefetch_cache;
+
   ArchiveReader(const std::vector<ArchiveReader *> &readers);
 
   ArchiveReader(const struct Main *bmain, const char *filename);
@@ -44,6 +49,11 @@ class ArchiveReader {
 
   /* Detect if the Archive was written by Blender prior to 4.4. */
   bool is_blender_archive_version_prior_44();
+
+  io::FramePrefetchCache &prefetch_cache()
+  {
+    return m_prefetch_cache;
+  }
 };
 
 }  // namespace blender::io::alembic
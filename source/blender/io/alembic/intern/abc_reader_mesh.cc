@@ -25,6 +25,8 @@
 
 #include "BLT_translation.hh"
 
+#include "IO_frame_prefetch.hh"
+
 #include "BKE_customdata.hh"
 #include "BKE_geometry_set.hh"
 #include "BKE_lib_id.hh"
@@ -246,6 +248,43 @@ static void read_mpolys(CDStreamConfig &config, const AbcMeshData &mesh_data)
   }
 }
 
+/**
+ * Only read the UVs of the corners, for meshes that keep their faces from an earlier sample.
+ * The corner order matches the one of #read_mpolys.
+ */
+static void read_corner_uvs(CDStreamConfig &config, const AbcMeshData &mesh_data)
+{
+  float2 *mloopuvs = config.mloopuv;
+  const Int32ArraySamplePtr &face_indices = mesh_data.face_indices;
+  const Int32ArraySamplePtr &face_counts = mesh_data.face_counts;
+  const V2fArraySamplePtr &uvs = mesh_data.uvs;
+  const UInt32ArraySamplePtr &uvs_indices = mesh_data.uvs_indices;
+
+  if (!(mloopuvs && uvs && uvs_indices)) {
+    return;
+  }
+
+  const size_t uvs_size = uvs->size();
+  const bool do_uvs_per_loop = mesh_data.uv_scope == ABC_UV_SCOPE_LOOP;
+  uint loop_index = 0;
+
+  for (int i = 0; i < face_counts->size(); i++) {
+    const int face_size = (*face_counts)[i];
+
+    /* NOTE: Alembic data is stored in the reverse order. */
+    uint rev_loop_index = loop_index + (face_size - 1);
+    for (int f = 0; f < face_size; f++, loop_index++, rev_loop_index--) {
+      const int vert = (*face_indices)[loop_index];
+      const uint uv_index = (*uvs_indices)[do_uvs_per_loop ? loop_index : vert];
+      if (uv_index >= uvs_size) {
+        continue;
+      }
+      mloopuvs[rev_loop_index][0] = (*uvs)[uv_index][0];
+      mloopuvs[rev_loop_index][1] = (*uvs)[uv_index][1];
+    }
+  }
+}
+
 static void process_no_normals(CDStreamConfig & /*config*/)
 {
   /* Absence of normals in the Alembic mesh is interpreted as 'smooth'. */
@@ -306,19 +345,14 @@ static void process_vertex_normals(CDStreamConfig &config,
   bke::mesh_set_custom_normals_from_verts(*config.mesh, vert_normals);
 }
 
-static void process_normals(CDStreamConfig &config,
-                            const IN3fGeomParam &normals,
-                            const ISampleSelector &selector)
+static void process_normals(CDStreamConfig &config, const IN3fGeomParam::Sample &normsamp)
 {
-  if (!normals.valid()) {
+  if (!normsamp.valid()) {
     process_no_normals(config);
     return;
   }
 
-  IN3fGeomParam::Sample normsamp = normals.getExpandedValue(selector);
-  Alembic::AbcGeom::GeometryScope scope = normals.getScope();
-
-  switch (scope) {
+  switch (normsamp.getScope()) {
     case Alembic::AbcGeom::kFacevaryingScope: /* 'Vertex Normals' in Houdini. */
       process_loop_normals(config, normsamp.getVals());
       break;
@@ -427,32 +461,121 @@ static bool samples_have_same_topology(const SampleType &sample, const SampleTyp
   return true;
 }
 
+/**
+ * Samples of a mesh that change every frame, read from the file either right before they are
+ * converted, or ahead of time on a worker thread (see #io::FramePrefetchCache).
+ */
+struct AbcMeshFrame : public io::PrefetchedFrame {
+  IPolyMeshSchema::Sample sample;
+
+  /* Optional settings for reading interpolated vertices. If present, `ceil_positions` is
+   * valid. */
+  std::optional<SampleInterpolationSettings> interpolation_settings;
+  P3fArraySamplePtr ceil_positions;
+
+  /* Only read with #MOD_MESHSEQ_READ_POLY. */
+  IN3fGeomParam::Sample normals;
+  V3fArraySamplePtr velocities;
+
+  /* The settings the frame was read with. */
+  int read_flag = 0;
+  std::string velocity_name;
+
+  int64_t size_in_bytes() const override
+  {
+    int64_t size = 0;
+    if (const P3fArraySamplePtr &positions = sample.getPositions()) {
+      size += positions->size() * sizeof(Imath::V3f);
+    }
+    if (const Int32ArraySamplePtr &face_indices = sample.getFaceIndices()) {
+      size += face_indices->size() * sizeof(int32_t);
+    }
+    if (const Int32ArraySamplePtr &face_counts = sample.getFaceCounts()) {
+      size += face_counts->size() * sizeof(int32_t);
+    }
+    if (ceil_positions) {
+      size += ceil_positions->size() * sizeof(Imath::V3f);
+    }
+    if (normals.valid()) {
+      size += normals.getVals()->size() * sizeof(Imath::V3f);
+    }
+    if (velocities) {
+      size += velocities->size() * sizeof(Imath::V3f);
+    }
+    return size;
+  }
+
+  /** Whether the frame contains everything needed to read a mesh with the given settings. */
+  bool is_compatible(const int other_read_flag, const std::string &other_velocity_name) const
+  {
+    if ((other_read_flag & MOD_MESHSEQ_READ_POLY) && !(read_flag & MOD_MESHSEQ_READ_POLY)) {
+      return false;
+    }
+    return (other_read_flag & MOD_MESHSEQ_INTERPOLATE_VERTICES) ==
+               (read_flag & MOD_MESHSEQ_INTERPOLATE_VERTICES) &&
+           other_velocity_name == velocity_name;
+  }
+};
+
+/**
+ * Read the samples that change every frame. Only accesses the schema, so it can be called from
+ * worker threads. May throw an #Alembic::Util::Exception.
+ */
+static std::unique_ptr<AbcMeshFrame> read_mesh_frame(const IPolyMeshSchema &schema,
+                                                     const ISampleSelector &selector,
+                                                     const int read_flag,
+                                                     const std::string &velocity_name)
+{
+  std::unique_ptr<AbcMeshFrame> frame = std::make_unique<AbcMeshFrame>();
+  frame->read_flag = read_flag;
+  frame->velocity_name = velocity_name;
+  frame->sample = schema.getValue(selector);
+
+  if (read_flag & MOD_MESHSEQ_INTERPOLATE_VERTICES) {
+    const std::optional<SampleInterpolationSettings> interpolation_settings =
+        get_sample_interpolation_settings(
+            selector, schema.getTimeSampling(), schema.getNumSamples());
+    if (interpolation_settings.has_value()) {
+      Alembic::AbcGeom::IPolyMeshSchema::Sample ceil_sample;
+      schema.get(ceil_sample, Alembic::Abc::ISampleSelector(interpolation_settings->ceil_index));
+      if (samples_have_same_topology(frame->sample, ceil_sample)) {
+        /* Only set interpolation data if the samples are compatible. */
+        frame->ceil_positions = ceil_sample.getPositions();
+        frame->interpolation_settings = interpolation_settings;
+      }
+    }
+  }
+
+  if (read_flag & MOD_MESHSEQ_READ_POLY) {
+    const IN3fGeomParam &normals = schema.getNormalsParam();
+    if (normals.valid()) {
+      frame->normals = normals.getExpandedValue(selector);
+    }
+  }
+
+  if (!velocity_name.empty()) {
+    frame->velocities = get_velocity_prop(schema, selector, velocity_name);
+  }
+
+  return frame;
+}
+
 static void read_mesh_sample(const std::string &iobject_full_name,
                              ImportSettings *settings,
                              const IPolyMeshSchema &schema,
                              const ISampleSelector &selector,
+                             const AbcMeshFrame &frame,
+                             const bool keep_topology,
                              CDStreamConfig &config)
 {
-  const IPolyMeshSchema::Sample sample = schema.getValue(selector);
-
   AbcMeshData abc_mesh_data;
-  abc_mesh_data.face_counts = sample.getFaceCounts();
-  abc_mesh_data.face_indices = sample.getFaceIndices();
-  abc_mesh_data.positions = sample.getPositions();
-
-  const std::optional<SampleInterpolationSettings> interpolation_settings =
-      get_sample_interpolation_settings(
-          selector, schema.getTimeSampling(), schema.getNumSamples());
+  abc_mesh_data.face_counts = frame.sample.getFaceCounts();
+  abc_mesh_data.face_indices = frame.sample.getFaceIndices();
+  abc_mesh_data.positions = frame.sample.getPositions();
 
-  const bool use_vertex_interpolation = settings->read_flag & MOD_MESHSEQ_INTERPOLATE_VERTICES;
-  if (use_vertex_interpolation && interpolation_settings.has_value()) {
-    Alembic::AbcGeom::IPolyMeshSchema::Sample ceil_sample;
-    schema.get(ceil_sample, Alembic::Abc::ISampleSelector(interpolation_settings->ceil_index));
-    if (samples_have_same_topology(sample, ceil_sample)) {
-      /* Only set interpolation data if the samples are compatible. */
-      abc_mesh_data.ceil_positions = ceil_sample.getPositions();
-      abc_mesh_data.interpolation_settings = interpolation_settings;
-    }
+  if (settings->read_flag & MOD_MESHSEQ_INTERPOLATE_VERTICES) {
+    abc_mesh_data.ceil_positions = frame.ceil_positions;
+    abc_mesh_data.interpolation_settings = frame.interpolation_settings;
   }
 
   if ((settings->read_flag & MOD_MESHSEQ_READ_UV) != 0) {
@@ -465,29 +588,38 @@ static void read_mesh_sample(const std::string &iobject_full_name,
   }
 
   if ((settings->read_flag & MOD_MESHSEQ_READ_POLY) != 0) {
-    read_mpolys(config, abc_mesh_data);
-    process_normals(config, schema.getNormalsParam(), selector);
+    if (keep_topology) {
+      read_corner_uvs(config, abc_mesh_data);
+    }
+    else {
+      read_mpolys(config, abc_mesh_data);
+    }
+    process_normals(config, frame.normals);
   }
 
   if ((settings->read_flag & (MOD_MESHSEQ_READ_UV | MOD_MESHSEQ_READ_COLOR)) != 0) {
     read_custom_data(iobject_full_name, schema.getArbGeomParams(), config, selector);
   }
 
-  if (!settings->velocity_name.empty() && settings->velocity_scale != 0.0f) {
-    V3fArraySamplePtr velocities = get_velocity_prop(schema, selector, settings->velocity_name);
-    if (velocities) {
-      read_velocity(velocities, config, settings->velocity_scale);
-    }
+  if (!settings->velocity_name.empty() && settings->velocity_scale != 0.0f && frame.velocities) {
+    read_velocity(frame.velocities, config, settings->velocity_scale);
   }
 }
 
-static CDStreamConfig get_config(Mesh *mesh)
+static CDStreamConfig get_config(Mesh *mesh, const bool keep_topology)
 {
   CDStreamConfig config;
   config.mesh = mesh;
   config.positions = mesh->vert_positions_for_write().data();
-  config.corner_verts = mesh->corner_verts_for_write().data();
-  config.face_offsets = mesh->face_offsets_for_write().data();
+  if (keep_topology) {
+    /* Only read then. Not requesting write access keeps the arrays shared with the input mesh,
+     * along with the caches that depend on them. */
+    config.corner_verts = const_cast<int *>(mesh->corner_verts().data());
+  }
+  else {
+    config.corner_verts = mesh->corner_verts_for_write().data();
+    config.face_offsets = mesh->face_offsets_for_write().data();
+  }
   config.totvert = mesh->verts_num;
   config.totloop = mesh->corners_num;
   config.faces_num = mesh->faces_num;
@@ -616,6 +748,42 @@ bool AbcMeshReader::accepts_object_type(
   return true;
 }
 
+/**
+ * Expects the element counts to match already. Faces of the sample with consecutive corners of the
+ * same vertex never match, so that the mesh is validated again by #read_mpolys.
+ */
+static bool mesh_faces_match_sample(const Mesh &mesh,
+                                    const Alembic::Abc::Int32ArraySample &face_indices,
+                                    const Alembic::Abc::Int32ArraySample &face_counts)
+{
+  uint abc_index = 0;
+
+  const int *mesh_corner_verts = mesh.corner_verts().data();
+  const int *mesh_face_offsets = mesh.face_offsets().data();
+
+  for (int i = 0; i < face_counts.size(); i++) {
+    if (mesh_face_offsets[i] != abc_index) {
+      return false;
+    }
+
+    const int abc_face_size = face_counts[i];
+    /* NOTE: Alembic data is stored in the reverse order. */
+    uint rev_loop_index = abc_index + (abc_face_size - 1);
+    for (int f = 0; f < abc_face_size; f++, abc_index++, rev_loop_index--) {
+      const int mesh_vert = mesh_corner_verts[rev_loop_index];
+      const int abc_vert = face_indices[abc_index];
+      if (mesh_vert != abc_vert) {
+        return false;
+      }
+      if (f > 0 && abc_vert == face_indices[abc_index - 1]) {
+        return false;
+      }
+    }
+  }
+
+  return true;
+}
+
 bool AbcMeshReader::topology_changed(const Mesh *existing_mesh, const ISampleSelector &sample_sel)
 {
   IPolyMeshSchema::Sample sample;
@@ -632,6 +800,12 @@ bool AbcMeshReader::topology_changed(const Mesh *existing_mesh, const ISampleSel
     return false;
   }
 
+  return this->topology_changed(existing_mesh, sample);
+}
+
+bool AbcMeshReader::topology_changed(const Mesh *existing_mesh,
+                                     const IPolyMeshSchema::Sample &sample) const
+{
   const P3fArraySamplePtr &positions = sample.getPositions();
   const Alembic::Abc::Int32ArraySamplePtr &face_indices = sample.getFaceIndices();
   const Alembic::Abc::Int32ArraySamplePtr &face_counts = sample.getFaceCounts();
@@ -646,37 +820,38 @@ bool AbcMeshReader::topology_changed(const Mesh *existing_mesh, const ISampleSel
 
   /* Check first if we indeed have multiple samples, unless we read a file sequence in which case
    * we need to do a full topology comparison. */
-  if (!m_is_reading_a_file_sequence && (m_schema.getFaceIndicesProperty().getNumSamples() == 1 &&
-                                        m_schema.getFaceCountsProperty().getNumSamples() == 1))
-  {
+  if (!m_is_reading_a_file_sequence && this->has_constant_topology()) {
     return false;
   }
 
   /* Otherwise, we need to check the connectivity as files from e.g. videogrammetry may have the
    * same face count, but different connections between faces. */
-  uint abc_index = 0;
-
-  const int *mesh_corner_verts = existing_mesh->corner_verts().data();
-  const int *mesh_face_offsets = existing_mesh->face_offsets().data();
+  return !mesh_faces_match_sample(*existing_mesh, *face_indices, *face_counts);
+}
 
-  for (int i = 0; i < face_counts->size(); i++) {
-    if (mesh_face_offsets[i] != abc_index) {
-      return true;
-    }
+bool AbcMeshReader::has_constant_topology() const
+{
+  /* Covers both #kConstantTopology and #kHomogenousTopology, which only differ in whether the
+   * positions are animated. */
+  return m_schema.getFaceIndicesProperty().getNumSamples() == 1 &&
+         m_schema.getFaceCountsProperty().getNumSamples() == 1;
+}
 
-    const int abc_face_size = (*face_counts)[i];
-    /* NOTE: Alembic data is stored in the reverse order. */
-    uint rev_loop_index = abc_index + (abc_face_size - 1);
-    for (int f = 0; f < abc_face_size; f++, abc_index++, rev_loop_index--) {
-      const int mesh_vert = mesh_corner_verts[rev_loop_index];
-      const int abc_vert = (*face_indices)[abc_index];
-      if (mesh_vert != abc_vert) {
-        return true;
-      }
-    }
+bool AbcMeshReader::can_keep_topology(const Mesh &mesh,
+                                      const IPolyMeshSchema::Sample &sample) const
+{
+  if (mesh.loose_edges().count > 0) {
+    /* Rebuilding the edges from the faces removes the loose edges. */
+    return false;
   }
-
-  return false;
+  if (m_is_reading_a_file_sequence || !this->has_constant_topology()) {
+    /* The connectivity was compared by #topology_changed already. */
+    return true;
+  }
+  /* The topology of the file doesn't change, but the input mesh may not come from the file, e.g.
+   * when other modifiers come first. Comparing is still much cheaper than rebuilding the faces
+   * and edges, and invalidating the caches that depend on them. */
+  return mesh_faces_match_sample(mesh, *sample.getFaceIndices(), *sample.getFaceCounts());
 }
 
 void AbcMeshReader::read_geometry(bke::GeometrySet &geometry_set,
@@ -698,6 +873,59 @@ void AbcMeshReader::read_geometry(bke::GeometrySet &geometry_set,
   geometry_set.replace_mesh(new_mesh);
 }
 
+AbcMeshReader::~AbcMeshReader()
+{
+  if (m_prefetch_cache) {
+    m_prefetch_cache->remove_reader(this);
+  }
+}
+
+void AbcMeshReader::set_prefetch_cache(io::FramePrefetchCache *prefetch_cache)
+{
+  m_prefetch_cache = prefetch_cache;
+}
+
+void AbcMeshReader::prefetch_frames(const Span<double> times,
+                                    const int read_flag,
+                                    const char *velocity_name,
+                                    const float velocity_scale,
+                                    const int64_t memory_limit)
+{
+  if (!m_prefetch_cache) {
+    return;
+  }
+  m_prefetch_cache->set_memory_limit(memory_limit);
+  const std::string frame_velocity_name = velocity_scale != 0.0f ? velocity_name : "";
+  m_prefetch_cache->prefetch(
+      this, times, [this, read_flag, frame_velocity_name](const double time) {
+        std::unique_ptr<AbcMeshFrame> frame;
+        try {
+          frame = read_mesh_frame(m_schema,
+                                  ISampleSelector(time, ISampleSelector::kFloorIndex),
+                                  read_flag,
+                                  frame_velocity_name);
+        }
+        catch (Alembic::Util::Exception & /*ex*/) {
+          /* Reported when the frame is read again for evaluation. */
+        }
+        return frame;
+      });
+}
+
+std::shared_ptr<const AbcMeshFrame> AbcMeshReader::read_frame(const ISampleSelector &sample_sel,
+                                                              const int read_flag,
+                                                              const std::string &velocity_name)
+{
+  if (m_prefetch_cache) {
+    std::shared_ptr<const AbcMeshFrame> frame = std::static_pointer_cast<const AbcMeshFrame>(
+        m_prefetch_cache->lookup(this, sample_sel.getRequestedTime()));
+    if (frame && frame->is_compatible(read_flag, velocity_name)) {
+      return frame;
+    }
+  }
+  return read_mesh_frame(m_schema, sample_sel, read_flag, velocity_name);
+}
+
 Mesh *AbcMeshReader::read_mesh(Mesh *existing_mesh,
                                const ISampleSelector &sample_sel,
                                const int read_flag,
@@ -705,9 +933,10 @@ Mesh *AbcMeshReader::read_mesh(Mesh *existing_mesh,
                                const float velocity_scale,
                                const char **r_err_str)
 {
-  IPolyMeshSchema::Sample sample;
+  const std::string frame_velocity_name = velocity_scale != 0.0f ? velocity_name : "";
+  std::shared_ptr<const AbcMeshFrame> frame;
   try {
-    sample = m_schema.getValue(sample_sel);
+    frame = this->read_frame(sample_sel, read_flag, frame_velocity_name);
   }
   catch (Alembic::Util::Exception &ex) {
     if (r_err_str != nullptr) {
@@ -721,9 +950,9 @@ Mesh *AbcMeshReader::read_mesh(Mesh *existing_mesh,
     return existing_mesh;
   }
 
-  const P3fArraySamplePtr &positions = sample.getPositions();
-  const Alembic::Abc::Int32ArraySamplePtr &face_indices = sample.getFaceIndices();
-  const Alembic::Abc::Int32ArraySamplePtr &face_counts = sample.getFaceCounts();
+  const P3fArraySamplePtr &positions = frame->sample.getPositions();
+  const Alembic::Abc::Int32ArraySamplePtr &face_indices = frame->sample.getFaceIndices();
+  const Alembic::Abc::Int32ArraySamplePtr &face_counts = frame->sample.getFaceCounts();
 
   /* Do some very minimal mesh validation. */
   const int poly_count = face_counts->size();
@@ -741,6 +970,7 @@ Mesh *AbcMeshReader::read_mesh(Mesh *existing_mesh,
   }
 
   Mesh *new_mesh = nullptr;
+  bool keep_topology = false;
 
   /* Only read point data when streaming meshes, unless we need to create new ones. */
   ImportSettings settings;
@@ -748,11 +978,26 @@ Mesh *AbcMeshReader::read_mesh(Mesh *existing_mesh,
   settings.velocity_name = velocity_name;
   settings.velocity_scale = velocity_scale;
 
-  if (topology_changed(existing_mesh, sample_sel)) {
+  if (topology_changed(existing_mesh, frame->sample)) {
     new_mesh = BKE_mesh_new_nomain_from_template(
         existing_mesh, positions->size(), 0, face_counts->size(), face_indices->size());
 
     settings.read_flag |= MOD_MESHSEQ_READ_ALL;
+    if (!frame->is_compatible(settings.read_flag, frame_velocity_name)) {
+      /* The normals are needed for new meshes, even if the modifier doesn't read them. */
+      try {
+        frame = read_mesh_frame(m_schema, sample_sel, settings.read_flag, frame_velocity_name);
+      }
+      catch (Alembic::Util::Exception &ex) {
+        printf("Alembic: error reading mesh sample for '%s/%s' at time %f: %s\n",
+               m_iobject.getFullName().c_str(),
+               m_schema.getName().c_str(),
+               sample_sel.getRequestedTime(),
+               ex.what());
+        BKE_id_free(nullptr, new_mesh);
+        return existing_mesh;
+      }
+    }
   }
   else {
     /* If the face count changed (e.g. by triangulation), only read points.
@@ -769,14 +1014,20 @@ Mesh *AbcMeshReader::read_mesh(Mesh *existing_mesh,
             "read!");
       }
     }
+    else if (settings.read_flag & MOD_MESHSEQ_READ_POLY) {
+      /* Only the vertex and corner data changes. Keep the faces and edges of the input mesh, so
+       * that they and the caches depending on them (e.g. BVH trees) aren't rebuilt every frame. */
+      keep_topology = this->can_keep_topology(*existing_mesh, frame->sample);
+    }
   }
 
   Mesh *mesh_to_export = new_mesh ? new_mesh : existing_mesh;
-  CDStreamConfig config = get_config(mesh_to_export);
+  CDStreamConfig config = get_config(mesh_to_export, keep_topology);
   config.time = sample_sel.getRequestedTime();
   config.modifier_error_message = r_err_str;
 
-  read_mesh_sample(m_iobject.getFullName(), &settings, m_schema, sample_sel, config);
+  read_mesh_sample(
+      m_iobject.getFullName(), &settings, m_schema, sample_sel, *frame, keep_topology, config);
 
   if (new_mesh) {
     /* Here we assume that the number of materials doesn't change, i.e. that
@@ -1112,7 +1363,7 @@ Mesh *AbcSubDReader::read_mesh(Mesh *existing_mesh,
 
   /* Only read point data when streaming meshes, unless we need to create new ones. */
   Mesh *mesh_to_export = new_mesh ? new_mesh : existing_mesh;
-  CDStreamConfig config = get_config(mesh_to_export);
+  CDStreamConfig config = get_config(mesh_to_export, false);
   config.time = sample_sel.getRequestedTime();
   config.modifier_error_message = r_err_str;
   read_subd_sample(m_iobject.getFullName(), &settings, m_schema, sample_sel, config);
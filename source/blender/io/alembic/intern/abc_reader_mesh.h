@@ -14,15 +14,40 @@
 #include <Alembic/AbcGeom/IPolyMesh.h>
 #include <Alembic/AbcGeom/ISubD.h>
 
+#include <memory>
+
 struct Mesh;
 
+namespace blender::io {
+class FramePrefetchCache;
+}
+
 namespace blender::io::alembic {
 
+struct AbcMeshFrame;
+
 class AbcMeshReader final : public AbcObjectReader {
   Alembic::AbcGeom::IPolyMeshSchema m_schema;
 
+  /** Cache of the archive the reader was opened from, to read frames ahead of time. */
+  io::FramePrefetchCache *m_prefetch_cache = nullptr;
+
  public:
   AbcMeshReader(const Alembic::Abc::IObject &object, ImportSettings &settings);
+  ~AbcMeshReader() override;
+
+  void set_prefetch_cache(io::FramePrefetchCache *prefetch_cache);
+
+  /**
+   * Read the samples of the frames at the given times on background threads, so that
+   * #read_mesh doesn't have to wait for the file when they are evaluated.
+   * Does nothing when the reader has no prefetch cache.
+   */
+  void prefetch_frames(Span<double> times,
+                       int read_flag,
+                       const char *velocity_name,
+                       float velocity_scale,
+                       int64_t memory_limit);
 
   bool valid() const override;
   bool accepts_object_type(const Alembic::AbcCoreAbstract::ObjectHeader &alembic_header,
@@ -48,6 +73,25 @@ class AbcMeshReader final : public AbcObjectReader {
                         const Alembic::Abc::ISampleSelector &sample_sel) override;
 
  private:
+  bool topology_changed(const Mesh *existing_mesh,
+                        const Alembic::AbcGeom::IPolyMeshSchema::Sample &sample) const;
+
+  /** True when the face counts and indices of the schema are the same for all samples. */
+  bool has_constant_topology() const;
+
+  /**
+   * True when the faces of the mesh are the same as the ones of the sample, and the mesh has no
+   * loose edges, so that only the vertex and corner data has to be read. Expects the element
+   * counts to match already.
+   */
+  bool can_keep_topology(const Mesh &mesh,
+                         const Alembic::AbcGeom::IPolyMeshSchema::Sample &sample) const;
+
+  /** Get the samples of the frame from the prefetch cache, or read them from the file. */
+  std::shared_ptr<const AbcMeshFrame> read_frame(const Alembic::Abc::ISampleSelector &sample_sel,
+                                                 int read_flag,
+                                                 const std::string &velocity_name);
+
   void readFaceSetsSample(Main *bmain,
                           Mesh *mesh,
                           const Alembic::AbcGeom::ISampleSelector &sample_sel);
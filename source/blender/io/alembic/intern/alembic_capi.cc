@@ -849,6 +849,14 @@ void ABC_read_geometry(CacheReader *reader,
                             params->velocity_name,
                             params->velocity_scale,
                             r_err_str);
+
+  if (AbcMeshReader *mesh_reader = dynamic_cast<AbcMeshReader *>(abc_reader)) {
+    mesh_reader->prefetch_frames({params->prefetch_times, params->prefetch_times_num},
+                                 params->read_flags,
+                                 params->velocity_name,
+                                 params->velocity_scale,
+                                 params->prefetch_memory_limit);
+  }
 }
 
 bool ABC_mesh_topology_changed(CacheReader *reader,
@@ -912,5 +920,9 @@ CacheReader *CacheReader_open_alembic_object(CacheArchiveHandle *handle,
   abc_reader->object(object);
   abc_reader->incref();
 
+  if (AbcMeshReader *mesh_reader = dynamic_cast<AbcMeshReader *>(abc_reader)) {
+    mesh_reader->set_prefetch_cache(&archive->prefetch_cache());
+  }
+
   return reinterpret_cast<CacheReader *>(abc_reader);
 }
@@ -0,0 +1,113 @@
+/* SPDX-FileCopyrightText: 2025 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#pragma once
+
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+
+#include "BLI_map.hh"
+#include "BLI_set.hh"
+#include "BLI_span.hh"
+
+struct TaskPool;
+
+namespace blender::io {
+
+/**
+ * Data of a single frame of a cache reader, read from the file ahead of time.
+ * The derived types are specific to the file format.
+ */
+class PrefetchedFrame {
+ public:
+  virtual ~PrefetchedFrame() = default;
+
+  /** Approximate memory used by the frame, counted against the memory limit of the cache. */
+  virtual int64_t size_in_bytes() const = 0;
+};
+
+/**
+ * Reads frames of cache file readers (e.g. of the Mesh Sequence Cache modifier) ahead of the
+ * playhead on background threads, so that evaluating the next frames only has to convert data
+ * that is already in memory.
+ *
+ * One cache is shared by all readers of a cache file. When the memory limit is exceeded, the
+ * least recently used frames are freed first.
+ */
+class FramePrefetchCache {
+ public:
+  /**
+   * Read the frame at the given time from the file. Called on a worker thread, concurrently
+   * with other reads from the same reader. Returns null on failure.
+   */
+  using ReadFrameFn = std::function<std::unique_ptr<PrefetchedFrame>(double time)>;
+
+ private:
+  struct CachedFrame {
+    std::shared_ptr<const PrefetchedFrame> frame;
+    int64_t size_in_bytes = 0;
+    uint64_t last_used = 0;
+  };
+
+  struct ReaderFrames {
+    Map<double, CachedFrame> frames;
+    Set<double> pending;
+    /** Amount of frames that are read right now. */
+    int reading_num = 0;
+    /** Set when the reader is removed, pending reads are skipped then. */
+    bool removed = false;
+  };
+
+  struct ReadTask;
+
+  TaskPool *task_pool_ = nullptr;
+
+  std::mutex mutex_;
+  std::condition_variable reading_done_;
+  Map<const void *, std::shared_ptr<ReaderFrames>> readers_;
+  int64_t memory_limit_ = 0;
+  int64_t memory_usage_ = 0;
+  uint64_t use_clock_ = 0;
+
+ public:
+  FramePrefetchCache();
+  ~FramePrefetchCache();
+
+  FramePrefetchCache(const FramePrefetchCache &other) = delete;
+  FramePrefetchCache &operator=(const FramePrefetchCache &other) = delete;
+
+  /** Set the memory limit of the cache in bytes, freeing frames if it's exceeded. */
+  void set_memory_limit(int64_t limit);
+
+  /** Get the frame read ahead of time for the reader, or null if it's not available (yet). */
+  std::shared_ptr<const PrefetchedFrame> lookup(const void *reader, double time);
+
+  /**
+   * Read the frames at the given times on background threads, unless they are already cached or
+   * being read. The times are expected to be in order of priority.
+   */
+  void prefetch(const void *reader, Span<double> times, const ReadFrameFn &read_fn);
+
+  /**
+   * Free the frames of the reader, skip its pending reads and wait for the reads that already
+   * started. Has to be called before the reader is freed.
+   */
+  void remove_reader(const void *reader);
+
+  /** Wait until all scheduled frames are read. */
+  void work_and_wait();
+
+  int64_t memory_usage();
+
+ private:
+  static void read_task_run(TaskPool *pool, void *taskdata);
+  static void read_task_free(TaskPool *pool, void *taskdata);
+  void read_task(ReadTask &task);
+  /** Free least recently used frames until the memory usage fits the limit. */
+  void evict_frames(int64_t limit);
+};
+
+}  // namespace blender::io
@@ -0,0 +1,76 @@
+/* SPDX-FileCopyrightText: 2024 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#pragma once
+
+#include <cstdint>
+
+#include "BLI_math_vector_types.hh"
+#include "BLI_span.hh"
+#include "BLI_string_ref.hh"
+
+/*
+ * Number to text formatting used by text exporters.
+ *
+ * The functions write into a caller provided buffer and return the end of
+ * the written text, without any null terminator. The caller has to ensure
+ * there is enough room, see #number_max_chars and #float3_row_max_chars.
+ *
+ * The output is exactly the same as the `fmt` library produces for the
+ * equivalent format strings (`{}` and `{:.Nf}`), just without the format
+ * string parsing, intermediate buffers and the generic fixed precision
+ * algorithm. This is a hot path when exporting large meshes.
+ */
+
+namespace blender::io {
+
+/** Maximum amount of characters written by any single number formatting function. */
+constexpr int64_t number_max_chars = 64;
+
+/** Maximum supported precision of #format_float_fixed. */
+constexpr int float_fixed_max_precision = 9;
+
+/**
+ * Format an integer, same as `fmt::format("{}", value)`.
+ */
+char *format_int(char *dst, int64_t value);
+char *format_uint(char *dst, uint64_t value);
+
+/**
+ * Format a float with a fixed amount of digits after the decimal point,
+ * same as `fmt::format("{:.{}f}", value, precision)`, i.e. the exactly rounded
+ * decimal value of the float.
+ *
+ * `precision` has to be in `[0, float_fixed_max_precision]`.
+ */
+char *format_float_fixed(char *dst, float value, int precision);
+
+/**
+ * Format a float with the shortest text that reads back as the same float,
+ * same as `fmt::format("{}", value)`.
+ */
+char *format_float_shortest(char *dst, float value);
+
+/**
+ * Maximum amount of characters written by the float3 row functions for one row
+ * with a prefix of the given length.
+ */
+constexpr int64_t float3_row_max_chars(const int64_t prefix_len)
+{
+  return prefix_len + 3 * number_max_chars + 3;
+}
+
+/**
+ * Write rows of `<prefix>x y z\n`, one for each vector, with fixed precision.
+ * `dst` needs room for `rows.size() * float3_row_max_chars(prefix.size())` characters.
+ */
+char *format_float3_rows_fixed(char *dst, StringRef prefix, Span<float3> rows, int precision);
+
+/**
+ * Write rows of `<prefix>x y z\n`, one for each vector, in shortest round-trip form.
+ * `dst` needs room for `rows.size() * float3_row_max_chars(prefix.size())` characters.
+ */
+char *format_float3_rows_shortest(char *dst, StringRef prefix, Span<float3> rows);
+
+}  // namespace blender::io
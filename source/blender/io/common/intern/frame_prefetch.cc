@@ -0,0 +1,176 @@
+/* SPDX-FileCopyrightText: 2025 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#include "IO_frame_prefetch.hh"
+
+#include "BLI_assert.h"
+#include "BLI_task.h"
+
+#include "MEM_guardedalloc.h"
+
+namespace blender::io {
+
+struct FramePrefetchCache::ReadTask {
+  FramePrefetchCache *cache;
+  std::shared_ptr<ReaderFrames> reader_frames;
+  double time;
+  ReadFrameFn read_fn;
+};
+
+FramePrefetchCache::FramePrefetchCache()
+{
+  task_pool_ = BLI_task_pool_create_background(this, TASK_PRIORITY_LOW);
+}
+
+FramePrefetchCache::~FramePrefetchCache()
+{
+  BLI_task_pool_cancel(task_pool_);
+  BLI_task_pool_free(task_pool_);
+  BLI_assert(readers_.is_empty());
+}
+
+void FramePrefetchCache::set_memory_limit(const int64_t limit)
+{
+  std::scoped_lock lock(mutex_);
+  memory_limit_ = limit;
+  this->evict_frames(limit);
+}
+
+std::shared_ptr<const PrefetchedFrame> FramePrefetchCache::lookup(const void *reader,
+                                                                  const double time)
+{
+  std::scoped_lock lock(mutex_);
+  const std::shared_ptr<ReaderFrames> *reader_frames = readers_.lookup_ptr(reader);
+  if (!reader_frames) {
+    return nullptr;
+  }
+  CachedFrame *cached_frame = (*reader_frames)->frames.lookup_ptr(time);
+  if (!cached_frame) {
+    return nullptr;
+  }
+  cached_frame->last_used = ++use_clock_;
+  return cached_frame->frame;
+}
+
+void FramePrefetchCache::prefetch(const void *reader,
+                                  const Span<double> times,
+                                  const ReadFrameFn &read_fn)
+{
+  std::scoped_lock lock(mutex_);
+  if (memory_limit_ <= 0) {
+    return;
+  }
+  std::shared_ptr<ReaderFrames> &reader_frames = readers_.lookup_or_add_cb(
+      reader, []() { return std::make_shared<ReaderFrames>(); });
+  for (const double time : times) {
+    if (reader_frames->frames.contains(time) || !reader_frames->pending.add(time)) {
+      continue;
+    }
+    ReadTask *task = MEM_new<ReadTask>(__func__);
+    task->cache = this;
+    task->reader_frames = reader_frames;
+    task->time = time;
+    task->read_fn = read_fn;
+    BLI_task_pool_push(task_pool_, read_task_run, task, true, read_task_free);
+  }
+}
+
+void FramePrefetchCache::remove_reader(const void *reader)
+{
+  std::unique_lock lock(mutex_);
+  const std::shared_ptr<ReaderFrames> reader_frames = readers_.pop_default(reader, nullptr);
+  if (!reader_frames) {
+    return;
+  }
+  reader_frames->removed = true;
+  reading_done_.wait(lock, [&]() { return reader_frames->reading_num == 0; });
+  for (const CachedFrame &cached_frame : reader_frames->frames.values()) {
+    memory_usage_ -= cached_frame.size_in_bytes;
+  }
+  reader_frames->frames.clear();
+  reader_frames->pending.clear();
+}
+
+void FramePrefetchCache::work_and_wait()
+{
+  BLI_task_pool_work_and_wait(task_pool_);
+}
+
+int64_t FramePrefetchCache::memory_usage()
+{
+  std::scoped_lock lock(mutex_);
+  return memory_usage_;
+}
+
+void FramePrefetchCache::read_task_run(TaskPool *pool, void *taskdata)
+{
+  ReadTask &task = *static_cast<ReadTask *>(taskdata);
+  if (BLI_task_pool_current_canceled(pool)) {
+    return;
+  }
+  task.cache->read_task(task);
+}
+
+void FramePrefetchCache::read_task_free(TaskPool * /*pool*/, void *taskdata)
+{
+  MEM_delete(static_cast<ReadTask *>(taskdata));
+}
+
+void FramePrefetchCache::read_task(ReadTask &task)
+{
+  ReaderFrames &reader_frames = *task.reader_frames;
+  {
+    std::scoped_lock lock(mutex_);
+    if (reader_frames.removed) {
+      return;
+    }
+    reader_frames.reading_num++;
+  }
+
+  /* Read outside of the lock, this is where the time is spent. */
+  std::unique_ptr<PrefetchedFrame> frame = task.read_fn(task.time);
+
+  {
+    std::scoped_lock lock(mutex_);
+    reader_frames.reading_num--;
+    reader_frames.pending.remove(task.time);
+    if (frame && !reader_frames.removed) {
+      const int64_t size = frame->size_in_bytes();
+      if (size <= memory_limit_) {
+        this->evict_frames(memory_limit_ - size);
+        CachedFrame cached_frame;
+        cached_frame.frame = std::move(frame);
+        cached_frame.size_in_bytes = size;
+        cached_frame.last_used = ++use_clock_;
+        reader_frames.frames.add_new(task.time, std::move(cached_frame));
+        memory_usage_ += size;
+      }
+    }
+  }
+  reading_done_.notify_all();
+}
+
+void FramePrefetchCache::evict_frames(const int64_t limit)
+{
+  while (memory_usage_ > limit) {
+    ReaderFrames *oldest_reader = nullptr;
+    double oldest_time = 0.0;
+    uint64_t oldest_use = UINT64_MAX;
+    for (const std::shared_ptr<ReaderFrames> &reader_frames : readers_.values()) {
+      for (const auto item : reader_frames->frames.items()) {
+        if (item.value.last_used < oldest_use) {
+          oldest_reader = reader_frames.get();
+          oldest_time = item.key;
+          oldest_use = item.value.last_used;
+        }
+      }
+    }
+    if (!oldest_reader) {
+      break;
+    }
+    memory_usage_ -= oldest_reader->frames.pop(oldest_time).size_in_bytes;
+  }
+}
+
+}  // namespace blender::io
@@ -0,0 +1,124 @@
+/* SPDX-FileCopyrightText: 2025 Blender Authors
+ *
+ * SPDX-License-Identifier: Apache-2.0 */
+
+#include "IO_frame_prefetch.hh"
+
+#include "testing/testing.h"
+
+#include <atomic>
+
+namespace blender::io {
+
+class TestFrame : public PrefetchedFrame {
+ public:
+  double time;
+  int64_t size;
+
+  TestFrame(const double time, const int64_t size) : time(time), size(size) {}
+
+  int64_t size_in_bytes() const override
+  {
+    return size;
+  }
+};
+
+static double frame_time(const std::shared_ptr<const PrefetchedFrame> &frame)
+{
+  return dynamic_cast<const TestFrame &>(*frame).time;
+}
+
+TEST(frame_prefetch, LookupPrefetchedFrames)
+{
+  FramePrefetchCache cache;
+  cache.set_memory_limit(1000);
+  const int reader = 0;
+
+  std::atomic<int> reads = 0;
+  const auto read_fn = [&](const double time) {
+    reads++;
+    return std::make_unique<TestFrame>(time, 10);
+  };
+  cache.prefetch(&reader, {1.0, 2.0, 3.0}, read_fn);
+  cache.work_and_wait();
+
+  EXPECT_EQ(reads, 3);
+  EXPECT_EQ(cache.memory_usage(), 30);
+  EXPECT_EQ(frame_time(cache.lookup(&reader, 2.0)), 2.0);
+  EXPECT_EQ(cache.lookup(&reader, 4.0), nullptr);
+  const int other_reader = 0;
+  EXPECT_EQ(cache.lookup(&other_reader, 2.0), nullptr);
+
+  /* Frames that are cached already are not read again. */
+  cache.prefetch(&reader, {2.0, 3.0, 4.0}, read_fn);
+  cache.work_and_wait();
+  EXPECT_EQ(reads, 4);
+
+  cache.remove_reader(&reader);
+  EXPECT_EQ(cache.lookup(&reader, 2.0), nullptr);
+  EXPECT_EQ(cache.memory_usage(), 0);
+}
+
+TEST(frame_prefetch, FailedReads)
+{
+  FramePrefetchCache cache;
+  cache.set_memory_limit(1000);
+  const int reader = 0;
+
+  cache.prefetch(&reader, {1.0}, [](const double /*time*/) { return nullptr; });
+  cache.work_and_wait();
+  EXPECT_EQ(cache.lookup(&reader, 1.0), nullptr);
+
+  /* Frames that failed to read can be requested again. */
+  cache.prefetch(
+      &reader, {1.0}, [](const double time) { return std::make_unique<TestFrame>(time, 10); });
+  cache.work_and_wait();
+  EXPECT_NE(cache.lookup(&reader, 1.0), nullptr);
+
+  cache.remove_reader(&reader);
+}
+
+TEST(frame_prefetch, MemoryLimit)
+{
+  FramePrefetchCache cache;
+  cache.set_memory_limit(30);
+  const int reader = 0;
+  const auto read_fn = [](const double time) { return std::make_unique<TestFrame>(time, 10); };
+
+  for (const double time : {1.0, 2.0, 3.0}) {
+    cache.prefetch(&reader, {time}, read_fn);
+    cache.work_and_wait();
+  }
+  EXPECT_EQ(cache.memory_usage(), 30);
+
+  /* Using a frame keeps it in the cache, the least recently used frame is freed instead. */
+  EXPECT_NE(cache.lookup(&reader, 1.0), nullptr);
+  cache.prefetch(&reader, {4.0}, read_fn);
+  cache.work_and_wait();
+  EXPECT_EQ(cache.memory_usage(), 30);
+  EXPECT_NE(cache.lookup(&reader, 1.0), nullptr);
+  EXPECT_EQ(cache.lookup(&reader, 2.0), nullptr);
+  EXPECT_NE(cache.lookup(&reader, 4.0), nullptr);
+
+  /* Frames larger than the limit are never stored. */
+  cache.prefetch(
+      &reader, {5.0}, [](const double time) { return std::make_unique<TestFrame>(time, 100); });
+  cache.work_and_wait();
+  EXPECT_EQ(cache.lookup(&reader, 5.0), nullptr);
+  EXPECT_EQ(cache.memory_usage(), 30);
+
+  cache.set_memory_limit(10);
+  EXPECT_EQ(cache.memory_usage(), 10);
+  EXPECT_NE(cache.lookup(&reader, 4.0), nullptr);
+
+  /* Without memory there is nothing to prefetch. */
+  cache.set_memory_limit(0);
+  EXPECT_EQ(cache.memory_usage(), 0);
+  cache.prefetch(&reader, {6.0}, read_fn);
+  cache.work_and_wait();
+  EXPECT_EQ(cache.lookup(&reader, 6.0), nullptr);
+
+  cache.remove_reader(&reader);
+}
+
+}  // namespace blender::io
@@ -0,0 +1,174 @@
+/* SPDX-FileCopyrightText: 2024 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#include "IO_number_format.hh"
+
+#include <cstring>
+
+#include "BLI_assert.h"
+
+/* SEP macro from BLI path utils clashes with SEP symbol in fmt headers. */
+#undef SEP
+#include <fmt/format.h>
+
+namespace blender::io {
+
+static const char digit_pairs[] =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+
+static const uint64_t pow10_table[] = {1,
+                                       10,
+                                       100,
+                                       1000,
+                                       10000,
+                                       100000,
+                                       1000000,
+                                       10000000,
+                                       100000000,
+                                       1000000000};
+
+static int count_digits(uint64_t value)
+{
+  int count = 1;
+  while (value >= 10000) {
+    value /= 10000;
+    count += 4;
+  }
+  if (value >= 1000) {
+    return count + 3;
+  }
+  if (value >= 100) {
+    return count + 2;
+  }
+  return count + (value >= 10 ? 1 : 0);
+}
+
+/** Write exactly `digits` least significant decimal digits of `value`, zero padded. */
+static char *write_digits(char *dst, uint64_t value, const int digits)
+{
+  char *p = dst + digits;
+  while (p - dst >= 2) {
+    p -= 2;
+    memcpy(p, &digit_pairs[(value % 100) * 2], 2);
+    value /= 100;
+  }
+  if (p != dst) {
+    *--p = char('0' + value % 10);
+  }
+  return dst + digits;
+}
+
+char *format_uint(char *dst, const uint64_t value)
+{
+  return write_digits(dst, value, count_digits(value));
+}
+
+char *format_int(char *dst, const int64_t value)
+{
+  if (value < 0) {
+    *dst++ = '-';
+    return format_uint(dst, 0 - uint64_t(value));
+  }
+  return format_uint(dst, uint64_t(value));
+}
+
+char *format_float_fixed(char *dst, const float value, const int precision)
+{
+  BLI_assert(precision >= 0 && precision <= float_fixed_max_precision);
+  uint32_t bits;
+  memcpy(&bits, &value, sizeof(bits));
+  const uint32_t exponent_bits = (bits >> 23) & 0xff;
+  const uint32_t mantissa_bits = bits & 0x7fffff;
+  if (exponent_bits == 0xff) {
+    return fmt::format_to(dst, "{:.{}f}", value, precision);
+  }
+
+  /* The float is exactly `mantissa * 2^exponent`, so the value scaled by `10^precision` is an
+   * integer shifted by the exponent, which can be rounded exactly (ties to even). */
+  const uint64_t mantissa = exponent_bits == 0 ? mantissa_bits : (mantissa_bits | 0x800000);
+  const int exponent = exponent_bits == 0 ? -149 : int(exponent_bits) - 150;
+  const uint64_t scale = pow10_table[precision];
+  const uint64_t scaled = mantissa * scale;
+  uint64_t rounded;
+  if (exponent >= 0) {
+    if (exponent >= 64 || scaled > (UINT64_MAX >> exponent)) {
+      /* Huge values, rare enough to not need a fast path. */
+      return fmt::format_to(dst, "{:.{}f}", value, precision);
+    }
+    rounded = scaled << exponent;
+  }
+  else if (exponent <= -64) {
+    rounded = 0;
+  }
+  else {
+    const int shift = -exponent;
+    rounded = scaled >> shift;
+    const uint64_t remainder = scaled & ((uint64_t(1) << shift) - 1);
+    const uint64_t half = uint64_t(1) << (shift - 1);
+    if (remainder > half || (remainder == half && (rounded & 1))) {
+      rounded++;
+    }
+  }
+
+  if (bits >> 31) {
+    *dst++ = '-';
+  }
+  dst = format_uint(dst, rounded / scale);
+  if (precision > 0) {
+    *dst++ = '.';
+    dst = write_digits(dst, rounded % scale, precision);
+  }
+  return dst;
+}
+
+char *format_float_shortest(char *dst, const float value)
+{
+  /* The shortest round-trip digits are computed by `fmt` (Dragonbox), writing straight into the
+   * destination avoids the intermediate string of `fmt::format`. */
+  return fmt::format_to(dst, "{}", value);
+}
+
+char *format_float3_rows_fixed(char *dst,
+                               const StringRef prefix,
+                               const Span<float3> rows,
+                               const int precision)
+{
+  for (const float3 &row : rows) {
+    memcpy(dst, prefix.data(), prefix.size());
+    dst += prefix.size();
+    dst = format_float_fixed(dst, row.x, precision);
+    *dst++ = ' ';
+    dst = format_float_fixed(dst, row.y, precision);
+    *dst++ = ' ';
+    dst = format_float_fixed(dst, row.z, precision);
+    *dst++ = '\n';
+  }
+  return dst;
+}
+
+char *format_float3_rows_shortest(char *dst, const StringRef prefix, const Span<float3> rows)
+{
+  for (const float3 &row : rows) {
+    memcpy(dst, prefix.data(), prefix.size());
+    dst += prefix.size();
+    dst = format_float_shortest(dst, row.x);
+    *dst++ = ' ';
+    dst = format_float_shortest(dst, row.y);
+    *dst++ = ' ';
+    dst = format_float_shortest(dst, row.z);
+    *dst++ = '\n';
+  }
+  return dst;
+}
+
+}  // namespace blender::io
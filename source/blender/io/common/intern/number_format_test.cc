@@ -0,0 +1,110 @@
+/* SPDX-FileCopyrightText: 2024 Blender Authors
+ *
+ * SPDX-License-Identifier: Apache-2.0 */
+
+#include "IO_number_format.hh"
+
+#include "BLI_array.hh"
+#include "BLI_rand.hh"
+
+#include "testing/testing.h"
+
+#include <cstring>
+
+/* SEP macro from BLI path utils clashes with SEP symbol in fmt headers. */
+#undef SEP
+#include <fmt/format.h>
+
+namespace blender::io {
+
+static std::string fixed_str(float value, int precision)
+{
+  char buf[number_max_chars];
+  return std::string(buf, format_float_fixed(buf, value, precision));
+}
+
+static std::string shortest_str(float value)
+{
+  char buf[number_max_chars];
+  return std::string(buf, format_float_shortest(buf, value));
+}
+
+static float float_from_bits(uint32_t bits)
+{
+  float value;
+  memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+
+TEST(io_common_number_format, format_int)
+{
+  char buf[number_max_chars];
+  for (const int64_t value : {int64_t(0),
+                              int64_t(7),
+                              int64_t(-1),
+                              int64_t(10),
+                              int64_t(99),
+                              int64_t(-100),
+                              int64_t(123456789),
+                              std::numeric_limits<int64_t>::min(),
+                              std::numeric_limits<int64_t>::max()})
+  {
+    EXPECT_EQ(std::string(buf, format_int(buf, value)), fmt::format("{}", value));
+  }
+  EXPECT_EQ(std::string(buf, format_uint(buf, std::numeric_limits<uint64_t>::max())),
+            "18446744073709551615");
+}
+
+TEST(io_common_number_format, format_float_fixed)
+{
+  EXPECT_EQ(fixed_str(0.0f, 6), "0.000000");
+  EXPECT_EQ(fixed_str(-0.0f, 6), "-0.000000");
+  EXPECT_EQ(fixed_str(1.0f, 0), "1");
+  EXPECT_EQ(fixed_str(0.5f, 0), "0");
+  EXPECT_EQ(fixed_str(1.5f, 0), "2");
+  EXPECT_EQ(fixed_str(-2.25f, 1), "-2.2");
+  EXPECT_EQ(fixed_str(0.1f, 9), "0.100000001");
+  EXPECT_EQ(fixed_str(-1e-7f, 4), "-0.0000");
+  EXPECT_EQ(fixed_str(123.456f, 4), "123.4560");
+  EXPECT_EQ(fixed_str(3.0e38f, 2), fmt::format("{:.2f}", 3.0e38f));
+  EXPECT_EQ(fixed_str(std::numeric_limits<float>::infinity(), 6), "inf");
+}
+
+TEST(io_common_number_format, format_float_shortest)
+{
+  EXPECT_EQ(shortest_str(0.0f), "0");
+  EXPECT_EQ(shortest_str(-0.0f), "-0");
+  EXPECT_EQ(shortest_str(1.0f), "1");
+  EXPECT_EQ(shortest_str(0.1f), "0.1");
+  EXPECT_EQ(shortest_str(-12.5f), "-12.5");
+  EXPECT_EQ(shortest_str(0.0001f), "0.0001");
+  EXPECT_EQ(shortest_str(0.00001f), "1e-05");
+  EXPECT_EQ(shortest_str(1e15f), "1000000000000000");
+  EXPECT_EQ(shortest_str(1e16f), "1e+16");
+  EXPECT_EQ(shortest_str(1.5e-45f), "1e-45");
+  EXPECT_EQ(shortest_str(std::numeric_limits<float>::quiet_NaN()), "nan");
+}
+
+TEST(io_common_number_format, matches_fmt_random)
+{
+  RandomNumberGenerator rng(7);
+  for (int i = 0; i < 100000; i++) {
+    const float value = i % 2 ? float_from_bits(rng.get_uint32()) :
+                                rng.get_float() * 200.0f - 100.0f;
+    EXPECT_EQ(shortest_str(value), fmt::format("{}", value));
+    EXPECT_EQ(fixed_str(value, 4), fmt::format("{:.4f}", value));
+    EXPECT_EQ(fixed_str(value, 6), fmt::format("{:.6f}", value));
+  }
+}
+
+TEST(io_common_number_format, float3_rows)
+{
+  const Array<float3> rows = {float3(1.0f, -0.5f, 0.25f), float3(0.0f, 2.0f, 1e-6f)};
+  char buf[2 * float3_row_max_chars(2)];
+  EXPECT_EQ(std::string(buf, format_float3_rows_fixed(buf, "v ", rows, 4)),
+            "v 1.0000 -0.5000 0.2500\nv 0.0000 2.0000 0.0000\n");
+  EXPECT_EQ(std::string(buf, format_float3_rows_shortest(buf, "v ", rows)),
+            "v 1 -0.5 0.25\nv 0 2 1e-06\n");
+}
+
+}  // namespace blender::io
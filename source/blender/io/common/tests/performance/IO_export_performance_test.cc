@@ -0,0 +1,85 @@
+/* SPDX-FileCopyrightText: 2024 Blender Authors
+ *
+ * SPDX-License-Identifier: Apache-2.0 */
+
+#include "testing/testing.h"
+
+#include "IO_number_format.hh"
+
+#include "BLI_array.hh"
+#include "BLI_rand.hh"
+#include "BLI_timeit.hh"
+#include "BLI_vector.hh"
+
+/* SEP macro from BLI path utils clashes with SEP symbol in fmt headers. */
+#undef SEP
+#include <fmt/format.h>
+
+#include <cstdio>
+
+using namespace blender;
+
+/* Amount of vertex rows formatted by each test, roughly an 80 MB OBJ file. */
+static constexpr int ROWS_NUM = 2'000'000;
+
+static Array<float3> create_positions()
+{
+  Array<float3> positions(ROWS_NUM);
+  RandomNumberGenerator rng(1);
+  for (float3 &pos : positions) {
+    pos = float3(rng.get_float(), rng.get_float(), rng.get_float()) * 20.0f - float3(10.0f);
+  }
+  return positions;
+}
+
+static void print_throughput(const char *name, const int64_t bytes, const timeit::Nanoseconds time)
+{
+  const double seconds = std::chrono::duration<double>(time).count();
+  printf("%-24s %8.1f MB/s\n", name, double(bytes) / seconds / (1024.0 * 1024.0));
+}
+
+/** Time formatting all positions into one text buffer, the way the text exporters do. */
+template<typename Fn> static void export_perf_impl(const char *name, const Fn &format_rows)
+{
+  const Array<float3> positions = create_positions();
+  Vector<char> text;
+  text.reserve(ROWS_NUM * io::float3_row_max_chars(2));
+  const timeit::TimePoint start = timeit::Clock::now();
+  format_rows(positions.as_span(), text);
+  print_throughput(name, text.size(), timeit::Clock::now() - start);
+}
+
+static void append_fmt(Vector<char> &text, const fmt::memory_buffer &buf)
+{
+  text.extend(Span<char>(buf.data(), buf.size()));
+}
+
+TEST(io_export, float_rows_fixed_perf)
+{
+  export_perf_impl("fmt fixed rows", [](Span<float3> rows, Vector<char> &text) {
+    for (const float3 &row : rows) {
+      fmt::memory_buffer buf;
+      fmt::format_to(fmt::appender(buf), "v {:.6f} {:.6f} {:.6f}\n", row.x, row.y, row.z);
+      append_fmt(text, buf);
+    }
+  });
+  export_perf_impl("number_format fixed rows", [](Span<float3> rows, Vector<char> &text) {
+    char *end = io::format_float3_rows_fixed(text.end(), "v ", rows, 6);
+    text.increase_size_by_unchecked(end - text.end());
+  });
+}
+
+TEST(io_export, float_rows_shortest_perf)
+{
+  export_perf_impl("fmt shortest rows", [](Span<float3> rows, Vector<char> &text) {
+    for (const float3 &row : rows) {
+      fmt::memory_buffer buf;
+      fmt::format_to(fmt::appender(buf), "v {} {} {}\n", row.x, row.y, row.z);
+      append_fmt(text, buf);
+    }
+  });
+  export_perf_impl("number_format short rows", [](Span<float3> rows, Vector<char> &text) {
+    char *end = io::format_float3_rows_shortest(text.end(), "v ", rows);
+    text.increase_size_by_unchecked(end - text.end());
+  });
+}
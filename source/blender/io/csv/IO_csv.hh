@@ -19,6 +19,20 @@ struct CSVImportParams {
   /** Full path to the source CSV file to import. */
   char filepath[FILE_MAX];
   char delimiter = ',';
+  /**
+   * Parse the file from a memory mapping in bounded windows, writing the values straight into
+   * the attribute arrays. This keeps the peak memory usage close to the size of the resulting
+   * point cloud, at the cost of an additional pass over the file to count the rows.
+   */
+  bool use_streaming = false;
+  /**
+   * Approximate number of bytes that are parsed at once when streaming, which bounds the memory
+   * used for temporary data. Column types are inferred from at most this many bytes as well.
+   * Smaller sizes are mostly useful to test the streaming with small files.
+   */
+  int64_t streaming_window_size = 64 * 1024 * 1024;
+  /** Store integer columns whose values all fit into 8 bits as 8-bit integer attributes. */
+  bool use_compact_integers = false;
 
   ReportList *reports = nullptr;
 };
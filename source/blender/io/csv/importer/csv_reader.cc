@@ -8,9 +8,17 @@
 
 #include <atomic>
 #include <charconv>
+#include <fcntl.h>
+#include <limits>
 #include <optional>
 #include <variant>
 
+#ifndef WIN32
+#  include <unistd.h> /* For close. */
+#else
+#  include <io.h> /* For close. */
+#endif
+
 #include "BLI_array_utils.hh"
 #include "fast_float.h"
 
@@ -19,9 +27,11 @@
 #include "BKE_pointcloud.hh"
 #include "BKE_report.hh"
 
+#include "BLI_bounds.hh"
 #include "BLI_csv_parse.hh"
 #include "BLI_fileops.hh"
 #include "BLI_implicit_sharing.hh"
+#include "BLI_mmap.h"
 #include "BLI_vector.hh"
 
 #include "IO_csv.hh"
@@ -215,7 +225,8 @@ static Array<std::optional<GArray<>>> flatten_valid_attribute_chunks(
               /* This chunk was read entirely as integers, so it still has to be converted to
                * floats. */
               BLI_assert(int_vec->size() == dst_range.size());
-              uninitialized_convert_n(int_vec->data(), dst_range.size(), attribute_buffer);
+              uninitialized_convert_n(
+                  int_vec->data(), dst_range.size(), attribute_buffer + dst_range.first());
             }
             else {
               /* Expected data to be available, because the `found_invalid` flag was not
@@ -260,7 +271,54 @@ static Array<std::optional<GArray<>>> flatten_valid_attribute_chunks(
   return flattened_attributes;
 }
 
-PointCloud *import_csv_as_pointcloud(const CSVImportParams &import_params)
+static void init_columns_info(const csv_parse::CsvRecord &record,
+                              const csv_parse::CsvParseOptions &parse_options,
+                              LinearAllocator<> &allocator,
+                              Array<ColumnInfo> &r_columns_info)
+{
+  r_columns_info.reinitialize(record.size());
+  for (const int i : record.index_range()) {
+    ColumnInfo &column_info = r_columns_info[i];
+    const StringRef name = csv_parse::unescape_field(
+        record.field_str(i), parse_options, allocator);
+    column_info.name = name;
+    if (!bke::allow_procedural_attribute_access(name) || bke::attribute_name_is_anonymous(name) ||
+        name.is_empty())
+    {
+      column_info.has_invalid_name = true;
+      continue;
+    }
+  }
+}
+
+static bool fits_into_int8(const Span<int> values)
+{
+  const std::optional<Bounds<int>> bounds = bounds::min_max(values);
+  return bounds.has_value() && bounds->min >= INT8_MIN && bounds->max <= INT8_MAX;
+}
+
+static void convert_to_int8(const Span<int> src, MutableSpan<int8_t> dst)
+{
+  threading::parallel_for(src.index_range(), 4096, [&](const IndexRange range) {
+    for (const int64_t i : range) {
+      dst[i] = int8_t(src[i]);
+    }
+  });
+}
+
+/**
+ * All points are placed at the origin, so the bounding box can be set eagerly to avoid computing
+ * it later.
+ */
+static void set_bounds_at_origin(PointCloud &pointcloud)
+{
+  pointcloud.runtime->bounds_cache.ensure([](Bounds<float3> &r_bounds) {
+    r_bounds.min = float3(0);
+    r_bounds.max = float3(0);
+  });
+}
+
+static PointCloud *import_csv_as_pointcloud_in_memory(const CSVImportParams &import_params)
 {
   size_t buffer_len;
   void *buffer = BLI_file_read_text_as_mem(import_params.filepath, 0, &buffer_len);
@@ -284,19 +342,7 @@ PointCloud *import_csv_as_pointcloud(const CSVImportParams &import_params)
   parse_options.delimiter = import_params.delimiter;
 
   const auto parse_header = [&](const csv_parse::CsvRecord &record) {
-    columns_info.reinitialize(record.size());
-    for (const int i : record.index_range()) {
-      ColumnInfo &column_info = columns_info[i];
-      const StringRef name = csv_parse::unescape_field(
-          record.field_str(i), parse_options, allocator);
-      column_info.name = name;
-      if (!bke::allow_procedural_attribute_access(name) ||
-          bke::attribute_name_is_anonymous(name) || name.is_empty())
-      {
-        column_info.has_invalid_name = true;
-        continue;
-      }
-    }
+    init_columns_info(record, parse_options, allocator, columns_info);
   };
   const auto parse_data_chunk = [&](const csv_parse::CsvRecords &records) {
     return parse_records_chunk(records, columns_info);
@@ -346,6 +392,14 @@ PointCloud *import_csv_as_pointcloud(const CSVImportParams &import_params)
     if (!attribute.has_value()) {
       continue;
     }
+    if (import_params.use_compact_integers && attribute->type().is<int>()) {
+      const Span<int> values = attribute->as_span().typed<int>();
+      if (fits_into_int8(values)) {
+        GArray<> compact_attribute(CPPType::get<int8_t>(), values.size());
+        convert_to_int8(values, compact_attribute.as_mutable_span().typed<int8_t>());
+        attribute = std::move(compact_attribute);
+      }
+    }
     const auto *data = new ImplicitSharedValue<GArray<>>(std::move(*attribute));
     const eCustomDataType type = bke::cpp_type_to_custom_data_type(attribute->type());
     const ColumnInfo &column_info = columns_info[column_i];
@@ -356,14 +410,283 @@ PointCloud *import_csv_as_pointcloud(const CSVImportParams &import_params)
     data->remove_user_and_delete_if_last();
   }
 
-  /* Since all positions are set to zero, the bounding box can be updated eagerly to avoid
-   * computing it later. */
-  pointcloud->runtime->bounds_cache.ensure([](Bounds<float3> &r_bounds) {
-    r_bounds.min = float3(0);
-    r_bounds.max = float3(0);
+  set_bounds_at_origin(*pointcloud);
+
+  return pointcloud;
+}
+
+/** Number of bytes at the start of the file that are used to infer the column types. */
+static constexpr int64_t streaming_type_inference_bytes = 1024 * 1024;
+
+/**
+ * Attribute array of a column that is filled window by window while streaming the file. Integers
+ * and floats have the same size, so when a column that was read as integers so far turns out to
+ * contain floats, the values read already can be converted in place.
+ */
+struct StreamedColumn {
+  void *data = nullptr;
+  bool is_float = false;
+};
+static_assert(sizeof(int) == sizeof(float));
+
+static void convert_ints_to_floats_in_place(void *data, const int64_t size)
+{
+  const int *int_data = static_cast<const int *>(data);
+  float *float_data = static_cast<float *>(data);
+  threading::parallel_for(IndexRange(size), 4096, [&](const IndexRange range) {
+    for (const int64_t i : range) {
+      const int value = int_data[i];
+      float_data[i] = float(value);
+    }
+  });
+}
+
+/**
+ * Move the parsed data of all chunks of a window into the attribute arrays, starting at the index
+ * of the first record of the window.
+ */
+static void copy_window_to_columns(const Span<ColumnInfo> columns_info,
+                                   const OffsetIndices<int> chunk_offsets,
+                                   MutableSpan<ChunkResult> chunks,
+                                   const int window_start,
+                                   MutableSpan<StreamedColumn> columns)
+{
+  threading::parallel_for(columns.index_range(), 1, [&](const IndexRange columns_range) {
+    for (const int column_i : columns_range) {
+      StreamedColumn &column = columns[column_i];
+      if (column.data == nullptr) {
+        continue;
+      }
+      const ColumnInfo &column_info = columns_info[column_i];
+      if (column_info.found_invalid) {
+        MEM_freeN(column.data);
+        column.data = nullptr;
+        continue;
+      }
+      if (column_info.found_float && !column.is_float) {
+        convert_ints_to_floats_in_place(column.data, window_start);
+        column.is_float = true;
+      }
+      threading::parallel_for(chunks.index_range(), 1, [&](const IndexRange chunks_range) {
+        for (const int chunk_i : chunks_range) {
+          const IndexRange dst_range = chunk_offsets[chunk_i].shift(window_start);
+          ColumnData &column_data = chunks[chunk_i].columns[column_i];
+          if (const auto *float_vec = std::get_if<Vector<float>>(&column_data)) {
+            BLI_assert(column.is_float);
+            BLI_assert(float_vec->size() == dst_range.size());
+            float *dst = static_cast<float *>(column.data) + dst_range.first();
+            uninitialized_copy_n(float_vec->data(), dst_range.size(), dst);
+          }
+          else if (const auto *int_vec = std::get_if<Vector<int>>(&column_data)) {
+            BLI_assert(int_vec->size() == dst_range.size());
+            if (column.is_float) {
+              float *dst = static_cast<float *>(column.data) + dst_range.first();
+              uninitialized_convert_n(int_vec->data(), dst_range.size(), dst);
+            }
+            else {
+              int *dst = static_cast<int *>(column.data) + dst_range.first();
+              uninitialized_copy_n(int_vec->data(), dst_range.size(), dst);
+            }
+          }
+          else {
+            /* Expected data to be available, because the `found_invalid` flag was not set. */
+            BLI_assert_unreachable();
+          }
+          /* Free data for chunk. */
+          column_data = std::monostate{};
+        }
+      });
+    }
+  });
+}
+
+/**
+ * Import the file without ever holding all of its text or all parsed values in memory at once.
+ * The file is memory-mapped, the column types are inferred from the start of the file and the
+ * records are counted, so that the attribute arrays can be allocated up front. The records are
+ * then parsed in bounded windows and copied straight into those arrays.
+ */
+static PointCloud *import_csv_as_pointcloud_streaming(const CSVImportParams &import_params)
+{
+  const int file_descriptor = BLI_open(import_params.filepath, O_BINARY | O_RDONLY, 0);
+  if (file_descriptor == -1) {
+    BKE_reportf(import_params.reports,
+                RPT_ERROR,
+                "CSV Import: Cannot open file '%s'",
+                import_params.filepath);
+    return nullptr;
+  }
+  BLI_SCOPED_DEFER([&]() { close(file_descriptor); });
+
+  BLI_mmap_file *mmap_file = BLI_mmap_open(file_descriptor);
+  if (mmap_file == nullptr) {
+    /* Fall back to reading the whole file if it cannot be mapped. */
+    return import_csv_as_pointcloud_in_memory(import_params);
+  }
+  BLI_SCOPED_DEFER([&]() { BLI_mmap_free(mmap_file); });
+  const Span<char> buffer{static_cast<const char *>(BLI_mmap_get_pointer(mmap_file)),
+                          int64_t(BLI_mmap_get_length(mmap_file))};
+  if (buffer.is_empty()) {
+    BKE_reportf(
+        import_params.reports, RPT_ERROR, "CSV Import: empty file '%s'", import_params.filepath);
+    return nullptr;
+  }
+
+  const auto report_parse_error = [&]() {
+    BKE_reportf(import_params.reports,
+                RPT_ERROR,
+                "CSV import: failed to parse file '%s'",
+                import_params.filepath);
+  };
+
+  LinearAllocator<> allocator;
+  Array<ColumnInfo> columns_info;
+  csv_parse::CsvParseOptions parse_options;
+  parse_options.delimiter = import_params.delimiter;
+
+  const auto parse_header = [&](const csv_parse::CsvRecord &record) {
+    init_columns_info(record, parse_options, allocator, columns_info);
+  };
+  const auto parse_data_chunk = [&](const csv_parse::CsvRecords &records) {
+    return parse_records_chunk(records, columns_info);
+  };
+
+  /* Infer the column types from the records at the start of the file. The parsed values are
+   * discarded, the flags in #ColumnInfo are what matters. A column may still turn out to contain
+   * floats or invalid values later on. */
+  int64_t prefix_size = std::min({buffer.size(),
+                                  streaming_type_inference_bytes,
+                                  std::max<int64_t>(import_params.streaming_window_size, 1)});
+  while (prefix_size < buffer.size() && buffer[prefix_size - 1] != '\n') {
+    prefix_size++;
+  }
+  csv_parse::parse_csv_in_chunks<ChunkResult>(
+      buffer.take_front(prefix_size), parse_options, parse_header, parse_data_chunk);
+  if (columns_info.is_empty()) {
+    /* No header was found, so the file is malformed or empty. */
+    report_parse_error();
+    return nullptr;
+  }
+
+  /* Count the records so that the attribute arrays can be allocated once. */
+  int64_t records_num = 0;
+  if (!csv_parse::parse_csv_in_windows<int64_t>(
+          buffer,
+          parse_options,
+          import_params.streaming_window_size,
+          [](const csv_parse::CsvRecord & /*record*/) {},
+          [](const csv_parse::CsvRecords &records) { return records.size(); },
+          [&](const MutableSpan<int64_t> chunk_sizes) {
+            for (const int64_t chunk_size : chunk_sizes) {
+              records_num += chunk_size;
+            }
+          }))
+  {
+    report_parse_error();
+    return nullptr;
+  }
+  if (records_num > std::numeric_limits<int>::max()) {
+    BKE_reportf(import_params.reports,
+                RPT_ERROR,
+                "CSV import: too many rows in file '%s'",
+                import_params.filepath);
+    return nullptr;
+  }
+  const int points_num = int(records_num);
+
+  Array<StreamedColumn> columns(columns_info.size());
+  BLI_SCOPED_DEFER([&]() {
+    for (StreamedColumn &column : columns) {
+      MEM_SAFE_FREE(column.data);
+    }
   });
+  for (const int column_i : columns_info.index_range()) {
+    const ColumnInfo &column_info = columns_info[column_i];
+    if (column_info.has_invalid_name || column_info.found_invalid || points_num == 0) {
+      continue;
+    }
+    columns[column_i].data = MEM_malloc_arrayN<int>(size_t(points_num), __func__);
+    columns[column_i].is_float = column_info.found_float;
+  }
+
+  /* Parse the values window by window and copy them into the attribute arrays right away. */
+  int window_start = 0;
+  bool found_size_mismatch = false;
+  const bool parse_success = csv_parse::parse_csv_in_windows<ChunkResult>(
+      buffer,
+      parse_options,
+      import_params.streaming_window_size,
+      [](const csv_parse::CsvRecord & /*record*/) {},
+      parse_data_chunk,
+      [&](const MutableSpan<ChunkResult> chunks) {
+        Vector<int> chunk_offsets_vec;
+        chunk_offsets_vec.append(0);
+        for (const ChunkResult &chunk : chunks) {
+          chunk_offsets_vec.append(chunk_offsets_vec.last() + chunk.rows_num);
+        }
+        const OffsetIndices<int> chunk_offsets(chunk_offsets_vec);
+        if (found_size_mismatch || chunk_offsets.total_size() > points_num - window_start) {
+          /* Should not happen, because the windows are split the same way as when counting. */
+          found_size_mismatch = true;
+          return;
+        }
+        copy_window_to_columns(columns_info, chunk_offsets, chunks, window_start, columns);
+        window_start += chunk_offsets.total_size();
+      });
+  if (!parse_success || found_size_mismatch || window_start != points_num) {
+    report_parse_error();
+    return nullptr;
+  }
+  if (BLI_mmap_any_io_error(mmap_file)) {
+    BKE_reportf(import_params.reports,
+                RPT_ERROR,
+                "CSV import: error reading file '%s'",
+                import_params.filepath);
+    return nullptr;
+  }
+
+  PointCloud *pointcloud = BKE_pointcloud_new_nomain(points_num);
+  pointcloud->positions_for_write().fill(float3(0));
+
+  /* Add all valid attributes to the pointcloud, which takes ownership of the arrays. */
+  bke::MutableAttributeAccessor attributes = pointcloud->attributes_for_write();
+  for (const int column_i : columns_info.index_range()) {
+    StreamedColumn &column = columns[column_i];
+    const ColumnInfo &column_info = columns_info[column_i];
+    if (column.data == nullptr || column_info.found_invalid) {
+      continue;
+    }
+    eCustomDataType type = column.is_float ? CD_PROP_FLOAT : CD_PROP_INT32;
+    if (import_params.use_compact_integers && !column.is_float) {
+      const Span<int> values(static_cast<const int *>(column.data), points_num);
+      if (fits_into_int8(values)) {
+        int8_t *compact_data = MEM_malloc_arrayN<int8_t>(size_t(points_num), __func__);
+        convert_to_int8(values, {compact_data, points_num});
+        MEM_freeN(column.data);
+        column.data = compact_data;
+        type = CD_PROP_INT8;
+      }
+    }
+    if (attributes.add(column_info.name,
+                       bke::AttrDomain::Point,
+                       type,
+                       bke::AttributeInitMoveArray(column.data)))
+    {
+      column.data = nullptr;
+    }
+  }
+
+  set_bounds_at_origin(*pointcloud);
 
   return pointcloud;
 }
 
+PointCloud *import_csv_as_pointcloud(const CSVImportParams &import_params)
+{
+  if (import_params.use_streaming) {
+    return import_csv_as_pointcloud_streaming(import_params);
+  }
+  return import_csv_as_pointcloud_in_memory(import_params);
+}
+
 }  // namespace blender::io::csv
@@ -0,0 +1,137 @@
+/* SPDX-FileCopyrightText: 2025 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#include "testing/testing.h"
+
+#include "BKE_appdir.hh"
+#include "BKE_attribute.hh"
+#include "BKE_idtype.hh"
+#include "BKE_lib_id.hh"
+#include "BKE_pointcloud.hh"
+
+#include "BLI_fileops.h"
+#include "BLI_string.h"
+
+#include "DNA_pointcloud_types.h"
+
+#include "IO_csv.hh"
+
+#include <fstream>
+
+namespace blender::io::csv {
+
+class CSVImportTest : public testing::Test {
+ public:
+  static void SetUpTestSuite()
+  {
+    BKE_idtype_init();
+    BKE_tempdir_init(nullptr);
+  }
+
+  void TearDown() override
+  {
+    if (!filepath_.empty()) {
+      BLI_delete(filepath_.c_str(), false, false);
+    }
+  }
+
+  /** Write the text into a temporary file and return the import parameters for it. */
+  CSVImportParams write_file(const std::string &name, const std::string &text)
+  {
+    filepath_ = std::string(BKE_tempdir_session()) + SEP_STR + name;
+    std::ofstream file(filepath_, std::ios::binary);
+    file << text;
+    file.close();
+    CSVImportParams params;
+    STRNCPY(params.filepath, filepath_.c_str());
+    return params;
+  }
+
+ private:
+  std::string filepath_;
+};
+
+/* Float columns are parsed in chunks, and chunks that only contain integers are converted to
+ * floats afterwards. Each chunk has to end up at its own offset in the attribute. */
+TEST_F(CSVImportTest, IntChunksOfFloatColumn)
+{
+  /* Many chunks of integers, only the last rows contain floats. */
+  constexpr int rows_num = 50000;
+  std::string text = "value\n";
+  for (const int i : IndexRange(rows_num - 10)) {
+    text += std::to_string(i) + "\n";
+  }
+  for (const int i : IndexRange(rows_num - 10, 10)) {
+    text += std::to_string(i) + ".0\n";
+  }
+  const CSVImportParams params = write_file("int_chunks_of_float_column.csv", text);
+
+  PointCloud *pointcloud = import_csv_as_pointcloud(params);
+  ASSERT_NE(pointcloud, nullptr);
+  ASSERT_EQ(pointcloud->totpoint, rows_num);
+  const bke::AttributeAccessor attributes = pointcloud->attributes();
+  const VArraySpan<float> values = *attributes.lookup<float>("value");
+  ASSERT_FALSE(values.is_empty());
+  for (const int i : values.index_range()) {
+    ASSERT_EQ(values[i], float(i));
+  }
+  BKE_id_free(nullptr, pointcloud);
+}
+
+static void expect_equal_attributes(const PointCloud &a, const PointCloud &b)
+{
+  ASSERT_EQ(a.totpoint, b.totpoint);
+  const bke::AttributeAccessor attributes_a = a.attributes();
+  const bke::AttributeAccessor attributes_b = b.attributes();
+  EXPECT_EQ(attributes_a.all_ids(), attributes_b.all_ids());
+  attributes_a.foreach_attribute([&](const bke::AttributeIter &iter) {
+    const GVArraySpan values_a = *iter.get();
+    const GVArraySpan values_b = *attributes_b.lookup(iter.name);
+    ASSERT_FALSE(values_b.is_empty()) << iter.name;
+    ASSERT_EQ(values_a.type(), values_b.type()) << iter.name;
+    const CPPType &type = values_a.type();
+    for (const int i : IndexRange(values_a.size())) {
+      ASSERT_TRUE(type.is_equal(values_a[i], values_b[i])) << iter.name << " at " << i;
+    }
+  });
+}
+
+/* The streaming import parses the file in windows and writes the values into the attributes
+ * directly, converting values in place when a column turns out to contain floats later on. It
+ * should give the same result as the regular import. */
+TEST_F(CSVImportTest, StreamingMatchesRegular)
+{
+  constexpr int rows_num = 20000;
+  std::string text = "large,float_later,invalid_later,small\n";
+  for (const int i : IndexRange(rows_num)) {
+    text += std::to_string(i * 1000) + ",";
+    text += std::to_string(i) + (i >= rows_num / 2 ? ".5," : ",");
+    text += (i >= rows_num - 100 ? "x" : std::to_string(i)) + ",";
+    text += std::to_string(i % 200 - 100) + "\n";
+  }
+  CSVImportParams params = write_file("streaming.csv", text);
+  params.use_compact_integers = true;
+  params.streaming_window_size = 4096;
+
+  PointCloud *regular = import_csv_as_pointcloud(params);
+  params.use_streaming = true;
+  PointCloud *streamed = import_csv_as_pointcloud(params);
+  ASSERT_NE(regular, nullptr);
+  ASSERT_NE(streamed, nullptr);
+  expect_equal_attributes(*regular, *streamed);
+
+  const bke::AttributeAccessor attributes = streamed->attributes();
+  EXPECT_EQ(attributes.lookup_meta_data("large")->data_type, CD_PROP_INT32);
+  EXPECT_EQ(attributes.lookup_meta_data("float_later")->data_type, CD_PROP_FLOAT);
+  EXPECT_FALSE(attributes.contains("invalid_later"));
+  EXPECT_EQ(attributes.lookup_meta_data("small")->data_type, CD_PROP_INT8);
+  const VArraySpan<float> float_later = *attributes.lookup<float>("float_later");
+  EXPECT_EQ(float_later[rows_num / 2 - 1], float(rows_num / 2 - 1));
+  EXPECT_EQ(float_later[rows_num - 1], float(rows_num - 1) + 0.5f);
+
+  BKE_id_free(nullptr, regular);
+  BKE_id_free(nullptr, streamed);
+}
+
+}  // namespace blender::io::csv
@@ -20,6 +20,7 @@
 #include "BLI_listbase.h"
 #include "BLI_ordered_edge.hh"
 #include "BLI_string.h"
+#include "BLI_task.hh"
 
 #include "BLT_translation.hh"
 
@@ -338,48 +339,73 @@ static bool import_blend_shapes(Main &bmain,
   return mesh_key != nullptr;
 }
 
+/**
+ * Convert the geometry, attributes and skin weights of the FBX mesh to a mesh outside of Main.
+ * Does not touch any shared state, so meshes can be converted in parallel.
+ */
+static Mesh *import_mesh_nomain(const ufbx_mesh *fmesh, const FBXImportParams &params)
+{
+  const ufbx_skin_deformer *skin = get_skin_from_mesh(fmesh);
+
+  Mesh *mesh = BKE_mesh_new_nomain(
+      fmesh->num_vertices, fmesh->num_edges, fmesh->num_faces, fmesh->num_indices);
+  bke::MutableAttributeAccessor attributes = mesh->attributes_for_write();
+  AttributeOwner attr_owner = AttributeOwner::from_id(&mesh->id);
+
+  import_vertex_positions(fmesh, mesh);
+  import_faces(fmesh, mesh);
+  import_face_material_indices(fmesh, attributes);
+  import_face_smoothing(fmesh, attributes);
+  import_edges(fmesh, mesh, attributes);
+  import_uvs(fmesh, attributes, attr_owner);
+  if (params.vertex_colors != eFBXVertexColorMode::None) {
+    import_colors(fmesh, mesh, attributes, attr_owner, params.vertex_colors);
+  }
+  if (params.use_custom_normals) {
+    import_normals(fmesh, mesh);
+  }
+  if (skin != nullptr) {
+    import_skin_vertex_groups(fmesh, skin, mesh);
+  }
+
+  /* Validate if needed. */
+  if (params.validate_meshes) {
+    bool verbose_validate = false;
+#ifndef NDEBUG
+    verbose_validate = true;
+#endif
+    BKE_mesh_validate(mesh, verbose_validate, false);
+  }
+
+  return mesh;
+}
+
 void import_meshes(Main &bmain,
                    const ufbx_scene &fbx,
                    FbxElementMapping &mapping,
                    const FBXImportParams &params)
 {
+  Vector<const ufbx_mesh *> fmeshes;
   for (const ufbx_mesh *fmesh : fbx.meshes) {
     if (fmesh->instances.count == 0) {
       continue; /* Ignore if not used by any objects. */
     }
+    fmeshes.append(fmesh);
+  }
 
-    const ufbx_skin_deformer *skin = get_skin_from_mesh(fmesh);
-
-    /* Create Mesh outside of main. */
-    Mesh *mesh = BKE_mesh_new_nomain(
-        fmesh->num_vertices, fmesh->num_edges, fmesh->num_faces, fmesh->num_indices);
-    bke::MutableAttributeAccessor attributes = mesh->attributes_for_write();
-    AttributeOwner attr_owner = AttributeOwner::from_id(&mesh->id);
-
-    import_vertex_positions(fmesh, mesh);
-    import_faces(fmesh, mesh);
-    import_face_material_indices(fmesh, attributes);
-    import_face_smoothing(fmesh, attributes);
-    import_edges(fmesh, mesh, attributes);
-    import_uvs(fmesh, attributes, attr_owner);
-    if (params.vertex_colors != eFBXVertexColorMode::None) {
-      import_colors(fmesh, mesh, attributes, attr_owner, params.vertex_colors);
-    }
-    if (params.use_custom_normals) {
-      import_normals(fmesh, mesh);
-    }
-    if (skin != nullptr) {
-      import_skin_vertex_groups(fmesh, skin, mesh);
+  /* Convert the meshes in parallel; creating the data-blocks and objects in Main has to happen
+   * on one thread, in the order of the file so that names are stable. */
+  Array<Mesh *> nomain_meshes(fmeshes.size());
+  threading::parallel_for(fmeshes.index_range(), 1, [&](const IndexRange range) {
+    for (const int i : range) {
+      nomain_meshes[i] = import_mesh_nomain(fmeshes[i], params);
     }
+  });
 
-    /* Validate if needed. */
-    if (params.validate_meshes) {
-      bool verbose_validate = false;
-#ifndef NDEBUG
-      verbose_validate = true;
-#endif
-      BKE_mesh_validate(mesh, verbose_validate, false);
-    }
+  for (const int mesh_index : fmeshes.index_range()) {
+    const ufbx_mesh *fmesh = fmeshes[mesh_index];
+    const ufbx_skin_deformer *skin = get_skin_from_mesh(fmesh);
+    Mesh *mesh = nomain_meshes[mesh_index];
 
     /* Steps below have to be done on the final mesh in Main. */
     Mesh *mesh_main = static_cast<Mesh *>(
@@ -79,6 +79,21 @@ class FileBuffer : private NonMovable {
     }
   }
 
+  /**
+   * Return room for at least \a max_len characters at the end of the last block, to be
+   * written directly. Has to be followed by #commit with the end of the written text.
+   */
+  char *reserve(size_t max_len)
+  {
+    ensure_space(max_len);
+    return blocks_.last().end();
+  }
+  void commit(char *end)
+  {
+    VectorChar &bb = blocks_.last();
+    bb.increase_size_by_unchecked(end - bb.end());
+  }
+
   template<typename... T> void write_fstring(fmt::format_string<T...> fmt, T &&...args)
   {
     /* Format into a local buffer. */
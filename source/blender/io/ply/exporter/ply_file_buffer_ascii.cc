@@ -8,31 +8,51 @@
 
 #include "ply_file_buffer_ascii.hh"
 
+#include "IO_number_format.hh"
+
 namespace blender::io::ply {
 
+/* Write floats, each preceded by a space. */
+static char *write_floats(char *p, const std::initializer_list<float> values)
+{
+  for (const float v : values) {
+    *p++ = ' ';
+    p = format_float_shortest(p, v);
+  }
+  return p;
+}
+
 void FileBufferAscii::write_vertex(float x, float y, float z)
 {
-  write_fstring("{} {} {}", x, y, z);
+  char *p = reserve(3 * (number_max_chars + 1));
+  p = format_float_shortest(p, x);
+  p = write_floats(p, {y, z});
+  commit(p);
 }
 
 void FileBufferAscii::write_UV(float u, float v)
 {
-  write_fstring(" {} {}", u, v);
+  commit(write_floats(reserve(2 * (number_max_chars + 1)), {u, v}));
 }
 
 void FileBufferAscii::write_data(float v)
 {
-  write_fstring(" {}", v);
+  commit(write_floats(reserve(number_max_chars + 1), {v}));
 }
 
 void FileBufferAscii::write_vertex_normal(float nx, float ny, float nz)
 {
-  write_fstring(" {} {} {}", nx, ny, nz);
+  commit(write_floats(reserve(3 * (number_max_chars + 1)), {nx, ny, nz}));
 }
 
 void FileBufferAscii::write_vertex_color(uchar r, uchar g, uchar b, uchar a)
 {
-  write_fstring(" {} {} {} {}", r, g, b, a);
+  char *p = reserve(4 * 4);
+  for (const uchar v : {r, g, b, a}) {
+    *p++ = ' ';
+    p = format_uint(p, v);
+  }
+  commit(p);
 }
 
 void FileBufferAscii::write_vertex_end()
@@ -42,17 +62,23 @@ void FileBufferAscii::write_vertex_end()
 
 void FileBufferAscii::write_face(char count, Span<uint32_t> const &vertex_indices)
 {
-  write_fstring("{}", int(count));
-
+  char *p = reserve(number_max_chars + vertex_indices.size() * (number_max_chars + 1) + 1);
+  p = format_int(p, int(count));
   for (const uint32_t v : vertex_indices) {
-    write_fstring(" {}", v);
+    *p++ = ' ';
+    p = format_uint(p, v);
   }
-  write_newline();
+  *p++ = '\n';
+  commit(p);
 }
 
 void FileBufferAscii::write_edge(int first, int second)
 {
-  write_fstring("{} {}", first, second);
-  write_newline();
+  char *p = reserve(2 * number_max_chars + 2);
+  p = format_int(p, first);
+  *p++ = ' ';
+  p = format_int(p, second);
+  *p++ = '\n';
+  commit(p);
 }
 }  // namespace blender::io::ply
@@ -166,7 +166,7 @@ const char *read_header(PlyReadBuffer &file, PlyHeader &r_header)
 static Mesh *read_ply_to_mesh(const PLYImportParams &import_params, const char *ob_name)
 {
   /* Parse header. */
-  PlyReadBuffer file(import_params.filepath, 64 * 1024);
+  PlyReadBuffer file(import_params.filepath, 64 * 1024, true);
 
   PlyHeader header;
   const char *err = read_header(file, header);
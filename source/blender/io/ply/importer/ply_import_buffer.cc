@@ -5,12 +5,20 @@
 #include "ply_import_buffer.hh"
 
 #include "BLI_fileops.h"
+#include "BLI_mmap.h"
 
 #include <algorithm>
 #include <cstdio>
 #include <cstring>
+#include <fcntl.h>
 #include <stdexcept>
 
+#ifndef WIN32
+#  include <unistd.h> /* For close. */
+#else
+#  include <io.h> /* For close. */
+#endif
+
 static inline bool is_newline(char ch)
 {
   return ch == '\n';
@@ -18,9 +26,29 @@ static inline bool is_newline(char ch)
 
 namespace blender::io::ply {
 
-PlyReadBuffer::PlyReadBuffer(const char *file_path, size_t read_buffer_size)
-    : buffer_(read_buffer_size), read_buffer_size_(read_buffer_size)
+PlyReadBuffer::PlyReadBuffer(const char *file_path,
+                             size_t read_buffer_size,
+                             bool use_memory_mapping)
+    : read_buffer_size_(read_buffer_size)
 {
+  if (use_memory_mapping) {
+    const int file_descriptor = BLI_open(file_path, O_BINARY | O_RDONLY, 0);
+    if (file_descriptor != -1) {
+      /* The mapping stays valid after the file descriptor is closed. */
+      mmap_file_ = BLI_mmap_open(file_descriptor);
+      close(file_descriptor);
+    }
+    if (mmap_file_ != nullptr) {
+      /* The whole file is one big buffer. */
+      data_ = static_cast<const char *>(BLI_mmap_get_pointer(mmap_file_));
+      buf_used_ = int64_t(BLI_mmap_get_length(mmap_file_));
+      last_newline_ = buf_used_;
+      at_eof_ = true;
+      return;
+    }
+  }
+  buffer_.reinitialize(read_buffer_size);
+  data_ = buffer_.data();
   file_ = BLI_fopen(file_path, "rb");
 }
 
@@ -29,6 +57,9 @@ PlyReadBuffer::~PlyReadBuffer()
   if (file_ != nullptr) {
     fclose(file_);
   }
+  if (mmap_file_ != nullptr) {
+    BLI_mmap_free(mmap_file_);
+  }
 }
 
 void PlyReadBuffer::after_header(bool is_binary)
@@ -44,21 +75,21 @@ Span<char> PlyReadBuffer::read_line()
   if (pos_ >= last_newline_) {
     refill_buffer();
   }
-  BLI_assert(last_newline_ <= buffer_.size());
-  int res_begin = pos_;
-  while (pos_ < last_newline_ && !is_newline(buffer_[pos_])) {
+  BLI_assert(last_newline_ <= buf_used_);
+  int64_t res_begin = pos_;
+  while (pos_ < last_newline_ && !is_newline(data_[pos_])) {
     pos_++;
   }
-  int res_end = pos_;
+  int64_t res_end = pos_;
   /* Remove possible trailing CR from the result. */
-  if (res_end > res_begin && buffer_[res_end - 1] == '\r') {
+  if (res_end > res_begin && data_[res_end - 1] == '\r') {
     --res_end;
   }
   /* Move cursor past newline. */
-  if (pos_ < buf_used_ && is_newline(buffer_[pos_])) {
+  if (pos_ < buf_used_ && is_newline(data_[pos_])) {
     pos_++;
   }
-  return Span<char>(buffer_.data() + res_begin, res_end - res_begin);
+  return Span<char>(data_ + res_begin, res_end - res_begin);
 }
 
 bool PlyReadBuffer::read_bytes(void *dst, size_t size)
@@ -69,9 +100,9 @@ bool PlyReadBuffer::read_bytes(void *dst, size_t size)
         return false;
       }
     }
-    int to_copy = int(size);
+    int64_t to_copy = int64_t(size);
     to_copy = std::min(to_copy, buf_used_);
-    memcpy(dst, buffer_.data() + pos_, to_copy);
+    memcpy(dst, data_ + pos_, to_copy);
     pos_ += to_copy;
     dst = (char *)dst + to_copy;
     size -= to_copy;
@@ -79,8 +110,26 @@ bool PlyReadBuffer::read_bytes(void *dst, size_t size)
   return true;
 }
 
+const uint8_t *PlyReadBuffer::read_bytes_in_place(size_t size)
+{
+  if (mmap_file_ == nullptr || pos_ + int64_t(size) > buf_used_) {
+    return nullptr;
+  }
+  const uint8_t *result = reinterpret_cast<const uint8_t *>(data_ + pos_);
+  pos_ += int64_t(size);
+  return result;
+}
+
+bool PlyReadBuffer::any_io_error() const
+{
+  return mmap_file_ != nullptr && BLI_mmap_any_io_error(mmap_file_);
+}
+
 bool PlyReadBuffer::refill_buffer()
 {
+  if (mmap_file_ != nullptr) {
+    return false; /* The whole mapped file is always available. */
+  }
   BLI_assert(pos_ <= buf_used_);
   BLI_assert(pos_ <= buffer_.size());
   BLI_assert(buf_used_ <= buffer_.size());
@@ -90,7 +139,7 @@ bool PlyReadBuffer::refill_buffer()
   }
 
   /* Move any leftover to start of buffer. */
-  int keep = buf_used_ - pos_;
+  int64_t keep = buf_used_ - pos_;
   if (keep > 0) {
     memmove(buffer_.data(), buffer_.data() + pos_, keep);
   }
@@ -98,7 +147,7 @@ bool PlyReadBuffer::refill_buffer()
   size_t read = fread(buffer_.data() + keep, 1, read_buffer_size_ - keep, file_) + keep;
   at_eof_ = read < read_buffer_size_;
   pos_ = 0;
-  buf_used_ = int(read);
+  buf_used_ = int64_t(read);
 
   /* Skip past newlines at the front of the buffer and find last newline. */
   if (!is_binary_) {
@@ -106,7 +155,7 @@ bool PlyReadBuffer::refill_buffer()
       pos_++;
     }
 
-    int last_nl = buf_used_;
+    int64_t last_nl = buf_used_;
     if (!at_eof_) {
       while (last_nl > 0) {
         --last_nl;
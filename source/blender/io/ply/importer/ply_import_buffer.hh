@@ -8,20 +8,28 @@
 
 #pragma once
 
+#include <cstdint>
 #include <cstdio>
 
 #include "BLI_array.hh"
 #include "BLI_span.hh"
 
+struct BLI_mmap_file;
+
 namespace blender::io::ply {
 
 /**
  * Reads underlying PLY file in large chunks, and provides interface for ascii/header
  * parsing to read individual lines, and for binary parsing to read chunks of bytes.
+ *
+ * When `use_memory_mapping` is set and the file can be mapped, the whole file is accessed
+ * through the mapping instead, and binary data can be read in place without any copies.
  */
 class PlyReadBuffer {
  public:
-  PlyReadBuffer(const char *file_path, size_t read_buffer_size = 64 * 1024);
+  PlyReadBuffer(const char *file_path,
+                size_t read_buffer_size = 64 * 1024,
+                bool use_memory_mapping = false);
   ~PlyReadBuffer();
 
   /** After header is parsed, indicate whether the rest of reading will be ascii or binary. */
@@ -38,14 +46,27 @@ class PlyReadBuffer {
    */
   bool read_bytes(void *dst, size_t size);
 
+  /**
+   * When the file is memory-mapped, returns a pointer to the next `size` bytes without copying
+   * them, and moves past them. Returns null if the file is not mapped or if this amount of bytes
+   * can not be read; nothing is consumed in that case.
+   */
+  const uint8_t *read_bytes_in_place(size_t size);
+
+  /** Whether reading from the memory-mapped file failed. */
+  bool any_io_error() const;
+
  private:
   bool refill_buffer();
 
   FILE *file_ = nullptr;
+  BLI_mmap_file *mmap_file_ = nullptr;
   Array<char> buffer_;
-  int pos_ = 0;
-  int buf_used_ = 0;
-  int last_newline_ = 0;
+  /** Either #buffer_ or the start of the mapped file. */
+  const char *data_ = nullptr;
+  int64_t pos_ = 0;
+  int64_t buf_used_ = 0;
+  int64_t last_newline_ = 0;
   size_t read_buffer_size_ = 0;
   bool at_eof_ = false;
   bool is_binary_ = false;
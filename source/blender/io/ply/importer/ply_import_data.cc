@@ -10,12 +10,15 @@
 #include "ply_data.hh"
 #include "ply_import_buffer.hh"
 
+#include "BLI_array.hh"
 #include "BLI_endian_switch.h"
 #include "BLI_string_ref.hh"
+#include "BLI_task.hh"
 
 #include "fast_float.h"
 
 #include <charconv>
+#include <optional>
 
 #include "CLG_log.h"
 static CLG_LogRef LOG = {"io.ply"};
@@ -193,22 +196,16 @@ template<typename T> static T get_binary_value(PlyDataTypes type, const uint8_t
   return val;
 }
 
-static const char *parse_row_binary(PlyReadBuffer &file,
-                                    const PlyHeader &header,
-                                    const PlyElement &element,
-                                    Vector<uint8_t> &r_scratch,
-                                    Vector<float> &r_values)
+/**
+ * Convert one fixed-stride binary row into floats. For big endian files the row is byte swapped in
+ * place, so it must point to writable memory.
+ */
+static const char *decode_row_binary(uint8_t *row,
+                                     const PlyHeader &header,
+                                     const PlyElement &element,
+                                     MutableSpan<float> r_values)
 {
-  if (element.stride == 0) {
-    return "Vertex/Edge element contains list properties, this is not supported";
-  }
-  BLI_assert(r_scratch.size() == element.stride);
-  BLI_assert(r_values.size() == element.properties.size());
-  if (!file.read_bytes(r_scratch.data(), r_scratch.size())) {
-    return "Could not read row of binary property";
-  }
-
-  const uint8_t *ptr = r_scratch.data();
+  const uint8_t *ptr = row;
   if (header.type == PlyFormatType::BINARY_LE) {
     /* Little endian: just read/convert the values. */
     for (int i = 0, n = int(element.properties.size()); i != n; i++) {
@@ -232,6 +229,255 @@ static const char *parse_row_binary(PlyReadBuffer &file,
   return nullptr;
 }
 
+static const char *parse_row_binary(PlyReadBuffer &file,
+                                    const PlyHeader &header,
+                                    const PlyElement &element,
+                                    Vector<uint8_t> &r_scratch,
+                                    Vector<float> &r_values)
+{
+  if (element.stride == 0) {
+    return "Vertex/Edge element contains list properties, this is not supported";
+  }
+  BLI_assert(r_scratch.size() == element.stride);
+  BLI_assert(r_values.size() == element.properties.size());
+  if (!file.read_bytes(r_scratch.data(), r_scratch.size())) {
+    return "Could not read row of binary property";
+  }
+  return decode_row_binary(r_scratch.data(), header, element, r_values);
+}
+
+/**
+ * Decoder for the rows of a fixed-stride binary element, built once from the header's property
+ * list. Instead of dispatching on the type and endianness of every value, whole columns of a batch
+ * of rows are converted at once with loops that are specialized for the property type.
+ */
+class BinaryElementDecoder {
+  const PlyElement &element_;
+  Array<int> offsets_;
+  bool big_endian_;
+  /** Size of all property types in bytes, or zero when they differ. */
+  int uniform_type_size_ = 0;
+
+ public:
+  BinaryElementDecoder(const PlyHeader &header, const PlyElement &element)
+      : element_(element),
+        offsets_(element.properties.size()),
+        big_endian_(header.type == PlyFormatType::BINARY_BE)
+  {
+    BLI_assert(element.stride != 0);
+    int offset = 0;
+    for (const int i : element.properties.index_range()) {
+      offsets_[i] = offset;
+      offset += data_type_size[element.properties[i].type];
+    }
+    uniform_type_size_ = data_type_size[element.properties.first().type];
+    for (const PlyProperty &prop : element.properties) {
+      if (data_type_size[prop.type] != uniform_type_size_) {
+        uniform_type_size_ = 0;
+        break;
+      }
+    }
+  }
+
+  bool needs_byte_swap() const
+  {
+    return big_endian_;
+  }
+
+  /**
+   * Convert big endian rows to little endian in place. When all properties have the same size,
+   * the whole batch is swapped as one contiguous array.
+   */
+  void byte_swap_rows(uint8_t *rows, const int64_t rows_num) const
+  {
+    BLI_assert(big_endian_);
+    if (uniform_type_size_ != 0) {
+      const int64_t values_num = rows_num * element_.properties.size();
+      endian_switch_array(rows, uniform_type_size_, int(values_num));
+      return;
+    }
+    for (const int64_t row : IndexRange(rows_num)) {
+      uint8_t *ptr = rows + row * element_.stride;
+      for (const int i : element_.properties.index_range()) {
+        endian_switch(ptr + offsets_[i], data_type_size[element_.properties[i].type]);
+      }
+    }
+  }
+
+  /**
+   * Convert one property of consecutive (little endian) rows to floats, writing every
+   * `dst_stride`-th value of `dst`. Values are divided by `normalizer`.
+   */
+  void decode_column(const uint8_t *rows,
+                     const int64_t rows_num,
+                     const int prop_index,
+                     float *dst,
+                     const int64_t dst_stride,
+                     const float normalizer = 1.0f) const
+  {
+    const uint8_t *src = rows + offsets_[prop_index];
+    const int64_t stride = element_.stride;
+    switch (element_.properties[prop_index].type) {
+      case CHAR:
+        decode_column<int8_t>(src, stride, rows_num, dst, dst_stride, normalizer);
+        break;
+      case UCHAR:
+        decode_column<uint8_t>(src, stride, rows_num, dst, dst_stride, normalizer);
+        break;
+      case SHORT:
+        decode_column<int16_t>(src, stride, rows_num, dst, dst_stride, normalizer);
+        break;
+      case USHORT:
+        decode_column<uint16_t>(src, stride, rows_num, dst, dst_stride, normalizer);
+        break;
+      case INT:
+        decode_column<int32_t>(src, stride, rows_num, dst, dst_stride, normalizer);
+        break;
+      case UINT:
+        decode_column<uint32_t>(src, stride, rows_num, dst, dst_stride, normalizer);
+        break;
+      case FLOAT:
+        decode_column<float>(src, stride, rows_num, dst, dst_stride, normalizer);
+        break;
+      case DOUBLE:
+        decode_column<double>(src, stride, rows_num, dst, dst_stride, normalizer);
+        break;
+      default:
+        BLI_assert_msg(false, "Unknown property type");
+    }
+  }
+
+ private:
+  template<typename T>
+  static void decode_column(const uint8_t *src,
+                            const int64_t src_stride,
+                            const int64_t rows_num,
+                            float *dst,
+                            const int64_t dst_stride,
+                            const float normalizer)
+  {
+    for (int64_t i = 0; i < rows_num; i++) {
+      T value;
+      memcpy(&value, src + i * src_stride, sizeof(T));
+      dst[i * dst_stride] = float(value) / normalizer;
+    }
+  }
+};
+
+/** Number of rows that are decoded together by #BinaryElementDecoder. */
+static constexpr int64_t binary_rows_batch_size = 16 * 1024;
+
+/**
+ * Load a fixed-stride binary vertex element in batches of rows that are decoded in parallel,
+ * straight from the file mapping when possible.
+ */
+static const char *load_vertex_element_binary(PlyReadBuffer &file,
+                                              const PlyHeader &header,
+                                              const PlyElement &element,
+                                              const int3 vertex_index,
+                                              const std::optional<int3> color_index,
+                                              const std::optional<int> alpha_index,
+                                              const std::optional<int3> normal_index,
+                                              const std::optional<int2> uv_index,
+                                              const Span<int64_t> custom_attr_indices,
+                                              PlyData *data)
+{
+  if (element.stride == 0) {
+    return "Vertex/Edge element contains list properties, this is not supported";
+  }
+  if (!ELEM(header.type, PlyFormatType::BINARY_LE, PlyFormatType::BINARY_BE)) {
+    return "Unknown binary ply format for vertex element";
+  }
+  const BinaryElementDecoder decoder(header, element);
+
+  /* Decode consecutive rows into the vertex data, starting at the first index of `range`. */
+  const auto decode_rows = [&](const uint8_t *rows, const IndexRange range) {
+    const int64_t start = range.start();
+    const int64_t size = range.size();
+    float *positions = &data->vertices[start].x;
+    decoder.decode_column(rows, size, vertex_index.x, positions + 0, 3);
+    decoder.decode_column(rows, size, vertex_index.y, positions + 1, 3);
+    decoder.decode_column(rows, size, vertex_index.z, positions + 2, 3);
+    if (color_index) {
+      float *colors = &data->vertex_colors[start].x;
+      for (const int i : IndexRange(3)) {
+        const int prop_index = (*color_index)[i];
+        decoder.decode_column(rows,
+                              size,
+                              prop_index,
+                              colors + i,
+                              4,
+                              data_type_normalizer[element.properties[prop_index].type]);
+      }
+      if (alpha_index) {
+        decoder.decode_column(rows,
+                              size,
+                              *alpha_index,
+                              colors + 3,
+                              4,
+                              data_type_normalizer[element.properties[*alpha_index].type]);
+      }
+      else {
+        for (const int64_t i : IndexRange(size)) {
+          colors[i * 4 + 3] = 1.0f;
+        }
+      }
+    }
+    if (normal_index) {
+      float *normals = &data->vertex_normals[start].x;
+      for (const int i : IndexRange(3)) {
+        decoder.decode_column(rows, size, (*normal_index)[i], normals + i, 3);
+      }
+    }
+    if (uv_index) {
+      float *uvs = &data->uv_coordinates[start].x;
+      for (const int i : IndexRange(2)) {
+        decoder.decode_column(rows, size, (*uv_index)[i], uvs + i, 2);
+      }
+    }
+    for (const int64_t ci : custom_attr_indices.index_range()) {
+      decoder.decode_column(
+          rows, size, int(custom_attr_indices[ci]), &data->vertex_custom_attr[ci].data[start], 1);
+    }
+  };
+
+  const int64_t stride = element.stride;
+  if (const uint8_t *mapped_rows = file.read_bytes_in_place(size_t(stride) * element.count)) {
+    threading::parallel_for(
+        IndexRange(element.count), binary_rows_batch_size, [&](const IndexRange range) {
+          const uint8_t *rows = mapped_rows + range.start() * stride;
+          if (!decoder.needs_byte_swap()) {
+            decode_rows(rows, range);
+            return;
+          }
+          /* The mapping is read-only, so big endian rows are swapped in a copy. */
+          Array<uint8_t> swapped_rows(range.size() * stride);
+          memcpy(swapped_rows.data(), rows, swapped_rows.size());
+          decoder.byte_swap_rows(swapped_rows.data(), range.size());
+          decode_rows(swapped_rows.data(), range);
+        });
+    return nullptr;
+  }
+
+  /* No mapping: read batches of rows through the buffer and decode each of them in parallel. */
+  Array<uint8_t> batch(binary_rows_batch_size * stride);
+  for (int64_t start = 0; start < element.count; start += binary_rows_batch_size) {
+    const IndexRange batch_range = IndexRange::from_begin_end(
+        start, std::min<int64_t>(start + binary_rows_batch_size, element.count));
+    if (!file.read_bytes(batch.data(), batch_range.size() * stride)) {
+      return "Could not read row of binary property";
+    }
+    threading::parallel_for(batch_range.index_range(), 2048, [&](const IndexRange range) {
+      uint8_t *rows = batch.data() + range.start() * stride;
+      if (decoder.needs_byte_swap()) {
+        decoder.byte_swap_rows(rows, range.size());
+      }
+      decode_rows(rows, range.shift(start));
+    });
+  }
+  return nullptr;
+}
+
 static const char *load_vertex_element(PlyReadBuffer &file,
                                        const PlyHeader &header,
                                        const PlyElement &element,
@@ -270,15 +516,28 @@ static const char *load_vertex_element(PlyReadBuffer &file,
     data->vertex_custom_attr.append(attr);
   }
 
-  data->vertices.reserve(element.count);
+  data->vertices.resize(element.count);
   if (has_color) {
-    data->vertex_colors.reserve(element.count);
+    data->vertex_colors.resize(element.count);
   }
   if (has_normal) {
-    data->vertex_normals.reserve(element.count);
+    data->vertex_normals.resize(element.count);
   }
   if (has_uv) {
-    data->uv_coordinates.reserve(element.count);
+    data->uv_coordinates.resize(element.count);
+  }
+
+  if (header.type != PlyFormatType::ASCII) {
+    return load_vertex_element_binary(file,
+                                      header,
+                                      element,
+                                      vertex_index,
+                                      has_color ? std::optional(color_index) : std::nullopt,
+                                      has_alpha ? std::optional(alpha_index) : std::nullopt,
+                                      has_normal ? std::optional(normal_index) : std::nullopt,
+                                      has_uv ? std::optional(uv_index) : std::nullopt,
+                                      custom_attr_indices,
+                                      data);
   }
 
   float4 color_norm = {1, 1, 1, 1};
@@ -292,20 +551,8 @@ static const char *load_vertex_element(PlyReadBuffer &file,
   }
 
   Vector<float> value_vec(element.properties.size());
-  Vector<uint8_t> scratch;
-  if (header.type != PlyFormatType::ASCII) {
-    scratch.resize(element.stride);
-  }
-
   for (int i = 0; i < element.count; i++) {
-
-    const char *error = nullptr;
-    if (header.type == PlyFormatType::ASCII) {
-      error = parse_row_ascii(file, value_vec);
-    }
-    else {
-      error = parse_row_binary(file, header, element, scratch, value_vec);
-    }
+    const char *error = parse_row_ascii(file, value_vec);
     if (error != nullptr) {
       return error;
     }
@@ -315,7 +562,7 @@ static const char *load_vertex_element(PlyReadBuffer &file,
     vertex3.x = value_vec[vertex_index.x];
     vertex3.y = value_vec[vertex_index.y];
     vertex3.z = value_vec[vertex_index.z];
-    data->vertices.append(vertex3);
+    data->vertices[i] = vertex3;
 
     /* Vertex color */
     if (has_color) {
@@ -329,7 +576,7 @@ static const char *load_vertex_element(PlyReadBuffer &file,
       else {
         colors4.w = 1.0f;
       }
-      data->vertex_colors.append(colors4);
+      data->vertex_colors[i] = colors4;
     }
 
     /* If normals */
@@ -338,7 +585,7 @@ static const char *load_vertex_element(PlyReadBuffer &file,
       normals3.x = value_vec[normal_index.x];
       normals3.y = value_vec[normal_index.y];
       normals3.z = value_vec[normal_index.z];
-      data->vertex_normals.append(normals3);
+      data->vertex_normals[i] = normals3;
     }
 
     /* If uv */
@@ -346,7 +593,7 @@ static const char *load_vertex_element(PlyReadBuffer &file,
       float2 uvmap;
       uvmap.x = value_vec[uv_index.x];
       uvmap.y = value_vec[uv_index.y];
-      data->uv_coordinates.append(uvmap);
+      data->uv_coordinates[i] = uvmap;
     }
 
     /* Custom attributes */
@@ -677,6 +924,10 @@ std::unique_ptr<PlyData> import_ply_data(PlyReadBuffer &file, PlyHeader &header)
     }
   }
 
+  if (file.any_io_error()) {
+    data->error = "Could not read the file";
+  }
+
   return data;
 }
 
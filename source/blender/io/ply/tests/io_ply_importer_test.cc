@@ -4,12 +4,18 @@
 
 #include "testing/testing.h"
 
+#include "BKE_appdir.hh"
+
+#include "BLI_endian_switch.h"
+#include "BLI_fileops.h"
 #include "BLI_path_utils.hh"
 
 #include "ply_import.hh"
 #include "ply_import_buffer.hh"
 #include "ply_import_data.hh"
 
+#include <fstream>
+
 namespace blender::io::ply {
 
 /* Extensive tests for PLY importing are in `io_ply_import_test.py`.
@@ -62,6 +68,52 @@ TEST(ply_import, BufferRefillTest)
   EXPECT_EQ_ARRAY(exp_edges, data_b->edges.data(), 12);
 }
 
+/* Binary vertex elements are decoded column-wise in batches of rows. Check mixed property types
+ * in a big endian file, both through the file mapping and through the read buffer. */
+TEST(ply_import, BinaryBigEndianVertexTest)
+{
+  BKE_tempdir_init(nullptr);
+  const std::string ply_path = std::string(BKE_tempdir_session()) + SEP_STR "vertices_be.ply";
+  constexpr int verts_num = 20000;
+  {
+    std::ofstream file(ply_path, std::ios::binary);
+    file << "ply\nformat binary_big_endian 1.0\nelement vertex " << verts_num << "\n";
+    file << "property float x\nproperty float y\nproperty float z\n";
+    file << "property uchar red\nproperty uchar green\nproperty uchar blue\n";
+    file << "property short weight\nend_header\n";
+    for (int i = 0; i < verts_num; i++) {
+      float position[3] = {float(i), float(-i), 0.5f};
+      BLI_endian_switch_float_array(position, 3);
+      file.write(reinterpret_cast<const char *>(position), sizeof(position));
+      const uint8_t color[3] = {uint8_t(i % 256), 0, 255};
+      file.write(reinterpret_cast<const char *>(color), sizeof(color));
+      int16_t weight = int16_t(i % 1000 - 500);
+      BLI_endian_switch_int16(&weight);
+      file.write(reinterpret_cast<const char *>(&weight), sizeof(weight));
+    }
+  }
+
+  for (const bool use_memory_mapping : {true, false}) {
+    PlyReadBuffer infile(ply_path.c_str(), 64 * 1024, use_memory_mapping);
+    PlyHeader header;
+    ASSERT_EQ(nullptr, read_header(infile, header));
+    std::unique_ptr<PlyData> data = import_ply_data(infile, header);
+    ASSERT_TRUE(data->error.empty());
+    ASSERT_EQ(verts_num, data->vertices.size());
+    ASSERT_EQ(verts_num, data->vertex_colors.size());
+    ASSERT_EQ(1, data->vertex_custom_attr.size());
+    EXPECT_EQ("weight", data->vertex_custom_attr[0].name);
+    for (const int i : {0, 1, 255, 4096, 16383, 16384, verts_num - 1}) {
+      EXPECT_EQ(float3(i, -i, 0.5f), data->vertices[i]);
+      EXPECT_EQ(float4((i % 256) / 255.0f, 0.0f, 1.0f, 1.0f), data->vertex_colors[i]);
+      EXPECT_EQ(float(i % 1000 - 500), data->vertex_custom_attr[0].data[i]);
+    }
+  }
+
+  BLI_delete(ply_path.c_str(), false, false);
+  BKE_tempdir_session_purge();
+}
+
 //@TODO: now we put vertex color attribute first, maybe put position first?
 //@TODO: test with vertex element having list properties
 //@TODO: test with edges starting with non-vertex index properties
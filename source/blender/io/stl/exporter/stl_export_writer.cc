@@ -19,8 +19,16 @@
 
 #include "BLI_fileops.h"
 
+#include "IO_number_format.hh"
+
 namespace blender::io::stl {
 
+static char *append_text(char *dst, const StringRef text)
+{
+  text.copy_unsafe(dst);
+  return dst + text.size();
+}
+
 FileWriter::FileWriter(const char *filepath, bool ascii) : tris_num_(0), ascii_(ascii)
 {
   file_ = BLI_fopen(filepath, "wb");
@@ -60,27 +68,18 @@ void FileWriter::write_triangle(const PackedTriangle &data)
 {
   tris_num_++;
   if (ascii_) {
-    fmt::print(file_,
-               "facet normal {} {} {}\n"
-               " outer loop\n"
-               "  vertex {} {} {}\n"
-               "  vertex {} {} {}\n"
-               "  vertex {} {} {}\n"
-               " endloop\n"
-               "endfacet\n",
-
-               data.normal.x,
-               data.normal.y,
-               data.normal.z,
-               data.vertices[0].x,
-               data.vertices[0].y,
-               data.vertices[0].z,
-               data.vertices[1].x,
-               data.vertices[1].y,
-               data.vertices[1].z,
-               data.vertices[2].x,
-               data.vertices[2].y,
-               data.vertices[2].z);
+    /* Format the whole facet at once, the float rows dominate the output size. */
+    char text[4 * float3_row_max_chars(13) + 64];
+    char *p = text;
+    const float3 normal = data.normal;
+    p = format_float3_rows_shortest(p, "facet normal ", {normal});
+    p = append_text(p, " outer loop\n");
+    for (int i = 0; i < 3; i++) {
+      const float3 vertex = data.vertices[i];
+      p = format_float3_rows_shortest(p, "  vertex ", {vertex});
+    }
+    p = append_text(p, " endloop\nendfacet\n");
+    fwrite(text, 1, p - text, file_);
   }
   else {
     fwrite(&data, sizeof(data), 1, file_);
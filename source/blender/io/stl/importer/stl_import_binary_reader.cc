@@ -8,10 +8,22 @@
 
 #include <cstdint>
 #include <cstdio>
+#include <fcntl.h>
 
+#ifndef WIN32
+#  include <unistd.h> /* For close. */
+#else
+#  include <io.h> /* For close. */
+#endif
+
+#include "BKE_lib_id.hh"
 #include "BKE_mesh.hh"
 
 #include "BLI_array.hh"
+#include "BLI_fileops.h"
+#include "BLI_memory_utils.hh"
+#include "BLI_mmap.h"
+#include "BLI_span.hh"
 
 #include "DNA_mesh_types.h"
 
@@ -20,10 +32,69 @@
 #include "stl_import_binary_reader.hh"
 #include "stl_import_mesh.hh"
 
+#include "CLG_log.h"
+static CLG_LogRef LOG = {"io.stl"};
+
 namespace blender::io::stl {
 
-Mesh *read_stl_binary(FILE *file, const bool use_custom_normals)
+/**
+ * Read the triangles directly from a memory-mapped file, without copying them into an
+ * intermediate buffer first. Returns false if the file could not be mapped.
+ */
+static bool read_stl_binary_mapped(const char *filepath,
+                                   const bool use_custom_normals,
+                                   Mesh *&r_mesh)
 {
+  const int file_descriptor = BLI_open(filepath, O_BINARY | O_RDONLY, 0);
+  if (file_descriptor == -1) {
+    return false;
+  }
+  BLI_SCOPED_DEFER([&]() { close(file_descriptor); });
+
+  BLI_mmap_file *mmap_file = BLI_mmap_open(file_descriptor);
+  if (mmap_file == nullptr) {
+    return false;
+  }
+  BLI_SCOPED_DEFER([&]() { BLI_mmap_free(mmap_file); });
+
+  const size_t length = BLI_mmap_get_length(mmap_file);
+  if (length < BINARY_HEADER_SIZE + sizeof(uint32_t)) {
+    return false;
+  }
+  const char *memory = static_cast<const char *>(BLI_mmap_get_pointer(mmap_file));
+  uint32_t num_tris;
+  memcpy(&num_tris, memory + BINARY_HEADER_SIZE, sizeof(uint32_t));
+
+  /* Don't read past the end of a truncated file. */
+  const size_t data_offset = BINARY_HEADER_SIZE + sizeof(uint32_t);
+  num_tris = uint32_t(std::min<size_t>(num_tris, (length - data_offset) / BINARY_STRIDE));
+  if (num_tris == 0) {
+    r_mesh = BKE_mesh_new_nomain(0, 0, 0, 0);
+    return true;
+  }
+
+  /* #PackedTriangle has an alignment of one, so it can be used in place. */
+  const Span<PackedTriangle> tris(reinterpret_cast<const PackedTriangle *>(memory + data_offset),
+                                  num_tris);
+  Mesh *mesh = stl_triangles_to_mesh(tris, use_custom_normals);
+
+  if (BLI_mmap_any_io_error(mmap_file)) {
+    CLOG_ERROR(&LOG, "STL Importer: IO error while reading file '%s'", filepath);
+    BKE_id_free(nullptr, mesh);
+    r_mesh = nullptr;
+    return true;
+  }
+  r_mesh = mesh;
+  return true;
+}
+
+Mesh *read_stl_binary(const char *filepath, FILE *file, const bool use_custom_normals)
+{
+  Mesh *mesh = nullptr;
+  if (read_stl_binary_mapped(filepath, use_custom_normals, mesh)) {
+    return mesh;
+  }
+
   const int chunk_size = 1024;
   uint32_t num_tris = 0;
   fseek(file, BINARY_HEADER_SIZE, SEEK_SET);
@@ -25,6 +25,10 @@ struct Mesh;
 
 namespace blender::io::stl {
 
-Mesh *read_stl_binary(FILE *file, bool use_custom_normals);
+/**
+ * Read a binary STL file. The file is memory-mapped when possible, with the already opened
+ * `file` used as fallback.
+ */
+Mesh *read_stl_binary(const char *filepath, FILE *file, bool use_custom_normals);
 
 }  // namespace blender::io::stl
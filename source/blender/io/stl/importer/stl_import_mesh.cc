@@ -8,8 +8,15 @@
 
 #include "BKE_mesh.hh"
 
+#include "BLI_array.hh"
 #include "BLI_array_utils.hh"
+#include "BLI_index_mask.hh"
+#include "BLI_map.hh"
+#include "BLI_math_base.h"
+#include "BLI_offset_indices.hh"
 #include "BLI_span.hh"
+#include "BLI_task.hh"
+#include "BLI_threads.h"
 
 #include "DNA_mesh_types.h"
 
@@ -21,63 +28,195 @@ static CLG_LogRef LOG = {"io.stl"};
 
 namespace blender::io::stl {
 
-STLMeshHelper::STLMeshHelper(int tris_num, bool use_custom_normals)
-    : use_custom_normals_(use_custom_normals)
+namespace weld {
+
+/**
+ * Return a hash value that is likely to be different in the low bits from the normal `hash()`
+ * function, which is used to pick the hash map for a key. This avoids collisions within the maps.
+ */
+template<typename T> static uint64_t hash_2(const T &key)
 {
-  degenerate_tris_num_ = 0;
-  duplicate_tris_num_ = 0;
-  tris_.reserve(tris_num);
-  /* Upper bound (all vertices are unique). */
-  verts_.reserve(tris_num * 3);
-  if (use_custom_normals) {
-    loop_normals_.reserve(tris_num * 3);
-  }
+  return get_default_hash(key) >> 32;
 }
 
-bool STLMeshHelper::add_triangle(const PackedTriangle &data)
+static int get_parallel_maps_count(const int64_t keys_num)
 {
-  int v1_id = verts_.index_of_or_add(data.vertices[0]);
-  int v2_id = verts_.index_of_or_add(data.vertices[1]);
-  int v3_id = verts_.index_of_or_add(data.vertices[2]);
-  if ((v1_id == v2_id) || (v1_id == v3_id) || (v2_id == v3_id)) {
-    degenerate_tris_num_++;
-    return false;
-  }
-  if (!tris_.add({v1_id, v2_id, v3_id})) {
-    duplicate_tris_num_++;
-    return false;
+  /* Don't use parallelization when there are few elements. */
+  if (keys_num < 10000) {
+    return 1;
   }
+  /* Use at most 8 separate hash tables. Every table has to look at all elements,
+   * so using more threads has diminishing returns. */
+  const int system_thread_count = BLI_system_thread_count();
+  return power_of_2_min_i(std::min(8, system_thread_count));
+}
 
-  if (use_custom_normals_) {
-    loop_normals_.append_n_times(data.normal, 3);
-  }
-  return true;
+/**
+ * For every key in the mask, find the index of the first equal key in the mask. Parallelization is
+ * achieved by having multiple hash maps for different subsets of keys, chosen by the lower bits of
+ * a second hash value. Each map is filled in index order, so the result does not depend on the
+ * number of maps or threads.
+ */
+template<typename T, typename GetKeyFn>
+static void find_first_occurrences(const IndexMask &mask,
+                                   const GetKeyFn &get_key,
+                                   MutableSpan<int> r_first)
+{
+  const int parallel_maps = get_parallel_maps_count(mask.size());
+  BLI_assert(is_power_of_2_i(parallel_maps));
+  const uint32_t parallel_mask = uint32_t(parallel_maps) - 1;
+  threading::parallel_for(IndexRange(parallel_maps), 1, [&](const IndexRange range) {
+    for (const int task_index : range) {
+      Map<T, int> first_indices;
+      first_indices.reserve(mask.size() / parallel_maps);
+      mask.foreach_index([&](const int i) {
+        const T &key = get_key(i);
+        /* Only add the key when it belongs into this map. */
+        if (task_index == (parallel_mask & hash_2(key))) {
+          r_first[i] = first_indices.lookup_or_add(key, i);
+        }
+      });
+    }
+  });
 }
 
-Mesh *STLMeshHelper::to_mesh()
+/**
+ * Give every index that is its own first occurrence a new consecutive index, in index order.
+ * Other indices are mapped to the new index of their first occurrence.
+ */
+static int compact_first_occurrences(const Span<int> first, MutableSpan<int> r_new_indices)
+{
+  constexpr int64_t chunk_size = 64 * 1024;
+  const int64_t chunks_num = divide_ceil_ul(first.size(), chunk_size);
+  Array<int> chunk_offsets_data(chunks_num + 1);
+  threading::parallel_for(IndexRange(chunks_num), 1, [&](const IndexRange range) {
+    for (const int64_t chunk : range) {
+      const IndexRange chunk_range = IndexRange(chunk * chunk_size, chunk_size)
+                                         .intersect(first.index_range());
+      int count = 0;
+      for (const int64_t i : chunk_range) {
+        count += first[i] == i;
+      }
+      chunk_offsets_data[chunk] = count;
+    }
+  });
+  const OffsetIndices<int> chunk_offsets = offset_indices::accumulate_counts_to_offsets(
+      chunk_offsets_data);
+
+  threading::parallel_for(IndexRange(chunks_num), 1, [&](const IndexRange range) {
+    for (const int64_t chunk : range) {
+      const IndexRange chunk_range = IndexRange(chunk * chunk_size, chunk_size)
+                                         .intersect(first.index_range());
+      int new_index = chunk_offsets[chunk].start();
+      for (const int64_t i : chunk_range) {
+        if (first[i] == i) {
+          r_new_indices[i] = new_index++;
+        }
+      }
+    }
+  });
+  threading::parallel_for(first.index_range(), 4096, [&](const IndexRange range) {
+    for (const int64_t i : range) {
+      if (first[i] != i) {
+        r_new_indices[i] = r_new_indices[first[i]];
+      }
+    }
+  });
+  return chunk_offsets.total_size();
+}
+
+}  // namespace weld
+
+Mesh *stl_triangles_to_mesh(const Span<PackedTriangle> tris, const bool use_custom_normals)
 {
-  if (degenerate_tris_num_ > 0) {
-    CLOG_WARN(&LOG, "Removed %d degenerate triangles during import", degenerate_tris_num_);
+  const int64_t corners_num = tris.size() * 3;
+  const auto corner_position = [&](const int64_t corner) -> const float3 & {
+    return tris[corner / 3].vertices[corner % 3];
+  };
+
+  /* Merge vertices at identical positions. */
+  Array<int> first_corner(corners_num);
+  weld::find_first_occurrences<float3>(IndexRange(corners_num), corner_position, first_corner);
+  Array<int> soup_corner_verts(corners_num);
+  const int verts_num = weld::compact_first_occurrences(first_corner, soup_corner_verts);
+
+  Array<float3> positions(verts_num);
+  threading::parallel_for(IndexRange(corners_num), 4096, [&](const IndexRange range) {
+    for (const int64_t corner : range) {
+      if (first_corner[corner] == corner) {
+        positions[soup_corner_verts[corner]] = corner_position(corner);
+      }
+    }
+  });
+  first_corner = {};
+
+  /* Remove degenerate and duplicate triangles. */
+  const auto tri_verts = [&](const int64_t tri) {
+    return Triangle{soup_corner_verts[tri * 3 + 0],
+                    soup_corner_verts[tri * 3 + 1],
+                    soup_corner_verts[tri * 3 + 2]};
+  };
+  IndexMaskMemory memory;
+  const IndexMask valid_tris = IndexMask::from_predicate(
+      tris.index_range(), GrainSize(4096), memory, [&](const int64_t tri) {
+        const Triangle t = tri_verts(tri);
+        return t.v1 != t.v2 && t.v1 != t.v3 && t.v2 != t.v3;
+      });
+  Array<int> first_tri(tris.size());
+  weld::find_first_occurrences<Triangle>(valid_tris, tri_verts, first_tri);
+  const IndexMask unique_tris = IndexMask::from_predicate(
+      valid_tris, GrainSize(4096), memory, [&](const int64_t tri) {
+        return first_tri[tri] == tri;
+      });
+
+  const int64_t degenerate_tris_num = tris.size() - valid_tris.size();
+  const int64_t duplicate_tris_num = valid_tris.size() - unique_tris.size();
+  if (degenerate_tris_num > 0) {
+    CLOG_WARN(&LOG, "Removed %d degenerate triangles during import", int(degenerate_tris_num));
   }
-  if (duplicate_tris_num_ > 0) {
-    CLOG_WARN(&LOG, "Removed %d duplicate triangles during import", duplicate_tris_num_);
+  if (duplicate_tris_num > 0) {
+    CLOG_WARN(&LOG, "Removed %d duplicate triangles during import", int(duplicate_tris_num));
   }
 
-  Mesh *mesh = BKE_mesh_new_nomain(verts_.size(), 0, tris_.size(), tris_.size() * 3);
-  mesh->vert_positions_for_write().copy_from(verts_);
+  const int faces_num = unique_tris.size();
+  Mesh *mesh = BKE_mesh_new_nomain(verts_num, 0, faces_num, faces_num * 3);
+  mesh->vert_positions_for_write().copy_from(positions);
   offset_indices::fill_constant_group_size(3, 0, mesh->face_offsets_for_write());
-  array_utils::copy(tris_.as_span().cast<int>(), mesh->corner_verts_for_write());
+  MutableSpan<int> corner_verts = mesh->corner_verts_for_write();
+  unique_tris.foreach_index(GrainSize(4096), [&](const int64_t tri, const int64_t face) {
+    corner_verts.slice(face * 3, 3).copy_from(soup_corner_verts.as_span().slice(tri * 3, 3));
+  });
 
   bke::mesh_smooth_set(*mesh, false);
 
   /* NOTE: edges must be calculated first before setting custom normals. */
   bke::mesh_calc_edges(*mesh, false, false);
 
-  if (use_custom_normals_ && loop_normals_.size() == mesh->corners_num) {
-    bke::mesh_set_custom_normals(*mesh, loop_normals_);
+  if (use_custom_normals) {
+    Array<float3> corner_normals(mesh->corners_num);
+    unique_tris.foreach_index(GrainSize(4096), [&](const int64_t tri, const int64_t face) {
+      corner_normals.as_mutable_span().slice(face * 3, 3).fill(tris[tri].normal);
+    });
+    bke::mesh_set_custom_normals(*mesh, corner_normals);
   }
 
   return mesh;
 }
 
+STLMeshHelper::STLMeshHelper(int tris_num, bool use_custom_normals)
+    : use_custom_normals_(use_custom_normals)
+{
+  tris_.reserve(tris_num);
+}
+
+void STLMeshHelper::add_triangle(const PackedTriangle &data)
+{
+  tris_.append(data);
+}
+
+Mesh *STLMeshHelper::to_mesh()
+{
+  return stl_triangles_to_mesh(tris_, use_custom_normals_);
+}
+
 }  // namespace blender::io::stl
@@ -11,8 +11,8 @@
 #include <cstdint>
 
 #include "BLI_math_vector_types.hh"
+#include "BLI_span.hh"
 #include "BLI_vector.hh"
-#include "BLI_vector_set.hh"
 #include "stl_data.hh"
 
 struct Mesh;
@@ -47,22 +47,25 @@ class Triangle {
   }
 };
 
+/**
+ * Create a mesh from a triangle soup. Vertices at identical positions and duplicate triangles are
+ * merged, and degenerate triangles are removed. The welding runs in parallel; the resulting
+ * vertex and face order is the order of first occurrence in `tris`, independent of threading.
+ */
+Mesh *stl_triangles_to_mesh(Span<PackedTriangle> tris, bool use_custom_normals);
+
 class STLMeshHelper {
  private:
-  VectorSet<float3> verts_;
-  VectorSet<Triangle> tris_;
-  Vector<float3> loop_normals_;
-  int degenerate_tris_num_;
-  int duplicate_tris_num_;
+  Vector<PackedTriangle> tris_;
   const bool use_custom_normals_;
 
  public:
   STLMeshHelper(int tris_num, bool use_custom_normals);
 
-  /* Creates a new triangle from specified vertex locations,
-   * duplicate vertices and triangles are merged.
+  /* Adds a new triangle from specified vertex locations.
+   * Duplicate vertices and triangles are merged in #to_mesh.
    */
-  bool add_triangle(const PackedTriangle &data);
+  void add_triangle(const PackedTriangle &data);
 
   Mesh *to_mesh();
 };
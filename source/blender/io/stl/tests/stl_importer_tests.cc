@@ -0,0 +1,84 @@
+/* SPDX-FileCopyrightText: 2025 Blender Authors
+ *
+ * SPDX-License-Identifier: Apache-2.0 */
+
+#include "testing/testing.h"
+
+#include "BKE_idtype.hh"
+#include "BKE_lib_id.hh"
+#include "BKE_mesh.hh"
+
+#include "BLI_vector_set.hh"
+
+#include "DNA_mesh_types.h"
+
+#include "stl_data.hh"
+#include "stl_import_mesh.hh"
+
+namespace blender::io::stl {
+
+class STLImportTest : public testing::Test {
+ public:
+  static void SetUpTestSuite()
+  {
+    BKE_idtype_init();
+  }
+};
+
+/* Vertex welding runs on multiple hash maps in parallel; the result should still match welding
+ * the triangles one by one. */
+TEST_F(STLImportTest, weld_matches_serial_order)
+{
+  /* A grid of quads with shared vertices, split into two triangles each, with some duplicate and
+   * degenerate triangles mixed in. Large enough to use multiple hash maps. */
+  constexpr int grid_size = 100;
+  Vector<PackedTriangle> tris;
+  for (const int y : IndexRange(grid_size)) {
+    for (const int x : IndexRange(grid_size)) {
+      /* Reverse the order of rows to not just add vertices in sorted order. */
+      const float fy = float(grid_size - y);
+      const float3 v00(x, fy, 0), v10(x + 1, fy, 0), v01(x, fy + 1, 0), v11(x + 1, fy + 1, 0);
+      PackedTriangle tri{};
+      tri.normal = float3(0, 0, 1);
+      tri.vertices[0] = v00;
+      tri.vertices[1] = v10;
+      tri.vertices[2] = v11;
+      tris.append(tri);
+      tri.vertices[0] = v00;
+      tri.vertices[1] = v11;
+      tri.vertices[2] = v01;
+      tris.append(tri);
+      if (x % 7 == 0) {
+        /* Same triangle with a different winding. */
+        std::swap(tri.vertices[0], tri.vertices[1]);
+        tris.append(tri);
+      }
+      if (x % 11 == 0) {
+        tri.vertices[2] = tri.vertices[0];
+        tris.append(tri);
+      }
+    }
+  }
+
+  VectorSet<float3> expected_verts;
+  VectorSet<Triangle> expected_tris;
+  for (const PackedTriangle &tri : tris) {
+    const int v1 = expected_verts.index_of_or_add(tri.vertices[0]);
+    const int v2 = expected_verts.index_of_or_add(tri.vertices[1]);
+    const int v3 = expected_verts.index_of_or_add(tri.vertices[2]);
+    if (v1 != v2 && v1 != v3 && v2 != v3) {
+      expected_tris.add({v1, v2, v3});
+    }
+  }
+
+  Mesh *mesh = stl_triangles_to_mesh(tris, false);
+  ASSERT_EQ(mesh->verts_num, expected_verts.size());
+  ASSERT_EQ(mesh->faces_num, expected_tris.size());
+  EXPECT_EQ(mesh->verts_num, (grid_size + 1) * (grid_size + 1));
+  EXPECT_EQ(mesh->faces_num, grid_size * grid_size * 2);
+  EXPECT_EQ(mesh->vert_positions(), expected_verts.as_span());
+  EXPECT_EQ(mesh->corner_verts(), expected_tris.as_span().cast<int>());
+  BKE_id_free(nullptr, mesh);
+}
+
+}  // namespace blender::io::stl
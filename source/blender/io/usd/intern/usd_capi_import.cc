@@ -7,6 +7,7 @@
 #include "usd_hook.hh"
 #include "usd_light_convert.hh"
 #include "usd_reader_geom.hh"
+#include "usd_reader_mesh.hh"
 #include "usd_reader_prim.hh"
 #include "usd_reader_stage.hh"
 
@@ -270,6 +271,15 @@ static void import_startjob(void *customdata, wmJobWorkerStatus *worker_status)
     }
   }
 
+  /* Convert the geometry of independent prims on all threads, it's attached to Main below. */
+  archive->prepare_object_data(0.0);
+  *data->do_update = true;
+
+  if (G.is_break) {
+    data->was_canceled = true;
+    return;
+  }
+
   /* Setup parenthood and read actual object data. */
   i = 0;
   for (USDPrimReader *reader : archive->readers()) {
@@ -520,6 +530,11 @@ void USD_read_geometry(CacheReader *reader,
   }
 
   usd_reader->read_geometry(geometry_set, params, r_err_str);
+
+  if (USDMeshReader *mesh_reader = dynamic_cast<USDMeshReader *>(usd_reader)) {
+    mesh_reader->prefetch_frames({params.prefetch_times, params.prefetch_times_num},
+                                 params.prefetch_memory_limit);
+  }
 }
 
 bool USD_mesh_topology_changed(CacheReader *reader,
@@ -576,6 +591,10 @@ CacheReader *CacheReader_open_usd_object(CacheArchiveHandle *handle,
   usd_reader->object(object);
   usd_reader->incref();
 
+  if (USDMeshReader *mesh_reader = dynamic_cast<USDMeshReader *>(usd_reader)) {
+    mesh_reader->set_prefetch_cache(&archive->prefetch_cache());
+  }
+
   return reinterpret_cast<CacheReader *>(usd_reader);
 }
 
@@ -19,6 +19,7 @@ struct Scene;
 namespace blender::io::usd {
 
 class USDHierarchyIterator;
+struct USDMeshPrototypes;
 
 struct USDExporterContext {
   Main *bmain;
@@ -35,6 +36,8 @@ struct USDExporterContext {
   const USDExportParams &export_params;
   std::string export_file_path;
   std::function<std::string(Main *, Scene *, Image *, ImageUser *)> export_image_fn;
+  /** Mesh prims that were written already, for #USDExportParams::deduplicate_meshes. */
+  USDMeshPrototypes *mesh_prototypes = nullptr;
 };
 
 }  // namespace blender::io::usd
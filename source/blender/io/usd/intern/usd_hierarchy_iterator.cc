@@ -38,8 +38,13 @@ USDHierarchyIterator::USDHierarchyIterator(Main *bmain,
                                            const USDExportParams &params)
     : AbstractHierarchyIterator(bmain, depsgraph), stage_(stage), params_(params)
 {
+  if (params_.deduplicate_meshes) {
+    mesh_prototypes_ = std::make_unique<USDMeshPrototypes>();
+  }
 }
 
+USDHierarchyIterator::~USDHierarchyIterator() = default;
+
 bool USDHierarchyIterator::mark_as_weak_export(const Object *object) const
 {
   if (params_.selected_objects_only && (object->base_flag & BASE_SELECTED) == 0) {
@@ -98,6 +103,12 @@ void USDHierarchyIterator::set_export_frame(float frame_nr)
 {
   /* The USD stage is already set up to have FPS time-codes per frame. */
   export_time_ = pxr::UsdTimeCode(frame_nr);
+
+  if (mesh_prototypes_) {
+    /* The meshes of the previous frame may have been freed, see
+     * #USDMeshPrototypes::geometry_hash_by_sharing. */
+    mesh_prototypes_->geometry_hash_by_sharing.clear();
+  }
 }
 
 USDExporterContext USDHierarchyIterator::create_usd_export_context(const HierarchyContext *context)
@@ -131,8 +142,10 @@ USDExporterContext USDHierarchyIterator::create_usd_export_context(const Hierarc
   const std::string export_file_path = root_layer->GetRealPath();
   auto get_time_code = [this]() { return this->export_time_; };
 
-  return USDExporterContext{
+  USDExporterContext usd_export_context{
       bmain_, depsgraph_, stage_, path, get_time_code, params_, export_file_path};
+  usd_export_context.mesh_prototypes = mesh_prototypes_.get();
+  return usd_export_context;
 }
 
 AbstractHierarchyWriter *USDHierarchyIterator::create_transform_writer(
@@ -8,6 +8,7 @@
 #include "usd_exporter_context.hh"
 #include "usd_skel_convert.hh"
 
+#include <memory>
 #include <string>
 
 #include <pxr/usd/usd/common.h>
@@ -33,11 +34,14 @@ class USDHierarchyIterator : public AbstractHierarchyIterator {
   ObjExportMap skinned_mesh_export_map_;
   ObjExportMap shape_key_mesh_export_map_;
 
+  std::unique_ptr<USDMeshPrototypes> mesh_prototypes_;
+
  public:
   USDHierarchyIterator(Main *bmain,
                        Depsgraph *depsgraph,
                        pxr::UsdStageRefPtr stage,
                        const USDExportParams &params);
+  ~USDHierarchyIterator() override;
 
   void set_export_frame(float frame_nr);
 
@@ -17,6 +17,7 @@
 #include "BKE_attribute.hh"
 #include "BKE_customdata.hh"
 #include "BKE_geometry_set.hh"
+#include "BKE_lib_id.hh"
 #include "BKE_main.hh"
 #include "BKE_material.hh"
 #include "BKE_mesh.hh"
@@ -37,6 +38,8 @@
 #include "DNA_object_types.h"
 #include "DNA_windowmanager_types.h"
 
+#include "IO_frame_prefetch.hh"
+
 #include <pxr/base/gf/matrix4f.h>
 #include <pxr/base/vt/array.h>
 #include <pxr/base/vt/types.h>
@@ -167,6 +170,16 @@ static void assign_materials(Main *bmain,
 
 }  // namespace utils
 
+USDMeshReader::~USDMeshReader()
+{
+  if (prefetch_cache_) {
+    prefetch_cache_->remove_reader(this);
+  }
+  if (prepared_mesh_ && (prepared_mesh_->id.tag & ID_TAG_NO_MAIN)) {
+    BKE_id_free(nullptr, prepared_mesh_);
+  }
+}
+
 void USDMeshReader::create_object(Main *bmain)
 {
   Mesh *mesh = BKE_mesh_add(bmain, name_.c_str());
@@ -175,17 +188,33 @@ void USDMeshReader::create_object(Main *bmain)
   object_->data = mesh;
 }
 
-void USDMeshReader::read_object_data(Main *bmain, const double motionSampleTime)
+void USDMeshReader::prepare_object_data(const double motionSampleTime)
 {
-  Mesh *mesh = (Mesh *)object_->data;
+  if (prepared_mesh_) {
+    return;
+  }
 
   is_initial_load_ = true;
   const USDMeshReadParams params = create_mesh_read_params(motionSampleTime,
                                                            import_params_.mesh_read_flag);
 
-  Mesh *read_mesh = this->read_mesh(mesh, params, nullptr);
+  /* The object data is only used as template for the new mesh, and is only modified directly
+   * when the prim has no geometry. Nothing else accesses it while readers are prepared. */
+  prepared_mesh_ = this->read_mesh(static_cast<Mesh *>(object_->data), params, nullptr);
 
   is_initial_load_ = false;
+}
+
+void USDMeshReader::read_object_data(Main *bmain, const double motionSampleTime)
+{
+  Mesh *mesh = (Mesh *)object_->data;
+
+  /* Readers are usually prepared in parallel beforehand, see
+   * #USDStageReader::prepare_object_data. */
+  this->prepare_object_data(motionSampleTime);
+  Mesh *read_mesh = prepared_mesh_;
+  prepared_mesh_ = nullptr;
+
   if (read_mesh != mesh) {
     BKE_mesh_nomain_to_mesh(read_mesh, mesh, object_);
   }
@@ -223,31 +252,95 @@ void USDMeshReader::read_object_data(Main *bmain, const double motionSampleTime)
   USDXformReader::read_object_data(bmain, motionSampleTime);
 }
 
-bool USDMeshReader::topology_changed(const Mesh *existing_mesh, const double motionSampleTime)
-{
-  /* TODO(makowalski): Is it the best strategy to cache the mesh
-   * geometry in this function?  This needs to be revisited. */
+/**
+ * Attributes of a mesh that can change every frame, read from the stage either right before they
+ * are converted, or ahead of time on a worker thread (see #io::FramePrefetchCache).
+ */
+struct USDMeshFrame : public io::PrefetchedFrame {
+  pxr::VtIntArray face_indices;
+  pxr::VtIntArray face_counts;
+  pxr::VtVec3fArray positions;
+  pxr::VtVec3fArray normals;
+  pxr::TfToken normal_interpolation;
+  pxr::VtVec3fArray velocities;
 
-  mesh_prim_.GetFaceVertexIndicesAttr().Get(&face_indices_, motionSampleTime);
-  mesh_prim_.GetFaceVertexCountsAttr().Get(&face_counts_, motionSampleTime);
-  mesh_prim_.GetPointsAttr().Get(&positions_, motionSampleTime);
+  int64_t size_in_bytes() const override
+  {
+    return int64_t(face_indices.size() + face_counts.size()) * sizeof(int) +
+           int64_t(positions.size() + normals.size() + velocities.size()) * sizeof(pxr::GfVec3f);
+  }
+};
 
-  const pxr::UsdGeomPrimvarsAPI primvarsAPI(mesh_prim_);
+/** Only reads from the stage, so it can be called from worker threads. */
+static std::unique_ptr<USDMeshFrame> read_mesh_frame(const pxr::UsdGeomMesh &mesh_prim,
+                                                     const double motionSampleTime)
+{
+  std::unique_ptr<USDMeshFrame> frame = std::make_unique<USDMeshFrame>();
 
-  /* TODO(makowalski): Reading normals probably doesn't belong in this function,
-   * as this is not required to determine if the topology has changed. */
+  mesh_prim.GetFaceVertexIndicesAttr().Get(&frame->face_indices, motionSampleTime);
+  mesh_prim.GetFaceVertexCountsAttr().Get(&frame->face_counts, motionSampleTime);
+  mesh_prim.GetPointsAttr().Get(&frame->positions, motionSampleTime);
+
+  const pxr::UsdGeomPrimvarsAPI primvarsAPI(mesh_prim);
 
   /* If 'normals' and 'primvars:normals' are both specified, the latter has precedence. */
   const pxr::UsdGeomPrimvar primvar = primvarsAPI.GetPrimvar(usdtokens::normalsPrimvar);
   if (primvar.HasValue()) {
-    primvar.ComputeFlattened(&normals_, motionSampleTime);
-    normal_interpolation_ = primvar.GetInterpolation();
+    primvar.ComputeFlattened(&frame->normals, motionSampleTime);
+    frame->normal_interpolation = primvar.GetInterpolation();
   }
   else {
-    mesh_prim_.GetNormalsAttr().Get(&normals_, motionSampleTime);
-    normal_interpolation_ = mesh_prim_.GetNormalsInterpolation();
+    mesh_prim.GetNormalsAttr().Get(&frame->normals, motionSampleTime);
+    frame->normal_interpolation = mesh_prim.GetNormalsInterpolation();
   }
 
+  mesh_prim.GetVelocitiesAttr().Get(&frame->velocities, motionSampleTime);
+
+  return frame;
+}
+
+void USDMeshReader::set_prefetch_cache(io::FramePrefetchCache *prefetch_cache)
+{
+  prefetch_cache_ = prefetch_cache;
+}
+
+void USDMeshReader::prefetch_frames(const Span<double> motion_sample_times,
+                                    const int64_t memory_limit)
+{
+  if (!prefetch_cache_) {
+    return;
+  }
+  prefetch_cache_->set_memory_limit(memory_limit);
+  prefetch_cache_->prefetch(this, motion_sample_times, [this](const double time) {
+    return read_mesh_frame(mesh_prim_, time);
+  });
+}
+
+bool USDMeshReader::topology_changed(const Mesh *existing_mesh, const double motionSampleTime)
+{
+  /* TODO(makowalski): Is it the best strategy to cache the mesh
+   * geometry in this function?  This needs to be revisited. */
+
+  std::shared_ptr<const USDMeshFrame> frame;
+  if (prefetch_cache_) {
+    frame = std::static_pointer_cast<const USDMeshFrame>(
+        prefetch_cache_->lookup(this, motionSampleTime));
+  }
+  if (!frame) {
+    frame = read_mesh_frame(mesh_prim_, motionSampleTime);
+  }
+
+  /* The arrays are shared with the frame, not copied. */
+  face_indices_ = frame->face_indices;
+  face_counts_ = frame->face_counts;
+  positions_ = frame->positions;
+
+  /* TODO(makowalski): Reading normals probably doesn't belong in this function,
+   * as this is not required to determine if the topology has changed. */
+  normals_ = frame->normals;
+  normal_interpolation_ = frame->normal_interpolation;
+  velocities_ = frame->velocities;
+
   return positions_.size() != existing_mesh->verts_num ||
          face_counts_.size() != existing_mesh->faces_num ||
          face_indices_.size() != existing_mesh->corners_num;
@@ -284,6 +377,44 @@ void USDMeshReader::read_mpolys(Mesh *mesh) const
   bke::mesh_calc_edges(*mesh, false, false);
 }
 
+bool USDMeshReader::can_keep_topology(const Mesh &mesh) const
+{
+  if (mesh_prim_.GetFaceVertexIndicesAttr().ValueMightBeTimeVarying() ||
+      mesh_prim_.GetFaceVertexCountsAttr().ValueMightBeTimeVarying())
+  {
+    return false;
+  }
+  if (mesh.loose_edges().count > 0) {
+    /* Rebuilding the edges from the faces removes the loose edges. */
+    return false;
+  }
+
+  /* The topology of the prim doesn't change, but the input mesh may not come from the prim, e.g.
+   * when other modifiers come first. Comparing is still much cheaper than rebuilding the faces
+   * and edges, and invalidating the caches that depend on them. */
+  const Span<int> face_offsets = mesh.face_offsets();
+  const Span<int> corner_verts = mesh.corner_verts();
+  int loop_index = 0;
+
+  for (int i = 0; i < face_counts_.size(); i++) {
+    const int face_size = face_counts_[i];
+    if (face_offsets[i] != loop_index) {
+      return false;
+    }
+
+    /* Same order as in #read_mpolys. */
+    const int loop_end_index = loop_index + (face_size - 1);
+    for (int f = 0; f < face_size; ++f, ++loop_index) {
+      const int vert = face_indices_[is_left_handed_ ? loop_end_index - f : loop_index];
+      if (corner_verts[loop_index] != vert) {
+        return false;
+      }
+    }
+  }
+
+  return true;
+}
+
 void USDMeshReader::read_uv_data_primvar(Mesh *mesh,
                                          const pxr::UsdGeomPrimvar &primvar,
                                          const double motionSampleTime)
@@ -530,10 +661,9 @@ void USDMeshReader::read_edge_creases(Mesh *mesh, const double motionSampleTime)
   creases.finish();
 }
 
-void USDMeshReader::read_velocities(Mesh *mesh, const double motionSampleTime)
+void USDMeshReader::read_velocities(Mesh *mesh)
 {
-  pxr::VtVec3fArray velocities;
-  mesh_prim_.GetVelocitiesAttr().Get(&velocities, motionSampleTime);
+  const pxr::VtVec3fArray &velocities = velocities_;
 
   if (!velocities.empty()) {
     bke::MutableAttributeAccessor attributes = mesh->attributes_for_write();
@@ -627,7 +757,8 @@ void USDMeshReader::process_normals_uniform(Mesh *mesh) const
 void USDMeshReader::read_mesh_sample(ImportSettings *settings,
                                      Mesh *mesh,
                                      const double motionSampleTime,
-                                     const bool new_mesh)
+                                     const bool new_mesh,
+                                     const bool keep_topology)
 {
   /* Note that for new meshes we always want to read verts and faces,
    * regardless of the value of the read_flag, to avoid a crash downstream
@@ -642,7 +773,9 @@ void USDMeshReader::read_mesh_sample(ImportSettings *settings,
   }
 
   if (new_mesh || (settings->read_flag & MOD_MESHSEQ_READ_POLY) != 0) {
-    read_mpolys(mesh);
+    if (!keep_topology) {
+      read_mpolys(mesh);
+    }
     read_edge_creases(mesh, motionSampleTime);
 
     if (normal_interpolation_ == pxr::UsdGeomTokens->faceVarying) {
@@ -665,7 +798,7 @@ void USDMeshReader::read_mesh_sample(ImportSettings *settings,
       (settings->read_flag & MOD_MESHSEQ_READ_COLOR) ||
       (settings->read_flag & MOD_MESHSEQ_READ_ATTRIBUTES))
   {
-    read_velocities(mesh, motionSampleTime);
+    read_velocities(mesh);
     read_custom_data(settings, mesh, motionSampleTime, new_mesh);
   }
 }
@@ -888,9 +1021,7 @@ Mesh *USDMeshReader::read_mesh(Mesh *existing_mesh,
 
   Mesh *active_mesh = existing_mesh;
   bool new_mesh = false;
-
-  /* TODO(makowalski): implement the optimization of only updating the mesh points when
-   * the topology is consistent, as in the Alembic importer. */
+  bool keep_topology = false;
 
   ImportSettings settings;
   settings.read_flag |= params.read_flags;
@@ -900,9 +1031,17 @@ Mesh *USDMeshReader::read_mesh(Mesh *existing_mesh,
     active_mesh = BKE_mesh_new_nomain_from_template(
         existing_mesh, positions_.size(), 0, face_counts_.size(), face_indices_.size());
   }
+  else if (!is_initial_load_ && (settings.read_flag & MOD_MESHSEQ_READ_POLY)) {
+    /* Only update the vertex and corner data. Keep the faces and edges of the input mesh, so that
+     * they and the caches depending on them (e.g. BVH trees) aren't rebuilt every frame. */
+    keep_topology = this->can_keep_topology(*existing_mesh);
+  }
 
-  read_mesh_sample(
-      &settings, active_mesh, params.motion_sample_time, new_mesh || is_initial_load_);
+  read_mesh_sample(&settings,
+                   active_mesh,
+                   params.motion_sample_time,
+                   new_mesh || is_initial_load_,
+                   keep_topology);
 
   if (new_mesh) {
     /* Here we assume that the number of materials doesn't change, i.e. that
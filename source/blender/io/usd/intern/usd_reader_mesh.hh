@@ -13,6 +13,10 @@
 
 #include <pxr/usd/usdGeom/mesh.h>
 
+namespace blender::io {
+class FramePrefetchCache;
+}
+
 namespace blender::io::usd {
 
 class USDMeshReader : public USDGeomReader {
@@ -28,6 +32,7 @@ class USDMeshReader : public USDGeomReader {
   pxr::VtIntArray face_counts_;
   pxr::VtVec3fArray positions_;
   pxr::VtVec3fArray normals_;
+  pxr::VtVec3fArray velocities_;
 
   pxr::TfToken normal_interpolation_;
   pxr::TfToken orientation_;
@@ -39,6 +44,15 @@ class USDMeshReader : public USDGeomReader {
    * implemented.  Note this will break if faces or positions vary. */
   bool is_initial_load_ = false;
 
+  /**
+   * Mesh converted by #prepare_object_data, moved into the object data by
+   * #read_object_data. May be the object data itself when it didn't need a new mesh.
+   */
+  Mesh *prepared_mesh_ = nullptr;
+
+  /** Cache of the stage the reader was opened from, to read frames ahead of time. */
+  io::FramePrefetchCache *prefetch_cache_ = nullptr;
+
  public:
   USDMeshReader(const pxr::UsdPrim &prim,
                 const USDImportParams &import_params,
@@ -47,12 +61,16 @@ class USDMeshReader : public USDGeomReader {
   {
   }
 
+  ~USDMeshReader() override;
+
   bool valid() const override
   {
     return bool(mesh_prim_);
   }
 
   void create_object(Main *bmain) override;
+  /** Convert the topology, normals and primvars of the prim into a standalone mesh. */
+  void prepare_object_data(double motionSampleTime) override;
   void read_object_data(Main *bmain, double motionSampleTime) override;
 
   void read_geometry(bke::GeometrySet &geometry_set,
@@ -61,6 +79,15 @@ class USDMeshReader : public USDGeomReader {
 
   bool topology_changed(const Mesh *existing_mesh, double motionSampleTime) override;
 
+  void set_prefetch_cache(io::FramePrefetchCache *prefetch_cache);
+
+  /**
+   * Read the attributes of the frames at the given times on background threads, so that
+   * #read_geometry doesn't have to wait for the stage when they are evaluated.
+   * Does nothing when the reader has no prefetch cache.
+   */
+  void prefetch_frames(Span<double> motion_sample_times, int64_t memory_limit);
+
   /**
    * If the USD mesh prim has a valid `UsdSkel` schema defined, return the USD path
    * string to the bound skeleton, if any. Returns the empty string if no skeleton
@@ -82,15 +109,22 @@ class USDMeshReader : public USDGeomReader {
                                            blender::Map<pxr::SdfPath, int> *r_mat_map);
 
   void read_mpolys(Mesh *mesh) const;
+  /**
+   * True when the faces of the mesh are the same as the ones read by #topology_changed, the mesh
+   * has no loose edges, and the face attributes of the prim don't change over time. Then only the
+   * vertex and corner data has to be read. Expects the element counts to match already.
+   */
+  bool can_keep_topology(const Mesh &mesh) const;
   void read_subdiv();
   void read_vertex_creases(Mesh *mesh, double motionSampleTime);
   void read_edge_creases(Mesh *mesh, double motionSampleTime);
-  void read_velocities(Mesh *mesh, double motionSampleTime);
+  void read_velocities(Mesh *mesh);
 
   void read_mesh_sample(ImportSettings *settings,
                         Mesh *mesh,
                         double motionSampleTime,
-                        bool new_mesh);
+                        bool new_mesh,
+                        bool keep_topology);
 
   Mesh *read_mesh(struct Mesh *existing_mesh,
                   const USDMeshReadParams params,
@@ -95,6 +95,13 @@ class USDPrimReader {
   virtual bool valid() const;
 
   virtual void create_object(Main *bmain) = 0;
+
+  /**
+   * Convert the parts of the prim data that don't need access to Main ahead of
+   * #read_object_data. This is called for all readers in parallel after #create_object,
+   * so it must only modify data owned by this reader.
+   */
+  virtual void prepare_object_data(double /*motionSampleTime*/) {}
   virtual void read_object_data(Main * /*bmain*/, double /*motionSampleTime*/){};
 
   Object *object() const;
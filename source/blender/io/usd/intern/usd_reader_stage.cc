@@ -49,8 +49,10 @@
 #include "BLI_math_rotation.h"
 #include "BLI_sort.hh"
 #include "BLI_string.h"
+#include "BLI_task.hh"
 
 #include "BKE_collection.hh"
+#include "BKE_global.hh"
 #include "BKE_lib_id.hh"
 #include "BKE_modifier.hh"
 #include "BKE_report.hh"
@@ -745,6 +747,20 @@ void USDStageReader::sort_readers()
       });
 }
 
+void USDStageReader::prepare_object_data(const double motionSampleTime) const
+{
+  threading::parallel_for(readers_.index_range(), 1, [&](const IndexRange range) {
+    for (USDPrimReader *reader : readers_.as_span().slice(range)) {
+      if (G.is_break) {
+        return;
+      }
+      if (reader && reader->object()) {
+        reader->prepare_object_data(motionSampleTime);
+      }
+    }
+  });
+}
+
 void USDStageReader::create_proto_collections(Main *bmain, Collection *parent_collection)
 {
   if (proto_readers_.is_empty() && instancer_proto_readers_.is_empty()) {
@@ -7,6 +7,8 @@
 #include "BLI_set.hh"
 #include "BLI_vector.hh"
 
+#include "IO_frame_prefetch.hh"
+
 #include "usd.hh"
 #include "usd_hash_types.hh"
 #include "usd_reader_prim.hh"
@@ -54,6 +56,9 @@ class USDStageReader {
   /* Readers for point instancer prototypes. */
   ProtoReaderMap instancer_proto_readers_;
 
+  /* Frames of the mesh readers opened for the mesh sequence cache, read ahead of time. */
+  FramePrefetchCache prefetch_cache_;
+
  public:
   USDStageReader(pxr::UsdStageRefPtr stage,
                  const USDImportParams &params,
@@ -114,6 +119,11 @@ class USDStageReader {
     return settings_;
   }
 
+  FramePrefetchCache &prefetch_cache()
+  {
+    return prefetch_cache_;
+  }
+
   /** Get the wmJobWorkerStatus-provided `reports` list pointer, to use with the BKE_report API. */
   ReportList *reports() const
   {
@@ -135,6 +145,13 @@ class USDStageReader {
 
   void sort_readers();
 
+  /**
+   * Convert the data of all readers that doesn't depend on Main in parallel, see
+   * #USDPrimReader::prepare_object_data. Must be called after the objects were created and
+   * before #USDPrimReader::read_object_data, which attaches the data to Main.
+   */
+  void prepare_object_data(double motionSampleTime) const;
+
   /**
    * Create prototype collections for instancing by the USD instance readers.
    */
@@ -17,6 +17,7 @@
 
 #include "BLI_array_utils.hh"
 #include "BLI_assert.h"
+#include "BLI_listbase.h"
 #include "BLI_math_vector_types.hh"
 
 #include "BKE_anonymous_attribute_id.hh"
@@ -26,6 +27,7 @@
 #include "BKE_material.hh"
 #include "BKE_mesh.hh"
 #include "BKE_mesh_wrapper.hh"
+#include "BKE_modifier.hh"
 #include "BKE_object.hh"
 #include "BKE_report.hh"
 #include "BKE_subdiv.hh"
@@ -37,7 +39,11 @@
 
 #include "DNA_key_types.h"
 #include "DNA_material_types.h"
+#include "DNA_meshdata_types.h"
 #include "DNA_modifier_types.h"
+#include "DNA_object_types.h"
+
+#include "xxhash.h"
 
 #include "CLG_log.h"
 static CLG_LogRef LOG = {"io.usd"};
@@ -123,7 +129,26 @@ void USDGenericMeshWriter::do_write(HierarchyContext &context)
     const SubsurfModifierData *subsurfData = get_last_subdiv_modifier(
         usd_export_context_.export_params.evaluation_mode, object_eval);
 
-    write_mesh(context, mesh, subsurfData);
+    std::optional<USDMeshPrototypeKey> prototype_key;
+    bool wrote_reference = false;
+    if (this->can_deduplicate_mesh(context)) {
+      /* Ensure data exists if currently in edit mode. */
+      BKE_mesh_wrapper_ensure_mdata(mesh);
+      prototype_key = this->get_prototype_key(context, *mesh, needsfree, subsurfData);
+      if (const pxr::SdfPath *prototype_path =
+              usd_export_context_.mesh_prototypes->prim_paths.lookup_ptr(*prototype_key))
+      {
+        wrote_reference = this->write_mesh_reference(context, *prototype_path);
+      }
+    }
+
+    if (!wrote_reference) {
+      write_mesh(context, mesh, subsurfData);
+      if (prototype_key) {
+        usd_export_context_.mesh_prototypes->prim_paths.add(std::move(*prototype_key),
+                                                            usd_export_context_.usd_path);
+      }
+    }
 
     auto prim = usd_export_context_.stage->GetPrimAtPath(usd_export_context_.usd_path);
     if (prim.IsValid() && object_eval) {
@@ -281,6 +306,162 @@ void USDGenericMeshWriter::free_export_mesh(Mesh *mesh)
   BKE_id_free(nullptr, mesh);
 }
 
+bool USDGenericMeshWriter::can_deduplicate_mesh(const HierarchyContext &context) const
+{
+  const USDExportParams &params = usd_export_context_.export_params;
+  if (!params.deduplicate_meshes || usd_export_context_.mesh_prototypes == nullptr) {
+    return false;
+  }
+  if (is_animated_) {
+    /* The mesh may only match the other mesh in some frames. */
+    return false;
+  }
+  if (params.use_instancing && (context.is_instance() || context.is_prototype())) {
+    /* Scene graph instancing shares the data already. */
+    return false;
+  }
+  if (params.merge_parent_xform) {
+    /* The mesh prim may hold the transform of the object too. */
+    return false;
+  }
+  return true;
+}
+
+static void hash_custom_data(XXH3_state_t *state,
+                             const CustomData &data,
+                             const int elements_num,
+                             const bool hash_sharing_info)
+{
+  for (const CustomDataLayer &layer : Span<CustomDataLayer>(data.layers, data.totlayer)) {
+    if (layer.type == CD_ORIGINDEX) {
+      /* Not exported, and differs between meshes evaluated from different objects. */
+      continue;
+    }
+    XXH3_128bits_update(state, &layer.type, sizeof(layer.type));
+    XXH3_128bits_update(state, &layer.active_rnd, sizeof(layer.active_rnd));
+    XXH3_128bits_update(state, layer.name, strlen(layer.name) + 1);
+    if (hash_sharing_info) {
+      XXH3_128bits_update(state, &layer.sharing_info, sizeof(layer.sharing_info));
+    }
+    else if (layer.type == CD_MDEFORMVERT) {
+      /* The weights are stored in separate arrays for every vertex, hash them instead of the
+       * pointers to them. */
+      for (const MDeformVert &dvert :
+           Span(static_cast<const MDeformVert *>(layer.data), elements_num))
+      {
+        XXH3_128bits_update(state, &dvert.totweight, sizeof(dvert.totweight));
+        for (const MDeformWeight &dw : Span(dvert.dw, dvert.totweight)) {
+          XXH3_128bits_update(state, &dw.def_nr, sizeof(dw.def_nr));
+          XXH3_128bits_update(state, &dw.weight, sizeof(dw.weight));
+        }
+      }
+    }
+    else {
+      const size_t size = size_t(elements_num) *
+                          size_t(CustomData_sizeof(eCustomDataType(layer.type)));
+      XXH3_128bits_update(state, layer.data, size);
+    }
+  }
+}
+
+/**
+ * Hash the topology and all attributes of the mesh. With `hash_sharing_info`, the identity of the
+ * arrays is hashed instead of their data, which is much faster but only finds meshes that share
+ * all their data. That is common for instances of the same geometry.
+ */
+static std::optional<USDMeshHash> hash_mesh(const Mesh &mesh, const bool hash_sharing_info)
+{
+  if (hash_sharing_info) {
+    if (mesh.faces_num > 0 && mesh.runtime->face_offsets_sharing_info == nullptr) {
+      return std::nullopt;
+    }
+    for (const CustomData *data :
+         {&mesh.vert_data, &mesh.edge_data, &mesh.face_data, &mesh.corner_data})
+    {
+      for (const CustomDataLayer &layer : Span<CustomDataLayer>(data->layers, data->totlayer)) {
+        if (layer.type != CD_ORIGINDEX && layer.sharing_info == nullptr) {
+          return std::nullopt;
+        }
+      }
+    }
+  }
+
+  XXH3_state_t *state = XXH3_createState();
+  XXH3_128bits_reset(state);
+  const int sizes[4] = {mesh.verts_num, mesh.edges_num, mesh.faces_num, mesh.corners_num};
+  XXH3_128bits_update(state, sizes, sizeof(sizes));
+  if (hash_sharing_info) {
+    XXH3_128bits_update(state,
+                        &mesh.runtime->face_offsets_sharing_info,
+                        sizeof(mesh.runtime->face_offsets_sharing_info));
+  }
+  else {
+    const Span<int> face_offsets = mesh.face_offsets();
+    XXH3_128bits_update(state, face_offsets.data(), face_offsets.size_in_bytes());
+  }
+  hash_custom_data(state, mesh.vert_data, mesh.verts_num, hash_sharing_info);
+  LISTBASE_FOREACH (const bDeformGroup *, group, &mesh.vertex_group_names) {
+    /* The vertex group indices of the weights refer to these names. */
+    XXH3_128bits_update(state, group->name, strlen(group->name) + 1);
+  }
+  hash_custom_data(state, mesh.edge_data, mesh.edges_num, hash_sharing_info);
+  hash_custom_data(state, mesh.face_data, mesh.faces_num, hash_sharing_info);
+  hash_custom_data(state, mesh.corner_data, mesh.corners_num, hash_sharing_info);
+  const XXH128_hash_t hash = XXH3_128bits_digest(state);
+  XXH3_freeState(state);
+  return USDMeshHash{hash.low64, hash.high64};
+}
+
+USDMeshPrototypeKey USDGenericMeshWriter::get_prototype_key(
+    const HierarchyContext &context,
+    const Mesh &mesh,
+    const bool mesh_is_temporary,
+    const SubsurfModifierData *subsurfData) const
+{
+  USDMeshPrototypes &prototypes = *usd_export_context_.mesh_prototypes;
+
+  USDMeshPrototypeKey key;
+  /* The arrays of temporary meshes are freed right after writing them, so their sharing info can
+   * be reused by unrelated data later on. */
+  const std::optional<USDMeshHash> sharing_hash = mesh_is_temporary ? std::nullopt :
+                                                                      hash_mesh(mesh, true);
+  if (sharing_hash) {
+    key.geometry_hash = prototypes.geometry_hash_by_sharing.lookup_or_add_cb(
+        *sharing_hash, [&]() { return *hash_mesh(mesh, false); });
+  }
+  else {
+    key.geometry_hash = *hash_mesh(mesh, false);
+  }
+
+  for (const int mat_num : IndexRange(context.object->totcol)) {
+    key.materials.append(BKE_object_material_get(context.object, mat_num + 1));
+  }
+  if (subsurfData) {
+    key.has_subdiv = true;
+    key.subdiv_uv_smooth = subsurfData->uv_smooth;
+    key.subdiv_boundary_smooth = subsurfData->boundary_smooth;
+  }
+  return key;
+}
+
+bool USDGenericMeshWriter::write_mesh_reference(const HierarchyContext &context,
+                                                const pxr::SdfPath &prototype_path)
+{
+  pxr::UsdStageRefPtr stage = usd_export_context_.stage;
+  const pxr::SdfPath &usd_path = usd_export_context_.usd_path;
+
+  pxr::UsdGeomMesh usd_mesh = pxr::UsdGeomMesh::Define(stage, usd_path);
+  if (!usd_mesh.GetPrim().GetReferences().AddInternalReference(prototype_path)) {
+    CLOG_WARN(&LOG,
+              "Unable to add reference from %s to %s, writing mesh data instead",
+              usd_path.GetAsString().c_str(),
+              prototype_path.GetAsString().c_str());
+    return false;
+  }
+  write_visibility(context, get_export_time_code(), usd_mesh);
+  return true;
+}
+
 struct USDMeshData {
   pxr::VtArray<pxr::GfVec3f> points;
   pxr::VtIntArray face_vertex_counts;
@@ -834,6 +1015,21 @@ void USDMeshWriter::do_write(HierarchyContext &context)
   }
 }
 
+bool USDMeshWriter::can_deduplicate_mesh(const HierarchyContext &context) const
+{
+  if (write_skinned_mesh_ || write_blend_shapes_) {
+    /* The skinning and blend shape data depends on the object. */
+    return false;
+  }
+  if (usd_export_context_.export_params.export_armatures &&
+      BKE_modifiers_findby_type(context.object, eModifierType_Armature))
+  {
+    /* Which attributes are written depends on the bones of the armature. */
+    return false;
+  }
+  return USDGenericMeshWriter::can_deduplicate_mesh(context);
+}
+
 Mesh *USDMeshWriter::get_export_mesh(Object *object_eval, bool &r_needsfree)
 {
   if (write_blend_shapes_) {
@@ -6,9 +6,11 @@
 #include "usd_writer_abstract.hh"
 
 #include "BLI_map.hh"
+#include "BLI_vector.hh"
 
 #include <pxr/usd/usdGeom/mesh.h>
 
+struct Material;
 struct SubsurfModifierData;
 
 namespace blender::bke {
@@ -22,6 +24,61 @@ struct USDMeshData;
 /* Mapping from material slot number to array of face indices with that material. */
 using MaterialFaceGroups = Map<short, pxr::VtArray<int>>;
 
+/** 128-bit hash of mesh data, large enough to treat meshes with equal hashes as identical. */
+struct USDMeshHash {
+  uint64_t low = 0;
+  uint64_t high = 0;
+
+  uint64_t hash() const
+  {
+    return low;
+  }
+
+  friend bool operator==(const USDMeshHash &a, const USDMeshHash &b)
+  {
+    return a.low == b.low && a.high == b.high;
+  }
+};
+
+/** Everything that is written to a mesh prim, when it is not animated. */
+struct USDMeshPrototypeKey {
+  /** Hash of the topology and all attributes of the exported mesh. */
+  USDMeshHash geometry_hash;
+  /** Materials of the object, which are bound to the mesh prim. */
+  Vector<const Material *> materials;
+  /** Settings of the subdivision modifier that is exported as subdivision scheme. */
+  bool has_subdiv = false;
+  int subdiv_uv_smooth = 0;
+  int subdiv_boundary_smooth = 0;
+
+  uint64_t hash() const
+  {
+    return get_default_hash(geometry_hash, materials.hash(), subdiv_uv_smooth);
+  }
+
+  friend bool operator==(const USDMeshPrototypeKey &a, const USDMeshPrototypeKey &b)
+  {
+    return a.geometry_hash == b.geometry_hash && a.materials == b.materials &&
+           a.has_subdiv == b.has_subdiv && a.subdiv_uv_smooth == b.subdiv_uv_smooth &&
+           a.subdiv_boundary_smooth == b.subdiv_boundary_smooth;
+  }
+};
+
+/**
+ * Mesh prims that were written already, so that meshes with identical content are written once
+ * and referenced by the mesh prims of all other objects (see
+ * #USDExportParams::deduplicate_meshes). That happens a lot for scattered geometry.
+ */
+struct USDMeshPrototypes {
+  Map<USDMeshPrototypeKey, pxr::SdfPath> prim_paths;
+  /**
+   * Geometry hashes by a hash of the implicit sharing info of all mesh arrays. Meshes that share
+   * all their arrays are identical, so their data doesn't have to be hashed again. The sharing
+   * info pointers are only meaningful while the meshes exist, so this is cleared every frame.
+   */
+  Map<USDMeshHash, USDMeshHash> geometry_hash_by_sharing;
+};
+
 /* Writer for USD geometry. Does not assume the object is a mesh object. */
 class USDGenericMeshWriter : public USDAbstractWriter {
  public:
@@ -34,8 +91,16 @@ class USDGenericMeshWriter : public USDAbstractWriter {
   virtual Mesh *get_export_mesh(Object *object_eval, bool &r_needsfree) = 0;
   virtual void free_export_mesh(Mesh *mesh);
 
+  /** Whether the mesh prim may reference an identical mesh prim instead of holding the data. */
+  virtual bool can_deduplicate_mesh(const HierarchyContext &context) const;
+
  private:
   void write_mesh(HierarchyContext &context, Mesh *mesh, const SubsurfModifierData *subsurfData);
+  USDMeshPrototypeKey get_prototype_key(const HierarchyContext &context,
+                                        const Mesh &mesh,
+                                        bool mesh_is_temporary,
+                                        const SubsurfModifierData *subsurfData) const;
+  bool write_mesh_reference(const HierarchyContext &context, const pxr::SdfPath &prototype_path);
   pxr::TfToken get_subdiv_scheme(const SubsurfModifierData *subsurfData);
   void write_subdiv(const pxr::TfToken &subdiv_scheme,
                     const pxr::UsdGeomMesh &usd_mesh,
@@ -67,6 +132,7 @@ class USDMeshWriter : public USDGenericMeshWriter {
   void do_write(HierarchyContext &context) override;
 
   Mesh *get_export_mesh(Object *object_eval, bool &r_needsfree) override;
+  bool can_deduplicate_mesh(const HierarchyContext &context) const override;
 
   /**
    * Determine whether we should write skinned mesh or blend shape data
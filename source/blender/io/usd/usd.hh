@@ -150,6 +150,7 @@ struct USDExportParams {
   bool merge_parent_xform = false;
 
   bool use_instancing = false;
+  bool deduplicate_meshes = false;
   bool export_custom_properties = true;
   bool author_blender_name = true;
   bool allow_unicode = false;
@@ -252,6 +253,15 @@ struct USDImportParams {
 struct USDMeshReadParams {
   double motion_sample_time; /* USD TimeCode in frames. */
   int read_flags; /* MOD_MESHSEQ_xxx value that is set from MeshSeqCacheModifierData.read_flag. */
+
+  /** USD TimeCodes of upcoming frames to read ahead of time on background threads, may be null. */
+  const double *prefetch_times = nullptr;
+  int prefetch_times_num = 0;
+  /**
+   * Memory limit in bytes for the frames read ahead of time, shared by the stage.
+   * Zero frees the frames that were read ahead of time.
+   */
+  int64_t prefetch_memory_limit = 0;
 };
 
 USDMeshReadParams create_mesh_read_params(double motion_sample_time, int read_flags);
@@ -7,6 +7,7 @@
  */
 
 #include <algorithm>
+#include <array>
 #include <system_error>
 
 #include "BKE_attribute.hh"
@@ -233,14 +234,16 @@ static int calc_chunk_count(int count)
   return (count + chunk_size - 1) / chunk_size;
 }
 
-/* Write /tot_count/ items to OBJ file output. Each item is written
+/* Write /tot_count/ items to OBJ file output. Each range of items is written
  * by a /function/ that should be independent from other items.
  * If the amount of items is large enough (> chunk_size), then writing
  * will be done in parallel, into temporary FormatHandler buffers that
  * will be written into the final /fh/ buffer at the end.
  */
 template<typename Function>
-void obj_parallel_chunked_output(FormatHandler &fh, int tot_count, const Function &function)
+void obj_parallel_chunked_output_ranges(FormatHandler &fh,
+                                        int tot_count,
+                                        const Function &function)
 {
   if (tot_count <= 0) {
     return;
@@ -250,9 +253,7 @@ void obj_parallel_chunked_output(FormatHandler &fh, int tot_count, const Functio
    * overhead. */
   const int chunk_count = calc_chunk_count(tot_count);
   if (chunk_count == 1) {
-    for (int i = 0; i < tot_count; i++) {
-      function(fh, i);
-    }
+    function(fh, IndexRange(tot_count));
     return;
   }
   /* Give each chunk its own temporary output buffer, and process them in parallel. */
@@ -261,10 +262,7 @@ void obj_parallel_chunked_output(FormatHandler &fh, int tot_count, const Functio
     for (const int r : range) {
       int i_start = r * chunk_size;
       int i_end = std::min(i_start + chunk_size, tot_count);
-      auto &buf = buffers[r];
-      for (int i = i_start; i < i_end; i++) {
-        function(buf, i);
-      }
+      function(buffers[r], IndexRange::from_begin_end(i_start, i_end));
     }
   });
   /* Emit all temporary output buffers into the destination buffer. */
@@ -273,6 +271,17 @@ void obj_parallel_chunked_output(FormatHandler &fh, int tot_count, const Functio
   }
 }
 
+/* Same as #obj_parallel_chunked_output_ranges, with a /function/ called for each item. */
+template<typename Function>
+void obj_parallel_chunked_output(FormatHandler &fh, int tot_count, const Function &function)
+{
+  obj_parallel_chunked_output_ranges(fh, tot_count, [&](FormatHandler &buf, IndexRange range) {
+    for (const int i : range) {
+      function(buf, i);
+    }
+  });
+}
+
 void OBJWriter::write_vertex_coords(FormatHandler &fh,
                                     const OBJMesh &obj_mesh_data,
                                     bool write_colors) const
@@ -300,9 +309,18 @@ void OBJWriter::write_vertex_coords(FormatHandler &fh,
     });
   }
   else {
-    obj_parallel_chunked_output(fh, tot_count, [&](FormatHandler &buf, int i) {
-      const float3 vertex = math::transform_point(transform, positions[i]);
-      buf.write_obj_vertex(vertex[0], vertex[1], vertex[2]);
+    obj_parallel_chunked_output_ranges(fh, tot_count, [&](FormatHandler &buf, IndexRange range) {
+      /* Transform small batches of positions, and format them as rows at once. */
+      constexpr int64_t batch_size = 1024;
+      std::array<float3, batch_size> vertices;
+      for (int64_t start = range.start(); start < range.one_after_last(); start += batch_size) {
+        const IndexRange batch = IndexRange::from_begin_end(
+            start, std::min(start + batch_size, range.one_after_last()));
+        for (const int64_t i : batch.index_range()) {
+          vertices[i] = math::transform_point(transform, positions[batch[i]]);
+        }
+        buf.write_obj_vertices(Span<float3>(vertices.data(), batch.size()));
+      }
     });
   }
 }
@@ -320,10 +338,10 @@ void OBJWriter::write_normals(FormatHandler &fh, OBJMesh &obj_mesh_data)
 {
   /* Poly normals should be calculated earlier via store_normal_coords_and_indices. */
   const Span<float3> normal_coords = obj_mesh_data.get_normal_coords();
-  obj_parallel_chunked_output(fh, normal_coords.size(), [&](FormatHandler &buf, int i) {
-    const float3 &normal = normal_coords[i];
-    buf.write_obj_normal(normal[0], normal[1], normal[2]);
-  });
+  obj_parallel_chunked_output_ranges(
+      fh, normal_coords.size(), [&](FormatHandler &buf, IndexRange range) {
+        buf.write_obj_normals(normal_coords.slice(range));
+      });
 }
 
 OBJWriter::func_vert_uv_normal_indices OBJWriter::get_face_element_writer(
@@ -8,12 +8,17 @@
 
 #pragma once
 
+#include <algorithm>
 #include <cstdio>
 
+#include "BLI_math_vector_types.hh"
+#include "BLI_span.hh"
 #include "BLI_string_ref.hh"
 #include "BLI_utility_mixins.hh"
 #include "BLI_vector.hh"
 
+#include "IO_number_format.hh"
+
 /* SEP macro from BLI path utils clashes with SEP symbol in fmt headers. */
 #undef SEP
 #include <fmt/format.h>
@@ -68,19 +73,50 @@ class FormatHandler : NonCopyable, NonMovable {
 
   void write_obj_vertex(float x, float y, float z)
   {
-    write_impl("v {:.6f} {:.6f} {:.6f}\n", x, y, z);
+    char *p = reserve(float3_row_max_chars(2));
+    p = format_float3_rows_fixed(p, "v ", {float3(x, y, z)}, 6);
+    commit(p);
   }
   void write_obj_vertex_color(float x, float y, float z, float r, float g, float b)
   {
-    write_impl("v {:.6f} {:.6f} {:.6f} {:.4f} {:.4f} {:.4f}\n", x, y, z, r, g, b);
+    char *p = reserve(2 + 6 * (number_max_chars + 1));
+    *p++ = 'v';
+    for (const float v : {x, y, z}) {
+      *p++ = ' ';
+      p = format_float_fixed(p, v, 6);
+    }
+    for (const float v : {r, g, b}) {
+      *p++ = ' ';
+      p = format_float_fixed(p, v, 4);
+    }
+    *p++ = '\n';
+    commit(p);
   }
   void write_obj_uv(float x, float y)
   {
-    write_impl("vt {:.6f} {:.6f}\n", x, y);
+    char *p = reserve(4 + 2 * (number_max_chars + 1));
+    *p++ = 'v';
+    *p++ = 't';
+    *p++ = ' ';
+    p = format_float_fixed(p, x, 6);
+    *p++ = ' ';
+    p = format_float_fixed(p, y, 6);
+    *p++ = '\n';
+    commit(p);
   }
   void write_obj_normal(float x, float y, float z)
   {
-    write_impl("vn {:.4f} {:.4f} {:.4f}\n", x, y, z);
+    write_obj_normals({float3(x, y, z)});
+  }
+  /** Write a `vn` row for every normal. */
+  void write_obj_normals(Span<float3> normals)
+  {
+    write_float3_rows(normals, "vn ", 4);
+  }
+  /** Write a `v` row for every (already transformed) vertex position. */
+  void write_obj_vertices(Span<float3> positions)
+  {
+    write_float3_rows(positions, "v ", 6);
   }
   void write_obj_face_begin()
   {
@@ -92,19 +128,40 @@ class FormatHandler : NonCopyable, NonMovable {
   }
   void write_obj_face_v_uv_normal(int v, int uv, int n)
   {
-    write_impl(" {}/{}/{}", v, uv, n);
+    char *p = reserve(4 + 3 * number_max_chars);
+    *p++ = ' ';
+    p = format_int(p, v);
+    *p++ = '/';
+    p = format_int(p, uv);
+    *p++ = '/';
+    p = format_int(p, n);
+    commit(p);
   }
   void write_obj_face_v_normal(int v, int n)
   {
-    write_impl(" {}//{}", v, n);
+    char *p = reserve(4 + 2 * number_max_chars);
+    *p++ = ' ';
+    p = format_int(p, v);
+    *p++ = '/';
+    *p++ = '/';
+    p = format_int(p, n);
+    commit(p);
   }
   void write_obj_face_v_uv(int v, int uv)
   {
-    write_impl(" {}/{}", v, uv);
+    char *p = reserve(2 + 2 * number_max_chars);
+    *p++ = ' ';
+    p = format_int(p, v);
+    *p++ = '/';
+    p = format_int(p, uv);
+    commit(p);
   }
   void write_obj_face_v(int v)
   {
-    write_impl(" {}", v);
+    char *p = reserve(1 + number_max_chars);
+    *p++ = ' ';
+    p = format_int(p, v);
+    commit(p);
   }
   void write_obj_usemtl(StringRef s)
   {
@@ -128,7 +185,14 @@ class FormatHandler : NonCopyable, NonMovable {
   }
   void write_obj_edge(int a, int b)
   {
-    write_impl("l {} {}\n", a, b);
+    char *p = reserve(4 + 2 * number_max_chars);
+    *p++ = 'l';
+    *p++ = ' ';
+    p = format_int(p, a);
+    *p++ = ' ';
+    p = format_int(p, b);
+    *p++ = '\n';
+    commit(p);
   }
   void write_obj_cstype()
   {
@@ -152,7 +216,10 @@ class FormatHandler : NonCopyable, NonMovable {
   }
   void write_obj_nurbs_parm(float v)
   {
-    write_impl(" {:.6f}", v);
+    char *p = reserve(1 + number_max_chars);
+    *p++ = ' ';
+    p = format_float_fixed(p, v, 6);
+    commit(p);
   }
   void write_obj_nurbs_parm_end()
   {
@@ -205,6 +272,38 @@ class FormatHandler : NonCopyable, NonMovable {
     }
   }
 
+  /**
+   * Return room for at least \a max_len characters at the end of the last block, to be
+   * written directly. Has to be followed by #commit with the end of the written text.
+   */
+  char *reserve(size_t max_len)
+  {
+    ensure_space(max_len);
+    return blocks_.last().end();
+  }
+  void commit(char *end)
+  {
+    VectorChar &bb = blocks_.last();
+    bb.increase_size_by_unchecked(end - bb.end());
+  }
+
+  void write_float3_rows(Span<float3> rows, StringRef prefix, int precision)
+  {
+    /* Format as many rows at once as fit into the space left in the last block. Rows are usually
+     * much shorter than their worst case length, so the block is filled over several batches. */
+    const int64_t row_max_len = float3_row_max_chars(prefix.size());
+    for (int64_t start = 0; start < rows.size();) {
+      ensure_space(row_max_len);
+      const VectorChar &block = blocks_.last();
+      const int64_t rows_fit = (block.capacity() - block.size()) / row_max_len;
+      const Span<float3> batch = rows.slice(start, std::min(rows_fit, rows.size() - start));
+      char *p = reserve(batch.size() * row_max_len);
+      p = format_float3_rows_fixed(p, prefix, batch, precision);
+      commit(p);
+      start += batch.size();
+    }
+  }
+
   template<typename... T> void write_impl(fmt::format_string<T...> fmt, T &&...args)
   {
     /* Format into a local buffer. */
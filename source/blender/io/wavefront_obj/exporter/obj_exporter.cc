@@ -15,6 +15,7 @@
 #include "BKE_report.hh"
 #include "BKE_scene.hh"
 
+#include "BLI_function_ref.hh"
 #include "BLI_path_utils.hh"
 #include "BLI_string.h"
 #include "BLI_task.hh"
@@ -23,6 +24,7 @@
 #include "DEG_depsgraph_query.hh"
 
 #include "DNA_collection_types.h"
+#include "DNA_mesh_types.h"
 #include "DNA_scene_types.h"
 
 #include "ED_object.hh"
@@ -99,15 +101,19 @@ static bool is_curve_nurbs_compatible(const Nurb *nurb)
 }
 
 /**
- * Filter supported objects from the Scene.
+ * Iterate over the objects supported by the exporter, in depsgraph order.
  *
- * \note Curves are also stored with Meshes if export settings specify so.
+ * The OBJMesh is constructed (and so the mesh evaluated or converted) while the object is
+ * current in the iterator: dupli objects only live for the duration of one iteration step.
+ *
+ * \note Curves are also passed as meshes if export settings specify so.
  */
-std::pair<Vector<std::unique_ptr<OBJMesh>>, Vector<std::unique_ptr<OBJCurve>>>
-filter_supported_objects(Depsgraph *depsgraph, const OBJExportParams &export_params)
+static void foreach_supported_object(
+    Depsgraph *depsgraph,
+    const OBJExportParams &export_params,
+    const FunctionRef<void(std::unique_ptr<OBJMesh> obj_mesh)> mesh_fn,
+    const FunctionRef<void(std::unique_ptr<OBJCurve> obj_curve)> nurbs_fn)
 {
-  Vector<std::unique_ptr<OBJMesh>> r_exportable_meshes;
-  Vector<std::unique_ptr<OBJCurve>> r_exportable_nurbs;
   DEGObjectIterSettings deg_iter_settings{};
   deg_iter_settings.depsgraph = depsgraph;
   deg_iter_settings.flags = DEG_ITER_OBJECT_FLAG_LINKED_DIRECTLY |
@@ -122,7 +128,7 @@ filter_supported_objects(Depsgraph *depsgraph, const OBJExportParams &export_par
         /* Evaluated surface objects appear as mesh objects from the iterator. */
         break;
       case OB_MESH:
-        r_exportable_meshes.append(std::make_unique<OBJMesh>(depsgraph, export_params, object));
+        mesh_fn(std::make_unique<OBJMesh>(depsgraph, export_params, object));
         break;
       case OB_CURVES_LEGACY: {
         Curve *curve = static_cast<Curve *>(object->data);
@@ -130,18 +136,17 @@ filter_supported_objects(Depsgraph *depsgraph, const OBJExportParams &export_par
         if (!nurb) {
           /* An empty curve. Not yet supported to export these as meshes. */
           if (export_params.export_curves_as_nurbs) {
-            r_exportable_nurbs.append(
-                std::make_unique<OBJCurve>(depsgraph, export_params, object));
+            nurbs_fn(std::make_unique<OBJCurve>(depsgraph, export_params, object));
           }
           break;
         }
         if (export_params.export_curves_as_nurbs && is_curve_nurbs_compatible(nurb)) {
           /* Export in parameter form: control points. */
-          r_exportable_nurbs.append(std::make_unique<OBJCurve>(depsgraph, export_params, object));
+          nurbs_fn(std::make_unique<OBJCurve>(depsgraph, export_params, object));
         }
         else {
           /* Export in mesh form: edges and vertices. */
-          r_exportable_meshes.append(std::make_unique<OBJMesh>(depsgraph, export_params, object));
+          mesh_fn(std::make_unique<OBJMesh>(depsgraph, export_params, object));
         }
         break;
       }
@@ -151,108 +156,242 @@ filter_supported_objects(Depsgraph *depsgraph, const OBJExportParams &export_par
     }
   }
   DEG_OBJECT_ITER_END;
+}
+
+std::pair<Vector<std::unique_ptr<OBJMesh>>, Vector<std::unique_ptr<OBJCurve>>>
+filter_supported_objects(Depsgraph *depsgraph, const OBJExportParams &export_params)
+{
+  Vector<std::unique_ptr<OBJMesh>> r_exportable_meshes;
+  Vector<std::unique_ptr<OBJCurve>> r_exportable_nurbs;
+  foreach_supported_object(
+      depsgraph,
+      export_params,
+      [&](std::unique_ptr<OBJMesh> obj_mesh) { r_exportable_meshes.append(std::move(obj_mesh)); },
+      [&](std::unique_ptr<OBJCurve> obj_curve) {
+        r_exportable_nurbs.append(std::move(obj_curve));
+      });
   return {std::move(r_exportable_meshes), std::move(r_exportable_nurbs)};
 }
 
-static void write_mesh_objects(const Span<std::unique_ptr<OBJMesh>> exportable_as_mesh,
-                               OBJWriter &obj_writer,
-                               MTLWriter *mtl_writer,
-                               const OBJExportParams &export_params)
+/**
+ * Write the text of one mesh object into \a fh.
+ *
+ * \param stream_file: When not null, the buffer is written into this file (and cleared) after
+ * each section of the object, so that a single large object never has all of its text in
+ * memory at once.
+ */
+static void write_mesh_object(FormatHandler &fh,
+                              OBJMesh &obj,
+                              const IndexOffsets &offsets,
+                              const Span<int> obj_mtlindices,
+                              OBJWriter &obj_writer,
+                              MTLWriter *mtl_writer,
+                              const OBJExportParams &export_params,
+                              FILE *stream_file)
 {
-  /* Parallelization is over meshes/objects, which means
-   * we have to have the output text buffer for each object,
-   * and write them all into the file at the end. */
-  size_t count = exportable_as_mesh.size();
-  Array<FormatHandler> buffers(count);
-
-  /* Serial: gather material indices, ensure normals & edges. */
-  Vector<Vector<int>> mtlindices;
-  if (mtl_writer) {
+  auto flush = [&]() {
+    if (stream_file) {
+      fh.write_to_file(stream_file);
+    }
+  };
+
+  obj_writer.write_object_name(fh, obj);
+  obj_writer.write_vertex_coords(fh, obj, export_params.export_colors);
+  flush();
+
+  if (obj.tot_faces() > 0) {
+    if (export_params.export_smooth_groups) {
+      obj.calc_smooth_groups(export_params.smooth_groups_bitflags);
+    }
     if (export_params.export_materials) {
-      obj_writer.write_mtllib_name(mtl_writer->mtl_file_path());
+      obj.calc_face_order();
+    }
+    if (export_params.export_normals) {
+      obj_writer.write_normals(fh, obj);
+      flush();
+    }
+    if (export_params.export_uv) {
+      obj_writer.write_uv_coords(fh, obj);
+      flush();
     }
-    mtlindices.reserve(count);
+    /* This function takes a 0-indexed slot index for the obj_mesh object and
+     * returns the material name that we are using in the `.obj` file for it. */
+    auto matname_fn = [&](int s) -> const char * {
+      if (!mtl_writer || s < 0 || s >= obj_mtlindices.size()) {
+        return nullptr;
+      }
+      return mtl_writer->mtlmaterial_name(obj_mtlindices[s]);
+    };
+    obj_writer.write_face_elements(fh, offsets, obj, matname_fn);
+    flush();
   }
-  for (const auto &obj_mesh : exportable_as_mesh) {
-    OBJMesh &obj = *obj_mesh;
-    if (mtl_writer) {
-      mtlindices.append(mtl_writer->add_materials(obj));
+  obj_writer.write_edges_indices(fh, offsets, obj);
+
+  /* Nothing will need this object's data after this point, release
+   * various arrays here. */
+  obj.clear();
+}
+
+/**
+ * Streaming writer of mesh objects.
+ *
+ * Objects are handed over one at a time while the depsgraph is iterated, and gathered into a
+ * window bounded by object count and mesh size. A full window is formatted in parallel over its
+ * objects, while the text of the previous window is written to the file. Once written, the text
+ * and the objects are freed, so peak memory depends on the window size rather than the scene.
+ */
+class OBJMeshStreamWriter : NonCopyable, NonMovable {
+  /** Maximum number of objects formatted together. */
+  static constexpr int window_max_objects = 128;
+  /**
+   * Maximum number of mesh elements (vertices and face corners) formatted together. Larger
+   * objects are formatted on their own and written to the file section by section.
+   */
+  static constexpr int64_t window_max_elements = 4 * 1024 * 1024;
+
+  OBJWriter &obj_writer_;
+  MTLWriter *mtl_writer_;
+  const OBJExportParams &export_params_;
+
+  /** Index offsets of the next object; sequentially added over all written meshes. */
+  IndexOffsets offsets_{0, 0, 0};
+
+  Vector<std::unique_ptr<OBJMesh>> window_;
+  Vector<Vector<int>> window_mtlindices_;
+  int64_t window_elements_ = 0;
+
+  /** Formatted text of the last window, not yet written to the file. */
+  FormatHandler pending_;
+
+ public:
+  OBJMeshStreamWriter(OBJWriter &obj_writer,
+                      MTLWriter *mtl_writer,
+                      const OBJExportParams &export_params)
+      : obj_writer_(obj_writer), mtl_writer_(mtl_writer), export_params_(export_params)
+  {
+    if (mtl_writer_ && export_params_.export_materials) {
+      obj_writer_.write_mtllib_name(mtl_writer_->mtl_file_path());
     }
   }
 
-  /* Parallel over meshes: store normal coords & indices, uv coords and indices. */
-  threading::parallel_for(IndexRange(count), 1, [&](IndexRange range) {
-    for (const int i : range) {
-      OBJMesh &obj = *exportable_as_mesh[i];
-      if (export_params.export_normals) {
-        obj.store_normal_coords_and_indices();
-      }
-      if (export_params.export_uv) {
-        obj.store_uv_coords_and_indices();
-      }
+  void add(std::unique_ptr<OBJMesh> obj_mesh)
+  {
+    /* Serial: gather material indices in object order. */
+    Vector<int> mtlindices;
+    if (mtl_writer_) {
+      mtlindices = mtl_writer_->add_materials(*obj_mesh);
     }
-  });
-
-  /* Serial: calculate index offsets; these are sequentially added
-   * over all meshes, and requite normal/uv indices to be calculated. */
-  Vector<IndexOffsets> index_offsets;
-  index_offsets.reserve(count);
-  IndexOffsets offsets{0, 0, 0};
-  for (const auto &obj_mesh : exportable_as_mesh) {
-    OBJMesh &obj = *obj_mesh;
-    index_offsets.append(offsets);
-    offsets.vertex_offset += obj.tot_vertices();
-    offsets.uv_vertex_offset += obj.tot_uv_vertices();
-    offsets.normal_offset += obj.get_normal_coords().size();
+
+    const int64_t elements = int64_t(obj_mesh->tot_vertices()) +
+                             int64_t(obj_mesh->get_mesh()->corners_num);
+    if (elements >= window_max_elements) {
+      this->flush_window();
+      pending_.write_to_file(obj_writer_.get_outfile());
+      window_.append(std::move(obj_mesh));
+      window_mtlindices_.append(std::move(mtlindices));
+      this->format_window(pending_, obj_writer_.get_outfile());
+      return;
+    }
+
+    if (window_.size() >= window_max_objects ||
+        window_elements_ + elements > window_max_elements)
+    {
+      this->flush_window();
+    }
+    window_.append(std::move(obj_mesh));
+    window_mtlindices_.append(std::move(mtlindices));
+    window_elements_ += elements;
   }
 
-  /* Parallel over meshes: main result writing. */
-  threading::parallel_for(IndexRange(count), 1, [&](IndexRange range) {
-    for (const int i : range) {
-      OBJMesh &obj = *exportable_as_mesh[i];
-      auto &fh = buffers[i];
+  /** Format and write all remaining objects. */
+  void finish()
+  {
+    this->flush_window();
+    pending_.write_to_file(obj_writer_.get_outfile());
+  }
 
-      obj_writer.write_object_name(fh, obj);
-      obj_writer.write_vertex_coords(fh, obj, export_params.export_colors);
+ private:
+  /**
+   * Format the current window, overlapped with writing the previous one into the file.
+   * The text of the current window becomes pending.
+   */
+  void flush_window()
+  {
+    if (window_.is_empty()) {
+      return;
+    }
+    FormatHandler window_text;
+    threading::parallel_invoke(
+        pending_.get_block_count() > 0,
+        [&]() { pending_.write_to_file(obj_writer_.get_outfile()); },
+        [&]() { this->format_window(window_text, nullptr); });
+    pending_.append_from(window_text);
+  }
 
-      if (obj.tot_faces() > 0) {
-        if (export_params.export_smooth_groups) {
-          obj.calc_smooth_groups(export_params.smooth_groups_bitflags);
+  /** Format all objects of the window into \a r_fh, then release them. */
+  void format_window(FormatHandler &r_fh, FILE *stream_file)
+  {
+    const Span<std::unique_ptr<OBJMesh>> objects = window_;
+    const int64_t count = objects.size();
+
+    /* Parallel over meshes: store normal coords & indices, uv coords and indices. */
+    threading::parallel_for(objects.index_range(), 1, [&](IndexRange range) {
+      for (const int i : range) {
+        OBJMesh &obj = *objects[i];
+        if (export_params_.export_normals) {
+          obj.store_normal_coords_and_indices();
         }
-        if (export_params.export_materials) {
-          obj.calc_face_order();
+        if (export_params_.export_uv) {
+          obj.store_uv_coords_and_indices();
         }
-        if (export_params.export_normals) {
-          obj_writer.write_normals(fh, obj);
-        }
-        if (export_params.export_uv) {
-          obj_writer.write_uv_coords(fh, obj);
-        }
-        /* This function takes a 0-indexed slot index for the obj_mesh object and
-         * returns the material name that we are using in the `.obj` file for it. */
-        const auto *obj_mtlindices = mtlindices.is_empty() ? nullptr : &mtlindices[i];
-        auto matname_fn = [&](int s) -> const char * {
-          if (!obj_mtlindices || s < 0 || s >= obj_mtlindices->size()) {
-            return nullptr;
-          }
-          return mtl_writer->mtlmaterial_name((*obj_mtlindices)[s]);
-        };
-        obj_writer.write_face_elements(fh, index_offsets[i], obj, matname_fn);
       }
-      obj_writer.write_edges_indices(fh, index_offsets[i], obj);
+    });
+
+    /* Serial: calculate index offsets, they require normal/uv indices to be calculated. */
+    Array<IndexOffsets> index_offsets(count);
+    for (const int i : objects.index_range()) {
+      const OBJMesh &obj = *objects[i];
+      index_offsets[i] = offsets_;
+      offsets_.vertex_offset += obj.tot_vertices();
+      offsets_.uv_vertex_offset += obj.tot_uv_vertices();
+      offsets_.normal_offset += obj.get_normal_coords().size();
+    }
 
-      /* Nothing will need this object's data after this point, release
-       * various arrays here. */
-      obj.clear();
+    if (count == 1) {
+      write_mesh_object(r_fh,
+                        *objects[0],
+                        index_offsets[0],
+                        window_mtlindices_[0],
+                        obj_writer_,
+                        mtl_writer_,
+                        export_params_,
+                        stream_file);
+    }
+    else {
+      /* Parallel over meshes: main result writing. */
+      Array<FormatHandler> buffers(count);
+      threading::parallel_for(objects.index_range(), 1, [&](IndexRange range) {
+        for (const int i : range) {
+          write_mesh_object(buffers[i],
+                            *objects[i],
+                            index_offsets[i],
+                            window_mtlindices_[i],
+                            obj_writer_,
+                            mtl_writer_,
+                            export_params_,
+                            nullptr);
+        }
+      });
+      for (FormatHandler &buffer : buffers) {
+        r_fh.append_from(buffer);
+      }
     }
-  });
 
-  /* Write all the object text buffers into the output file. */
-  FILE *f = obj_writer.get_outfile();
-  for (auto &b : buffers) {
-    b.write_to_file(f);
+    window_.clear();
+    window_mtlindices_.clear();
+    window_elements_ = 0;
   }
-}
+};
 
 /**
  * Export NURBS Curves in parameter form, not as vertices and edges.
@@ -300,10 +439,19 @@ void export_frame(Depsgraph *depsgraph, const OBJExportParams &export_params, co
 
   frame_writer->write_header();
 
-  auto [exportable_as_mesh, exportable_as_nurbs] = filter_supported_objects(depsgraph,
-                                                                            export_params);
+  /* Meshes are formatted and written while the depsgraph is iterated, so that only a bounded
+   * window of them is alive at once. NURBS curves are small and written after them. */
+  Vector<std::unique_ptr<OBJCurve>> exportable_as_nurbs;
+  OBJMeshStreamWriter mesh_writer(*frame_writer, mtl_writer.get(), export_params);
+  foreach_supported_object(
+      depsgraph,
+      export_params,
+      [&](std::unique_ptr<OBJMesh> obj_mesh) { mesh_writer.add(std::move(obj_mesh)); },
+      [&](std::unique_ptr<OBJCurve> obj_curve) {
+        exportable_as_nurbs.append(std::move(obj_curve));
+      });
+  mesh_writer.finish();
 
-  write_mesh_objects(exportable_as_mesh, *frame_writer, mtl_writer.get(), export_params);
   if (mtl_writer && export_params.export_materials) {
     mtl_writer->write_header(export_params.blen_filepath);
     char dest_dir[FILE_MAX];
@@ -14,6 +14,7 @@
 #include "BLI_math_vector_types.hh"
 #include "BLI_string.h"
 #include "BLI_string_ref.hh"
+#include "BLI_task.hh"
 #include "BLI_vector.hh"
 
 #include "IO_string_utils.hh"
@@ -74,12 +75,60 @@ static Geometry *create_geometry(Geometry *const prev_geometry,
   return new_geometry();
 }
 
-static void geom_add_vertex(const char *p, const char *end, GlobalVertices &r_global_vertices)
+/**
+ * Part of a read buffer that ends on a line boundary, parsed independently from the other parts
+ * of the buffer (possibly on a different thread).
+ *
+ * Vertex positions, UVs and normals are parsed into local arrays, and faces are parsed with their
+ * indices still unresolved, since relative indices depend on all the vertex data before them.
+ * Lines that depend on or modify the parser state (objects, groups, materials, curves etc.) are
+ * kept as-is, and are handled when the slices are merged in file order.
+ */
+struct ParsedSlice {
+  /** Face corner as written in the file; indices are not bounds-checked nor made zero-based. */
+  struct RawFaceCorner {
+    int vert_index;
+    int uv_vert_index = -1;
+    int vertex_normal_index = -1;
+    bool got_uv = false;
+    bool got_normal = false;
+  };
+
+  /** A face or a state line, along with the vertex data counts of the slice before it. */
+  struct Item {
+    int vertices_num;
+    int uv_vertices_num;
+    int vert_normals_num;
+    /** Face corners of the item, empty for lines. */
+    IndexRange corners;
+    /** Line that has to be processed in order, when the item is not a face. */
+    StringRef line;
+    bool is_face = false;
+  };
+
+  Vector<float3> vertices;
+  Vector<float2> uv_vertices;
+  Vector<float3> vert_normals;
+  /** Colors and weights from the `xyzrgb` extension, with slice-local vertex indices. */
+  Vector<std::pair<int, float3>> vertex_colors;
+  Vector<std::pair<int, float>> vertex_weights;
+
+  Vector<RawFaceCorner> face_corners;
+  Vector<Item> items;
+  size_t lines_num = 0;
+};
+
+/**
+ * Approximate size of the line-aligned parts that a read buffer is split into
+ * for parallel parsing.
+ */
+static constexpr int64_t parse_slice_size = 64 * 1024;
+
+static void slice_add_vertex(const char *p, const char *end, ParsedSlice &r_slice)
 {
-  r_global_vertices.flush_mrgb_block();
   float3 vert;
   p = parse_floats(p, end, 0.0f, vert, 3);
-  r_global_vertices.vertices.append(vert);
+  r_slice.vertices.append(vert);
   /* OBJ extension: `xyzrgb` vertex colors, when the vertex position
    * is followed by 3 more RGB color components. See
    * http://paulbourke.net/dataformats/obj/colour.html */
@@ -89,11 +138,11 @@ static void geom_add_vertex(const char *p, const char *end, GlobalVertices &r_gl
     if (srgb.x >= 0 && srgb.y >= 0 && srgb.z >= 0) {
       float3 linear;
       srgb_to_linearrgb_v3_v3(linear, srgb);
-      r_global_vertices.set_vertex_color(r_global_vertices.vertices.size() - 1, linear);
+      r_slice.vertex_colors.append({int(r_slice.vertices.size() - 1), linear});
     }
     else if (srgb.x > 0) {
       /* Treats value in srgb.x as weight. */
-      r_global_vertices.set_vertex_weight(r_global_vertices.vertices.size() - 1, srgb.x);
+      r_slice.vertex_weights.append({int(r_slice.vertices.size() - 1), srgb.x});
     }
   }
   UNUSED_VARS(p);
@@ -126,9 +175,7 @@ static void geom_add_mrgb_colors(const char *p, const char *end, GlobalVertices
   }
 }
 
-static void geom_add_vertex_normal(const char *p,
-                                   const char *end,
-                                   GlobalVertices &r_global_vertices)
+static void slice_add_vertex_normal(const char *p, const char *end, ParsedSlice &r_slice)
 {
   float3 normal;
   parse_floats(p, end, 0.0f, normal, 3);
@@ -136,14 +183,14 @@ static void geom_add_vertex_normal(const char *p,
    * making them ever-so-slightly non unit length. Make sure they are
    * normalized. */
   normalize_v3(normal);
-  r_global_vertices.vert_normals.append(normal);
+  r_slice.vert_normals.append(normal);
 }
 
-static void geom_add_uv_vertex(const char *p, const char *end, GlobalVertices &r_global_vertices)
+static void slice_add_uv_vertex(const char *p, const char *end, ParsedSlice &r_slice)
 {
   float2 uv;
   parse_floats(p, end, 0.0f, uv, 2);
-  r_global_vertices.uv_vertices.append(uv);
+  r_slice.uv_vertices.append(uv);
 }
 
 /**
@@ -209,30 +256,16 @@ static void geom_add_polyline(Geometry *geom,
   }
 }
 
-static void geom_add_polygon(Geometry *geom,
-                             const char *p,
-                             const char *end,
-                             const GlobalVertices &global_vertices,
-                             const int material_index,
-                             const int group_index,
-                             const bool shaded_smooth)
+/**
+ * Parse the corners of a face line into the slice. Indices are resolved later,
+ * in #geom_add_polygon.
+ */
+static void slice_add_face(const char *p, const char *end, ParsedSlice &r_slice)
 {
-  FaceElem curr_face;
-  curr_face.shaded_smooth = shaded_smooth;
-  curr_face.material_index = material_index;
-  if (group_index >= 0) {
-    curr_face.vertex_group_index = group_index;
-    geom->has_vertex_groups_ = true;
-  }
-
-  const int orig_corners_size = geom->face_corners_.size();
-  curr_face.start_index_ = orig_corners_size;
-
-  bool face_valid = true;
+  const int corners_start = r_slice.face_corners.size();
   p = drop_whitespace(p, end);
-  while (p < end && face_valid) {
-    FaceCorner corner;
-    bool got_uv = false, got_normal = false;
+  while (p < end) {
+    ParsedSlice::RawFaceCorner corner;
     /* Parse vertex index. */
     p = parse_int(p, end, INT32_MAX, corner.vert_index, false);
 
@@ -241,21 +274,70 @@ static void geom_add_polygon(Geometry *geom,
       break;
     }
 
-    face_valid &= corner.vert_index != INT32_MAX;
     if (p < end && *p == '/') {
       /* Parse UV index. */
       ++p;
       if (p < end && *p != '/') {
         p = parse_int(p, end, INT32_MAX, corner.uv_vert_index, false);
-        got_uv = corner.uv_vert_index != INT32_MAX;
+        corner.got_uv = corner.uv_vert_index != INT32_MAX;
       }
       /* Parse normal index. */
       if (p < end && *p == '/') {
         ++p;
         p = parse_int(p, end, INT32_MAX, corner.vertex_normal_index, false);
-        got_normal = corner.vertex_normal_index != INT32_MAX;
+        corner.got_normal = corner.vertex_normal_index != INT32_MAX;
       }
     }
+    r_slice.face_corners.append(corner);
+
+    /* The rest of the face is invalid, no need to parse it. */
+    if (corner.vert_index == INT32_MAX) {
+      break;
+    }
+    /* Some files contain extra stuff per face (e.g. 4 indices); skip any remainder (#103441). */
+    p = drop_non_whitespace(p, end);
+    /* Skip whitespace to get to the next face corner. */
+    p = drop_whitespace(p, end);
+  }
+
+  ParsedSlice::Item item;
+  item.vertices_num = r_slice.vertices.size();
+  item.uv_vertices_num = r_slice.uv_vertices.size();
+  item.vert_normals_num = r_slice.vert_normals.size();
+  item.corners = IndexRange::from_begin_end(corners_start, r_slice.face_corners.size());
+  item.is_face = true;
+  r_slice.items.append(item);
+}
+
+static void geom_add_polygon(Geometry *geom,
+                             const Span<ParsedSlice::RawFaceCorner> raw_corners,
+                             const GlobalVertices &global_vertices,
+                             const int material_index,
+                             const int group_index,
+                             const bool shaded_smooth)
+{
+  FaceElem curr_face;
+  curr_face.shaded_smooth = shaded_smooth;
+  curr_face.material_index = material_index;
+  if (group_index >= 0) {
+    curr_face.vertex_group_index = group_index;
+    geom->has_vertex_groups_ = true;
+  }
+
+  const int orig_corners_size = geom->face_corners_.size();
+  curr_face.start_index_ = orig_corners_size;
+
+  bool face_valid = true;
+  for (const ParsedSlice::RawFaceCorner &raw_corner : raw_corners) {
+    if (!face_valid) {
+      break;
+    }
+    FaceCorner corner;
+    corner.vert_index = raw_corner.vert_index;
+    corner.uv_vert_index = raw_corner.uv_vert_index;
+    corner.vertex_normal_index = raw_corner.vertex_normal_index;
+
+    face_valid &= corner.vert_index != INT32_MAX;
     /* Always keep stored indices non-negative and zero-based. */
     corner.vert_index += corner.vert_index < 0 ? global_vertices.vertices.size() : -1;
     if (corner.vert_index < 0 || corner.vert_index >= global_vertices.vertices.size()) {
@@ -269,7 +351,7 @@ static void geom_add_polygon(Geometry *geom,
       geom->track_vertex_index(corner.vert_index);
     }
     /* Ignore UV index, if the geometry does not have any UVs (#103212). */
-    if (got_uv && !global_vertices.uv_vertices.is_empty()) {
+    if (raw_corner.got_uv && !global_vertices.uv_vertices.is_empty()) {
       corner.uv_vert_index += corner.uv_vert_index < 0 ? global_vertices.uv_vertices.size() : -1;
       if (corner.uv_vert_index < 0 || corner.uv_vert_index >= global_vertices.uv_vertices.size()) {
         CLOG_WARN(&LOG,
@@ -282,7 +364,7 @@ static void geom_add_polygon(Geometry *geom,
     /* Ignore corner normal index, if the geometry does not have any normals.
      * Some obj files out there do have face definitions that refer to normal indices,
      * without any normals being present (#98782). */
-    if (got_normal && !global_vertices.vert_normals.is_empty()) {
+    if (raw_corner.got_normal && !global_vertices.vert_normals.is_empty()) {
       corner.vertex_normal_index += corner.vertex_normal_index < 0 ?
                                         global_vertices.vert_normals.size() :
                                         -1;
@@ -298,11 +380,6 @@ static void geom_add_polygon(Geometry *geom,
     }
     geom->face_corners_.append(corner);
     curr_face.corner_count_++;
-
-    /* Some files contain extra stuff per face (e.g. 4 indices); skip any remainder (#103441). */
-    p = drop_non_whitespace(p, end);
-    /* Skip whitespace to get to the next face corner. */
-    p = drop_whitespace(p, end);
   }
 
   if (face_valid) {
@@ -468,6 +545,142 @@ static bool parse_keyword(const char *&p, const char *end, StringRef keyword)
   return true;
 }
 
+/**
+ * Split the buffer into parts of approximately the given size, each ending right after a newline.
+ * The buffer is expected to end with a newline.
+ */
+static Vector<StringRef> split_into_line_slices(const StringRef buffer, const int64_t slice_size)
+{
+  Vector<StringRef> slices;
+  int64_t start = 0;
+  while (start < buffer.size()) {
+    int64_t end = std::min(start + slice_size, buffer.size());
+    const char *newline = static_cast<const char *>(
+        memchr(buffer.data() + end - 1, '\n', size_t(buffer.size() - end + 1)));
+    end = newline ? newline - buffer.data() + 1 : buffer.size();
+    slices.append(buffer.substr(start, end - start));
+    start = end;
+  }
+  return slices;
+}
+
+/**
+ * Parse vertex data and faces of the slice, and keep all other lines for #OBJParser::parse.
+ * This does not access any parser state, so slices can be parsed in parallel.
+ */
+static void parse_slice(StringRef slice_str, ParsedSlice &r_slice)
+{
+  while (!slice_str.is_empty()) {
+    const StringRef line = read_next_line(slice_str);
+    const char *p = line.begin(), *end = line.end();
+    p = drop_whitespace(p, end);
+    r_slice.lines_num++;
+    if (p == end) {
+      continue;
+    }
+    /* Most common things that start with 'v': vertices, normals, UVs. */
+    if (*p == 'v') {
+      if (parse_keyword(p, end, "v")) {
+        slice_add_vertex(p, end, r_slice);
+      }
+      else if (parse_keyword(p, end, "vn")) {
+        slice_add_vertex_normal(p, end, r_slice);
+      }
+      else if (parse_keyword(p, end, "vt")) {
+        slice_add_uv_vertex(p, end, r_slice);
+      }
+    }
+    /* Faces. */
+    else if (parse_keyword(p, end, "f")) {
+      slice_add_face(p, end, r_slice);
+    }
+    /* Comments, except for the #MRGB vertex color extension. */
+    else if (*p == '#' && !StringRef(p, end).startswith("#MRGB")) {
+      /* Nothing to do. */
+    }
+    else {
+      ParsedSlice::Item item;
+      item.vertices_num = r_slice.vertices.size();
+      item.uv_vertices_num = r_slice.uv_vertices.size();
+      item.vert_normals_num = r_slice.vert_normals.size();
+      item.line = StringRef(p, end);
+      r_slice.items.append(item);
+    }
+  }
+}
+
+/**
+ * Moves vertex data of a parsed slice into the global vertices, up to the point where
+ * the slice's items need it. This way relative indices and #MRGB blocks are resolved
+ * against the same data as if the file was parsed line by line.
+ */
+class SliceMerger {
+  ParsedSlice &slice_;
+  GlobalVertices &global_vertices_;
+  int vertices_num_ = 0;
+  int uv_vertices_num_ = 0;
+  int vert_normals_num_ = 0;
+  int vertex_colors_num_ = 0;
+  int vertex_weights_num_ = 0;
+
+ public:
+  SliceMerger(ParsedSlice &slice, GlobalVertices &global_vertices)
+      : slice_(slice), global_vertices_(global_vertices)
+  {
+  }
+
+  void append_until(const ParsedSlice::Item &item)
+  {
+    this->append_vertices(item.vertices_num);
+    if (item.uv_vertices_num > uv_vertices_num_) {
+      global_vertices_.uv_vertices.extend(slice_.uv_vertices.as_span().slice(
+          IndexRange::from_begin_end(uv_vertices_num_, item.uv_vertices_num)));
+      uv_vertices_num_ = item.uv_vertices_num;
+    }
+    if (item.vert_normals_num > vert_normals_num_) {
+      global_vertices_.vert_normals.extend(slice_.vert_normals.as_span().slice(
+          IndexRange::from_begin_end(vert_normals_num_, item.vert_normals_num)));
+      vert_normals_num_ = item.vert_normals_num;
+    }
+  }
+
+  void append_all()
+  {
+    ParsedSlice::Item item;
+    item.vertices_num = slice_.vertices.size();
+    item.uv_vertices_num = slice_.uv_vertices.size();
+    item.vert_normals_num = slice_.vert_normals.size();
+    this->append_until(item);
+  }
+
+ private:
+  void append_vertices(const int vertices_num)
+  {
+    if (vertices_num <= vertices_num_) {
+      return;
+    }
+    /* A pending #MRGB block applies to the vertices before the next vertex. */
+    global_vertices_.flush_mrgb_block();
+    const int64_t global_start = global_vertices_.vertices.size() - vertices_num_;
+    global_vertices_.vertices.extend(
+        slice_.vertices.as_span().slice(IndexRange::from_begin_end(vertices_num_, vertices_num)));
+    vertices_num_ = vertices_num;
+
+    while (vertex_colors_num_ < slice_.vertex_colors.size() &&
+           slice_.vertex_colors[vertex_colors_num_].first < vertices_num)
+    {
+      const auto &[index, color] = slice_.vertex_colors[vertex_colors_num_++];
+      global_vertices_.set_vertex_color(global_start + index, color);
+    }
+    while (vertex_weights_num_ < slice_.vertex_weights.size() &&
+           slice_.vertex_weights[vertex_weights_num_].first < vertices_num)
+    {
+      const auto &[index, weight] = slice_.vertex_weights[vertex_weights_num_++];
+      global_vertices_.set_vertex_weight(global_start + index, weight);
+    }
+  }
+};
+
 /* Special case: if there were no faces/edges in any geometries,
  * treat all the vertices as a point cloud. */
 static void use_all_vertices_if_no_faces(Geometry *geom,
@@ -555,128 +768,121 @@ void OBJParser::parse(Vector<std::unique_ptr<Geometry>> &r_all_geometries,
     }
     ++last_nl;
 
-    /* Parse the buffer (until last newline) that we have so far,
-     * line by line. */
-    StringRef buffer_str{buffer.data(), int64_t(last_nl)};
-    while (!buffer_str.is_empty()) {
-      StringRef line = read_next_line(buffer_str);
-      const char *p = line.begin(), *end = line.end();
-      p = drop_whitespace(p, end);
-      ++line_number;
-      if (p == end) {
-        continue;
+    /* Parse the buffer (until last newline) that we have so far: split it into line-aligned
+     * slices that are parsed in parallel, then merge them in order. */
+    const Vector<StringRef> slice_strs = split_into_line_slices(
+        StringRef(buffer.data(), int64_t(last_nl)), parse_slice_size);
+    Array<ParsedSlice> slices(slice_strs.size());
+    threading::parallel_for(slices.index_range(), 1, [&](const IndexRange range) {
+      for (const int64_t i : range) {
+        parse_slice(slice_strs[i], slices[i]);
       }
-      /* Most common things that start with 'v': vertices, normals, UVs. */
-      if (*p == 'v') {
-        if (parse_keyword(p, end, "v")) {
-          geom_add_vertex(p, end, r_global_vertices);
-        }
-        else if (parse_keyword(p, end, "vn")) {
-          geom_add_vertex_normal(p, end, r_global_vertices);
+    });
+
+    for (ParsedSlice &slice : slices) {
+      SliceMerger merger{slice, r_global_vertices};
+      for (const ParsedSlice::Item &item : slice.items) {
+        merger.append_until(item);
+        if (item.is_face) {
+          /* If we don't have a material index assigned yet, get one.
+           * It means "usemtl" state came from the previous object. */
+          if (state_material_index == -1 && !state_material_name.empty() &&
+              curr_geom->material_indices_.is_empty())
+          {
+            curr_geom->material_indices_.add_new(state_material_name, 0);
+            curr_geom->material_order_.append(state_material_name);
+            state_material_index = 0;
+          }
+
+          geom_add_polygon(curr_geom,
+                           slice.face_corners.as_span().slice(item.corners),
+                           r_global_vertices,
+                           state_material_index,
+                           state_group_index,
+                           state_shaded_smooth);
+          continue;
         }
-        else if (parse_keyword(p, end, "vt")) {
-          geom_add_uv_vertex(p, end, r_global_vertices);
+
+        const char *p = item.line.begin(), *end = item.line.end();
+        /* Polylines. */
+        if (parse_keyword(p, end, "l")) {
+          geom_add_polyline(curr_geom, p, end, r_global_vertices);
         }
-      }
-      /* Faces. */
-      else if (parse_keyword(p, end, "f")) {
-        /* If we don't have a material index assigned yet, get one.
-         * It means "usemtl" state came from the previous object. */
-        if (state_material_index == -1 && !state_material_name.empty() &&
-            curr_geom->material_indices_.is_empty())
-        {
-          curr_geom->material_indices_.add_new(state_material_name, 0);
-          curr_geom->material_order_.append(state_material_name);
-          state_material_index = 0;
+        /* Objects. */
+        else if (parse_keyword(p, end, "o")) {
+          if (import_params_.use_split_objects) {
+            geom_new_object(p,
+                            end,
+                            state_shaded_smooth,
+                            state_group_name,
+                            state_material_index,
+                            curr_geom,
+                            r_all_geometries);
+          }
         }
-
-        geom_add_polygon(curr_geom,
-                         p,
-                         end,
-                         r_global_vertices,
-                         state_material_index,
-                         state_group_index,
-                         state_shaded_smooth);
-      }
-      /* Faces. */
-      else if (parse_keyword(p, end, "l")) {
-        geom_add_polyline(curr_geom, p, end, r_global_vertices);
-      }
-      /* Objects. */
-      else if (parse_keyword(p, end, "o")) {
-        if (import_params_.use_split_objects) {
-          geom_new_object(p,
-                          end,
-                          state_shaded_smooth,
-                          state_group_name,
-                          state_material_index,
-                          curr_geom,
-                          r_all_geometries);
+        /* Groups. */
+        else if (parse_keyword(p, end, "g")) {
+          if (import_params_.use_split_groups) {
+            geom_new_object(p,
+                            end,
+                            state_shaded_smooth,
+                            state_group_name,
+                            state_material_index,
+                            curr_geom,
+                            r_all_geometries);
+          }
+          else {
+            geom_update_group(StringRef(p, end).trim(), state_group_name);
+            int new_index = curr_geom->group_indices_.size();
+            state_group_index = curr_geom->group_indices_.lookup_or_add(state_group_name,
+                                                                        new_index);
+            if (new_index == state_group_index) {
+              curr_geom->group_order_.append(state_group_name);
+            }
+          }
         }
-      }
-      /* Groups. */
-      else if (parse_keyword(p, end, "g")) {
-        if (import_params_.use_split_groups) {
-          geom_new_object(p,
-                          end,
-                          state_shaded_smooth,
-                          state_group_name,
-                          state_material_index,
-                          curr_geom,
-                          r_all_geometries);
+        /* Smoothing groups. */
+        else if (parse_keyword(p, end, "s")) {
+          geom_update_smooth_group(p, end, state_shaded_smooth);
         }
-        else {
-          geom_update_group(StringRef(p, end).trim(), state_group_name);
-          int new_index = curr_geom->group_indices_.size();
-          state_group_index = curr_geom->group_indices_.lookup_or_add(state_group_name, new_index);
-          if (new_index == state_group_index) {
-            curr_geom->group_order_.append(state_group_name);
+        /* Materials and their libraries. */
+        else if (parse_keyword(p, end, "usemtl")) {
+          state_material_name = StringRef(p, end).trim();
+          int new_mat_index = curr_geom->material_indices_.size();
+          state_material_index = curr_geom->material_indices_.lookup_or_add(state_material_name,
+                                                                            new_mat_index);
+          if (new_mat_index == state_material_index) {
+            curr_geom->material_order_.append(state_material_name);
           }
         }
-      }
-      /* Smoothing groups. */
-      else if (parse_keyword(p, end, "s")) {
-        geom_update_smooth_group(p, end, state_shaded_smooth);
-      }
-      /* Materials and their libraries. */
-      else if (parse_keyword(p, end, "usemtl")) {
-        state_material_name = StringRef(p, end).trim();
-        int new_mat_index = curr_geom->material_indices_.size();
-        state_material_index = curr_geom->material_indices_.lookup_or_add(state_material_name,
-                                                                          new_mat_index);
-        if (new_mat_index == state_material_index) {
-          curr_geom->material_order_.append(state_material_name);
+        else if (parse_keyword(p, end, "mtllib")) {
+          add_mtl_library(StringRef(p, end).trim());
+        }
+        else if (parse_keyword(p, end, "#MRGB")) {
+          geom_add_mrgb_colors(p, end, r_global_vertices);
+        }
+        /* Curve related things. */
+        else if (parse_keyword(p, end, "cstype")) {
+          curr_geom = geom_set_curve_type(curr_geom, p, end, state_group_name, r_all_geometries);
+        }
+        else if (parse_keyword(p, end, "deg")) {
+          geom_set_curve_degree(curr_geom, p, end);
+        }
+        else if (parse_keyword(p, end, "curv")) {
+          geom_add_curve_vertex_indices(curr_geom, p, end, r_global_vertices);
+        }
+        else if (parse_keyword(p, end, "parm")) {
+          geom_add_curve_parameters(curr_geom, p, end);
+        }
+        else if (StringRef(p, end).startswith("end")) {
+          /* End of curve definition, nothing else to do. */
+        }
+        else {
+          CLOG_WARN(&LOG, "OBJ element not recognized: '%s'", std::string(p, end).c_str());
         }
       }
-      else if (parse_keyword(p, end, "mtllib")) {
-        add_mtl_library(StringRef(p, end).trim());
-      }
-      else if (parse_keyword(p, end, "#MRGB")) {
-        geom_add_mrgb_colors(p, end, r_global_vertices);
-      }
-      /* Comments. */
-      else if (*p == '#') {
-        /* Nothing to do. */
-      }
-      /* Curve related things. */
-      else if (parse_keyword(p, end, "cstype")) {
-        curr_geom = geom_set_curve_type(curr_geom, p, end, state_group_name, r_all_geometries);
-      }
-      else if (parse_keyword(p, end, "deg")) {
-        geom_set_curve_degree(curr_geom, p, end);
-      }
-      else if (parse_keyword(p, end, "curv")) {
-        geom_add_curve_vertex_indices(curr_geom, p, end, r_global_vertices);
-      }
-      else if (parse_keyword(p, end, "parm")) {
-        geom_add_curve_parameters(curr_geom, p, end);
-      }
-      else if (StringRef(p, end).startswith("end")) {
-        /* End of curve definition, nothing else to do. */
-      }
-      else {
-        CLOG_WARN(&LOG, "OBJ element not recognized: '%s'", std::string(p, end).c_str());
-      }
+      merger.append_all();
+      line_number += slice.lines_num;
     }
 
     /* We might have a line that was cut in the middle by the previous buffer;
@@ -235,6 +235,26 @@ parm u 0.0
   ASSERT_EQ(got_string, expected);
 }
 
+TEST(obj_exporter_writer, format_handler_vertex_rows_fill_blocks)
+{
+  /* Rows are much shorter than their worst case length, so they should fill the blocks instead of
+   * starting a new block for every batch of rows. */
+  FormatHandler h(1024);
+  const Vector<float3> positions(1000, float3(1.0f, -2.0f, 3.0f));
+  h.write_obj_vertices(positions);
+
+  const std::string row = "v 1.000000 -2.000000 3.000000\n";
+  const size_t expected_size = positions.size() * row.size();
+  std::string expected;
+  for (int64_t i = 0; i < positions.size(); i++) {
+    expected += row;
+  }
+  ASSERT_EQ(h.get_as_string(), expected);
+  /* Only the worst case length of one row can be left unused at the end of each block. */
+  const size_t max_row_len = float3_row_max_chars(2);
+  ASSERT_LE(h.get_block_count(), expected_size / (1024 - max_row_len) + 1);
+}
+
 /* Return true if string #a and string #b are equal after their first newline. */
 static bool strings_equal_after_first_lines(const std::string &a, const std::string &b)
 {
@@ -6,8 +6,13 @@
 
 #include "testing/testing.h"
 
+#include "BKE_appdir.hh"
+
+#include "BLI_fileops.h"
 #include "BLI_string.h"
 
+#include <fstream>
+
 #include "CLG_log.h"
 
 #include "obj_import_file_reader.hh"
@@ -45,4 +50,68 @@ TEST(obj_import, BufferRefillTest)
   CLG_exit();
 }
 
+/* The read buffer is split into line-aligned slices that are parsed in parallel; make sure that
+ * relative indices and object/material state are resolved the same regardless of how the file
+ * is split up. */
+TEST(obj_import, ParallelSlicesTest)
+{
+  CLG_init();
+  BKE_tempdir_init(nullptr);
+
+  const std::string obj_path = std::string(BKE_tempdir_session()) + SEP_STR "slices.obj";
+  {
+    std::ofstream file(obj_path);
+    for (int obj_i = 0; obj_i < 4; obj_i++) {
+      file << "o Grid" << obj_i << "\n";
+      file << "usemtl Material" << obj_i % 2 << "\n";
+      for (int quad_i = 0; quad_i < 1000; quad_i++) {
+        file << "v " << quad_i << " 0 " << obj_i << "\n";
+        file << "v " << quad_i + 1 << " 0 " << obj_i << "\n";
+        file << "v " << quad_i + 1 << " 1 " << obj_i << "\n";
+        file << "v " << quad_i << " 1 " << obj_i << " 1 0.5 0\n";
+        file << "vt 0 0\nvt 1 0\nvt 1 1\nvt 0 1\n";
+        file << "f -4/-4 -3/-3 -2/-2 -1/-1\n";
+      }
+    }
+  }
+
+  OBJImportParams params;
+  STRNCPY(params.filepath, obj_path.c_str());
+
+  Vector<std::unique_ptr<Geometry>> geometries_small;
+  GlobalVertices vertices_small;
+  OBJParser{params, 650}.parse(geometries_small, vertices_small);
+
+  Vector<std::unique_ptr<Geometry>> geometries_large;
+  GlobalVertices vertices_large;
+  OBJParser{params, 1024 * 1024}.parse(geometries_large, vertices_large);
+
+  ASSERT_EQ(4, geometries_small.size());
+  ASSERT_EQ(4, geometries_large.size());
+  EXPECT_EQ(16000, vertices_small.vertices.size());
+  EXPECT_EQ(16000, vertices_large.vertices.size());
+  EXPECT_EQ(vertices_small.vertices.as_span(), vertices_large.vertices.as_span());
+  EXPECT_EQ(vertices_small.uv_vertices.as_span(), vertices_large.uv_vertices.as_span());
+  EXPECT_EQ(vertices_small.vertex_colors.as_span(), vertices_large.vertex_colors.as_span());
+  for (const int i : geometries_small.index_range()) {
+    const Geometry &small = *geometries_small[i];
+    const Geometry &large = *geometries_large[i];
+    EXPECT_EQ(small.geometry_name_, large.geometry_name_);
+    EXPECT_EQ(small.material_order_, large.material_order_);
+    EXPECT_FALSE(large.has_invalid_faces_);
+    ASSERT_EQ(1000, large.face_elements_.size());
+    ASSERT_EQ(small.face_corners_.size(), large.face_corners_.size());
+    for (const int corner : large.face_corners_.index_range()) {
+      EXPECT_EQ(small.face_corners_[corner].vert_index, large.face_corners_[corner].vert_index);
+      EXPECT_EQ(small.face_corners_[corner].uv_vert_index,
+                large.face_corners_[corner].uv_vert_index);
+    }
+    EXPECT_EQ(i * 4000 + 3999, large.face_corners_.last().vert_index);
+  }
+
+  BLI_delete(obj_path.c_str(), false, false);
+  BKE_tempdir_session_purge();
+  CLG_exit();
+}
+
 }  // namespace blender::io::obj
@@ -29,6 +29,9 @@
     .handle_readers = NULL, \
     .use_prefetch = 1, \
     .prefetch_cache_size = 4096, \
+    .use_playback_prefetch = 0, \
+    .playback_prefetch_frames = 8, \
+    .playback_prefetch_cache_size = 2048, \
   }
 
 /** \} */
@@ -82,7 +82,8 @@ typedef struct CacheFile {
   /** The frame offset to subtract. */
   float frame_offset;
 
-  char _pad[4];
+  /** Amount of frames after the current frame to read ahead of time during playback. */
+  int playback_prefetch_frames;
 
   /** Animation flag. */
   short flag;
@@ -97,7 +98,10 @@ typedef struct CacheFile {
    */
   char use_render_procedural;
 
-  char _pad1[3];
+  /** Read upcoming frames of mesh caches on background threads during playback. */
+  char use_playback_prefetch;
+
+  char _pad1[2];
 
   /** Enable data prefetching when using the Cycles Procedural. */
   char use_prefetch;
@@ -114,6 +118,10 @@ typedef struct CacheFile {
   /* Name of the velocity property in the archive. */
   char velocity_name[64];
 
+  /** Size in megabytes of the memory used for frames read ahead of time during playback. */
+  int playback_prefetch_cache_size;
+  char _pad3[4];
+
   /* Runtime */
   struct CacheArchiveHandle *handle;
   char handle_filepath[1024];
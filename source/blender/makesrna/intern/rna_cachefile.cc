@@ -310,6 +310,28 @@ static void rna_def_cachefile(BlenderRNA *brna)
       "fit within the limit, rendering is aborted");
   RNA_def_property_update(prop, 0, "rna_CacheFile_update");
 
+  prop = RNA_def_property(srna, "use_playback_prefetch", PROP_BOOLEAN, PROP_NONE);
+  RNA_def_property_ui_text(prop,
+                           "Playback Prefetch",
+                           "Read the upcoming frames of meshes in the background during playback, "
+                           "to reduce the time spent waiting for the file");
+  RNA_def_property_update(prop, 0, "rna_CacheFile_update");
+
+  prop = RNA_def_property(srna, "playback_prefetch_frames", PROP_INT, PROP_NONE);
+  RNA_def_property_range(prop, 1, 250);
+  RNA_def_property_ui_text(
+      prop, "Prefetch Frames", "Amount of frames after the current frame to read ahead of time");
+  RNA_def_property_update(prop, 0, "rna_CacheFile_update");
+
+  prop = RNA_def_property(srna, "playback_prefetch_cache_size", PROP_INT, PROP_UNSIGNED);
+  RNA_def_property_range(prop, 1, INT_MAX);
+  RNA_def_property_ui_range(prop, 64, 65536, 64, -1);
+  RNA_def_property_ui_text(prop,
+                           "Prefetch Cache Size",
+                           "Memory usage limit in megabytes for the frames read ahead of time, "
+                           "the least recently used frames are freed when it is exceeded");
+  RNA_def_property_update(prop, 0, "rna_CacheFile_update");
+
   /* ----------------- Axis Conversion ----------------- */
 
   prop = RNA_def_property(srna, "forward_axis", PROP_ENUM, PROP_NONE);
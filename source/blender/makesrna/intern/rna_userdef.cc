@@ -7614,6 +7614,13 @@ static void rna_def_userdef_experimental(BlenderRNA *brna)
   RNA_def_property_ui_text(
       prop, "Bundle and Closure Nodes", "Enables bundle and closure nodes in Geometry Nodes");
 
+  prop = RNA_def_property(srna, "use_undo_skip_unchanged_ids", PROP_BOOLEAN, PROP_NONE);
+  RNA_def_property_ui_text(prop,
+                           "Skip Unchanged Data-Blocks in Undo",
+                           "Reuse the undo memory of data-blocks that were not tagged as changed "
+                           "since the last undo step instead of storing them again. Faster undo "
+                           "pushes, but changes that are not tagged properly may be lost on undo");
+
   prop = RNA_def_property(srna, "use_extensions_debug", PROP_BOOLEAN, PROP_NONE);
   RNA_def_property_ui_text(
       prop,
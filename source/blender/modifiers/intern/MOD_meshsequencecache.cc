@@ -11,6 +11,7 @@
 #include "BLI_math_vector.hh"
 #include "BLI_string.h"
 #include "BLI_utildefines.h"
+#include "BLI_vector.hh"
 
 #include "BLT_translation.hh"
 
@@ -36,6 +37,7 @@
 #include "RNA_access.hh"
 #include "RNA_prototypes.hh"
 
+#include "DEG_depsgraph.hh"
 #include "DEG_depsgraph_build.hh"
 #include "DEG_depsgraph_query.hh"
 
@@ -143,6 +145,30 @@ static bool can_use_mesh_for_orco_evaluation(MeshSeqCacheModifierData *mcmd,
   return false;
 }
 
+/**
+ * Times of the frames following the evaluated one, read in the background while the current
+ * frame is processed, so that playback doesn't have to wait for the file.
+ * Only the active depsgraph prefetches, render and baking evaluate frames in their own order.
+ */
+static Vector<double> playback_prefetch_times(const CacheFile *cache_file,
+                                              const ModifierEvalContext *ctx,
+                                              const float frame,
+                                              const double fps,
+                                              const double time_scale)
+{
+  Vector<double> times;
+  if (!cache_file->use_playback_prefetch || cache_file->is_sequence ||
+      cache_file->override_frame || (ctx->flag & MOD_APPLY_ORCO) ||
+      !DEG_is_active(ctx->depsgraph))
+  {
+    return times;
+  }
+  for (const int i : IndexRange(1, cache_file->playback_prefetch_frames)) {
+    times.append(BKE_cachefile_time_offset(cache_file, double(frame) + i, fps) * time_scale);
+  }
+  return times;
+}
+
 static Mesh *generate_bounding_box_mesh(const std::optional<Bounds<float3>> &bounds,
                                         Material **mat,
                                         short totcol)
@@ -221,6 +247,12 @@ static void modify_geometry_set(ModifierData *md,
   }
 #  endif
 
+  /* Frames that were read ahead of time are freed when prefetching is disabled. */
+  const int64_t prefetch_memory_limit = cache_file->use_playback_prefetch ?
+                                            int64_t(cache_file->playback_prefetch_cache_size) *
+                                                1024 * 1024 :
+                                            0;
+
   switch (cache_file->type) {
     case CACHEFILE_TYPE_ALEMBIC: {
 #  ifdef WITH_ALEMBIC
@@ -229,14 +261,24 @@ static void modify_geometry_set(ModifierData *md,
       params.read_flags = mcmd->read_flag;
       params.velocity_name = mcmd->cache_file->velocity_name;
       params.velocity_scale = velocity_scale;
+      const Vector<double> prefetch_times = playback_prefetch_times(
+          cache_file, ctx, frame, FPS, 1.0);
+      params.prefetch_times = prefetch_times.data();
+      params.prefetch_times_num = prefetch_times.size();
+      params.prefetch_memory_limit = prefetch_memory_limit;
       ABC_read_geometry(mcmd->reader, ctx->object, *geometry_set, &params, &err_str);
 #  endif
       break;
     }
     case CACHEFILE_TYPE_USD: {
 #  ifdef WITH_USD
-      const blender::io::usd::USDMeshReadParams params = blender::io::usd::create_mesh_read_params(
+      blender::io::usd::USDMeshReadParams params = blender::io::usd::create_mesh_read_params(
           time * FPS, mcmd->read_flag);
+      const Vector<double> prefetch_times = playback_prefetch_times(
+          cache_file, ctx, frame, FPS, FPS);
+      params.prefetch_times = prefetch_times.data();
+      params.prefetch_times_num = prefetch_times.size();
+      params.prefetch_memory_limit = prefetch_memory_limit;
       blender::io::usd::USD_read_geometry(
           mcmd->reader, ctx->object, *geometry_set, params, &err_str);
 #  endif
@@ -2,6 +2,7 @@
  *
  * SPDX-License-Identifier: GPL-2.0-or-later */
 
+#include "BLI_fileops.h"
 #include "BLI_listbase.h"
 #include "BLI_string.h"
 
@@ -21,6 +22,8 @@ static void node_declare(NodeDeclarationBuilder &b)
       .hide_label()
       .description("Path to a CSV file");
   b.add_input<decl::String>("Delimiter").default_value(",");
+  b.add_input<decl::Bool>("Compact Integers")
+      .description("Store integer columns with values that fit into 8 bits as 8-bit integers");
 
   b.add_output<decl::Geometry>("Point Cloud");
 }
@@ -49,7 +52,14 @@ static void node_geo_exec(GeoNodeExecParams params)
 
   blender::io::csv::CSVImportParams import_params{};
   import_params.delimiter = delimiter[0];
+  import_params.use_compact_integers = params.extract_input<bool>("Compact Integers");
   STRNCPY(import_params.filepath, path->c_str());
+  /* Stream large files, to avoid holding the whole file and all parsed values in memory at the
+   * same time. */
+  const size_t streaming_min_file_size = 256 * 1024 * 1024;
+  /* The size is -1 for missing files, the regular import reports those. */
+  const size_t file_size = BLI_file_size(import_params.filepath);
+  import_params.use_streaming = file_size != size_t(-1) && file_size >= streaming_min_file_size;
 
   ReportList reports;
   BKE_reports_init(&reports, RPT_STORE);
@@ -684,6 +684,13 @@ void Render::compositor_execute(const Scene &scene,
   }
 
   this->compositor->execute();
+
+  /* The profiler only outlives the execution, but cached results are freed later, so make sure
+   * they are not reported to the profiler once it is freed. */
+  if (profiler) {
+    input_data.profiler = nullptr;
+    this->compositor->update_input_data(input_data);
+  }
 }
 
 void Render::compositor_free()
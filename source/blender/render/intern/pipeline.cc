@@ -13,6 +13,7 @@
 #include <cstdlib>
 #include <cstring>
 #include <forward_list>
+#include <optional>
 
 #include "DNA_anim_types.h"
 #include "DNA_image_types.h"
@@ -64,6 +65,7 @@
 
 #include "COM_compositor.hh"
 #include "COM_context.hh"
+#include "COM_profiler.hh"
 #include "COM_render_context.hh"
 
 #include "DEG_depsgraph.hh"
@@ -1386,6 +1388,12 @@ static void do_render_compositor(Render *re)
                             blender::compositor::OutputTypes::Previews;
         }
 
+        /* Profile the compositor if requested from the command line. */
+        std::optional<blender::compositor::Profiler> profiler;
+        if (G.compositor_profile_filepath[0] != '\0') {
+          profiler.emplace();
+        }
+
         blender::compositor::RenderContext compositor_render_context;
         LISTBASE_FOREACH (RenderView *, rv, &re->result->views) {
           COM_execute(re,
@@ -1394,11 +1402,15 @@ static void do_render_compositor(Render *re)
                       ntree,
                       rv->name,
                       &compositor_render_context,
-                      nullptr,
+                      profiler ? &*profiler : nullptr,
                       needed_outputs);
         }
         compositor_render_context.save_file_outputs(re->pipeline_scene_eval);
 
+        if (profiler) {
+          profiler->write_chrome_trace(G.compositor_profile_filepath);
+        }
+
         ntree->runtime->stats_draw = nullptr;
         ntree->runtime->test_break = nullptr;
         ntree->runtime->progress = nullptr;
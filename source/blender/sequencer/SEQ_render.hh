@@ -20,9 +20,14 @@ struct StripElem;
 
 namespace blender::seq {
 
+/** Maximum amount of frames that prefetching renders at the same time. */
+constexpr int PREFETCH_RENDER_SLOTS_MAX = 16;
+
 enum eTaskId {
   SEQ_TASK_MAIN_RENDER,
+  /** First prefetch render slot, the other slots use the following IDs. */
   SEQ_TASK_PREFETCH_RENDER,
+  SEQ_TASK_NUM = SEQ_TASK_PREFETCH_RENDER + PREFETCH_RENDER_SLOTS_MAX,
 };
 
 struct RenderData {
@@ -6,9 +6,20 @@
  * \ingroup sequencer
  */
 
+#include <algorithm>
 #include <cstddef>
+#include <cstring>
 #include <ctime>
-#include <memory.h>
+#include <fcntl.h>
+#include <memory>
+#include <string>
+#include <zstd.h>
+
+#ifndef WIN32
+#  include <unistd.h>
+#else
+#  include <io.h>
+#endif
 
 #include "MEM_guardedalloc.h"
 
@@ -21,13 +32,17 @@
 #include "IMB_imbuf_types.hh"
 
 #include "BLI_endian_defines.h"
-#include "BLI_endian_switch.h"
 #include "BLI_fileops.h"
 #include "BLI_fileops_types.h"
-#include "BLI_listbase.h"
+#include "BLI_map.hh"
+#include "BLI_mmap.h"
 #include "BLI_path_utils.hh"
+#include "BLI_set.hh"
 #include "BLI_string.h"
+#include "BLI_struct_equality_utils.hh"
+#include "BLI_task.h"
 #include "BLI_threads.h"
+#include "BLI_vector.hh"
 
 #include "BKE_main.hh"
 
@@ -41,64 +56,167 @@
  * Disk Cache Design Notes
  * =======================
  *
- * Disk cache uses directory specified in user preferences
+ * Disk cache uses directory specified in user preferences.
  * For each cached non-temp image, image data and supplementary info are written to HDD.
- * Multiple(DCACHE_IMAGES_PER_FILE) images share the same file.
- * Each of these files contains header DiskCacheHeader followed by image data.
- * ZLIB compression with user definable level can be used to compress image data(per image)
- * Images are written in order in which they are rendered.
- * Overwriting of individual entry is not possible.
- * Stored images are deleted by invalidation, or when size of all files exceeds maximum
- * size specified in user preferences.
+ * All images of a strip are stored in a single pack file, the images are appended to it in the
+ * order in which they are rendered. Next to the pack file, an index file lists the position,
+ * size, color space and last use of every image in the pack file.
+ *
+ * The indices of all pack files in the cache directory are loaded once, when the first disk cache
+ * is created, and are shared by all scenes. Reading an image only looks it up in the index and
+ * copies it from the memory-mapped pack file. Images are compressed with ZSTD with user definable
+ * level on background threads, so rendering doesn't have to wait for the compression.
+ *
+ * The store mutex only protects the in-memory indices and is never held during file access. Each
+ * pack file has its own mutex, which serializes appending, reading and compacting that pack file,
+ * so that reading images of one strip doesn't wait for writes to another one. Index files are
+ * written in batches of appended images, and when images are removed.
+ *
+ * Overwriting of individual images is not possible, removed images leave unused space in the pack
+ * file until it is compacted. Stored images are removed by invalidation, or when size of all pack
+ * files exceeds maximum size specified in user preferences. In that case, the least recently used
+ * images are removed first. The last use is stored in the index, so it's kept across sessions.
  * To distinguish 2 blend files with same name, scene->ed->disk_cache_timestamp
  * is used as UID. Blend file can still be copied manually which may cause conflict.
  */
 
 namespace blender::seq {
 
-/* Format string:
- * `<cache type>-<resolution X>x<resolution Y>-<rendersize>%(<view_id>)-<frame no>.dcf`. */
-#define DCACHE_FNAME_FORMAT "%d-%dx%d-%d%%(%d)-%d.dcf"
-#define DCACHE_IMAGES_PER_FILE 100
-#define DCACHE_CURRENT_VERSION 2
+#define DCACHE_PACK_FILENAME "frames.dcpack"
+#define DCACHE_INDEX_FILENAME "frames.dcindex"
+#define DCACHE_INDEX_MAGIC "SDCI"
+#define DCACHE_CURRENT_VERSION 3
+/* Images that wait for compression at most, further images are written on the calling thread. */
+#define DCACHE_PENDING_WRITES_MAX 8
+/* Images appended to a pack file before its index file is written again. Images that are not in
+ * the index file yet are lost when Blender exits unexpectedly, their data is removed when the pack
+ * file is compacted. */
+#define DCACHE_INDEX_FLUSH_APPENDS 32
 #define COLORSPACE_NAME_MAX 64 /* XXX: defined in IMB intern. */
 
-struct DiskCacheHeaderEntry {
-  uchar encoding;
-  uint64_t frameno;
-  uint64_t size_compressed;
-  uint64_t size_raw;
+/** Identifies an image within the pack file of a strip. */
+struct DiskCacheEntryKey {
+  int32_t cache_type;
+  int32_t rectx;
+  int32_t recty;
+  int32_t render_size;
+  int32_t view_id;
+  float frame_index;
+
+  uint64_t hash() const
+  {
+    return get_default_hash(get_default_hash(cache_type, rectx, recty),
+                            get_default_hash(render_size, view_id, frame_index));
+  }
+
+  BLI_STRUCT_EQUALITY_OPERATORS_6(
+      DiskCacheEntryKey, cache_type, rectx, recty, render_size, view_id, frame_index)
+};
+
+/** Written to the index file as is, directly after #DiskCacheIndexHeader. */
+struct DiskCacheEntry {
   uint64_t offset;
+  uint64_t size_stored;
+  uint64_t size_raw;
+  /** Value of #DiskCacheStore::use_clock when the image was last written or read. */
+  uint64_t last_used;
+  DiskCacheEntryKey key;
+  int32_t is_float;
+  int32_t is_compressed;
   char colorspace_name[COLORSPACE_NAME_MAX];
 };
+static_assert(sizeof(DiskCacheEntry) == 128, "Index file entries must not contain padding");
+
+struct DiskCacheIndexHeader {
+  char magic[4];
+  int32_t version;
+  int32_t endian;
+  int32_t entries_num;
+  /**
+   * Size of the pack file when the index was written. When the pack file is smaller, it was
+   * compacted without updating the index and the offsets are wrong.
+   */
+  uint64_t pack_size;
+};
 
-struct DiskCacheHeader {
-  DiskCacheHeaderEntry entry[DCACHE_IMAGES_PER_FILE];
+/** Pack file of a strip and its index. */
+struct DiskCachePack {
+  char dirpath[FILE_MAX];
+
+  /* Members below are protected by the store mutex. */
+
+  Map<DiskCacheEntryKey, DiskCacheEntry> entries;
+  /** Images that are being appended to the pack file. The pack is not deleted while there are. */
+  Set<DiskCacheEntryKey> pending;
+  /** Size of the pack file, including the data of removed images. */
+  uint64_t file_size = 0;
+  /** Size of the data of the images in #entries. */
+  uint64_t live_size = 0;
+  /** The index file doesn't match #entries anymore. */
+  bool index_dirty = false;
+  /** Images appended since the index file was written. */
+  int unflushed_appends_num = 0;
+  /** The pack was removed from the store and its files are deleted. */
+  bool is_removed = false;
+
+  /**
+   * Serializes access to the pack and index files. It may be locked before the store mutex, but
+   * not while the store mutex is locked.
+   */
+  ThreadMutex file_mutex;
+  /** Protected by #file_mutex. */
+  BLI_mmap_file *mmap_file = nullptr;
+
+  DiskCachePack()
+  {
+    BLI_mutex_init(&file_mutex);
+  }
+
+  ~DiskCachePack()
+  {
+    if (mmap_file != nullptr) {
+      BLI_mmap_free(mmap_file);
+    }
+    BLI_mutex_end(&file_mutex);
+  }
+};
+
+/** Index of all pack files in the cache directory, shared by all scenes. */
+struct DiskCacheStore {
+  /** Shared, so that packs stay valid while their files are accessed without the mutex. */
+  Map<std::string, std::shared_ptr<DiskCachePack>> packs;
+  ThreadMutex mutex;
+  /** Size of all pack files. */
+  uint64_t size_total = 0;
+  uint64_t use_clock = 0;
+  /** Incremented by invalidation, so that pending writes of outdated images are discarded. */
+  uint64_t invalidation_count = 0;
+  /** A thread is removing images to fit the size limit. */
+  bool is_enforcing_limits = false;
+  TaskPool *write_pool = nullptr;
+  int pending_writes_num = 0;
+  int users = 0;
 };
 
 struct SeqDiskCache {
   Main *bmain;
   int64_t timestamp;
-  ListBase files;
-  ThreadMutex read_write_mutex;
-  size_t size_total;
+  DiskCacheStore *store;
 };
 
-struct DiskCacheFile {
-  DiskCacheFile *next, *prev;
-  char filepath[FILE_MAX];
-  char dir[FILE_MAXDIR];
-  char file[FILE_MAX];
-  BLI_stat_t fstat;
-  int cache_type;
-  int rectx;
-  int recty;
-  int render_size;
-  int view_id;
-  int start_frame;
+struct DiskCacheWriteTask {
+  DiskCacheStore *store;
+  char dirpath[FILE_MAX];
+  DiskCacheEntryKey key;
+  ImBuf *ibuf;
+  char colorspace_name[COLORSPACE_NAME_MAX];
+  int compression_level;
+  uint64_t invalidation_count;
 };
 
 static ThreadMutex cache_create_lock = BLI_MUTEX_INITIALIZER;
+/** Protected by #cache_create_lock. */
+static DiskCacheStore *disk_cache_store = nullptr;
 
 static const char *seq_disk_cache_base_dir()
 {
@@ -131,154 +249,15 @@ bool seq_disk_cache_is_enabled(Main *bmain)
           bmain->filepath[0] != '\0');
 }
 
-static DiskCacheFile *seq_disk_cache_add_file_to_list(SeqDiskCache *disk_cache,
-                                                      const char *filepath)
-{
-
-  DiskCacheFile *cache_file = MEM_callocN<DiskCacheFile>("SeqDiskCacheFile");
-  char dir[FILE_MAXDIR], file[FILE_MAX];
-  BLI_path_split_dir_file(filepath, dir, sizeof(dir), file, sizeof(file));
-  STRNCPY(cache_file->filepath, filepath);
-  STRNCPY(cache_file->dir, dir);
-  STRNCPY(cache_file->file, file);
-  sscanf(file,
-         DCACHE_FNAME_FORMAT,
-         &cache_file->cache_type,
-         &cache_file->rectx,
-         &cache_file->recty,
-         &cache_file->render_size,
-         &cache_file->view_id,
-         &cache_file->start_frame);
-  cache_file->start_frame *= DCACHE_IMAGES_PER_FILE;
-  BLI_addtail(&disk_cache->files, cache_file);
-  return cache_file;
-}
-
-static void seq_disk_cache_get_files(SeqDiskCache *disk_cache, const char *dirpath)
-{
-  direntry *filelist, *fl;
-  uint i;
-  disk_cache->size_total = 0;
-
-  const int filelist_num = BLI_filelist_dir_contents(dirpath, &filelist);
-  i = filelist_num;
-  fl = filelist;
-  while (i--) {
-    /* Don't follow links. */
-    const eFileAttributes file_attrs = BLI_file_attributes(fl->path);
-    if (file_attrs & FILE_ATTR_ANY_LINK) {
-      fl++;
-      continue;
-    }
-
-    char file[FILE_MAX];
-    BLI_path_split_file_part(fl->path, file, sizeof(file));
-
-    bool is_dir = BLI_is_dir(fl->path);
-    if (is_dir && !FILENAME_IS_CURRPAR(file)) {
-      char subpath[FILE_MAX];
-      STRNCPY(subpath, fl->path);
-      BLI_path_slash_ensure(subpath, sizeof(subpath));
-      seq_disk_cache_get_files(disk_cache, subpath);
-    }
-
-    if (!is_dir) {
-      const char *ext = BLI_path_extension(fl->path);
-      if (ext && ext[1] == 'd' && ext[2] == 'c' && ext[3] == 'f') {
-        DiskCacheFile *cache_file = seq_disk_cache_add_file_to_list(disk_cache, fl->path);
-        cache_file->fstat = fl->s;
-        disk_cache->size_total += cache_file->fstat.st_size;
-      }
-    }
-    fl++;
-  }
-  BLI_filelist_free(filelist, filelist_num);
-}
-
-static DiskCacheFile *seq_disk_cache_get_oldest_file(SeqDiskCache *disk_cache)
-{
-  DiskCacheFile *oldest_file = static_cast<DiskCacheFile *>(disk_cache->files.first);
-  if (oldest_file == nullptr) {
-    return nullptr;
-  }
-  for (DiskCacheFile *cache_file = oldest_file->next; cache_file; cache_file = cache_file->next) {
-    if (cache_file->fstat.st_mtime < oldest_file->fstat.st_mtime) {
-      oldest_file = cache_file;
-    }
-  }
-
-  return oldest_file;
-}
-
-static void seq_disk_cache_delete_file(SeqDiskCache *disk_cache, DiskCacheFile *file)
-{
-  disk_cache->size_total -= file->fstat.st_size;
-  BLI_delete(file->filepath, false, false);
-  BLI_remlink(&disk_cache->files, file);
-  MEM_freeN(file);
-}
-
-bool seq_disk_cache_enforce_limits(SeqDiskCache *disk_cache)
-{
-  BLI_mutex_lock(&disk_cache->read_write_mutex);
-  while (disk_cache->size_total > seq_disk_cache_size_limit()) {
-    DiskCacheFile *oldest_file = seq_disk_cache_get_oldest_file(disk_cache);
-
-    if (!oldest_file) {
-      /* We shouldn't enforce limits with no files, do re-scan. */
-      seq_disk_cache_get_files(disk_cache, seq_disk_cache_base_dir());
-      continue;
-    }
-
-    if (BLI_exists(oldest_file->filepath) == 0) {
-      /* File may have been manually deleted during runtime, do re-scan. */
-      BLI_freelistN(&disk_cache->files);
-      seq_disk_cache_get_files(disk_cache, seq_disk_cache_base_dir());
-      continue;
-    }
-
-    seq_disk_cache_delete_file(disk_cache, oldest_file);
-  }
-  BLI_mutex_unlock(&disk_cache->read_write_mutex);
-
-  return true;
-}
-
-static DiskCacheFile *seq_disk_cache_get_file_entry_by_path(SeqDiskCache *disk_cache,
-                                                            const char *filepath)
-{
-  DiskCacheFile *cache_file = static_cast<DiskCacheFile *>(disk_cache->files.first);
-
-  for (; cache_file; cache_file = cache_file->next) {
-    if (BLI_strcasecmp(cache_file->filepath, filepath) == 0) {
-      return cache_file;
-    }
-  }
-
-  return nullptr;
-}
-
-/* Update file size and timestamp. */
-static void seq_disk_cache_update_file(SeqDiskCache *disk_cache, const char *filepath)
+/** Normalize the directory path, so that it can be used to look up the pack file. */
+static void seq_disk_cache_dir_normalize(char *dirpath)
 {
-  DiskCacheFile *cache_file;
-  int64_t size_before;
-  int64_t size_after;
-
-  cache_file = seq_disk_cache_get_file_entry_by_path(disk_cache, filepath);
-  size_before = cache_file->fstat.st_size;
-
-  if (BLI_stat(filepath, &cache_file->fstat) == -1) {
-    BLI_assert(false);
-    memset(&cache_file->fstat, 0, sizeof(BLI_stat_t));
-  }
-
-  size_after = cache_file->fstat.st_size;
-  disk_cache->size_total += size_after - size_before;
+  BLI_path_normalize(dirpath);
+  BLI_path_slash_rstrip(dirpath);
 }
 
 /* Path format:
- * <cache dir>/<project name>_seq_cache/<scene name>-<timestamp>/<strip name>/DCACHE_FNAME_FORMAT
+ * <cache dir>/<project name>_seq_cache/<scene name>-<timestamp>/<strip name>/DCACHE_PACK_FILENAME
  */
 
 static void seq_disk_cache_get_project_dir(SeqDiskCache *disk_cache,
@@ -306,26 +285,19 @@ static void seq_disk_cache_get_dir(
   BLI_path_make_safe_filename(strip_name);
 
   BLI_path_join(dirpath, dirpath_maxncpy, project_dir, scene_name, strip_name);
+  seq_disk_cache_dir_normalize(dirpath);
 }
 
-static void seq_disk_cache_get_file_path(SeqDiskCache *disk_cache,
-                                         SeqCacheKey *key,
-                                         char *filepath,
-                                         size_t filepath_maxncpy)
+static DiskCacheEntryKey seq_disk_cache_entry_key(const SeqCacheKey *key)
 {
-  seq_disk_cache_get_dir(disk_cache, key->context.scene, key->strip, filepath, filepath_maxncpy);
-  int frameno = int(key->frame_index) / DCACHE_IMAGES_PER_FILE;
-  char cache_filename[FILE_MAXFILE];
-  SNPRINTF(cache_filename,
-           DCACHE_FNAME_FORMAT,
-           key->type,
-           key->context.rectx,
-           key->context.recty,
-           key->context.preview_render_size,
-           key->context.view_id,
-           frameno);
-
-  BLI_path_append(filepath, filepath_maxncpy, cache_filename);
+  DiskCacheEntryKey entry_key;
+  entry_key.cache_type = key->type;
+  entry_key.rectx = key->context.rectx;
+  entry_key.recty = key->context.recty;
+  entry_key.render_size = key->context.preview_render_size;
+  entry_key.view_id = key->context.view_id;
+  entry_key.frame_index = key->frame_index;
+  return entry_key;
 }
 
 static void seq_disk_cache_create_version_file(const char *filepath)
@@ -369,318 +341,826 @@ static void seq_disk_cache_handle_versioning(SeqDiskCache *disk_cache)
   }
 }
 
-static void seq_disk_cache_delete_invalid_files(SeqDiskCache *disk_cache,
-                                                Scene *scene,
-                                                Strip *strip,
-                                                int invalidate_types,
-                                                int range_start,
-                                                int range_end)
+static void seq_disk_cache_pack_file_path(const DiskCachePack *pack,
+                                          const char *filename,
+                                          char *filepath,
+                                          size_t filepath_maxncpy)
 {
-  DiskCacheFile *next_file, *cache_file = static_cast<DiskCacheFile *>(disk_cache->files.first);
-  char cache_dir[FILE_MAX];
-  seq_disk_cache_get_dir(disk_cache, scene, strip, cache_dir, sizeof(cache_dir));
-  BLI_path_slash_ensure(cache_dir, sizeof(cache_dir));
-
-  while (cache_file) {
-    next_file = cache_file->next;
-    if (cache_file->cache_type & invalidate_types) {
-      if (STREQ(cache_dir, cache_file->dir)) {
-        const int timeline_frame_start = cache_file->start_frame + time_start_frame_get(strip);
-        if (timeline_frame_start > range_start && timeline_frame_start <= range_end) {
-          seq_disk_cache_delete_file(disk_cache, cache_file);
-        }
-      }
-    }
-    cache_file = next_file;
-  }
+  BLI_path_join(filepath, filepath_maxncpy, pack->dirpath, filename);
 }
 
-void seq_disk_cache_invalidate(SeqDiskCache *disk_cache,
-                               Scene *scene,
-                               Strip *strip,
-                               Strip *strip_changed,
-                               int invalidate_types)
+static void seq_disk_cache_pack_release_mmap(DiskCachePack *pack)
 {
-  int start;
-  int end;
-
-  BLI_mutex_lock(&disk_cache->read_write_mutex);
+  if (pack->mmap_file != nullptr) {
+    BLI_mmap_free(pack->mmap_file);
+    pack->mmap_file = nullptr;
+  }
+}
 
-  start = time_left_handle_frame_get(scene, strip_changed) - DCACHE_IMAGES_PER_FILE;
-  end = time_right_handle_frame_get(scene, strip_changed);
+/* Map the pack file. The mapping is recreated when images were appended past its end. */
+static bool seq_disk_cache_pack_ensure_mmap(DiskCachePack *pack, const uint64_t size)
+{
+  if (pack->mmap_file != nullptr && BLI_mmap_get_length(pack->mmap_file) >= size) {
+    return true;
+  }
+  seq_disk_cache_pack_release_mmap(pack);
 
-  seq_disk_cache_delete_invalid_files(disk_cache, scene, strip, invalidate_types, start, end);
+  char filepath[FILE_MAX];
+  seq_disk_cache_pack_file_path(pack, DCACHE_PACK_FILENAME, filepath, sizeof(filepath));
+  const int file = BLI_open(filepath, O_BINARY | O_RDONLY, 0);
+  if (file == -1) {
+    return false;
+  }
+  /* The mapping stays valid after the file is closed. */
+  pack->mmap_file = BLI_mmap_open(file);
+  close(file);
 
-  BLI_mutex_unlock(&disk_cache->read_write_mutex);
+  return pack->mmap_file != nullptr && BLI_mmap_get_length(pack->mmap_file) >= size;
 }
 
-static size_t deflate_imbuf_to_file(ImBuf *ibuf,
-                                    FILE *file,
-                                    int level,
-                                    DiskCacheHeaderEntry *header_entry)
+static bool seq_disk_cache_index_write(const DiskCachePack *pack,
+                                       const Span<DiskCacheEntry> entries,
+                                       const uint64_t pack_size)
 {
-  void *data = (ibuf->byte_buffer.data != nullptr) ? (void *)ibuf->byte_buffer.data :
-                                                     (void *)ibuf->float_buffer.data;
+  char filepath[FILE_MAX];
+  char filepath_temp[FILE_MAX];
+  seq_disk_cache_pack_file_path(pack, DCACHE_INDEX_FILENAME, filepath, sizeof(filepath));
+  SNPRINTF(filepath_temp, "%s@", filepath);
 
-  /* Apply compression if wanted, otherwise just write directly to the file. */
-  if (level > 0) {
-    return BLI_file_zstd_from_mem_at_pos(
-        data, header_entry->size_raw, file, header_entry->offset, level);
+  /* Write to a temporary file first, so that the index is never partially written. */
+  FILE *file = BLI_fopen(filepath_temp, "wb");
+  if (!file) {
+    return false;
   }
 
-  fseek(file, header_entry->offset, SEEK_SET);
-  return fwrite(data, 1, header_entry->size_raw, file);
+  DiskCacheIndexHeader header = {};
+  memcpy(header.magic, DCACHE_INDEX_MAGIC, sizeof(header.magic));
+  header.version = DCACHE_CURRENT_VERSION;
+  header.endian = ENDIAN_ORDER;
+  header.entries_num = int32_t(entries.size());
+  header.pack_size = pack_size;
+
+  bool success = fwrite(&header, sizeof(header), 1, file) == 1;
+  success = success && (entries.is_empty() || fwrite(entries.data(),
+                                                      sizeof(DiskCacheEntry),
+                                                      size_t(entries.size()),
+                                                      file) == size_t(entries.size()));
+  success = (fclose(file) == 0) && success;
+
+  if (!success || BLI_rename_overwrite(filepath_temp, filepath) != 0) {
+    BLI_delete(filepath_temp, false, false);
+    return false;
+  }
+  return true;
 }
 
-static size_t inflate_file_to_imbuf(ImBuf *ibuf, FILE *file, DiskCacheHeaderEntry *header_entry)
+/** Must be called with the store mutex locked. */
+static Vector<DiskCacheEntry> seq_disk_cache_pack_entries_copy(const DiskCachePack *pack)
 {
-  void *data = (ibuf->byte_buffer.data != nullptr) ? (void *)ibuf->byte_buffer.data :
-                                                     (void *)ibuf->float_buffer.data;
-  char header[4];
-  fseek(file, header_entry->offset, SEEK_SET);
-  if (fread(header, 1, sizeof(header), file) != sizeof(header)) {
-    return 0;
+  Vector<DiskCacheEntry> entries;
+  entries.reserve(pack->entries.size());
+  for (const DiskCacheEntry &entry : pack->entries.values()) {
+    entries.append(entry);
   }
+  return entries;
+}
 
-  /* Check if the data is compressed or raw. */
-  if (BLI_file_magic_is_zstd(header)) {
-    return BLI_file_unzstd_to_mem_at_pos(data, header_entry->size_raw, file, header_entry->offset);
+/**
+ * Write the index file of the pack if it doesn't match the entries anymore. The entries are copied
+ * with the store mutex locked, the file is written without it. Must be called with the file mutex
+ * of the pack locked.
+ */
+static void seq_disk_cache_pack_flush_index(DiskCacheStore *store, DiskCachePack *pack)
+{
+  BLI_mutex_lock(&store->mutex);
+  if (!pack->index_dirty || pack->is_removed) {
+    BLI_mutex_unlock(&store->mutex);
+    return;
+  }
+  const Vector<DiskCacheEntry> entries = seq_disk_cache_pack_entries_copy(pack);
+  const uint64_t pack_size = pack->file_size;
+  pack->index_dirty = false;
+  pack->unflushed_appends_num = 0;
+  BLI_mutex_unlock(&store->mutex);
+
+  if (!seq_disk_cache_index_write(pack, entries, pack_size)) {
+    BLI_mutex_lock(&store->mutex);
+    pack->index_dirty = true;
+    BLI_mutex_unlock(&store->mutex);
   }
-
-  fseek(file, header_entry->offset, SEEK_SET);
-  return fread(data, 1, header_entry->size_raw, file);
 }
 
-static bool seq_disk_cache_read_header(FILE *file, DiskCacheHeader *header)
+static std::shared_ptr<DiskCachePack> seq_disk_cache_index_read(const char *dirpath)
 {
-  BLI_fseek(file, 0LL, SEEK_SET);
-  const size_t num_items_read = fread(header, sizeof(*header), 1, file);
-  if (num_items_read < 1) {
-    BLI_assert_msg(0, "unable to read disk cache header");
-    perror("unable to read disk cache header");
-    return false;
+  std::shared_ptr<DiskCachePack> pack = std::make_shared<DiskCachePack>();
+  STRNCPY(pack->dirpath, dirpath);
+
+  char index_path[FILE_MAX];
+  char pack_path[FILE_MAX];
+  seq_disk_cache_pack_file_path(pack.get(), DCACHE_INDEX_FILENAME, index_path, sizeof(index_path));
+  seq_disk_cache_pack_file_path(pack.get(), DCACHE_PACK_FILENAME, pack_path, sizeof(pack_path));
+
+  BLI_stat_t pack_stat;
+  if (BLI_stat(pack_path, &pack_stat) == -1) {
+    return nullptr;
+  }
+  pack->file_size = uint64_t(pack_stat.st_size);
+
+  FILE *file = BLI_fopen(index_path, "rb");
+  if (!file) {
+    return nullptr;
   }
 
-  for (int i = 0; i < DCACHE_IMAGES_PER_FILE; i++) {
-    if ((ENDIAN_ORDER == B_ENDIAN) && header->entry[i].encoding == 0) {
-      BLI_endian_switch_uint64(&header->entry[i].frameno);
-      BLI_endian_switch_uint64(&header->entry[i].offset);
-      BLI_endian_switch_uint64(&header->entry[i].size_compressed);
-      BLI_endian_switch_uint64(&header->entry[i].size_raw);
+  DiskCacheIndexHeader header;
+  bool success = fread(&header, sizeof(header), 1, file) == 1 &&
+                 memcmp(header.magic, DCACHE_INDEX_MAGIC, sizeof(header.magic)) == 0 &&
+                 header.version == DCACHE_CURRENT_VERSION && header.endian == ENDIAN_ORDER &&
+                 header.entries_num >= 0 && header.pack_size <= pack->file_size;
+
+  for (int i = 0; success && i < header.entries_num; i++) {
+    DiskCacheEntry entry;
+    if (fread(&entry, sizeof(entry), 1, file) != 1) {
+      success = false;
+      break;
     }
+    /* Skip images of which the data was not completely written. */
+    if (entry.offset + entry.size_stored > header.pack_size) {
+      continue;
+    }
+    entry.colorspace_name[COLORSPACE_NAME_MAX - 1] = '\0';
+    if (pack->entries.add(entry.key, entry)) {
+      pack->live_size += entry.size_stored;
+    }
+  }
+  fclose(file);
+
+  if (!success) {
+    return nullptr;
   }
+  return pack;
+}
 
-  return true;
+/** Must be called with the store mutex locked. */
+static void seq_disk_cache_pack_remove_entry(DiskCachePack *pack, const DiskCacheEntryKey &key)
+{
+  if (const std::optional<DiskCacheEntry> entry = pack->entries.pop_try(key)) {
+    pack->live_size -= entry->size_stored;
+    pack->index_dirty = true;
+  }
 }
 
-static size_t seq_disk_cache_write_header(FILE *file, const DiskCacheHeader *header)
+/**
+ * Delete the pack file and its index and remove the pack from the store, unless images were added
+ * to it in the meantime. Must be called with the file mutex of the pack locked, the caller keeps
+ * the pack alive.
+ */
+static void seq_disk_cache_pack_delete_if_empty(DiskCacheStore *store, DiskCachePack *pack)
 {
-  BLI_fseek(file, 0LL, SEEK_SET);
-  return fwrite(header, sizeof(*header), 1, file);
+  seq_disk_cache_pack_release_mmap(pack);
+
+  BLI_mutex_lock(&store->mutex);
+  if (pack->is_removed || !pack->entries.is_empty() || !pack->pending.is_empty()) {
+    BLI_mutex_unlock(&store->mutex);
+    return;
+  }
+  /* Delete the files before unlocking, so that a new pack for the same strip starts with an empty
+   * file. */
+  char filepath[FILE_MAX];
+  seq_disk_cache_pack_file_path(pack, DCACHE_INDEX_FILENAME, filepath, sizeof(filepath));
+  BLI_delete(filepath, false, false);
+  seq_disk_cache_pack_file_path(pack, DCACHE_PACK_FILENAME, filepath, sizeof(filepath));
+  BLI_delete(filepath, false, false);
+
+  pack->is_removed = true;
+  store->size_total -= pack->file_size;
+  pack->file_size = 0;
+  store->packs.remove(pack->dirpath);
+  BLI_mutex_unlock(&store->mutex);
 }
 
-static int seq_disk_cache_add_header_entry(const SeqCacheKey *key,
-                                           ImBuf *ibuf,
-                                           DiskCacheHeader *header)
+/**
+ * Rewrite the pack file with only the data of the images in the index, or delete it when there
+ * are none. Only the file mutex of the pack is locked while copying the data, so the other packs
+ * can still be read and written.
+ */
+static void seq_disk_cache_pack_compact(DiskCacheStore *store, DiskCachePack *pack)
 {
-  int i;
-  uint64_t offset = sizeof(*header);
+  BLI_mutex_lock(&pack->file_mutex);
+
+  /* Images are only added with the file mutex locked, so the entries can only get fewer while
+   * compacting. */
+  BLI_mutex_lock(&store->mutex);
+  const Vector<DiskCacheEntry> entries = seq_disk_cache_pack_entries_copy(pack);
+  const uint64_t file_size = pack->file_size;
+  const bool is_removed = pack->is_removed;
+  BLI_mutex_unlock(&store->mutex);
+
+  if (is_removed) {
+    BLI_mutex_unlock(&pack->file_mutex);
+    return;
+  }
 
-  /* Lookup free entry, get offset for new data. */
-  for (i = 0; i < DCACHE_IMAGES_PER_FILE; i++) {
-    if (header->entry[i].size_compressed == 0) {
-      break;
+  const bool is_mapped = !entries.is_empty() && seq_disk_cache_pack_ensure_mmap(pack, file_size);
+  if (!entries.is_empty() && !is_mapped) {
+    /* The pack file was modified externally, none of its images can be used. */
+    BLI_mutex_lock(&store->mutex);
+    for (const DiskCacheEntry &entry : entries) {
+      seq_disk_cache_pack_remove_entry(pack, entry.key);
     }
+    BLI_mutex_unlock(&store->mutex);
+  }
+  if (!is_mapped) {
+    seq_disk_cache_pack_delete_if_empty(store, pack);
+    BLI_mutex_unlock(&pack->file_mutex);
+    return;
   }
 
-  /* Attempt to write beyond set entry limit.
-   * Reset file header and start writing from beginning.
-   */
-  if (i == DCACHE_IMAGES_PER_FILE) {
-    i = 0;
-    memset(header, 0, sizeof(*header));
+  char filepath[FILE_MAX];
+  char filepath_temp[FILE_MAX];
+  seq_disk_cache_pack_file_path(pack, DCACHE_PACK_FILENAME, filepath, sizeof(filepath));
+  SNPRINTF(filepath_temp, "%s@", filepath);
+
+  FILE *file = BLI_fopen(filepath_temp, "wb");
+  if (!file) {
+    BLI_mutex_unlock(&pack->file_mutex);
+    return;
   }
 
-  /* Calculate offset for image data. */
-  if (i > 0) {
-    offset = header->entry[i - 1].offset + header->entry[i - 1].size_compressed;
+  const char *data = static_cast<const char *>(BLI_mmap_get_pointer(pack->mmap_file));
+  Map<DiskCacheEntryKey, uint64_t> new_offsets;
+  uint64_t offset = 0;
+  bool success = true;
+  for (const DiskCacheEntry &entry : entries) {
+    success = success && fwrite(data + entry.offset, 1, entry.size_stored, file) ==
+                             entry.size_stored;
+    new_offsets.add_new(entry.key, offset);
+    offset += entry.size_stored;
   }
+  success = (fclose(file) == 0) && success && !BLI_mmap_any_io_error(pack->mmap_file);
 
-  if (ENDIAN_ORDER == B_ENDIAN) {
-    header->entry[i].encoding = 255;
+  /* The mapping has to be released before the file can be replaced on Windows. */
+  seq_disk_cache_pack_release_mmap(pack);
+
+  if (!success || BLI_rename_overwrite(filepath_temp, filepath) != 0) {
+    BLI_delete(filepath_temp, false, false);
+    BLI_mutex_unlock(&pack->file_mutex);
+    return;
   }
-  else {
-    header->entry[i].encoding = 0;
+
+  /* Images removed while compacting are still in the new file, they are counted as unused space
+   * until the next compaction. */
+  BLI_mutex_lock(&store->mutex);
+  for (DiskCacheEntry &entry : pack->entries.values()) {
+    entry.offset = new_offsets.lookup(entry.key);
   }
+  store->size_total -= pack->file_size - offset;
+  pack->file_size = offset;
+  pack->index_dirty = true;
+  BLI_mutex_unlock(&store->mutex);
 
-  header->entry[i].offset = offset;
-  header->entry[i].frameno = key->frame_index;
+  seq_disk_cache_pack_flush_index(store, pack);
+  BLI_mutex_unlock(&pack->file_mutex);
+}
 
-  /* Store colorspace name of ibuf. */
-  const char *colorspace_name;
-  if (ibuf->byte_buffer.data) {
-    header->entry[i].size_raw = int64_t(ibuf->x) * ibuf->y * ibuf->channels;
-    colorspace_name = IMB_colormanagement_get_rect_colorspace(ibuf);
+static void seq_disk_cache_load_pack(DiskCacheStore *store, const char *dirpath)
+{
+  std::shared_ptr<DiskCachePack> pack = seq_disk_cache_index_read(dirpath);
+  if (!pack) {
+    /* The files are from an interrupted write or were modified externally, they can't be used. */
+    char filepath[FILE_MAX];
+    BLI_path_join(filepath, sizeof(filepath), dirpath, DCACHE_INDEX_FILENAME);
+    BLI_delete(filepath, false, false);
+    BLI_path_join(filepath, sizeof(filepath), dirpath, DCACHE_PACK_FILENAME);
+    BLI_delete(filepath, false, false);
+    return;
   }
-  else {
-    header->entry[i].size_raw = int64_t(ibuf->x) * ibuf->y * ibuf->channels * 4;
-    colorspace_name = IMB_colormanagement_get_float_colorspace(ibuf);
+
+  for (const DiskCacheEntry &entry : pack->entries.values()) {
+    store->use_clock = std::max(store->use_clock, entry.last_used);
   }
-  STRNCPY(header->entry[i].colorspace_name, colorspace_name);
+  store->size_total += pack->file_size;
+  std::string key = pack->dirpath;
+  store->packs.add_overwrite(std::move(key), std::move(pack));
+}
 
-  return i;
+static void seq_disk_cache_load_packs(DiskCacheStore *store, const char *dirpath)
+{
+  direntry *filelist;
+  const int filelist_num = BLI_filelist_dir_contents(dirpath, &filelist);
+  for (int i = 0; i < filelist_num; i++) {
+    const char *path = filelist[i].path;
+    /* Don't follow links. */
+    const eFileAttributes file_attrs = BLI_file_attributes(path);
+    if (file_attrs & FILE_ATTR_ANY_LINK) {
+      continue;
+    }
+
+    char file[FILE_MAX];
+    BLI_path_split_file_part(path, file, sizeof(file));
+
+    if (BLI_is_dir(path)) {
+      if (!FILENAME_IS_CURRPAR(file)) {
+        char subpath[FILE_MAX];
+        STRNCPY(subpath, path);
+        BLI_path_slash_ensure(subpath, sizeof(subpath));
+        seq_disk_cache_load_packs(store, subpath);
+      }
+      continue;
+    }
+
+    if (STREQ(file, DCACHE_INDEX_FILENAME)) {
+      char pack_dirpath[FILE_MAX];
+      BLI_path_split_dir_part(path, pack_dirpath, sizeof(pack_dirpath));
+      seq_disk_cache_dir_normalize(pack_dirpath);
+      seq_disk_cache_load_pack(store, pack_dirpath);
+    }
+    else if (BLI_path_extension_check(file, ".dcf")) {
+      /* Image files of older versions, which stored up to 100 images per file. */
+      BLI_delete(path, false, false);
+    }
+  }
+  BLI_filelist_free(filelist, filelist_num);
 }
 
-static int seq_disk_cache_get_header_entry(const SeqCacheKey *key, const DiskCacheHeader *header)
+/**
+ * Remove the least recently used images when the cache is larger than the size limit and compact
+ * the pack files. Must be called without any mutex locked.
+ */
+static void seq_disk_cache_store_enforce_limits(DiskCacheStore *store)
 {
-  for (int i = 0; i < DCACHE_IMAGES_PER_FILE; i++) {
-    if (header->entry[i].frameno == key->frame_index) {
-      return i;
+  const uint64_t size_limit = seq_disk_cache_size_limit();
+
+  BLI_mutex_lock(&store->mutex);
+  if (store->size_total <= size_limit || store->is_enforcing_limits) {
+    BLI_mutex_unlock(&store->mutex);
+    return;
+  }
+  store->is_enforcing_limits = true;
+
+  /* Remove images until the cache is a bit smaller than the limit, so that the pack files don't
+   * have to be compacted after every write. */
+  const uint64_t size_target = size_limit - size_limit / 10;
+
+  struct LRUItem {
+    uint64_t last_used;
+    DiskCachePack *pack;
+    DiskCacheEntryKey key;
+  };
+  Vector<LRUItem> items;
+  uint64_t size_live = 0;
+  for (const std::shared_ptr<DiskCachePack> &pack : store->packs.values()) {
+    size_live += pack->live_size;
+    for (const DiskCacheEntry &entry : pack->entries.values()) {
+      items.append({entry.last_used, pack.get(), entry.key});
+    }
+  }
+  std::sort(items.begin(), items.end(), [](const LRUItem &a, const LRUItem &b) {
+    return a.last_used < b.last_used;
+  });
+  for (const LRUItem &item : items) {
+    if (size_live <= size_target) {
+      break;
+    }
+    size_live -= item.pack->entries.lookup(item.key).size_stored;
+    seq_disk_cache_pack_remove_entry(item.pack, item.key);
+  }
+
+  Vector<std::shared_ptr<DiskCachePack>> packs_to_compact;
+  for (const std::shared_ptr<DiskCachePack> &pack : store->packs.values()) {
+    if (pack->file_size > pack->live_size) {
+      packs_to_compact.append(pack);
     }
   }
+  BLI_mutex_unlock(&store->mutex);
 
-  return -1;
+  /* Reclaim the space of the removed images. */
+  for (const std::shared_ptr<DiskCachePack> &pack : packs_to_compact) {
+    seq_disk_cache_pack_compact(store, pack.get());
+  }
+
+  BLI_mutex_lock(&store->mutex);
+  store->is_enforcing_limits = false;
+  BLI_mutex_unlock(&store->mutex);
 }
 
-bool seq_disk_cache_write_file(SeqDiskCache *disk_cache, SeqCacheKey *key, ImBuf *ibuf)
+bool seq_disk_cache_enforce_limits(SeqDiskCache *disk_cache)
 {
-  BLI_mutex_lock(&disk_cache->read_write_mutex);
+  seq_disk_cache_store_enforce_limits(disk_cache->store);
+  return true;
+}
 
-  char filepath[FILE_MAX];
+void seq_disk_cache_invalidate(SeqDiskCache *disk_cache,
+                               Scene *scene,
+                               Strip *strip,
+                               Strip *strip_changed,
+                               int invalidate_types)
+{
+  DiskCacheStore *store = disk_cache->store;
+  char dirpath[FILE_MAX];
+  seq_disk_cache_get_dir(disk_cache, scene, strip, dirpath, sizeof(dirpath));
+
+  const int range_start = time_left_handle_frame_get(scene, strip_changed);
+  const int range_end = time_right_handle_frame_get(scene, strip_changed);
+  const int strip_start = time_start_frame_get(strip);
+
+  BLI_mutex_lock(&store->mutex);
+
+  /* Images that are still waiting for compression may be outdated now. */
+  store->invalidation_count++;
+
+  std::shared_ptr<DiskCachePack> pack;
+  bool needs_compaction = false;
+  if (const std::shared_ptr<DiskCachePack> *pack_ptr = store->packs.lookup_ptr(dirpath)) {
+    const int64_t removed_num = (*pack_ptr)->entries.remove_if([&](const auto item) {
+      const int timeline_frame = int(item.key.frame_index) + strip_start;
+      if ((item.key.cache_type & invalidate_types) && timeline_frame >= range_start &&
+          timeline_frame <= range_end)
+      {
+        (*pack_ptr)->live_size -= item.value.size_stored;
+        return true;
+      }
+      return false;
+    });
+
+    if (removed_num > 0) {
+      pack = *pack_ptr;
+      pack->index_dirty = true;
+      needs_compaction = pack->live_size < pack->file_size / 2;
+    }
+  }
+
+  BLI_mutex_unlock(&store->mutex);
 
-  seq_disk_cache_get_file_path(disk_cache, key, filepath, sizeof(filepath));
+  if (!pack) {
+    return;
+  }
+  /* The index file is updated right away, so that invalidated images are never read from it. */
+  if (needs_compaction) {
+    seq_disk_cache_pack_compact(store, pack.get());
+  }
+  else {
+    BLI_mutex_lock(&pack->file_mutex);
+    seq_disk_cache_pack_flush_index(store, pack.get());
+    BLI_mutex_unlock(&pack->file_mutex);
+  }
+}
+
+/**
+ * Append the image to the pack file and add it to the index. Must be called with the file mutex of
+ * the pack locked, and with the image in the pending images of the pack.
+ */
+static bool seq_disk_cache_pack_append(DiskCacheStore *store,
+                                       DiskCachePack *pack,
+                                       const DiskCacheWriteTask &task,
+                                       const void *data,
+                                       const uint64_t size_stored,
+                                       const uint64_t size_raw,
+                                       const bool is_compressed)
+{
+  char filepath[FILE_MAX];
+  seq_disk_cache_pack_file_path(pack, DCACHE_PACK_FILENAME, filepath, sizeof(filepath));
   BLI_file_ensure_parent_dir_exists(filepath);
 
-  /* Touch the file. */
-  FILE *file = BLI_fopen(filepath, "rb+");
-  if (!file) {
-    file = BLI_fopen(filepath, "wb+");
-    if (!file) {
-      BLI_mutex_unlock(&disk_cache->read_write_mutex);
-      return false;
+  int64_t offset = -1;
+  bool success = false;
+  if (FILE *file = BLI_fopen(filepath, "ab")) {
+    BLI_fseek(file, 0LL, SEEK_END);
+    offset = BLI_ftell(file);
+    success = offset >= 0 && fwrite(data, 1, size_stored, file) == size_stored;
+    success = (fclose(file) == 0) && success;
+  }
+
+  /* Data of failed writes is counted too, it's removed when the pack file is compacted. */
+  BLI_stat_t file_stat;
+  const bool has_file_size = BLI_stat(filepath, &file_stat) != -1;
+
+  BLI_mutex_lock(&store->mutex);
+  pack->pending.remove(task.key);
+  const uint64_t file_size = has_file_size ? uint64_t(file_stat.st_size) : pack->file_size;
+  store->size_total += file_size - pack->file_size;
+  pack->file_size = file_size;
+
+  success = success && uint64_t(offset) + size_stored <= file_size &&
+            task.invalidation_count == store->invalidation_count;
+  if (success) {
+    DiskCacheEntry entry = {};
+    entry.offset = uint64_t(offset);
+    entry.size_stored = size_stored;
+    entry.size_raw = size_raw;
+    entry.last_used = ++store->use_clock;
+    entry.key = task.key;
+    entry.is_float = task.ibuf->byte_buffer.data == nullptr;
+    entry.is_compressed = is_compressed;
+    STRNCPY(entry.colorspace_name, task.colorspace_name);
+    pack->entries.add_new(task.key, entry);
+    pack->live_size += size_stored;
+    pack->index_dirty = true;
+    pack->unflushed_appends_num++;
+  }
+  const bool flush_index = pack->unflushed_appends_num >= DCACHE_INDEX_FLUSH_APPENDS;
+  BLI_mutex_unlock(&store->mutex);
+
+  if (flush_index) {
+    seq_disk_cache_pack_flush_index(store, pack);
+  }
+  return success;
+}
+
+/**
+ * Compress the image and append it to the pack file of its strip. The compression happens without
+ * locking any mutex, so multiple images can be compressed at the same time.
+ */
+static bool seq_disk_cache_write_image(const DiskCacheWriteTask &task)
+{
+  DiskCacheStore *store = task.store;
+  ImBuf *ibuf = task.ibuf;
+
+  const void *data = (ibuf->byte_buffer.data != nullptr) ? (void *)ibuf->byte_buffer.data :
+                                                           (void *)ibuf->float_buffer.data;
+  const uint64_t size_raw = (ibuf->byte_buffer.data != nullptr) ?
+                                uint64_t(ibuf->x) * ibuf->y * ibuf->channels :
+                                uint64_t(ibuf->x) * ibuf->y * ibuf->channels * 4;
+
+  /* Store the image uncompressed if compression is disabled or doesn't make it smaller. */
+  void *compressed = nullptr;
+  uint64_t size_compressed = 0;
+  if (task.compression_level > 0) {
+    const size_t bound = ZSTD_compressBound(size_raw);
+    compressed = MEM_mallocN(bound, "SeqDiskCache compressed image");
+    size_compressed = ZSTD_compress(compressed, bound, data, size_raw, task.compression_level);
+    if (ZSTD_isError(size_compressed) || size_compressed >= size_raw) {
+      MEM_SAFE_FREE(compressed);
     }
-    seq_disk_cache_add_file_to_list(disk_cache, filepath);
   }
 
-  DiskCacheFile *cache_file = seq_disk_cache_get_file_entry_by_path(disk_cache, filepath);
-  DiskCacheHeader header;
-  memset(&header, 0, sizeof(header));
-  /* The file may be empty when touched (above).
-   * This is fine, don't attempt reading the header in that case. */
-  if (cache_file->fstat.st_size != 0 && !seq_disk_cache_read_header(file, &header)) {
-    fclose(file);
-    seq_disk_cache_delete_file(disk_cache, cache_file);
-    BLI_mutex_unlock(&disk_cache->read_write_mutex);
-    return false;
+  /* Reserve the image in its pack, so that the pack is kept and other threads don't write the same
+   * image. */
+  std::shared_ptr<DiskCachePack> pack;
+  BLI_mutex_lock(&store->mutex);
+  if (task.invalidation_count == store->invalidation_count) {
+    std::shared_ptr<DiskCachePack> &pack_ptr = store->packs.lookup_or_add_cb(
+        task.dirpath, [&]() {
+          std::shared_ptr<DiskCachePack> new_pack = std::make_shared<DiskCachePack>();
+          STRNCPY(new_pack->dirpath, task.dirpath);
+          return new_pack;
+        });
+    if (!pack_ptr->entries.contains(task.key) && pack_ptr->pending.add(task.key)) {
+      pack = pack_ptr;
+    }
   }
-  int entry_index = seq_disk_cache_add_header_entry(key, ibuf, &header);
+  BLI_mutex_unlock(&store->mutex);
+
+  bool success = false;
+  if (pack) {
+    BLI_mutex_lock(&pack->file_mutex);
+    if (compressed != nullptr) {
+      success = seq_disk_cache_pack_append(
+          store, pack.get(), task, compressed, size_compressed, size_raw, true);
+    }
+    else {
+      success = seq_disk_cache_pack_append(
+          store, pack.get(), task, data, size_raw, size_raw, false);
+    }
+    BLI_mutex_unlock(&pack->file_mutex);
+  }
+  MEM_SAFE_FREE(compressed);
 
-  size_t bytes_written = deflate_imbuf_to_file(
-      ibuf, file, seq_disk_cache_compression_level(), &header.entry[entry_index]);
+  if (success) {
+    seq_disk_cache_store_enforce_limits(store);
+  }
+  return success;
+}
 
-  if (bytes_written != 0) {
-    /* Last step is writing header, as image data can be overwritten,
-     * but missing data would cause problems.
-     */
-    header.entry[entry_index].size_compressed = bytes_written;
-    seq_disk_cache_write_header(file, &header);
-    seq_disk_cache_update_file(disk_cache, filepath);
-    fclose(file);
+static void seq_disk_cache_write_task_run(TaskPool * /*pool*/, void *taskdata)
+{
+  seq_disk_cache_write_image(*static_cast<DiskCacheWriteTask *>(taskdata));
+}
 
-    BLI_mutex_unlock(&disk_cache->read_write_mutex);
+static void seq_disk_cache_write_task_free(TaskPool * /*pool*/, void *taskdata)
+{
+  DiskCacheWriteTask *task = static_cast<DiskCacheWriteTask *>(taskdata);
+  BLI_mutex_lock(&task->store->mutex);
+  task->store->pending_writes_num--;
+  BLI_mutex_unlock(&task->store->mutex);
+  IMB_freeImBuf(task->ibuf);
+  MEM_delete(task);
+}
+
+bool seq_disk_cache_write_file(SeqDiskCache *disk_cache, SeqCacheKey *key, ImBuf *ibuf)
+{
+  if (ibuf->byte_buffer.data == nullptr && ibuf->float_buffer.data == nullptr) {
+    return false;
+  }
+
+  DiskCacheStore *store = disk_cache->store;
+  DiskCacheWriteTask *task = MEM_new<DiskCacheWriteTask>("SeqDiskCacheWriteTask");
+  task->store = store;
+  seq_disk_cache_get_dir(
+      disk_cache, key->context.scene, key->strip, task->dirpath, sizeof(task->dirpath));
+  task->key = seq_disk_cache_entry_key(key);
+  task->compression_level = seq_disk_cache_compression_level();
+  STRNCPY(task->colorspace_name,
+          (ibuf->byte_buffer.data != nullptr) ? IMB_colormanagement_get_rect_colorspace(ibuf) :
+                                                IMB_colormanagement_get_float_colorspace(ibuf));
+  /* The image is not modified anymore once it's cached, so it can be shared with the task. */
+  IMB_refImBuf(ibuf);
+  task->ibuf = ibuf;
+
+  BLI_mutex_lock(&store->mutex);
+  task->invalidation_count = store->invalidation_count;
+  const bool write_in_background = store->pending_writes_num < DCACHE_PENDING_WRITES_MAX;
+  if (write_in_background) {
+    store->pending_writes_num++;
+  }
+  BLI_mutex_unlock(&store->mutex);
+
+  if (write_in_background) {
+    BLI_task_pool_push(store->write_pool,
+                       seq_disk_cache_write_task_run,
+                       task,
+                       true,
+                       seq_disk_cache_write_task_free);
     return true;
   }
 
-  BLI_mutex_unlock(&disk_cache->read_write_mutex);
-  return false;
+  /* Too many images are waiting for compression already. Write this one on the calling thread, so
+   * that rendering doesn't get ahead of the compression indefinitely. */
+  const bool success = seq_disk_cache_write_image(*task);
+  IMB_freeImBuf(task->ibuf);
+  MEM_delete(task);
+  return success;
 }
 
 ImBuf *seq_disk_cache_read_file(SeqDiskCache *disk_cache, SeqCacheKey *key)
 {
-  BLI_mutex_lock(&disk_cache->read_write_mutex);
+  DiskCacheStore *store = disk_cache->store;
+  char dirpath[FILE_MAX];
+  seq_disk_cache_get_dir(disk_cache, key->context.scene, key->strip, dirpath, sizeof(dirpath));
+  const DiskCacheEntryKey entry_key = seq_disk_cache_entry_key(key);
 
-  char filepath[FILE_MAX];
-  DiskCacheHeader header;
+  BLI_mutex_lock(&store->mutex);
+  const std::shared_ptr<DiskCachePack> pack = store->packs.lookup_default(dirpath, nullptr);
+  BLI_mutex_unlock(&store->mutex);
 
-  seq_disk_cache_get_file_path(disk_cache, key, filepath, sizeof(filepath));
-  BLI_file_ensure_parent_dir_exists(filepath);
+  /* Item not found. */
+  if (!pack) {
+    return nullptr;
+  }
 
-  FILE *file = BLI_fopen(filepath, "rb");
-  if (!file) {
-    BLI_mutex_unlock(&disk_cache->read_write_mutex);
+  /* Lock the file mutex first, so that the offset stays valid until the data is copied. */
+  BLI_mutex_lock(&pack->file_mutex);
+
+  BLI_mutex_lock(&store->mutex);
+  DiskCacheEntry entry;
+  const DiskCacheEntry *entry_ptr = pack->entries.lookup_ptr(entry_key);
+  if (entry_ptr != nullptr) {
+    entry = *entry_ptr;
+  }
+  BLI_mutex_unlock(&store->mutex);
+
+  /* Item not found. */
+  if (entry_ptr == nullptr) {
+    BLI_mutex_unlock(&pack->file_mutex);
     return nullptr;
   }
 
-  if (!seq_disk_cache_read_header(file, &header)) {
-    fclose(file);
-    BLI_mutex_unlock(&disk_cache->read_write_mutex);
+  const uint64_t pixels_num = uint64_t(key->context.rectx) * key->context.recty;
+  const uint64_t expected_size = pixels_num * (entry.is_float ? 16 : 4);
+  if (entry.size_raw != expected_size ||
+      !seq_disk_cache_pack_ensure_mmap(pack.get(), entry.offset + entry.size_stored))
+  {
+    /* The image doesn't match the key, or the pack file was modified externally. */
+    BLI_mutex_lock(&store->mutex);
+    seq_disk_cache_pack_remove_entry(pack.get(), entry_key);
+    BLI_mutex_unlock(&store->mutex);
+    BLI_mutex_unlock(&pack->file_mutex);
     return nullptr;
   }
-  int entry_index = seq_disk_cache_get_header_entry(key, &header);
 
-  /* Item not found. */
-  if (entry_index < 0) {
-    fclose(file);
-    BLI_mutex_unlock(&disk_cache->read_write_mutex);
+  ImBuf *ibuf = IMB_allocImBuf(key->context.rectx,
+                               key->context.recty,
+                               32,
+                               (entry.is_float ? IB_float_data : IB_byte_data) |
+                                   IB_uninitialized_pixels);
+  void *pixels = nullptr;
+  if (ibuf != nullptr) {
+    if (entry.is_float) {
+      IMB_colormanagement_assign_float_colorspace(ibuf, entry.colorspace_name);
+      pixels = ibuf->float_buffer.data;
+    }
+    else {
+      IMB_colormanagement_assign_byte_colorspace(ibuf, entry.colorspace_name);
+      pixels = ibuf->byte_buffer.data;
+    }
+  }
+  if (pixels == nullptr) {
+    BLI_mutex_unlock(&pack->file_mutex);
+    IMB_freeImBuf(ibuf);
     return nullptr;
   }
 
-  ImBuf *ibuf;
-  uint64_t size_char = uint64_t(key->context.rectx) * key->context.recty * 4;
-  uint64_t size_float = uint64_t(key->context.rectx) * key->context.recty * 16;
-  size_t expected_size;
-
-  if (header.entry[entry_index].size_raw == size_char) {
-    expected_size = size_char;
-    ibuf = IMB_allocImBuf(
-        key->context.rectx, key->context.recty, 32, IB_byte_data | IB_uninitialized_pixels);
-    IMB_colormanagement_assign_byte_colorspace(ibuf, header.entry[entry_index].colorspace_name);
-  }
-  else if (header.entry[entry_index].size_raw == size_float) {
-    expected_size = size_float;
-    ibuf = IMB_allocImBuf(
-        key->context.rectx, key->context.recty, 32, IB_float_data | IB_uninitialized_pixels);
-    IMB_colormanagement_assign_float_colorspace(ibuf, header.entry[entry_index].colorspace_name);
+  /* Only copy the data out of the mapping while the file mutex is locked, because the pack file
+   * may be compacted afterwards. Decompression happens after unlocking. */
+  const char *stored = static_cast<const char *>(BLI_mmap_get_pointer(pack->mmap_file)) +
+                       entry.offset;
+  const uint64_t size_stored = entry.size_stored;
+  void *compressed = nullptr;
+  if (entry.is_compressed) {
+    compressed = MEM_mallocN(size_stored, "SeqDiskCache compressed image");
+    memcpy(compressed, stored, size_stored);
   }
   else {
-    fclose(file);
-    BLI_mutex_unlock(&disk_cache->read_write_mutex);
-    return nullptr;
+    memcpy(pixels, stored, size_stored);
+  }
+
+  bool success = !BLI_mmap_any_io_error(pack->mmap_file);
+  if (!success) {
+    seq_disk_cache_pack_release_mmap(pack.get());
   }
 
-  size_t bytes_read = inflate_file_to_imbuf(ibuf, file, &header.entry[entry_index]);
+  BLI_mutex_lock(&store->mutex);
+  if (!success) {
+    seq_disk_cache_pack_remove_entry(pack.get(), entry_key);
+  }
+  else if (DiskCacheEntry *stored_entry = pack->entries.lookup_ptr(entry_key)) {
+    stored_entry->last_used = ++store->use_clock;
+    pack->index_dirty = true;
+  }
+  BLI_mutex_unlock(&store->mutex);
+
+  BLI_mutex_unlock(&pack->file_mutex);
+
+  if (compressed != nullptr) {
+    success = success && ZSTD_decompress(pixels, expected_size, compressed, size_stored) ==
+                             expected_size;
+    MEM_freeN(compressed);
+  }
 
   /* Sanity check. */
-  if (bytes_read != expected_size) {
-    fclose(file);
+  if (!success) {
     IMB_freeImBuf(ibuf);
-    BLI_mutex_unlock(&disk_cache->read_write_mutex);
     return nullptr;
   }
-  BLI_file_touch(filepath);
-  seq_disk_cache_update_file(disk_cache, filepath);
-  fclose(file);
-
-  BLI_mutex_unlock(&disk_cache->read_write_mutex);
   return ibuf;
 }
 
+static DiskCacheStore *seq_disk_cache_store_create()
+{
+  DiskCacheStore *store = MEM_new<DiskCacheStore>("SeqDiskCacheStore");
+  BLI_mutex_init(&store->mutex);
+  store->write_pool = BLI_task_pool_create_background(nullptr, TASK_PRIORITY_LOW);
+  seq_disk_cache_load_packs(store, seq_disk_cache_base_dir());
+  return store;
+}
+
+static void seq_disk_cache_store_free(DiskCacheStore *store)
+{
+  /* Finish writing the images that are waiting for compression. */
+  BLI_task_pool_work_and_wait(store->write_pool);
+  BLI_task_pool_free(store->write_pool);
+
+  /* Write the images appended since the last index write, and keep the last use of the images for
+   * the next session. */
+  for (const std::shared_ptr<DiskCachePack> &pack : store->packs.values()) {
+    BLI_mutex_lock(&pack->file_mutex);
+    seq_disk_cache_pack_flush_index(store, pack.get());
+    seq_disk_cache_pack_release_mmap(pack.get());
+    BLI_mutex_unlock(&pack->file_mutex);
+  }
+
+  BLI_mutex_end(&store->mutex);
+  MEM_delete(store);
+}
+
 SeqDiskCache *seq_disk_cache_create(Main *bmain, Scene *scene)
 {
   SeqDiskCache *disk_cache = MEM_callocN<SeqDiskCache>("SeqDiskCache");
   disk_cache->bmain = bmain;
-  BLI_mutex_init(&disk_cache->read_write_mutex);
-  seq_disk_cache_handle_versioning(disk_cache);
-  seq_disk_cache_get_files(disk_cache, seq_disk_cache_base_dir());
   disk_cache->timestamp = scene->ed->disk_cache_timestamp;
+
+  BLI_mutex_lock(&cache_create_lock);
+  seq_disk_cache_handle_versioning(disk_cache);
+  if (disk_cache_store == nullptr) {
+    disk_cache_store = seq_disk_cache_store_create();
+  }
+  disk_cache_store->users++;
+  disk_cache->store = disk_cache_store;
   BLI_mutex_unlock(&cache_create_lock);
+
   return disk_cache;
 }
 
 void seq_disk_cache_free(SeqDiskCache *disk_cache)
 {
-  BLI_freelistN(&disk_cache->files);
-  BLI_mutex_end(&disk_cache->read_write_mutex);
+  BLI_mutex_lock(&cache_create_lock);
+  DiskCacheStore *store = disk_cache->store;
+  store->users--;
+  if (store->users == 0) {
+    seq_disk_cache_store_free(store);
+    disk_cache_store = nullptr;
+  }
+  BLI_mutex_unlock(&cache_create_lock);
+
   MEM_freeN(disk_cache);
 }
 
@@ -6,6 +6,7 @@
  * \ingroup bke
  */
 
+#include <algorithm>
 #include <cstddef>
 #include <ctime>
 #include <memory.h>
@@ -69,7 +70,8 @@ struct SeqCache {
   ThreadMutex iterator_mutex;
   BLI_mempool *keys_pool;
   BLI_mempool *items_pool;
-  SeqCacheKey *last_key;
+  /* Last cached key of the frame that is rendered by each task, used for linking. */
+  SeqCacheKey *last_key[SEQ_TASK_NUM];
   SeqDiskCache *disk_cache;
 };
 
@@ -210,9 +212,15 @@ static int get_stored_types_flag(Scene *scene, SeqCacheKey *key)
   return flag;
 }
 
+static void seq_cache_reset_linking(SeqCache *cache)
+{
+  std::fill_n(cache->last_key, SEQ_TASK_NUM, nullptr);
+}
+
 static void seq_cache_put_ex(Scene *scene, SeqCacheKey *key, ImBuf *ibuf)
 {
   SeqCache *cache = seq_cache_get_from_scene(scene);
+  SeqCacheKey *&last_key = cache->last_key[key->task_id];
   SeqCacheItem *item;
   item = static_cast<SeqCacheItem *>(BLI_mempool_alloc(cache->items_pool));
   item->cache_owner = cache;
@@ -223,7 +231,7 @@ static void seq_cache_put_ex(Scene *scene, SeqCacheKey *key, ImBuf *ibuf)
   /* Item stored for later use. */
   if (stored_types_flag & key->type) {
     key->is_temp_cache = false;
-    key->link_prev = cache->last_key;
+    key->link_prev = last_key;
   }
 
   BLI_assert(!BLI_ghash_haskey(cache->hash, key));
@@ -231,19 +239,19 @@ static void seq_cache_put_ex(Scene *scene, SeqCacheKey *key, ImBuf *ibuf)
   IMB_refImBuf(ibuf);
 
   /* Store pointer to last cached key. */
-  SeqCacheKey *temp_last_key = cache->last_key;
-  cache->last_key = key;
+  SeqCacheKey *temp_last_key = last_key;
+  last_key = key;
 
   /* Set last_key's reference to this key so we can look up chain backwards.
-   * Item is already put in cache, so cache->last_key points to current key.
+   * Item is already put in cache, so last_key points to current key.
    */
   if (!key->is_temp_cache && temp_last_key) {
-    temp_last_key->link_next = cache->last_key;
+    temp_last_key->link_next = last_key;
   }
 
   /* Reset linking. */
   if (key->type == SEQ_CACHE_STORE_FINAL_OUT) {
-    cache->last_key = nullptr;
+    last_key = nullptr;
   }
 }
 
@@ -360,7 +368,7 @@ static void seq_cache_recycle_linked(Scene *scene, SeqCacheKey *base)
 
     seq_cache_key_unlink(base);
     BLI_ghash_remove(cache->hash, base, seq_cache_keyfree, seq_cache_valfree);
-    BLI_assert(base != cache->last_key);
+    BLI_assert(base != cache->last_key[base->task_id]);
     base = prev;
   }
 
@@ -379,7 +387,7 @@ static void seq_cache_recycle_linked(Scene *scene, SeqCacheKey *base)
 
     seq_cache_key_unlink(base);
     BLI_ghash_remove(cache->hash, base, seq_cache_keyfree, seq_cache_valfree);
-    BLI_assert(base != cache->last_key);
+    BLI_assert(base != cache->last_key[base->task_id]);
     base = next;
   }
 }
@@ -498,7 +506,7 @@ static void seq_cache_create(Main *bmain, Scene *scene)
     cache->keys_pool = BLI_mempool_create(sizeof(SeqCacheKey), 0, 64, BLI_MEMPOOL_NOP);
     cache->items_pool = BLI_mempool_create(sizeof(SeqCacheItem), 0, 64, BLI_MEMPOOL_NOP);
     cache->hash = BLI_ghash_new(seq_cache_hashhash, seq_cache_hashcmp, "SeqCache hash");
-    cache->last_key = nullptr;
+    seq_cache_reset_linking(cache);
     cache->bmain = bmain;
     BLI_mutex_init(&cache->iterator_mutex);
     scene->ed->cache = cache;
@@ -567,8 +575,8 @@ void seq_cache_free_temp_cache(Scene *scene, short id, int timeline_frame)
       {
         seq_cache_key_unlink(key);
         BLI_ghash_remove(cache->hash, key, seq_cache_keyfree, seq_cache_valfree);
-        if (key == cache->last_key) {
-          cache->last_key = nullptr;
+        if (key == cache->last_key[key->task_id]) {
+          cache->last_key[key->task_id] = nullptr;
         }
       }
     }
@@ -618,7 +626,7 @@ void cache_cleanup(Scene *scene)
     /* NOTE: no need to call #seq_cache_key_unlink as all keys are removed. */
     BLI_ghash_remove(cache->hash, key, seq_cache_keyfree, seq_cache_valfree);
   }
-  cache->last_key = nullptr;
+  seq_cache_reset_linking(cache);
   seq_cache_unlock(scene);
 }
 
@@ -680,10 +688,21 @@ void seq_cache_cleanup_sequence(Scene *scene,
       BLI_ghash_remove(cache->hash, key, seq_cache_keyfree, seq_cache_valfree);
     }
   }
-  cache->last_key = nullptr;
+  seq_cache_reset_linking(cache);
   seq_cache_unlock(scene);
 }
 
+static SeqDiskCache *seq_cache_disk_cache_ensure(const RenderData *context)
+{
+  seq_cache_lock(context->scene);
+  SeqCache *cache = seq_cache_get_from_scene(context->scene);
+  if (cache->disk_cache == nullptr) {
+    cache->disk_cache = seq_disk_cache_create(context->bmain, context->scene);
+  }
+  seq_cache_unlock(context->scene);
+  return cache->disk_cache;
+}
+
 ImBuf *seq_cache_get(const RenderData *context, Strip *strip, float timeline_frame, int type)
 {
 
@@ -729,11 +748,7 @@ ImBuf *seq_cache_get(const RenderData *context, Strip *strip, float timeline_fra
 
   /* Try disk cache: */
   if (seq_disk_cache_is_enabled(context->bmain)) {
-    if (cache->disk_cache == nullptr) {
-      cache->disk_cache = seq_disk_cache_create(context->bmain, context->scene);
-    }
-
-    ibuf = seq_disk_cache_read_file(cache->disk_cache, &key);
+    ibuf = seq_disk_cache_read_file(seq_cache_disk_cache_ensure(context), &key);
 
     if (ibuf == nullptr) {
       return nullptr;
@@ -741,8 +756,13 @@ ImBuf *seq_cache_get(const RenderData *context, Strip *strip, float timeline_fra
 
     /* Store read image in RAM. Only recycle item for final type. */
     if (key.type != SEQ_CACHE_STORE_FINAL_OUT || seq_cache_recycle_item(scene)) {
-      SeqCacheKey *new_key = seq_cache_allocate_key(cache, context, strip, timeline_frame, type);
-      seq_cache_put_ex(scene, new_key, ibuf);
+      seq_cache_lock(scene);
+      /* Another thread may have read or rendered the same image in the meantime. */
+      if (!BLI_ghash_haskey(cache->hash, &key)) {
+        SeqCacheKey *new_key = seq_cache_allocate_key(cache, context, strip, timeline_frame, type);
+        seq_cache_put_ex(scene, new_key, ibuf);
+      }
+      seq_cache_unlock(scene);
     }
   }
 
@@ -770,8 +790,9 @@ bool seq_cache_put_if_possible(
   }
 
   if (scene->ed->cache) {
-    seq_cache_set_temp_cache_linked(scene, scene->ed->cache->last_key);
-    scene->ed->cache->last_key = nullptr;
+    SeqCacheKey *&last_key = scene->ed->cache->last_key[context->task_id];
+    seq_cache_set_temp_cache_linked(scene, last_key);
+    last_key = nullptr;
   }
 
   return false;
@@ -807,21 +828,26 @@ void seq_cache_put(
   seq_cache_lock(scene);
   SeqCache *cache = seq_cache_get_from_scene(scene);
   SeqCacheKey *key = seq_cache_allocate_key(cache, context, strip, timeline_frame, type);
+  /* Prefetch renders multiple frames at the same time, which may render the same image. */
+  if (BLI_ghash_haskey(cache->hash, key)) {
+    BLI_mempool_free(cache->keys_pool, key);
+    seq_cache_unlock(scene);
+    return;
+  }
   seq_cache_put_ex(scene, key, i);
-  seq_cache_unlock(scene);
 
   if (context->for_render) {
     key->is_temp_cache = true;
   }
+  /* The stored key can be freed by other threads as soon as the cache is unlocked. */
+  SeqCacheKey key_copy = *key;
+  seq_cache_unlock(scene);
 
-  if (!key->is_temp_cache) {
+  if (!key_copy.is_temp_cache) {
     if (seq_disk_cache_is_enabled(context->bmain)) {
-      if (cache->disk_cache == nullptr) {
-        seq_disk_cache_create(context->bmain, context->scene);
-      }
-
-      seq_disk_cache_write_file(cache->disk_cache, key, i);
-      seq_disk_cache_enforce_limits(cache->disk_cache);
+      SeqDiskCache *disk_cache = seq_cache_disk_cache_ensure(context);
+      seq_disk_cache_write_file(disk_cache, &key_copy, i);
+      seq_disk_cache_enforce_limits(disk_cache);
     }
   }
 }
@@ -867,7 +893,7 @@ void cache_iterate(
     interrupt = callback_iter(userdata, key->strip, timeline_frame, key->type);
   }
 
-  cache->last_key = nullptr;
+  seq_cache_reset_linking(cache);
   seq_cache_unlock(scene);
 }
 
@@ -876,4 +902,11 @@ bool seq_cache_is_full()
   return seq_cache_get_mem_total() < MEM_get_memory_in_use();
 }
 
+size_t seq_cache_get_mem_available()
+{
+  const size_t mem_total = seq_cache_get_mem_total();
+  const size_t mem_in_use = MEM_get_memory_in_use();
+  return mem_total > mem_in_use ? mem_total - mem_in_use : 0;
+}
+
 }  // namespace blender::seq
@@ -52,5 +52,7 @@ void seq_cache_cleanup_sequence(Scene *scene,
                                 int invalidate_types,
                                 bool force_seq_changed_range);
 bool seq_cache_is_full();
+/** Memory that can still be used before the cache is full, in bytes. */
+size_t seq_cache_get_mem_available();
 
 }  // namespace blender::seq
@@ -7,6 +7,7 @@
  */
 
 #include <algorithm>
+#include <cmath>
 #include <cstddef>
 #include <cstdlib>
 #include <cstring>
@@ -18,8 +19,10 @@
 #include "DNA_sequence_types.h"
 #include "DNA_space_types.h"
 
+#include "BLI_index_range.hh"
 #include "BLI_listbase.h"
 #include "BLI_threads.h"
+#include "BLI_time.h"
 #include "BLI_vector_set.hh"
 
 #include "IMB_imbuf.hh"
@@ -49,6 +52,27 @@
 
 namespace blender::seq {
 
+struct PrefetchJob;
+
+/**
+ * Renders one frame at a time on its own thread. Every slot evaluates its own copy of the scene,
+ * so that multiple frames can be rendered at the same time.
+ */
+struct PrefetchRenderSlot {
+  PrefetchJob *pfjob = nullptr;
+  int index = 0;
+
+  Depsgraph *depsgraph = nullptr;
+  Scene *scene_eval = nullptr;
+
+  /* context */
+  RenderData context = {};
+  RenderData context_cpy = {};
+
+  /** Frame that is rendered by this slot. */
+  float cfra = 0.0f;
+};
+
 struct PrefetchJob {
   PrefetchJob *next = nullptr;
   PrefetchJob *prev = nullptr;
@@ -56,19 +80,32 @@ struct PrefetchJob {
   Main *bmain = nullptr;
   Main *bmain_eval = nullptr;
   Scene *scene = nullptr;
-  Scene *scene_eval = nullptr;
-  Depsgraph *depsgraph = nullptr;
 
   ThreadMutex prefetch_suspend_mutex = {};
   ThreadCondition prefetch_suspend_cond = {};
+  /** Serializes depsgraph evaluation of the slots, which may touch shared original data. */
+  ThreadMutex depsgraph_mutex = {};
 
   ListBase threads = {};
 
-  /* context */
-  RenderData context = {};
-  RenderData context_cpy = {};
-  ListBase *seqbasep = nullptr;
-  ListBase *seqbasep_cpy = nullptr;
+  PrefetchRenderSlot *slots[PREFETCH_RENDER_SLOTS_MAX] = {};
+  /** Amount of slots that have a depsgraph and run when prefetching. */
+  int slots_num = 0;
+  /** Amount of slots that may render frames, adjusted to the measured cost of frames. */
+  int depth = 1;
+  /** Amount of slots that run, and of those the amount that are suspended. */
+  int running_num = 0;
+  int waiting_num = 0;
+
+  /** Average time to render a frame in seconds, zero when no frame was rendered yet. */
+  double frame_cost = 0.0;
+  /** Memory used by the last rendered frame. */
+  size_t frame_size = 0;
+
+  /* Render settings of the context that prefetching was started with. */
+  int rectx = 0;
+  int recty = 0;
+  int preview_render_size = 0;
 
   /* prefetch area */
   float cfra = 0.0f;
@@ -152,7 +189,13 @@ RenderData *seq_prefetch_get_original_context(const RenderData *context)
 {
   PrefetchJob *pfjob = seq_prefetch_job_get(context->scene);
 
-  return &pfjob->context;
+  for (const int i : IndexRange(pfjob->slots_num)) {
+    if (pfjob->slots[i]->scene_eval == context->scene) {
+      return &pfjob->slots[i]->context;
+    }
+  }
+  BLI_assert_unreachable();
+  return &pfjob->slots[0]->context;
 }
 
 static bool seq_prefetch_is_cache_full(Scene *scene)
@@ -166,13 +209,14 @@ static bool seq_prefetch_is_cache_full(Scene *scene)
   return seq_cache_recycle_item(pfjob->scene) == false;
 }
 
+/** First frame that is not rendered or claimed by a slot yet. */
 static float seq_prefetch_cfra(PrefetchJob *pfjob)
 {
   return pfjob->cfra + pfjob->num_frames_prefetched;
 }
-static AnimationEvalContext seq_prefetch_anim_eval_context(PrefetchJob *pfjob)
+static AnimationEvalContext seq_prefetch_anim_eval_context(PrefetchRenderSlot *slot)
 {
-  return BKE_animsys_eval_context_construct(pfjob->depsgraph, seq_prefetch_cfra(pfjob));
+  return BKE_animsys_eval_context_construct(slot->depsgraph, slot->cfra);
 }
 
 void seq_prefetch_get_time_range(Scene *scene, int *r_start, int *r_end)
@@ -183,37 +227,43 @@ void seq_prefetch_get_time_range(Scene *scene, int *r_start, int *r_end)
   *r_end = seq_prefetch_cfra(pfjob);
 }
 
-static void seq_prefetch_free_depsgraph(PrefetchJob *pfjob)
+static void seq_prefetch_free_depsgraph(PrefetchRenderSlot *slot)
 {
-  if (pfjob->depsgraph != nullptr) {
-    DEG_graph_free(pfjob->depsgraph);
+  if (slot->depsgraph != nullptr) {
+    DEG_graph_free(slot->depsgraph);
   }
-  pfjob->depsgraph = nullptr;
-  pfjob->scene_eval = nullptr;
+  slot->depsgraph = nullptr;
+  slot->scene_eval = nullptr;
 }
 
-static void seq_prefetch_update_depsgraph(PrefetchJob *pfjob)
+static void seq_prefetch_update_depsgraph(PrefetchRenderSlot *slot)
 {
-  DEG_evaluate_on_framechange(pfjob->depsgraph, seq_prefetch_cfra(pfjob));
+  BLI_mutex_lock(&slot->pfjob->depsgraph_mutex);
+  DEG_evaluate_on_framechange(slot->depsgraph, slot->cfra);
+  BLI_mutex_unlock(&slot->pfjob->depsgraph_mutex);
 }
 
-static void seq_prefetch_init_depsgraph(PrefetchJob *pfjob)
+static void seq_prefetch_init_depsgraph(PrefetchRenderSlot *slot)
 {
-  Main *bmain = pfjob->bmain_eval;
-  Scene *scene = pfjob->scene;
+  Main *bmain = slot->pfjob->bmain_eval;
+  Scene *scene = slot->pfjob->scene;
   ViewLayer *view_layer = BKE_view_layer_default_render(scene);
 
-  pfjob->depsgraph = DEG_graph_new(bmain, scene, view_layer, DAG_EVAL_RENDER);
-  DEG_debug_name_set(pfjob->depsgraph, "SEQUENCER PREFETCH");
+  slot->depsgraph = DEG_graph_new(bmain, scene, view_layer, DAG_EVAL_RENDER);
+  DEG_debug_name_set(slot->depsgraph, "SEQUENCER PREFETCH");
 
+  /* Building reads the original data that other slots may be evaluating. */
+  BLI_mutex_lock(&slot->pfjob->depsgraph_mutex);
   /* Make sure there is a correct evaluated scene pointer. */
-  DEG_graph_build_for_render_pipeline(pfjob->depsgraph);
+  DEG_graph_build_for_render_pipeline(slot->depsgraph);
 
   /* Update immediately so we have proper evaluated scene. */
-  seq_prefetch_update_depsgraph(pfjob);
+  slot->cfra = slot->pfjob->cfra;
+  DEG_evaluate_on_framechange(slot->depsgraph, slot->cfra);
+  BLI_mutex_unlock(&slot->pfjob->depsgraph_mutex);
 
-  pfjob->scene_eval = DEG_get_evaluated_scene(pfjob->depsgraph);
-  pfjob->scene_eval->ed->cache_flag = 0;
+  slot->scene_eval = DEG_get_evaluated_scene(slot->depsgraph);
+  slot->scene_eval->ed->cache_flag = 0;
 }
 
 static void seq_prefetch_update_area(PrefetchJob *pfjob)
@@ -236,6 +286,29 @@ static void seq_prefetch_update_area(PrefetchJob *pfjob)
   }
 }
 
+/**
+ * Amount of frames to render at the same time. Enough frames are rendered to keep up with the
+ * playback rate, but not more than the cache can hold or than there are threads to render them.
+ */
+static int seq_prefetch_depth_calc(const PrefetchJob *pfjob)
+{
+  const int depth_max = std::clamp(BLI_system_thread_count() - 1, 1, PREFETCH_RENDER_SLOTS_MAX);
+  if (pfjob->frame_cost <= 0.0) {
+    /* Start with a single frame until the cost of frames is known. */
+    return 1;
+  }
+
+  const Scene *scene = pfjob->scene;
+  const double fps = double(scene->r.frs_sec) / double(scene->r.frs_sec_base);
+  int depth = int(std::ceil(pfjob->frame_cost * fps));
+  if (pfjob->frame_size > 0) {
+    /* Intermediate images of a frame take more memory than the final image. */
+    const size_t frame_memory = pfjob->frame_size * 4;
+    depth = int(std::min(size_t(depth), seq_cache_get_mem_available() / frame_memory));
+  }
+  return std::clamp(depth, 1, depth_max);
+}
+
 void prefetch_stop_all()
 {
   /* TODO(Richard): Use wm_jobs for prefetch, or pass main. */
@@ -258,63 +331,50 @@ void prefetch_stop(Scene *scene)
   pfjob->stop = true;
 
   while (pfjob->running) {
-    BLI_condition_notify_one(&pfjob->prefetch_suspend_cond);
+    BLI_condition_notify_all(&pfjob->prefetch_suspend_cond);
   }
 }
 
-static void seq_prefetch_update_context(const RenderData *context)
+static void seq_prefetch_update_context(PrefetchRenderSlot *slot)
 {
-  PrefetchJob *pfjob;
-  pfjob = seq_prefetch_job_get(context->scene);
+  PrefetchJob *pfjob = slot->pfjob;
+  const eTaskId task_id = eTaskId(SEQ_TASK_PREFETCH_RENDER + slot->index);
 
   render_new_render_data(pfjob->bmain_eval,
-                         pfjob->depsgraph,
-                         pfjob->scene_eval,
-                         context->rectx,
-                         context->recty,
-                         context->preview_render_size,
+                         slot->depsgraph,
+                         slot->scene_eval,
+                         pfjob->rectx,
+                         pfjob->recty,
+                         pfjob->preview_render_size,
                          false,
-                         &pfjob->context_cpy);
-  pfjob->context_cpy.is_prefetch_render = true;
-  pfjob->context_cpy.task_id = SEQ_TASK_PREFETCH_RENDER;
+                         &slot->context_cpy);
+  slot->context_cpy.is_prefetch_render = true;
+  slot->context_cpy.task_id = task_id;
 
   render_new_render_data(pfjob->bmain,
-                         pfjob->depsgraph,
+                         slot->depsgraph,
                          pfjob->scene,
-                         context->rectx,
-                         context->recty,
-                         context->preview_render_size,
+                         pfjob->rectx,
+                         pfjob->recty,
+                         pfjob->preview_render_size,
                          false,
-                         &pfjob->context);
-  pfjob->context.is_prefetch_render = false;
+                         &slot->context);
+  slot->context.is_prefetch_render = false;
 
   /* Same ID as prefetch context, because context will be swapped, but we still
    * want to assign this ID to cache entries created in this thread.
    * This is to allow "temp cache" work correctly for both threads.
    */
-  pfjob->context.task_id = SEQ_TASK_PREFETCH_RENDER;
+  slot->context.task_id = task_id;
 }
 
-static void seq_prefetch_update_scene(Scene *scene)
+static void seq_prefetch_update_active_seqbase(PrefetchRenderSlot *slot)
 {
-  PrefetchJob *pfjob = seq_prefetch_job_get(scene);
-
-  if (!pfjob) {
-    return;
-  }
-
-  pfjob->scene = scene;
-  seq_prefetch_free_depsgraph(pfjob);
-  seq_prefetch_init_depsgraph(pfjob);
-}
-
-static void seq_prefetch_update_active_seqbase(PrefetchJob *pfjob)
-{
-  MetaStack *ms_orig = meta_stack_active_get(editing_get(pfjob->scene));
-  Editing *ed_eval = editing_get(pfjob->scene_eval);
+  MetaStack *ms_orig = meta_stack_active_get(editing_get(slot->pfjob->scene));
+  Editing *ed_eval = editing_get(slot->scene_eval);
 
   if (ms_orig != nullptr) {
-    Strip *meta_eval = seq_prefetch_get_original_sequence(ms_orig->parseq, pfjob->scene_eval);
+    Strip *meta_eval = seq_prefetch_get_original_sequence(ms_orig->parseq, slot->scene_eval);
     seqbase_active_set(ed_eval, &meta_eval->seqbase);
   }
   else {
@@ -322,12 +382,21 @@ static void seq_prefetch_update_active_seqbase(PrefetchJob *pfjob)
   }
 }
 
+/** Evaluate the current state of the scene for the slot, before it renders any frame. */
+static void seq_prefetch_slot_init(PrefetchRenderSlot *slot)
+{
+  seq_prefetch_free_depsgraph(slot);
+  seq_prefetch_init_depsgraph(slot);
+  seq_prefetch_update_context(slot);
+  seq_prefetch_update_active_seqbase(slot);
+}
+
 static void seq_prefetch_resume(Scene *scene)
 {
   PrefetchJob *pfjob = seq_prefetch_job_get(scene);
 
-  if (pfjob && pfjob->waiting) {
-    BLI_condition_notify_one(&pfjob->prefetch_suspend_cond);
+  if (pfjob && pfjob->waiting_num > 0) {
+    BLI_condition_notify_all(&pfjob->prefetch_suspend_cond);
   }
 }
 
@@ -340,22 +409,29 @@ void seq_prefetch_free(Scene *scene)
 
   prefetch_stop(scene);
 
-  BLI_threadpool_remove(&pfjob->threads, pfjob);
+  for (PrefetchRenderSlot *slot : pfjob->slots) {
+    if (slot == nullptr) {
+      continue;
+    }
+    BLI_threadpool_remove(&pfjob->threads, slot);
+    seq_prefetch_free_depsgraph(slot);
+    MEM_delete(slot);
+  }
   BLI_threadpool_end(&pfjob->threads);
   BLI_mutex_end(&pfjob->prefetch_suspend_mutex);
+  BLI_mutex_end(&pfjob->depsgraph_mutex);
   BLI_condition_end(&pfjob->prefetch_suspend_cond);
-  seq_prefetch_free_depsgraph(pfjob);
   BKE_main_free(pfjob->bmain_eval);
   scene->ed->prefetch_job = nullptr;
   MEM_delete(pfjob);
 }
 
-static bool seq_prefetch_seq_has_disk_cache(PrefetchJob *pfjob,
+static bool seq_prefetch_seq_has_disk_cache(PrefetchRenderSlot *slot,
                                             Strip *strip,
                                             bool can_have_final_image)
 {
-  RenderData *ctx = &pfjob->context_cpy;
-  float cfra = seq_prefetch_cfra(pfjob);
+  RenderData *ctx = &slot->context_cpy;
+  float cfra = slot->cfra;
 
   ImBuf *ibuf = seq_cache_get(ctx, strip, cfra, SEQ_CACHE_STORE_PREPROCESSED);
   if (ibuf != nullptr) {
@@ -382,28 +458,28 @@ static bool seq_prefetch_seq_has_disk_cache(PrefetchJob *pfjob,
   return false;
 }
 
-static bool seq_prefetch_scene_strip_is_rendered(PrefetchJob *pfjob,
+static bool seq_prefetch_scene_strip_is_rendered(PrefetchRenderSlot *slot,
                                                  ListBase *channels,
                                                  ListBase *seqbase,
                                                  blender::Span<Strip *> scene_strips,
                                                  bool is_recursive_check)
 {
-  float cfra = seq_prefetch_cfra(pfjob);
+  float cfra = slot->cfra;
   blender::Vector<Strip *> strips = seq_get_shown_sequences(
-      pfjob->scene_eval, channels, seqbase, cfra, 0);
+      slot->scene_eval, channels, seqbase, cfra, 0);
 
   /* Iterate over rendered strips. */
   for (Strip *strip : strips) {
     if (strip->type == STRIP_TYPE_META &&
         seq_prefetch_scene_strip_is_rendered(
-            pfjob, &strip->channels, &strip->seqbase, scene_strips, true))
+            slot, &strip->channels, &strip->seqbase, scene_strips, true))
     {
       return true;
     }
 
     /* Disable prefetching 3D scene strips, but check for disk cache. */
     if (strip->type == STRIP_TYPE_SCENE && (strip->flag & SEQ_SCENE_STRIPS) == 0 &&
-        !seq_prefetch_seq_has_disk_cache(pfjob, strip, !is_recursive_check))
+        !seq_prefetch_seq_has_disk_cache(slot, strip, !is_recursive_check))
     {
       return true;
     }
@@ -431,10 +507,12 @@ static blender::VectorSet<Strip *> query_scene_strips(ListBase *seqbase)
 
 /* Prefetch must avoid rendering scene strips, because rendering in background locks UI and can
  * make it unresponsive for long time periods. */
-static bool seq_prefetch_must_skip_frame(PrefetchJob *pfjob, ListBase *channels, ListBase *seqbase)
+static bool seq_prefetch_must_skip_frame(PrefetchRenderSlot *slot,
+                                         ListBase *channels,
+                                         ListBase *seqbase)
 {
   blender::VectorSet<Strip *> scene_strips = query_scene_strips(seqbase);
-  if (seq_prefetch_scene_strip_is_rendered(pfjob, channels, seqbase, scene_strips, false)) {
+  if (seq_prefetch_scene_strip_is_rendered(slot, channels, seqbase, scene_strips, false)) {
     return true;
   }
   return false;
@@ -443,83 +521,149 @@ static bool seq_prefetch_must_skip_frame(PrefetchJob *pfjob, ListBase *channels,
 static bool seq_prefetch_need_suspend(PrefetchJob *pfjob)
 {
   return seq_prefetch_is_cache_full(pfjob->scene) || pfjob->is_scrubbing ||
-         (seq_prefetch_cfra(pfjob) >= pfjob->scene->r.efra);
+         (seq_prefetch_cfra(pfjob) > pfjob->scene->r.efra);
+}
+
+static bool seq_prefetch_must_stop(PrefetchJob *pfjob)
+{
+  return !(pfjob->scene->ed->cache_flag & SEQ_CACHE_PREFETCH_ENABLE) || pfjob->stop;
 }
 
-static void seq_prefetch_do_suspend(PrefetchJob *pfjob)
+/**
+ * Wait until there is a frame to render for the slot and claim it, so that no other slot renders
+ * the same frame.
+ * \return false when prefetching stops.
+ */
+static bool seq_prefetch_claim_frame(PrefetchRenderSlot *slot)
 {
+  PrefetchJob *pfjob = slot->pfjob;
   BLI_mutex_lock(&pfjob->prefetch_suspend_mutex);
-  while (seq_prefetch_need_suspend(pfjob) &&
-         (pfjob->scene->ed->cache_flag & SEQ_CACHE_PREFETCH_ENABLE) && !pfjob->stop)
+  seq_prefetch_update_area(pfjob);
+  while (!seq_prefetch_must_stop(pfjob) &&
+         (seq_prefetch_need_suspend(pfjob) || slot->index >= pfjob->depth))
   {
-    pfjob->waiting = true;
+    pfjob->waiting_num++;
+    pfjob->waiting = pfjob->waiting_num == pfjob->running_num;
     BLI_condition_wait(&pfjob->prefetch_suspend_cond, &pfjob->prefetch_suspend_mutex);
+    pfjob->waiting_num--;
+    pfjob->waiting = false;
     seq_prefetch_update_area(pfjob);
   }
-  pfjob->waiting = false;
+
+  /* Avoid "collision" with main thread, but make sure to fetch at least few frames */
+  if (pfjob->num_frames_prefetched > 5 && (seq_prefetch_cfra(pfjob) - pfjob->scene->r.cfra) < 2) {
+    pfjob->stop = true;
+    BLI_condition_notify_all(&pfjob->prefetch_suspend_cond);
+  }
+
+  const bool claimed = !seq_prefetch_must_stop(pfjob);
+  if (claimed) {
+    slot->cfra = seq_prefetch_cfra(pfjob);
+    pfjob->num_frames_prefetched++;
+  }
   BLI_mutex_unlock(&pfjob->prefetch_suspend_mutex);
+  return claimed;
 }
 
-static void *seq_prefetch_frames(void *job)
+static void seq_prefetch_render_frame(PrefetchRenderSlot *slot)
 {
-  PrefetchJob *pfjob = (PrefetchJob *)job;
-
-  while (seq_prefetch_cfra(pfjob) <= pfjob->scene->r.efra) {
-    pfjob->scene_eval->ed->prefetch_job = nullptr;
+  PrefetchJob *pfjob = slot->pfjob;
+  slot->scene_eval->ed->prefetch_job = nullptr;
 
-    seq_prefetch_update_depsgraph(pfjob);
-    AnimData *adt = BKE_animdata_from_id(&pfjob->context_cpy.scene->id);
-    AnimationEvalContext anim_eval_context = seq_prefetch_anim_eval_context(pfjob);
-    BKE_animsys_evaluate_animdata(
-        &pfjob->context_cpy.scene->id, adt, &anim_eval_context, ADT_RECALC_ALL, false);
+  seq_prefetch_update_depsgraph(slot);
+  AnimData *adt = BKE_animdata_from_id(&slot->context_cpy.scene->id);
+  AnimationEvalContext anim_eval_context = seq_prefetch_anim_eval_context(slot);
+  BKE_animsys_evaluate_animdata(
+      &slot->context_cpy.scene->id, adt, &anim_eval_context, ADT_RECALC_ALL, false);
 
-    /* This is quite hacky solution:
-     * We need cross-reference original scene with copy for cache.
-     * However depsgraph must not have this data, because it will try to kill this job.
-     * Scene copy don't reference original scene. Perhaps, this could be done by depsgraph.
-     * Set to nullptr before return!
-     */
-    pfjob->scene_eval->ed->prefetch_job = pfjob;
+  /* This is quite hacky solution:
+   * We need cross-reference original scene with copy for cache.
+   * However depsgraph must not have this data, because it will try to kill this job.
+   * Scene copy don't reference original scene. Perhaps, this could be done by depsgraph.
+   * Set to nullptr before return!
+   */
+  slot->scene_eval->ed->prefetch_job = pfjob;
 
-    ListBase *seqbase = active_seqbase_get(editing_get(pfjob->scene_eval));
-    ListBase *channels = channels_displayed_get(editing_get(pfjob->scene_eval));
-    if (seq_prefetch_must_skip_frame(pfjob, channels, seqbase)) {
-      pfjob->num_frames_prefetched++;
-      /* Break instead of keep looping if the job should be terminated. */
-      if (!(pfjob->scene->ed->cache_flag & SEQ_CACHE_PREFETCH_ENABLE) || pfjob->stop) {
-        break;
-      }
-      continue;
-    }
+  ListBase *seqbase = active_seqbase_get(editing_get(slot->scene_eval));
+  ListBase *channels = channels_displayed_get(editing_get(slot->scene_eval));
+  if (seq_prefetch_must_skip_frame(slot, channels, seqbase)) {
+    return;
+  }
 
-    ImBuf *ibuf = render_give_ibuf(&pfjob->context_cpy, seq_prefetch_cfra(pfjob), 0);
-    seq_cache_free_temp_cache(pfjob->scene, pfjob->context.task_id, seq_prefetch_cfra(pfjob));
-    IMB_freeImBuf(ibuf);
+  const double start_time = BLI_time_now_seconds();
+  ImBuf *ibuf = render_give_ibuf(&slot->context_cpy, slot->cfra, 0);
+  seq_cache_free_temp_cache(pfjob->scene, slot->context.task_id, slot->cfra);
+  if (ibuf == nullptr) {
+    return;
+  }
+  const double cost = BLI_time_now_seconds() - start_time;
+  const size_t size = IMB_get_size_in_memory(ibuf);
+  IMB_freeImBuf(ibuf);
+
+  /* Frames found in the cache take no time, they are not representative for the cost. */
+  if (cost > 1e-3) {
+    BLI_mutex_lock(&pfjob->prefetch_suspend_mutex);
+    pfjob->frame_cost = pfjob->frame_cost > 0.0 ? pfjob->frame_cost * 0.75 + cost * 0.25 : cost;
+    pfjob->frame_size = size;
+    BLI_mutex_unlock(&pfjob->prefetch_suspend_mutex);
+  }
+}
 
-    /* Suspend thread if there is nothing to be prefetched. */
-    seq_prefetch_do_suspend(pfjob);
+static void *seq_prefetch_frames(void *slot_v)
+{
+  PrefetchRenderSlot *slot = static_cast<PrefetchRenderSlot *>(slot_v);
+  PrefetchJob *pfjob = slot->pfjob;
 
-    /* Avoid "collision" with main thread, but make sure to fetch at least few frames */
-    if (pfjob->num_frames_prefetched > 5 && (seq_prefetch_cfra(pfjob) - pfjob->scene->r.cfra) < 2)
-    {
-      break;
-    }
+  /* Building and evaluating the render depsgraph can take long for heavy scenes, so it's done
+   * here rather than on the main thread that starts the slot. */
+  if (!seq_prefetch_must_stop(pfjob)) {
+    seq_prefetch_slot_init(slot);
 
-    if (!(pfjob->scene->ed->cache_flag & SEQ_CACHE_PREFETCH_ENABLE) || pfjob->stop) {
-      break;
+    while (seq_prefetch_claim_frame(slot)) {
+      seq_prefetch_render_frame(slot);
     }
 
-    seq_prefetch_update_area(pfjob);
-    pfjob->num_frames_prefetched++;
+    seq_cache_free_temp_cache(pfjob->scene, slot->context.task_id, slot->cfra);
+    slot->scene_eval->ed->prefetch_job = nullptr;
   }
 
-  seq_cache_free_temp_cache(pfjob->scene, pfjob->context.task_id, seq_prefetch_cfra(pfjob));
-  pfjob->running = false;
-  pfjob->scene_eval->ed->prefetch_job = nullptr;
+  BLI_mutex_lock(&pfjob->prefetch_suspend_mutex);
+  pfjob->running_num--;
+  if (pfjob->running_num == 0) {
+    pfjob->running = false;
+  }
+  BLI_mutex_unlock(&pfjob->prefetch_suspend_mutex);
 
   return nullptr;
 }
 
+static PrefetchRenderSlot *seq_prefetch_slot_ensure(PrefetchJob *pfjob, const int index)
+{
+  if (pfjob->slots[index] == nullptr) {
+    pfjob->slots[index] = MEM_new<PrefetchRenderSlot>("PrefetchRenderSlot");
+    pfjob->slots[index]->pfjob = pfjob;
+    pfjob->slots[index]->index = index;
+  }
+  return pfjob->slots[index];
+}
+
+/**
+ * Start the next unused slot, its thread evaluates the scene before rendering frames.
+ * Must be called from the main thread.
+ */
+static void seq_prefetch_slot_add(PrefetchJob *pfjob)
+{
+  PrefetchRenderSlot *slot = seq_prefetch_slot_ensure(pfjob, pfjob->slots_num);
+  BLI_threadpool_remove(&pfjob->threads, slot);
+
+  BLI_mutex_lock(&pfjob->prefetch_suspend_mutex);
+  pfjob->slots_num++;
+  pfjob->running_num++;
+  pfjob->running = true;
+  BLI_mutex_unlock(&pfjob->prefetch_suspend_mutex);
+  BLI_threadpool_insert(&pfjob->threads, slot);
+}
+
 static PrefetchJob *seq_prefetch_start_ex(const RenderData *context, float cfra)
 {
   PrefetchJob *pfjob = seq_prefetch_job_get(context->scene);
@@ -531,31 +675,58 @@ static PrefetchJob *seq_prefetch_start_ex(const RenderData *context, float cfra)
     pfjob = MEM_new<PrefetchJob>("PrefetchJob");
     context->scene->ed->prefetch_job = pfjob;
 
-    BLI_threadpool_init(&pfjob->threads, seq_prefetch_frames, 1);
+    BLI_threadpool_init(&pfjob->threads, seq_prefetch_frames, PREFETCH_RENDER_SLOTS_MAX);
     BLI_mutex_init(&pfjob->prefetch_suspend_mutex);
+    BLI_mutex_init(&pfjob->depsgraph_mutex);
     BLI_condition_init(&pfjob->prefetch_suspend_cond);
 
     pfjob->bmain_eval = BKE_main_new();
-    pfjob->scene = context->scene;
-    seq_prefetch_init_depsgraph(pfjob);
   }
   pfjob->bmain = context->bmain;
+  pfjob->scene = context->scene;
+  pfjob->rectx = context->rectx;
+  pfjob->recty = context->recty;
+  pfjob->preview_render_size = context->preview_render_size;
 
   pfjob->cfra = cfra;
   pfjob->num_frames_prefetched = 1;
 
   pfjob->waiting = false;
   pfjob->stop = false;
-  pfjob->running = true;
+  pfjob->running_num = 0;
+  pfjob->waiting_num = 0;
+  pfjob->depth = seq_prefetch_depth_calc(pfjob);
+
+  /* Slots that are not used anymore don't need to keep their copy of the scene. */
+  for (int i = pfjob->depth; i < pfjob->slots_num; i++) {
+    BLI_threadpool_remove(&pfjob->threads, pfjob->slots[i]);
+    seq_prefetch_free_depsgraph(pfjob->slots[i]);
+  }
+  pfjob->slots_num = 0;
+  for (int i = 0; i < pfjob->depth; i++) {
+    seq_prefetch_slot_add(pfjob);
+  }
 
-  seq_prefetch_update_scene(context->scene);
-  seq_prefetch_update_context(context);
-  seq_prefetch_update_active_seqbase(pfjob);
+  return pfjob;
+}
 
-  BLI_threadpool_remove(&pfjob->threads, pfjob);
-  BLI_threadpool_insert(&pfjob->threads, pfjob);
+/**
+ * Adjust the amount of frames rendered at the same time to the measured cost of frames, adding
+ * slots to the running job when needed.
+ */
+static void seq_prefetch_update_depth(const RenderData *context)
+{
+  PrefetchJob *pfjob = seq_prefetch_job_get(context->scene);
 
-  return pfjob;
+  BLI_mutex_lock(&pfjob->prefetch_suspend_mutex);
+  pfjob->depth = std::min(seq_prefetch_depth_calc(pfjob), pfjob->slots_num + 1);
+  const bool add_slot = pfjob->depth > pfjob->slots_num && !pfjob->stop;
+  BLI_mutex_unlock(&pfjob->prefetch_suspend_mutex);
+
+  if (add_slot) {
+    seq_prefetch_slot_add(pfjob);
+  }
+  BLI_condition_notify_all(&pfjob->prefetch_suspend_cond);
 }
 
 void seq_prefetch_start(const RenderData *context, float timeline_frame)
@@ -575,10 +746,15 @@ void seq_prefetch_start(const RenderData *context, float timeline_frame)
      * prefetch enabled, prefetch not running, not scrubbing, not playing,
      * cache storage enabled, has strips to render, not rendering, not doing modal transform -
      * important, see D7820. */
-    if ((ed->cache_flag & SEQ_CACHE_PREFETCH_ENABLE) && !running && !scrubbing && !playing &&
+    if ((ed->cache_flag & SEQ_CACHE_PREFETCH_ENABLE) && !scrubbing && !playing &&
         ed->cache_flag & SEQ_CACHE_ALL_TYPES && has_strips && !G.is_rendering && !G.moving)
     {
-      seq_prefetch_start_ex(context, timeline_frame);
+      if (!running) {
+        seq_prefetch_start_ex(context, timeline_frame);
+      }
+      else if (BLI_thread_is_main()) {
+        seq_prefetch_update_depth(context);
+      }
     }
   }
 }
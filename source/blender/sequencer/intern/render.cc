@@ -76,6 +76,8 @@
 #include "utils.hh"
 
 #include <algorithm>
+#include <condition_variable>
+#include <mutex>
 
 namespace blender::seq {
 
@@ -86,7 +88,51 @@ static ImBuf *seq_render_strip_stack(const RenderData *context,
                                      float timeline_frame,
                                      int chanshown);
 
-static ThreadMutex seq_render_mutex = BLI_MUTEX_INITIALIZER;
+/**
+ * Prefetch renders several frames at the same time, each with its own evaluated scene, so they
+ * share the render lock. Other renders use the original scene and take it exclusively. Waiting
+ * exclusive renders are preferred, so that prefetching doesn't keep playback or editing waiting.
+ */
+static struct {
+  std::mutex mutex;
+  std::condition_variable cond;
+  int shared_num = 0;
+  int exclusive_waiting_num = 0;
+  bool exclusive = false;
+} seq_render_lock;
+
+static void seq_render_lock_acquire(const bool shared)
+{
+  std::unique_lock lock(seq_render_lock.mutex);
+  if (shared) {
+    seq_render_lock.cond.wait(lock, [] {
+      return !seq_render_lock.exclusive && seq_render_lock.exclusive_waiting_num == 0;
+    });
+    seq_render_lock.shared_num++;
+  }
+  else {
+    seq_render_lock.exclusive_waiting_num++;
+    seq_render_lock.cond.wait(
+        lock, [] { return !seq_render_lock.exclusive && seq_render_lock.shared_num == 0; });
+    seq_render_lock.exclusive_waiting_num--;
+    seq_render_lock.exclusive = true;
+  }
+}
+
+static void seq_render_lock_release(const bool shared)
+{
+  {
+    std::lock_guard lock(seq_render_lock.mutex);
+    if (shared) {
+      seq_render_lock.shared_num--;
+    }
+    else {
+      seq_render_lock.exclusive = false;
+    }
+  }
+  seq_render_lock.cond.notify_all();
+}
+
 DrawViewFn view3d_fn = nullptr; /* nullptr in background mode */
 
 /* -------------------------------------------------------------------- */
@@ -1056,6 +1102,9 @@ static ImBuf *seq_render_movie_strip_view(const RenderData *context,
   IMB_Proxy_Size psize = IMB_Proxy_Size(rendersize_to_proxysize(context->preview_render_size));
   const int frame_index = round_fl_to_int(give_frame_index(context->scene, strip, timeline_frame));
 
+  /* Playback decodes frames of the same size over and over, reuse the buffers of freed frames. */
+  MOV_set_use_frame_pool(sanim->anim, true);
+
   if (can_use_proxy(context, strip, psize)) {
     /* Try to get a proxy image.
      * Movie proxies are handled by ImBuf module with exception of `custom file` setting. */
@@ -2004,7 +2053,7 @@ ImBuf *render_give_ibuf(const RenderData *context, float timeline_frame, int cha
   relations_free_all_anim_ibufs(context->scene, timeline_frame);
 
   if (!strips.is_empty() && !out) {
-    BLI_mutex_lock(&seq_render_mutex);
+    seq_render_lock_acquire(context->is_prefetch_render);
     out = seq_render_strip_stack(context, &state, channels, seqbasep, timeline_frame, chanshown);
 
     if (context->is_prefetch_render) {
@@ -2014,7 +2063,7 @@ ImBuf *render_give_ibuf(const RenderData *context, float timeline_frame, int cha
       seq_cache_put_if_possible(
           context, strips.last(), timeline_frame, SEQ_CACHE_STORE_FINAL_OUT, out);
     }
-    BLI_mutex_unlock(&seq_render_mutex);
+    seq_render_lock_release(context->is_prefetch_render);
   }
 
   seq_prefetch_start(context, timeline_frame);
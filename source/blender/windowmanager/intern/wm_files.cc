@@ -1079,6 +1079,9 @@ bool WM_file_read(bContext *C,
      * risk, because the excluded path list is also loaded. Further it's just confusing
      * if a user loads a file and various preferences change. */
     params.skip_flags = BLO_READ_SKIP_USERDEF;
+    if (G.f & G_FLAG_READFILE_SKIP_UNUSED_IDS) {
+      params.skip_flags |= BLO_READ_SKIP_UNUSED_IDS;
+    }
 
     BlendFileReadReport bf_reports{};
     bf_reports.reports = reports;
@@ -2105,6 +2108,13 @@ static bool wm_file_write_check_with_report_on_failure(Main *bmain,
     return false;
   }
 
+  if (bmain->is_partially_read && BLI_path_cmp(BKE_main_blendfile_path(bmain), filepath) == 0) {
+    BKE_report(reports,
+               RPT_ERROR,
+               "Cannot overwrite a file that was only partially loaded, save as a new file");
+    return false;
+  }
+
   LISTBASE_FOREACH (Library *, li, &bmain->libraries) {
     if (BLI_path_cmp(li->runtime->filepath_abs, filepath) == 0) {
       BKE_reportf(reports, RPT_ERROR, "Cannot overwrite used library '%.240s'", filepath);
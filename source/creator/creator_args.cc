@@ -657,6 +657,7 @@ static void print_help(bArgs *ba, bool all)
   BLI_args_print_arg_doc(ba, "--render-output");
   BLI_args_print_arg_doc(ba, "--engine");
   BLI_args_print_arg_doc(ba, "--threads");
+  BLI_args_print_arg_doc(ba, "--profile-compositor");
 
   if (defs.with_cycles) {
     PRINT("Cycles Render Options:\n");
@@ -793,6 +794,7 @@ static void print_help(bArgs *ba, bool all)
   BLI_args_print_arg_doc(ba, "--app-template");
   BLI_args_print_arg_doc(ba, "--factory-startup");
   BLI_args_print_arg_doc(ba, "--enable-event-simulate");
+  BLI_args_print_arg_doc(ba, "--skip-unused-data");
   PRINT("\n");
   BLI_args_print_arg_doc(ba, "--env-system-datafiles");
   BLI_args_print_arg_doc(ba, "--env-system-scripts");
@@ -1627,6 +1629,17 @@ static int arg_handle_factory_startup_set(int /*argc*/, const char ** /*argv*/,
   return 0;
 }
 
+static const char arg_handle_skip_unused_data_set_doc[] =
+    "\n"
+    "\tOnly load the data-blocks used by scenes and the UI when opening blend-files.\n"
+    "\tThis reduces loading time and memory usage of large files, e.g. for rendering,\n"
+    "\tbut the opened files cannot be saved over.";
+static int arg_handle_skip_unused_data_set(int /*argc*/, const char ** /*argv*/, void * /*data*/)
+{
+  G.f |= G_FLAG_READFILE_SKIP_UNUSED_IDS;
+  return 0;
+}
+
 static const char arg_handle_enable_event_simulate_doc[] =
     "\n\t"
     "Enable event simulation testing feature 'bpy.types.Window.event_simulate'.";
@@ -2521,6 +2534,22 @@ static int arg_handle_profile_gpu_set(int /*argc*/, const char ** /*argv*/, void
 }
 #  endif
 
+static const char arg_handle_profile_compositor_set_doc[] =
+    "<filepath>\n"
+    "\tProfile the compositor, recording the time and memory used by every operation\n"
+    "\t(Appends events in the Trace Event Format to <filepath> for every composited frame)";
+static int arg_handle_profile_compositor_set(int argc, const char **argv, void * /*data*/)
+{
+  if (argc > 1) {
+    STRNCPY(G.compositor_profile_filepath, argv[1]);
+    BLI_path_canonicalize_native(G.compositor_profile_filepath,
+                                 sizeof(G.compositor_profile_filepath));
+    return 1;
+  }
+  fprintf(stderr, "\nError: you must specify a path after '--profile-compositor'.\n");
+  return 0;
+}
+
 /**
  * Implementation for #arg_handle_load_last_file, also used by `--open-last`.
  * \return true on success.
@@ -2693,6 +2722,8 @@ void main_args_setup(bContext *C, bArgs *ba, bool all)
                nullptr);
   BLI_args_add(ba, nullptr, "--profile-gpu", CB(arg_handle_profile_gpu_set), nullptr);
 #  endif
+  BLI_args_add(
+      ba, nullptr, "--profile-compositor", CB(arg_handle_profile_compositor_set), nullptr);
 
   /* Pass: Background Mode & Settings
    *
@@ -2890,6 +2921,7 @@ void main_args_setup(bContext *C, bArgs *ba, bool all)
   BLI_args_add(ba, nullptr, "--factory-startup", CB(arg_handle_factory_startup_set), nullptr);
   BLI_args_add(
       ba, nullptr, "--enable-event-simulate", CB(arg_handle_enable_event_simulate), nullptr);
+  BLI_args_add(ba, nullptr, "--skip-unused-data", CB(arg_handle_skip_unused_data_set), nullptr);
 
   /* Pass: Custom Window Stuff. */
   BLI_args_pass_set(ba, ARG_PASS_SETTINGS_GUI);
@@ -340,6 +340,87 @@ class CameraExportImportTest(unittest.TestCase):
         self.assertAlmostEqual(1, actual_scale.z, delta=delta_scale)
 
 
+class DeformingMeshStreamTest(AbstractAlembicTest):
+    """
+    The Mesh Sequence Cache modifier keeps the faces and edges of its input mesh when they match the
+    file, and only reads the deformed positions. The result should be the same as reading the frame
+    into a newly imported object.
+    """
+
+    def setUp(self):
+        super().setUp()
+        self._tempdir = tempfile.TemporaryDirectory()
+        self.abc_path = pathlib.Path(self._tempdir.name) / "deforming_grid.abc"
+
+        # A grid that is deformed by an animated shape key.
+        size = 4
+        mesh = bpy.data.meshes.new("Grid")
+        mesh.from_pydata(
+            [(x, y, 0.0) for y in range(size) for x in range(size)],
+            [],
+            [(y * size + x, y * size + x + 1, (y + 1) * size + x + 1, (y + 1) * size + x)
+             for y in range(size - 1) for x in range(size - 1)])
+        ob = bpy.data.objects.new("Grid", mesh)
+        bpy.context.scene.collection.objects.link(ob)
+        ob.shape_key_add(name="Basis")
+        deform = ob.shape_key_add(name="Deform")
+        for point in deform.data:
+            point.co.z = point.co.x * point.co.y
+        deform.value = 0.0
+        deform.keyframe_insert("value", frame=1)
+        deform.value = 1.0
+        deform.keyframe_insert("value", frame=2)
+
+        self.assertIn('FINISHED', bpy.ops.wm.alembic_export(filepath=str(self.abc_path), start=1, end=2))
+        bpy.ops.wm.open_mainfile(filepath=str(self.testdir / "empty.blend"))
+
+    def tearDown(self):
+        # Release the imported Alembic file, so that it can be deleted on Windows.
+        bpy.ops.wm.read_homefile(use_empty=True, use_factory_startup=True)
+        self._tempdir.cleanup()
+
+    def import_object(self):
+        objects = set(bpy.data.objects)
+        self.assertEqual({'FINISHED'}, bpy.ops.wm.alembic_import(
+            filepath=str(self.abc_path), as_background_job=False))
+        (ob,) = [ob for ob in set(bpy.data.objects) - objects if ob.type == 'MESH']
+        return ob
+
+    @staticmethod
+    def evaluated_mesh_data(ob):
+        depsgraph = bpy.context.evaluated_depsgraph_get()
+        mesh = ob.evaluated_get(depsgraph).data
+        return (
+            [tuple(vert.co) for vert in mesh.vertices],
+            sorted(tuple(sorted(edge.vertices)) for edge in mesh.edges),
+            [tuple(face.vertices) for face in mesh.polygons],
+        )
+
+    def do_stream_test(self, *, add_loose_edge: bool):
+        bpy.context.scene.frame_set(1)
+        ob = self.import_object()
+        if add_loose_edge:
+            # Connect the diagonal corners of the first face. Building the edges from the faces of
+            # the file removes the edge again.
+            ob.data.edges.add(1)
+            ob.data.edges[-1].vertices = (0, 5)
+            ob.data.update()
+        frame_1 = self.evaluated_mesh_data(ob)
+
+        bpy.context.scene.frame_set(2)
+        frame_2 = self.evaluated_mesh_data(ob)
+        self.assertNotEqual(frame_1[0], frame_2[0])
+
+        fresh_ob = self.import_object()
+        self.assertEqual(self.evaluated_mesh_data(fresh_ob), frame_2)
+
+    def test_stream_deforming_mesh(self):
+        self.do_stream_test(add_loose_edge=False)
+
+    def test_stream_deforming_mesh_with_loose_edge(self):
+        self.do_stream_test(add_loose_edge=True)
+
+
 class OverrideLayersTest(AbstractAlembicTest):
     def test_import_layer(self):
         fname = 'cube-base-file.abc'
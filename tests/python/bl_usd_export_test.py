@@ -1403,6 +1403,62 @@ class USDExportTest(AbstractUSDTest):
         self.assertEqual(stats['primary']['primCountsByType']['Mesh'], 2, "Unexpected number of primary meshes")
         self.assertEqual(stats['primary']['primCountsByType']['Points'], 4, "Unexpected number of primary point clouds")
 
+    def test_export_deduplicate_meshes(self):
+        """Test that identical meshes are written once and referenced by the other mesh prims."""
+        bpy.ops.wm.open_mainfile(filepath=str(self.testdir / "nested_instancing_test.blend"))
+
+        export_path = self.tempdir / "usd_export_deduplicate_meshes.usda"
+        self.export_and_validate(
+            filepath=str(export_path),
+            use_instancing=False,
+            deduplicate_meshes=True,
+        )
+
+        stage = Usd.Stage.Open(str(export_path))
+        meshes = [prim for prim in stage.Traverse() if prim.IsA(UsdGeom.Mesh)]
+        self.assertEqual(len(meshes), 2, "Unexpected number of meshes")
+
+        # Both planes use the same mesh, so only one of them holds the data.
+        references = [prim for prim in meshes if prim.HasAuthoredReferences()]
+        self.assertEqual(len(references), 1, "Expected one mesh to reference the other")
+        reference_mesh = UsdGeom.Mesh(references[0])
+        prototype_mesh = UsdGeom.Mesh(next(prim for prim in meshes if prim != references[0]))
+        points_path = reference_mesh.GetPath().AppendProperty("points")
+        self.assertIsNone(stage.GetRootLayer().GetAttributeAtPath(points_path))
+        self.assertEqual(reference_mesh.GetPointsAttr().Get(), prototype_mesh.GetPointsAttr().Get())
+        self.assertEqual(reference_mesh.GetFaceVertexIndicesAttr().Get(),
+                         prototype_mesh.GetFaceVertexIndicesAttr().Get())
+
+    def test_export_deduplicate_meshes_vertex_weights(self):
+        """Test that meshes with separately allocated but equal vertex weights are deduplicated."""
+        bpy.ops.wm.open_mainfile(filepath=str(self.testdir / "empty.blend"))
+
+        # The weights of every vertex are stored in their own arrays, so meshes created separately
+        # don't share them.
+        for i, weight in enumerate((0.5, 0.5, 0.25)):
+            mesh = bpy.data.meshes.new(f"Plane{i}")
+            mesh.from_pydata([(0, 0, 0), (1, 0, 0), (1, 1, 0), (0, 1, 0)], [], [(0, 1, 2, 3)])
+            ob = bpy.data.objects.new(f"Plane{i}", mesh)
+            ob.location.x = i * 2.0
+            bpy.context.scene.collection.objects.link(ob)
+            group = ob.vertex_groups.new(name="Group")
+            group.add([0, 2], weight, 'REPLACE')
+
+        export_path = self.tempdir / "usd_export_deduplicate_meshes_vertex_weights.usda"
+        self.export_and_validate(
+            filepath=str(export_path),
+            use_instancing=False,
+            deduplicate_meshes=True,
+        )
+
+        # Only the first two planes have the same weights.
+        stage = Usd.Stage.Open(str(export_path))
+        meshes = [prim for prim in stage.Traverse() if prim.IsA(UsdGeom.Mesh)]
+        self.assertEqual(len(meshes), 3, "Unexpected number of meshes")
+        references = [prim for prim in meshes if prim.HasAuthoredReferences()]
+        self.assertEqual(len(references), 1, "Expected one mesh to reference another")
+        self.assertIn(references[0].GetParent().GetName(), {"Plane0", "Plane1"})
+
     def test_texture_export_hook(self):
         """Exporting textures from on_material_export USD hook."""
 
@@ -1847,6 +1847,85 @@ class USDImportTest(AbstractUSDTest):
         bpy.utils.unregister_class(ImportMtlxTextureUSDHook)
 
 
+class USDDeformingMeshStreamTest(AbstractUSDTest):
+    """
+    The Mesh Sequence Cache modifier keeps the faces and edges of its input mesh when they match the
+    file, and only reads the deformed positions. The result should be the same as reading the frame
+    into a newly imported object.
+    """
+
+    def setUp(self):
+        super().setUp()
+        self.usd_path = str(self.tempdir / "usd_deforming_grid.usda")
+
+        # A grid that is deformed by an animated shape key.
+        size = 4
+        mesh = bpy.data.meshes.new("Grid")
+        mesh.from_pydata(
+            [(x, y, 0.0) for y in range(size) for x in range(size)],
+            [],
+            [(y * size + x, y * size + x + 1, (y + 1) * size + x + 1, (y + 1) * size + x)
+             for y in range(size - 1) for x in range(size - 1)])
+        ob = bpy.data.objects.new("Grid", mesh)
+        bpy.context.scene.collection.objects.link(ob)
+        ob.shape_key_add(name="Basis")
+        deform = ob.shape_key_add(name="Deform")
+        for point in deform.data:
+            point.co.z = point.co.x * point.co.y
+        deform.value = 0.0
+        deform.keyframe_insert("value", frame=1)
+        deform.value = 1.0
+        deform.keyframe_insert("value", frame=2)
+
+        bpy.context.scene.frame_start = 1
+        bpy.context.scene.frame_end = 2
+        res = bpy.ops.wm.usd_export(filepath=self.usd_path, export_animation=True)
+        self.assertEqual({'FINISHED'}, res, f"Unable to export to {self.usd_path}")
+        bpy.ops.wm.open_mainfile(filepath=str(self.testdir / "empty.blend"))
+
+    def import_object(self):
+        objects = set(bpy.data.objects)
+        res = bpy.ops.wm.usd_import(filepath=self.usd_path)
+        self.assertEqual({'FINISHED'}, res, f"Unable to import USD file {self.usd_path}")
+        (ob,) = [ob for ob in set(bpy.data.objects) - objects if ob.type == 'MESH']
+        self.assertEqual(ob.modifiers[0].type, 'MESH_SEQUENCE_CACHE')
+        return ob
+
+    @staticmethod
+    def evaluated_mesh_data(ob):
+        depsgraph = bpy.context.evaluated_depsgraph_get()
+        mesh = ob.evaluated_get(depsgraph).data
+        return (
+            [tuple(vert.co) for vert in mesh.vertices],
+            sorted(tuple(sorted(edge.vertices)) for edge in mesh.edges),
+            [tuple(face.vertices) for face in mesh.polygons],
+        )
+
+    def do_stream_test(self, *, add_loose_edge: bool):
+        bpy.context.scene.frame_set(1)
+        ob = self.import_object()
+        if add_loose_edge:
+            # Connect the diagonal corners of the first face. Building the edges from the faces of
+            # the file removes the edge again.
+            ob.data.edges.add(1)
+            ob.data.edges[-1].vertices = (0, 5)
+            ob.data.update()
+        frame_1 = self.evaluated_mesh_data(ob)
+
+        bpy.context.scene.frame_set(2)
+        frame_2 = self.evaluated_mesh_data(ob)
+        self.assertNotEqual(frame_1[0], frame_2[0])
+
+        fresh_ob = self.import_object()
+        self.assertEqual(self.evaluated_mesh_data(fresh_ob), frame_2)
+
+    def test_stream_deforming_mesh(self):
+        self.do_stream_test(add_loose_edge=False)
+
+    def test_stream_deforming_mesh_with_loose_edge(self):
+        self.do_stream_test(add_loose_edge=True)
+
+
 class GetPrimMapUsdImportHook(bpy.types.USDHook):
     bl_idname = "get_prim_map_usd_import_hook"
     bl_label = "Get Prim Map Usd Import Hook"
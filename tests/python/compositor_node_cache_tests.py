@@ -0,0 +1,175 @@
+# SPDX-FileCopyrightText: 2025 Blender Authors
+#
+# SPDX-License-Identifier: Apache-2.0
+
+import os
+import sys
+import tempfile
+import unittest
+
+import bpy
+
+
+class NodeCacheTest(unittest.TestCase):
+    """
+    Results of nodes are cached across evaluations by the CPU compositor. These tests make sure
+    that changing a parameter of a node invalidates the cached results of the nodes that depend
+    on it.
+    """
+
+    def setUp(self):
+        bpy.ops.wm.read_factory_settings(use_empty=True)
+        self.tempdir = tempfile.TemporaryDirectory()
+
+        scene = bpy.context.scene
+        scene.render.resolution_x = 32
+        scene.render.resolution_y = 32
+        scene.render.resolution_percentage = 100
+        scene.render.compositor_device = 'CPU'
+        scene.render.image_settings.file_format = 'OPEN_EXR'
+        scene.render.filepath = os.path.join(self.tempdir.name, "output.exr")
+        scene.view_settings.view_transform = 'Standard'
+
+        image = bpy.data.images.new("Input", 32, 32, float_buffer=True)
+        image.generated_color = (0.5, 0.5, 0.5, 1.0)
+
+        scene.use_nodes = True
+        tree = scene.node_tree
+        tree.nodes.clear()
+
+        image_node = tree.nodes.new("CompositorNodeImage")
+        image_node.image = image
+        self.curves_node = tree.nodes.new("CompositorNodeCurveRGB")
+        # The blur node is not a pixel node, so its result is cached.
+        self.blur_node = tree.nodes.new("CompositorNodeBlur")
+        self.blur_node.size_x = 2
+        self.blur_node.size_y = 2
+        composite_node = tree.nodes.new("CompositorNodeComposite")
+
+        tree.links.new(image_node.outputs["Image"], self.curves_node.inputs["Image"])
+        tree.links.new(self.curves_node.outputs["Image"], self.blur_node.inputs["Image"])
+        tree.links.new(self.blur_node.outputs["Image"], composite_node.inputs["Image"])
+
+    def tearDown(self):
+        self.tempdir.cleanup()
+
+    def render_center_pixel(self):
+        bpy.ops.render.render(write_still=True)
+        image = bpy.data.images.load(bpy.context.scene.render.filepath)
+        center = (16 * 32 + 16) * 4
+        pixel = tuple(image.pixels[center:center + 4])
+        bpy.data.images.remove(image)
+        return pixel
+
+    def test_curve_point_change(self):
+        initial_pixel = self.render_center_pixel()
+        self.assertEqual(initial_pixel, self.render_center_pixel())
+
+        # Only the points of the curve change, not the curve mapping itself.
+        curve = self.curves_node.mapping.curves[3]
+        curve.points[1].location = (1.0, 0.25)
+        self.curves_node.mapping.update()
+
+        changed_pixel = self.render_center_pixel()
+        self.assertAlmostEqual(changed_pixel[0], initial_pixel[0] * 0.25, places=3)
+
+    def test_input_value_change(self):
+        self.curves_node.inputs["Fac"].default_value = 0.0
+        initial_pixel = self.render_center_pixel()
+
+        self.curves_node.mapping.curves[3].points[1].location = (1.0, 0.25)
+        self.curves_node.mapping.update()
+        self.assertEqual(initial_pixel, self.render_center_pixel())
+
+        self.curves_node.inputs["Fac"].default_value = 1.0
+        changed_pixel = self.render_center_pixel()
+        self.assertAlmostEqual(changed_pixel[0], initial_pixel[0] * 0.25, places=3)
+
+
+class NodeCacheMemoryLimitTest(unittest.TestCase):
+    """
+    Cached results that an evaluation reuses must not be evicted by the results that the same
+    evaluation adds to the cache when the memory cache limit is exceeded.
+    """
+
+    size = 512
+
+    def setUp(self):
+        bpy.ops.wm.read_factory_settings(use_empty=True)
+        self.tempdir = tempfile.TemporaryDirectory()
+        self.memory_cache_limit = bpy.context.preferences.system.memory_cache_limit
+
+        scene = bpy.context.scene
+        scene.render.resolution_x = self.size
+        scene.render.resolution_y = self.size
+        scene.render.resolution_percentage = 100
+        scene.render.compositor_device = 'CPU'
+        scene.render.image_settings.file_format = 'OPEN_EXR'
+        scene.render.filepath = os.path.join(self.tempdir.name, "output.exr")
+        scene.view_settings.view_transform = 'Standard'
+
+        image = bpy.data.images.new("Input", self.size, self.size, float_buffer=True)
+        image.generated_type = 'UV_GRID'
+
+        scene.use_nodes = True
+        tree = scene.node_tree
+        tree.nodes.clear()
+
+        image_node = tree.nodes.new("CompositorNodeImage")
+        image_node.image = image
+        composite_node = tree.nodes.new("CompositorNodeComposite")
+
+        # Independent blurred branches that are added together, each blur result is 4 MB.
+        self.blur_nodes = []
+        sum_socket = None
+        for i in range(4):
+            blur_node = tree.nodes.new("CompositorNodeBlur")
+            blur_node.size_x = i + 1
+            blur_node.size_y = i + 1
+            tree.links.new(image_node.outputs["Image"], blur_node.inputs["Image"])
+            self.blur_nodes.append(blur_node)
+            if sum_socket is None:
+                sum_socket = blur_node.outputs["Image"]
+                continue
+            mix_node = tree.nodes.new("CompositorNodeMixRGB")
+            mix_node.blend_type = 'ADD'
+            tree.links.new(sum_socket, mix_node.inputs[1])
+            tree.links.new(blur_node.outputs["Image"], mix_node.inputs[2])
+            sum_socket = mix_node.outputs["Image"]
+        tree.links.new(sum_socket, composite_node.inputs["Image"])
+
+    def tearDown(self):
+        bpy.context.preferences.system.memory_cache_limit = self.memory_cache_limit
+        self.tempdir.cleanup()
+
+    def render_pixels(self):
+        bpy.ops.render.render(write_still=True)
+        image = bpy.data.images.load(bpy.context.scene.render.filepath)
+        pixels = image.pixels[:]
+        bpy.data.images.remove(image)
+        return pixels
+
+    def test_exceed_memory_limit(self):
+        # Only some of the blur results fit in the cache.
+        bpy.context.preferences.system.memory_cache_limit = 10
+        self.render_pixels()
+
+        # The other blur results are reused, while the changed one is computed and cached again.
+        self.blur_nodes[0].size_x = 5
+        self.blur_nodes[0].size_y = 5
+        cached_pixels = self.render_pixels()
+        self.blur_nodes[3].size_x = 6
+        self.blur_nodes[3].size_y = 6
+        cached_pixels_changed = self.render_pixels()
+
+        # A limit of zero disables the cache.
+        bpy.context.preferences.system.memory_cache_limit = 0
+        self.assertEqual(cached_pixels_changed, self.render_pixels())
+        self.blur_nodes[3].size_x = 4
+        self.blur_nodes[3].size_y = 4
+        self.assertEqual(cached_pixels, self.render_pixels())
+
+
+if __name__ == "__main__":
+    # Drop all arguments before "--", or everything if the delimiter is absent. Keep the executable path.
+    unittest.main(argv=sys.argv[:1] + (sys.argv[sys.argv.index("--") + 1:] if "--" in sys.argv else []))